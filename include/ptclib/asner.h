@@ -935,6 +935,7 @@ class PASN_Stream : public PBYTEArray
     PBoolean IsAtEnd() { return byteOffset >= GetSize(); }
     void ResetDecoder();
     void BeginEncoding();
+    void BeginEncoding(PINDEX reserve);
     void CompleteEncoding();
 
     virtual PBoolean Read(PChannel & chan) = 0;
@@ -980,6 +981,14 @@ class PASN_Stream : public PBYTEArray
     void ByteAlign();
 
   protected:
+    // Make sure there are nBytes available after the current position
+    void EncodeSpace(PINDEX nBytes)
+    {
+      if (byteOffset+nBytes > GetSize())
+        GrowEncoding(byteOffset+nBytes);
+    }
+    void GrowEncoding(PINDEX minSize);
+
     PINDEX byteOffset;
     unsigned bitOffset;
 
@@ -77,6 +77,12 @@ class PPER_Stream : public PASN_Stream
 
     void AnyTypeEncode(const PASN_Object * value);
 
+    /**Encode an object as a complete encoding, replacing any content.
+       The buffer is presized from the previous encoding of the same type, so
+       repeatedly encoding large PDUs does not repeatedly grow the buffer.
+      */
+    void EncodeObject(const PASN_Object & obj);
+
   protected:
     PBoolean aligned;
 };
@@ -0,0 +1,274 @@
+/*
+ * asntable.h
+ *
+ * Table driven Abstract Syntax Notation 1 encoding rules.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifndef PTLIB_ASNTABLE_H
+#define PTLIB_ASNTABLE_H
+
+#ifdef P_USE_PRAGMA
+#pragma interface
+#endif
+
+#include <ptclib/asner.h>
+
+#if P_ASN
+
+
+/* The table driven codec is an alternative to the class hierarchy generated
+   by asnparser. Each ASN.1 type is described by a constant PASN_TypeDescriptor
+   and its value is a plain structure, with no virtual functions or heap
+   allocated fields, so a structure may be declared on the stack or reused for
+   many messages. The asnparser --tables option generates the descriptors and
+   structures from an ASN.1 module.
+
+   Value structures must be zero initialised before first use, e.g. with
+   "T value = T();", and PASN_TableCodec::Free() called when finished if the
+   type contains a SEQUENCE OF.
+ */
+
+struct PASN_TypeDescriptor;
+
+
+/**Value of an OCTET STRING in a table driven structure.
+   When decoded, the m_data pointer refers directly into the buffer being
+   decoded, so that buffer must outlive the structure. The exception is PER
+   fixed size strings of one or two octets, which are not octet aligned, and
+   are copied into m_inline with m_data set to NULL.
+
+   For encoding, m_data may be set to any memory that outlives the encode.
+  */
+struct PASN_TableOctets
+{
+  const BYTE * m_data;
+  unsigned     m_size;
+  BYTE         m_inline[4];
+
+  const BYTE * GetPointer() const { return m_data != NULL ? m_data : m_inline; }
+  unsigned GetSize() const { return m_size; }
+  void SetValue(const void * data, unsigned size) { m_data = (const BYTE *)data; m_size = size; }
+  void SetValue(const PBYTEArray & data) { SetValue((const BYTE *)data, data.GetSize()); }
+  void SetValue(const PString & str) { SetValue((const char *)str, str.GetLength()); }
+  PString AsString() const { return PString((const char *)GetPointer(), m_size); }
+};
+
+
+/**Value of an OBJECT IDENTIFIER in a table driven structure.
+  */
+struct PASN_TableObjectId
+{
+  enum { MaxSize = 32 };
+
+  unsigned m_size;
+  unsigned m_value[MaxSize];
+
+  /// Set from dotted notation, e.g. "1.3.6.1.2.1"
+  bool SetValue(const PString & dotted);
+
+  /// Get as dotted notation
+  PString AsString() const;
+};
+
+
+/// NULL has no value, this is a placeholder for CHOICE alternatives
+typedef BYTE PASN_TableNull;
+
+
+/**Value of a SEQUENCE OF in a table driven structure.
+   The memory for the elements is retained when the size is reduced, so
+   reusing a structure for many decodes does not allocate once it has grown
+   to the largest size seen.
+  */
+struct PASN_TableArray
+{
+  void   * m_elements;
+  unsigned m_size;
+  unsigned m_capacity;
+
+  /**Set the number of elements.
+     Elements beyond the previous capacity are zeroed, elements between the
+     size and the capacity are left as they were.
+    */
+  bool SetSize(
+    unsigned size,          ///< New number of elements
+    unsigned elementSize    ///< Size of each element in bytes
+  );
+};
+
+
+/// Typed SEQUENCE OF, as used in generated structures.
+template <class T> struct PASN_TableArrayOf : public PASN_TableArray
+{
+  bool SetSize(unsigned size) { return PASN_TableArray::SetSize(size, sizeof(T)); }
+  unsigned GetSize() const { return m_size; }
+  T & operator[](unsigned idx) { return static_cast<T *>(m_elements)[idx]; }
+  const T & operator[](unsigned idx) const { return static_cast<const T *>(m_elements)[idx]; }
+};
+
+
+/**Description of a SEQUENCE field or a CHOICE alternative.
+  */
+struct PASN_FieldDescriptor
+{
+  const char                * m_name;     ///< ASN.1 identifier
+  const PASN_TypeDescriptor * m_type;     ///< Type of field
+  unsigned                    m_offset;   ///< Offset of value in structure
+  int                         m_optional; ///< Bit in the option mask, -1 if mandatory
+};
+
+
+/**Description of an ASN.1 type.
+   A SEQUENCE with any OPTIONAL fields or extensions must have a PUInt64
+   option mask as the first member of its structure, and a CHOICE has the
+   index of the selected alternative as an unsigned first member.
+  */
+struct PASN_TypeDescriptor
+{
+  enum Kinds {
+    e_Null,
+    e_Boolean,
+    e_Integer,      ///< Value is a PInt64
+    e_Enumeration,  ///< Value is an unsigned
+    e_ObjectId,     ///< Value is a PASN_TableObjectId
+    e_OctetString,  ///< Value is a PASN_TableOctets
+    e_Sequence,
+    e_SequenceOf,   ///< Value is a PASN_TableArray
+    e_Choice,
+    e_Any           ///< Value is a PASN_TableOctets with the complete encoding
+  };
+
+  const char                * m_name;          ///< ASN.1 type name
+  Kinds                       m_kind;
+  unsigned                    m_tag;           ///< BER tag, zero for untagged CHOICE
+  PASN_Object::TagClass       m_tagClass;
+  PASN_Object::ConstraintType m_constraint;    ///< Value or size constraint
+  int                         m_lowerLimit;
+  unsigned                    m_upperLimit;    ///< Maximum enumeration for ENUMERATED
+  bool                        m_extendable;    ///< Type has extension marker
+  unsigned                    m_size;          ///< Size of value structure
+  const PASN_FieldDescriptor* m_fields;        ///< SEQUENCE fields or CHOICE alternatives
+  unsigned                    m_rootCount;     ///< Number of fields before the extension marker
+  unsigned                    m_fieldCount;    ///< Total number of fields
+  unsigned                    m_optionalCount; ///< Number of OPTIONAL fields before the extension marker
+  const PASN_TypeDescriptor * m_element;       ///< Element type of SEQUENCE OF
+};
+
+
+/**Encoder and decoder for table driven structures.
+   The BER encoding is identical to that of the generated PASN_Object
+   classes, and the PER encoding uses the PPER_Stream primitives in the same
+   way, so the two may be freely mixed, e.g. a message encoded by the table
+   driven code decoded by the classes.
+  */
+class PASN_TableCodec
+{
+  public:
+    /**Decode BER from memory.
+       Octet strings in the @a value refer into @a data.
+       @return false if the data is not a valid encoding of the type.
+      */
+    static bool DecodeBER(
+      const PASN_TypeDescriptor & type, ///< Type to decode
+      void * value,                     ///< Structure to decode into
+      const BYTE * data,                ///< Encoded data
+      PINDEX size,                      ///< Size of encoded data
+      PINDEX * used = NULL              ///< Bytes of data used
+    );
+
+    /// Decode BER from the current position of the stream.
+    static bool DecodeBER(
+      const PASN_TypeDescriptor & type, ///< Type to decode
+      void * value,                     ///< Structure to decode into
+      PBER_Stream & strm                ///< Stream to decode from
+    );
+
+    /**Encode BER into memory.
+       The @a buffer is only ever grown, so reusing the same buffer for many
+       encodes avoids allocation.
+       @return length of the encoding at the start of @a buffer.
+      */
+    static PINDEX EncodeBER(
+      const PASN_TypeDescriptor & type, ///< Type to encode
+      const void * value,               ///< Structure to encode
+      PBYTEArray & buffer               ///< Buffer to encode into
+    );
+
+    /// Encode BER at the current position of the stream.
+    static void EncodeBER(
+      const PASN_TypeDescriptor & type, ///< Type to encode
+      const void * value,               ///< Structure to encode
+      PBER_Stream & strm                ///< Stream to encode to
+    );
+
+    /**Decode PER from the stream.
+       Octet strings in the @a value refer into the stream buffer.
+      */
+    static bool DecodePER(
+      const PASN_TypeDescriptor & type, ///< Type to decode
+      void * value,                     ///< Structure to decode into
+      PPER_Stream & strm                ///< Stream to decode from
+    );
+
+    /// Encode PER to the stream.
+    static void EncodePER(
+      const PASN_TypeDescriptor & type, ///< Type to encode
+      const void * value,               ///< Structure to encode
+      PPER_Stream & strm                ///< Stream to encode to
+    );
+
+    /**Convert a structure to the equivalent generated class.
+       This goes via the BER encoding, so the @a obj must be the generated
+       class for the same ASN.1 type.
+      */
+    static bool ToObject(
+      const PASN_TypeDescriptor & type, ///< Type of structure
+      const void * value,               ///< Structure to convert
+      PASN_Object & obj                 ///< Object to receive value
+    );
+
+    /**Convert a generated class to the equivalent structure.
+       The octet strings in @a value refer into @a storage, which must outlive
+       the structure.
+      */
+    static bool FromObject(
+      const PASN_TypeDescriptor & type, ///< Type of structure
+      const PASN_Object & obj,          ///< Object to convert
+      void * value,                     ///< Structure to receive value
+      PBYTEArray & storage              ///< Storage for the encoded object
+    );
+
+    /// Release all memory allocated for SEQUENCE OF within the structure.
+    static void Free(
+      const PASN_TypeDescriptor & type, ///< Type of structure
+      void * value                      ///< Structure to release
+    );
+};
+
+
+#endif // P_ASN
+
+#endif // PTLIB_ASNTABLE_H
+
+
+// End Of File ///////////////////////////////////////////////////////////////
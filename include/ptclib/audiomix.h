@@ -0,0 +1,281 @@
+/*
+ * audiomix.h
+ *
+ * Audio mixing for multi-party conferences.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifndef PTLIB_AUDIOMIX_H
+#define PTLIB_AUDIOMIX_H
+
+#ifdef P_USE_PRAGMA
+#pragma interface
+#endif
+
+#include <ptlib.h>
+
+#if P_AUDIO
+
+#include <ptlib/sound.h>
+#include <ptclib/delaychan.h>
+#include <map>
+#include <vector>
+
+
+/** Mixer for N-party audio conferences.
+    Each participant has a jitter tolerant input queue, into which 16 bit
+    mono PCM is written at the participants sample rate, being resampled to
+    the mixers rate as required. Once every period, one sample from each
+    participant is summed, and every participant receives the sum of all
+    the others, that is, the mix without its own audio.
+
+    Mixing is done by a background thread, paced by a PAdaptiveDelay, that
+    is started with Start(), or MixPeriod() may be called directly by the
+    application to supply its own timing.
+
+    Participants may be given a PSoundChannel recorder, which is read by
+    the mixer thread to get input, and/or a PSoundChannel player, to which
+    the mixed output is written. Alternatively, WriteAudio() and OnMixed()
+    may be used to get audio in and out of the mixer.
+  */
+class PAudioMixer : public PObject
+{
+    PCLASSINFO(PAudioMixer, PObject);
+  public:
+    /// Default values
+    enum {
+      DefaultSampleRate = 8000,
+      DefaultPeriodMS = 20,
+      DefaultJitterMS = 60
+    };
+
+    /**Create a new mixer.
+      */
+    PAudioMixer(
+      unsigned sampleRate = DefaultSampleRate,  ///< Sample rate mixing is done at
+      unsigned periodMS = DefaultPeriodMS       ///< Time between mixes
+    );
+
+    /// Destroy mixer, stopping thread and removing all participants.
+    ~PAudioMixer();
+
+    /**Add a participant to the mixer.
+       The @a jitterMS indicates how much audio is buffered before the
+       participant is included in the mix, after being added or after an
+       underrun, and so how much variation in the arrival of audio via
+       WriteAudio() is tolerated. Twice this is the maximum queued, older
+       audio being discarded when exceeded.
+
+       If @a recorder is not NULL, the mixer thread reads a period of audio
+       from the channel for each mix. If @a player is not NULL, the mixer
+       thread writes the mixed audio for the participant to the channel.
+       The channels should be opened, and set to mono, 16 bit, and
+       @a sampleRate. If @a autoDelete is true, the channels are deleted
+       when the participant is removed.
+
+       @return false if the @a id already exists.
+      */
+    bool AddParticipant(
+      const PString & id,             ///< Identifier for participant
+      unsigned sampleRate = 0,        ///< Sample rate for participant, zero is same as mixer
+      unsigned jitterMS = DefaultJitterMS, ///< Jitter tolerance for input
+      PSoundChannel * recorder = NULL,///< Optional channel for input audio
+      PSoundChannel * player = NULL,  ///< Optional channel for mixed output audio
+      bool autoDelete = true          ///< Delete the channels when participant removed
+    );
+
+    /**Remove a participant from the mixer.
+       @return false if the @a id does not exist.
+      */
+    bool RemoveParticipant(
+      const PString & id    ///< Identifier for participant
+    );
+
+    /// Remove all participants.
+    void RemoveAllParticipants();
+
+    /// Get identifiers for all current participants.
+    PStringArray GetParticipants() const;
+
+    /**Write input audio for a participant.
+       The @a data is 16 bit mono PCM at the participants sample rate.
+       @return false if the @a id does not exist.
+      */
+    bool WriteAudio(
+      const PString & id,   ///< Identifier for participant
+      const void * data,    ///< PCM data
+      PINDEX size           ///< Size of data in bytes
+    );
+
+    /**Start the mixer thread.
+       Every period MixPeriod() is called, the thread timing being controlled
+       via a PAdaptiveDelay.
+      */
+    bool Start();
+
+    /// Stop the mixer thread.
+    void Stop();
+
+    /// Indicate the mixer thread is running.
+    bool IsRunning() const { return m_thread != NULL; }
+
+    /**Mix a single period of audio.
+       This reads any recorder channels, collects a period from each of the
+       input queues, then calls OnMixed() for each participant. It is called
+       by the mixer thread, but may be called directly if it is not running.
+       Does nothing if the period is zero samples.
+
+       The mixer is only locked while the queues are accessed, so reading the
+       recorder channels and OnMixed() do not hold up other threads calling
+       WriteAudio(), AddParticipant() etc. A participant removed during the
+       mix is not deleted until the mix is complete.
+      */
+    void MixPeriod();
+
+    /**Called when the mixed audio for a participant is available.
+       The default behaviour writes to the player channel, if present.
+
+       This is called without the mixer locked, so may block on the player
+       and may call back into functions such as RemoveParticipant().
+      */
+    virtual void OnMixed(
+      const PString & id,     ///< Identifier for participant
+      const short * samples,  ///< Mixed PCM audio, at the participants rate
+      PINDEX count            ///< Number of samples
+    );
+
+    /// Get the sample rate mixing is done at.
+    unsigned GetSampleRate() const { return m_sampleRate; }
+
+    /// Get the time between mixes.
+    unsigned GetPeriod() const { return m_periodMS; }
+
+    /// Get the number of samples in a mixing period.
+    PINDEX GetPeriodSamples() const { return m_periodSamples; }
+
+    /// Statistics for a participant
+    struct Statistics
+    {
+      Statistics() : m_queued(0), m_underruns(0), m_overruns(0) { }
+      PINDEX   m_queued;     ///< Samples currently in input queue
+      unsigned m_underruns;  ///< Number of periods input queue was empty
+      unsigned m_overruns;   ///< Number of times input queue overflowed
+    };
+
+    /**Get the statistics for a participant.
+       @return false if the @a id does not exist.
+      */
+    bool GetStatistics(
+      const PString & id,   ///< Identifier for participant
+      Statistics & stats    ///< Statistics returned
+    ) const;
+
+    /**Add samples into a 32 bit accumulator.
+      */
+    static void AccumulateSamples(
+      int * sum,            ///< Accumulator
+      const short * samples,///< Samples to add
+      PINDEX count          ///< Number of samples
+    );
+
+    /**Output the accumulator less a participants own contribution,
+       saturating to 16 bits.
+      */
+    static void SubtractAndSaturate(
+      short * output,       ///< Output samples
+      const int * sum,      ///< Accumulator
+      const short * self,   ///< Samples to remove, NULL for none
+      PINDEX count          ///< Number of samples
+    );
+
+  protected:
+    // Linear interpolating sample rate converter, keeps state between blocks
+    struct Resampler
+    {
+      Resampler(unsigned srcRate, unsigned dstRate);
+      PINDEX GetMaxOutput(PINDEX count) const { return (PINDEX)((PUInt64)count*m_dstRate/m_srcRate + 2); }
+      PINDEX Convert(const short * src, PINDEX count, short * dst);
+
+      unsigned m_srcRate;
+      unsigned m_dstRate;
+      PUInt64  m_step;      // 32.32 fixed point
+      PUInt64  m_position;  // 32.32 fixed point, index 0 is m_last
+      short    m_last;
+    };
+
+    struct Participant
+    {
+      Participant(const PString & id, unsigned sampleRate, unsigned mixerRate, PINDEX periodSamples, PINDEX jitterSamples,
+                  PSoundChannel * recorder, PSoundChannel * player, bool autoDelete);
+      ~Participant();
+
+      void Write(const short * samples, PINDEX count);
+      void WriteResampled(const short * samples, PINDEX count);
+      bool Read(short * samples, PINDEX count);
+
+      PString            m_id;
+      unsigned           m_sampleRate;
+      std::vector<short> m_queue;       // Circular buffer at mixer rate
+      PINDEX             m_queuePos;
+      PINDEX             m_queued;
+      PINDEX             m_jitterSamples;
+      bool               m_buffering;
+      std::vector<short> m_input;       // Period of input at mixer rate
+      bool               m_active;      // m_input has audio this period
+      Resampler          m_inputResampler;
+      Resampler          m_outputResampler;
+      PShortArray        m_resampled;   // Scratch for sample rate conversion
+      PShortArray        m_recorded;    // Scratch for reading recorder, mixer thread only
+      PShortArray        m_mixed;       // Scratch for output conversion, mixer thread only
+      PSoundChannel    * m_recorder;
+      PSoundChannel    * m_player;
+      bool               m_autoDelete;
+      Statistics         m_statistics;
+      unsigned           m_references;  // Mixes/OnMixed() in progress using participant
+      bool               m_removed;     // Delete when m_references drops to zero
+    };
+    typedef std::map<PString, Participant *> ParticipantMap;
+
+    void MixMain();
+    void DeleteParticipant(Participant * participant);
+    void ReleaseParticipant(Participant * participant);
+
+    unsigned           m_sampleRate;
+    unsigned           m_periodMS;
+    PINDEX             m_periodSamples;
+    ParticipantMap     m_participants;
+    std::vector<int>   m_sum;
+    std::vector<short> m_output;
+    PThread          * m_thread;
+    atomic<bool>       m_running;
+    PAdaptiveDelay     m_pacing;
+    mutable PMutex     m_mutex;
+    PMutex             m_mixMutex;
+};
+
+
+#endif // P_AUDIO
+
+#endif // PTLIB_AUDIOMIX_H
+
+
+// End Of File ///////////////////////////////////////////////////////////////
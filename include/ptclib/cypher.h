@@ -268,9 +268,55 @@ class PBase64 : public PObject
     );
 
 
+    /** Get the length of the base 64 encoding of a data block.
+       This is the exact number of characters EncodeBlock() writes.
+     */
+    static PINDEX GetEncodedLength(
+      PINDEX length,           ///< Length of the data block.
+      Options options = e_LF,  ///< Options for encoding.
+      PINDEX width = 76        ///< Line widths if options != e_URL
+    );
+
+    /** Encode a data block directly into a caller supplied buffer.
+       No heap memory is used, which makes this suitable for encoding large
+       blocks, e.g. MIME attachments, or for many small ones, e.g. tokens.
+       The buffer must be at least GetEncodedLength() characters, a
+       terminating null is not written.
+
+       @return
+       Number of characters written to the buffer.
+     */
+    static PINDEX EncodeBlock(
+      const void * dataBlock,  ///< Pointer to data to be encoded to Base64
+      PINDEX length,           ///< Length of the data block.
+      char * buffer,           ///< Buffer to receive the Base64 characters
+      Options options = e_LF,  ///< Options for encoding.
+      PINDEX width = 76        ///< Line widths if options != e_URL
+    );
+
+    /** Get the maximum size of the data decoded from a base 64 string.
+     */
+    static PINDEX GetMaxDecodedLength(
+      PINDEX length            ///< Length of Base64 string
+    ) { return length/4*3 + 3; }
+
+    /** Decode a base 64 string directly into a caller supplied buffer.
+       Both the standard and URL safe alphabets are accepted, line endings are
+       ignored. The buffer must be at least GetMaxDecodedLength() bytes.
+
+       @return
+       Number of bytes decoded.
+     */
+    static PINDEX DecodeBlock(
+      const char * str,        ///< Base64 string to be decoded
+      PINDEX length,           ///< Length of Base64 string
+      BYTE * buffer,           ///< Buffer to receive decoded data
+      bool * perfect = NULL    ///< Set to false if the string had illegal characters or was incomplete
+    );
+
 
   private:
-    void OutputBase64(const BYTE * data);
+    PBoolean InternalProcessDecoding(const char * str, PINDEX length);
 
     PString m_encodedString;
     BYTE    m_saveTriple[3];
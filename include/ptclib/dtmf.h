@@ -110,7 +110,8 @@ class PTones : public PShortArray
       DefaultSampleRate = 8000,
       MinFrequency = 30,
       MinModulation = 5,
-      SineScale = 1000
+      SineScale = 1000,
+      DefaultCacheSize = 100
     };
 
     /** Create an empty tone buffer. Tones added will use the specified
@@ -131,6 +132,10 @@ class PTones : public PShortArray
 
     /** Generate a tone using the specified descriptor.
         See class general notes for format of the descriptor string.
+
+        If the buffer is empty, the rendered tone is kept in a process wide
+        cache keyed by the descriptor, sample rate and master volume, so
+        subsequent generation of the same tone shares the sample data.
       */
     bool Generate(
       const PString & descriptor,   ///< Descriptor string for tone(s). See class notes.
@@ -165,8 +170,16 @@ class PTones : public PShortArray
 
     virtual PBoolean SetSize(PINDEX newSize);
 
+    /** Set the maximum number of rendered tones kept in the process wide
+        cache. A value of zero disables the cache.
+      */
+    static void SetCacheSize(
+      PINDEX entries    ///< Maximum number of cached tones
+    );
+
   protected:
     void Reset();
+    bool InternalGenerate(const PString & descriptor);
 
     bool Juxtapose(unsigned frequency1, unsigned frequency2, unsigned milliseconds, unsigned volume);
     bool Modulate (unsigned frequency, unsigned modulate, unsigned milliseconds, unsigned volume);
@@ -175,6 +188,7 @@ class PTones : public PShortArray
 
     unsigned CalcSamples(unsigned milliseconds, unsigned frequency1, unsigned frequency2 = 0);
 
+    short * ReserveSamples(unsigned count);
     void AddSample(int sample, unsigned volume);
 
     unsigned m_sampleRate;
@@ -182,11 +196,65 @@ class PTones : public PShortArray
     unsigned m_masterVolume;
     char     m_lastOperation;
     unsigned m_lastFrequency1, m_lastFrequency2;
-    int      m_angle1, m_angle2;
+    uint32_t m_phase1, m_phase2;
     PINDEX   m_addPosition;
 };
 
 
+/** This class streams tone data into caller supplied buffers.
+    The descriptor is rendered once, via the PTones cache, and Read() then
+    copies from the shared samples, so no allocation occurs while streaming.
+  */
+class PTonesGenerator : public PObject
+{
+  PCLASSINFO(PTonesGenerator, PObject)
+
+  public:
+    /** Create a generator, optionally opening it on a tone descriptor.
+      */
+    PTonesGenerator(
+      const PString & descriptor = PString::Empty(),  ///< Descriptor string for tone(s). See PTones class notes.
+      unsigned masterVolume = PTones::MaxVolume,      ///< Percentage volume
+      unsigned sampleRate = PTones::DefaultSampleRate,///< Sample rate of generated data
+      bool autoRepeat = true                          ///< Repeat the tone indefinitely
+    );
+
+    /** Set the tone descriptor to be generated.
+      */
+    bool Open(
+      const PString & descriptor,                     ///< Descriptor string for tone(s). See PTones class notes.
+      unsigned masterVolume = PTones::MaxVolume,      ///< Percentage volume
+      unsigned sampleRate = PTones::DefaultSampleRate,///< Sample rate of generated data
+      bool autoRepeat = true                          ///< Repeat the tone indefinitely
+    );
+
+    /// Indicate generator has a tone to play
+    bool IsOpen() const { return !m_tones.IsEmpty(); }
+
+    /** Fill the buffer with the next samples of the tone.
+        If not auto-repeating, once the tone is complete the remainder of the
+        buffer is filled with silence.
+
+        @return number of tone samples written, zero indicates the tone is complete.
+      */
+    PINDEX Read(
+      short * buffer,   ///< Buffer to receive samples
+      PINDEX count      ///< Number of samples to write to buffer
+    );
+
+    /// Restart the tone from the beginning.
+    void Rewind() { m_position = 0; }
+
+    /// Get the sample rate of the generated tone.
+    unsigned GetSampleRate() const { return m_tones.GetSampleRate(); }
+
+  protected:
+    PTones m_tones;
+    PINDEX m_position;
+    bool   m_autoRepeat;
+};
+
+
 /**
   * this class can be used to generate PCM data for DTMF tones
   * at a sample rate of 8khz
@@ -0,0 +1,277 @@
+/*
+ * filecache.h
+ *
+ * Process wide cache of shared, read only, file content.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifndef PTLIB_FILECACHE_H
+#define PTLIB_FILECACHE_H
+
+#ifdef P_USE_PRAGMA
+#pragma interface
+#endif
+
+#include <ptlib.h>
+#include <ptlib/smartptr.h>
+#include <map>
+
+
+/**Read only content of a file, shared by any number of readers.
+   The content is either the file itself, memory mapped where the platform
+   allows so that all readers use the operating system page cache, or data
+   derived from the file, e.g. PCM decoded from a compressed WAV file, held
+   once in memory.
+  */
+class PFileContent : public PSmartObject
+{
+    PCLASSINFO(PFileContent, PSmartObject);
+  public:
+    /// Create empty content.
+    PFileContent();
+
+    /// Unmap or release the content.
+    ~PFileContent();
+
+    /**Map the whole of a file.
+       If the platform cannot memory map the file, it is read into memory,
+       provided it is not larger than @a maxReadSize.
+
+       Note, the file must not be truncated or rewritten in place while
+       mapped, on most Unix platforms reading a page beyond the new end of
+       file raises SIGBUS. Files should be replaced, e.g. by rename(), which
+       leaves the mapping on the old file. Use Load() for files that may be
+       modified.
+      */
+    bool Map(
+      const PFilePath & path,   ///< File to map
+      PINDEX maxReadSize = P_MAX_INDEX ///< Maximum size if read into memory
+    );
+
+    /**Read the whole of a file into memory.
+       This fails if the file is larger than @a maxSize.
+      */
+    bool Load(
+      const PFilePath & path,   ///< File to read
+      PINDEX maxSize = P_MAX_INDEX ///< Maximum size of file
+    );
+
+    /**Set the content to derived data.
+       The array is reference counted, so this does not copy the data.
+      */
+    void SetData(
+      const PBYTEArray & data   ///< Content data
+    );
+
+    /// Get pointer to the content.
+    const BYTE * GetPointer() const { return m_pointer; }
+
+    /// Get the size of the content in bytes.
+    off_t GetSize() const { return m_size; }
+
+    /// Indicate content is memory mapped from the file.
+    bool IsMapped() const { return m_mapped; }
+
+    /// Indicate something other than the cache is using the content.
+    bool IsInUse() const { return referenceCount > 1; }
+
+    /**Copy from the content.
+       @return number of bytes copied, zero at end of content.
+      */
+    PINDEX Read(
+      off_t position,   ///< Offset into content
+      void * buffer,    ///< Buffer to receive data
+      PINDEX length     ///< Maximum length to copy
+    ) const;
+
+    /**Advise the operating system that a region of a mapped file will be
+       needed soon. The pages are read asynchronously. This does nothing if
+       the content is not memory mapped.
+      */
+    void ReadAhead(
+      off_t position,   ///< Offset into content
+      off_t length      ///< Length of region
+    ) const;
+
+  protected:
+    void Unmap();
+    bool ReadFile(PFile & file, PINDEX maxSize);
+
+    const BYTE * m_pointer;
+    off_t        m_size;
+    bool         m_mapped;
+    PBYTEArray   m_data;
+#ifdef _WIN32
+    HANDLE       m_mapping;
+#endif
+};
+
+typedef PSmartPtr<PFileContent> PFileContentPtr;
+
+
+/**Process wide cache of file content.
+   This allows many readers of the same file, e.g. an IVR playing the same
+   prompt to many calls, to share one copy of the file content.
+
+   Content is keyed by the file path and a "variant" string, so different
+   derived forms of the one file, e.g. PCM at different sample rates, may
+   be cached. An empty variant is the raw file, memory mapped. If the file
+   modification time or size changes, the content is reloaded on the next
+   GetContent(), readers that already have the old content keep it until
+   they release it.
+
+   Derived content counts toward a maximum cache size. When exceeded, the
+   least recently requested content not in use by any reader is discarded.
+   Mapped content does not count, as it only uses address space, instead
+   the number of mapped files is limited, each using a file handle on some
+   platforms, and the least recently requested is unmapped when exceeded.
+
+   As a mapped file that is truncated in place would crash its readers,
+   only files without write permission are mapped by default. Other files
+   are read into memory, and count as derived content. See SetMapWritable().
+  */
+class PFileCache : public PObject
+{
+    PCLASSINFO(PFileCache, PObject);
+  public:
+    enum {
+      DefaultMaxSize = 256*1024*1024,
+      DefaultMaxContentSize = 16*1024*1024,
+      DefaultMaxMapped = 1000
+    };
+
+    /// Create a file cache, usually GetInstance() is used.
+    PFileCache();
+
+    /// Get the process wide instance.
+    static PFileCache & GetInstance();
+
+    /**Create derived content for a file.
+      */
+    struct Loader
+    {
+      virtual ~Loader() { }
+
+      /**Load the content.
+         The @a maxSize is the limit on the size of the content, loading
+         should fail if exceeded.
+        */
+      virtual bool Load(
+        const PFilePath & path, ///< File to load
+        PBYTEArray & data,      ///< Derived content
+        PINDEX maxSize          ///< Maximum size of content
+      ) = 0;
+    };
+
+    /**Get the content for a file.
+       If the content is not in the cache, or the file has changed, then it is
+       loaded. If @a loader is NULL, the file itself is mapped. The cache is
+       not locked while the loader executes, requests for other content
+       proceed, while concurrent requests for the same content wait for it to
+       be loaded once and all get the one result.
+
+       @return NULL pointer if the file could not be loaded.
+      */
+    PFileContentPtr GetContent(
+      const PFilePath & path,             ///< File to get content of
+      const PString & variant = PString::Empty(), ///< Variant of derived content
+      Loader * loader = NULL              ///< Loader for derived content
+    );
+
+    /// Remove all content not in use by a reader.
+    void Purge();
+
+    /// Set the maximum size of all derived content.
+    void SetMaxSize(off_t size);
+
+    /// Get the maximum size of all derived content.
+    off_t GetMaxSize() const;
+
+    /// Set the maximum size of a single derived content.
+    void SetMaxContentSize(PINDEX size);
+
+    /// Get the maximum size of a single derived content.
+    PINDEX GetMaxContentSize() const;
+
+    /// Get the current size of all derived content.
+    off_t GetTotalSize() const;
+
+    /// Set the maximum number of mapped files.
+    void SetMaxMapped(PINDEX count);
+
+    /// Get the maximum number of mapped files.
+    PINDEX GetMaxMapped() const;
+
+    /// Get the current number of mapped files.
+    PINDEX GetMappedCount() const;
+
+    /**Set flag to map files that have write permission.
+       This should only be set if the files are never truncated or rewritten
+       in place while in use, see PFileContent::Map().
+      */
+    void SetMapWritable(bool map);
+
+    /// Get flag to map files that have write permission.
+    bool GetMapWritable() const;
+
+  protected:
+    struct Entry
+    {
+      PFileContentPtr m_content;
+      PTime           m_modified;
+      PUInt64         m_fileSize;
+      PUInt64         m_lastUsed;
+    };
+    typedef std::map<PString, Entry> EntryMap;
+
+    // Content being loaded, other requests for it wait on m_loaded
+    struct Pending : PSmartObject
+    {
+      Pending() : m_waiters(0) { }
+      PSemaphore      m_loaded;
+      unsigned        m_waiters;
+      PFileContentPtr m_content;
+    };
+    typedef PSmartPtr<Pending> PendingPtr;
+    typedef std::map<PString, PendingPtr> PendingMap;
+
+    PFileContentPtr InternalLoad(const PFilePath & path, const PString & variant, Loader * loader, PINDEX maxContentSize, bool map);
+    void InternalPurge(off_t targetSize, PINDEX targetMapped);
+    void InternalRemove(const Entry & entry);
+
+    EntryMap   m_entries;
+    PendingMap m_pending;
+    off_t    m_maxSize;
+    PINDEX   m_maxContentSize;
+    off_t    m_totalSize;
+    PINDEX   m_maxMapped;
+    PINDEX   m_mappedCount;
+    bool     m_mapWritable;
+    PUInt64  m_useCounter;
+    mutable PMutex m_mutex;
+};
+
+
+#endif // PTLIB_FILECACHE_H
+
+
+// End Of File ///////////////////////////////////////////////////////////////
@@ -2170,6 +2170,51 @@ class PHTTPString : public PHTTPResource
 };
 
 
+//////////////////////////////////////////////////////////////////////////////
+// PHTTPLatencyHistograms
+
+/** This object describes a HyperText Transport Protocol resource which
+   returns the current state of all the <code>PLatencyHistogram</code>
+   instances in the registry.
+
+   By default the histograms are returned as plain text, one per line. If the
+   URL has the query parameter "format=json" then a JSON object is returned
+   instead, which includes the non-empty buckets of each histogram.
+ */
+class PHTTPLatencyHistograms : public PHTTPResource
+{
+  PCLASSINFO(PHTTPLatencyHistograms, PHTTPResource)
+
+  public:
+    /** Contruct a new latency histogram resource for the HTTP space.
+     */
+    PHTTPLatencyHistograms(
+      const PURL & url             ///< Name of the resource in URL space.
+    );
+    PHTTPLatencyHistograms(
+      const PURL & url,            ///< Name of the resource in URL space.
+      const PHTTPAuthority & auth  ///< Authorisation for the resource.
+    );
+
+  // Overrides from class PHTTPResource
+    /** Get the headers for the histograms, selecting the content type from
+       the "format" query parameter.
+     */
+    virtual PBoolean LoadHeaders(
+      PHTTPRequest & request    ///< Information on this request.
+    );
+
+    /** Get the snapshot of the histograms as text or JSON.
+     */
+    virtual PString LoadText(
+      PHTTPRequest & request    ///< Information on this request.
+    );
+
+  protected:
+    static bool IsJSON(const PHTTPRequest & request);
+};
+
+
 //////////////////////////////////////////////////////////////////////////////
 // PHTTPFile
 
@@ -170,6 +170,7 @@ class PJSON : public PObject
     {
       public:
         String(const char * str = NULL) : PString(str) { }
+        String(const char * str, PINDEX len) : PString(str, len) { }
         virtual bool IsType(Types type) const;
         virtual void ReadFrom(istream & strm);
         virtual void PrintOn(ostream & strm) const;
@@ -217,6 +218,101 @@ class PJSON : public PObject
         virtual Base * DeepClone() const;
     };
 
+    /**Handler for events generated by Parse().
+       This allows processing of a document without building the Object,
+       Array etc, tree in memory. Names and string values point directly
+       into the input buffer, unless they contain escape sequences, and are
+       only valid for the duration of the call.
+
+       Returning false from any function aborts the parse.
+      */
+    class Handler
+    {
+      public:
+        virtual ~Handler() { }
+        virtual bool OnStartObject() { return true; }
+        virtual bool OnEndObject() { return true; }
+        virtual bool OnStartArray() { return true; }
+        virtual bool OnEndArray() { return true; }
+        virtual bool OnName(const char * /*name*/, size_t /*length*/) { return true; }
+        virtual bool OnString(const char * /*value*/, size_t /*length*/) { return true; }
+        virtual bool OnNumber(NumberType /*value*/) { return true; }
+        virtual bool OnBoolean(bool /*value*/) { return true; }
+        virtual bool OnNull() { return true; }
+    };
+
+    /**Parse a JSON document in memory, calling the handler for each element.
+       @return false if there was a syntax error, or the handler aborted.
+      */
+    static bool Parse(
+      const char * json,    ///< JSON text
+      size_t length,        ///< Length of JSON text
+      Handler & handler,    ///< Handler for parse events
+      size_t * errorPosition = NULL ///< Offset of syntax error in json
+    );
+
+    /**Write compact JSON text to a memory buffer.
+       The buffer may be reused for many documents via Reset(), avoiding
+       memory allocations. Separators are added automatically.
+
+       As this is also a Handler, it may be passed to Parse() to minify
+       the JSON text.
+      */
+    class Writer : public Handler
+    {
+      public:
+        Writer();
+
+        /// Empty the buffer, keeping the memory for reuse.
+        void Reset();
+
+        Writer & StartObject();
+        Writer & EndObject();
+        Writer & StartArray();
+        Writer & EndArray();
+        Writer & Name(const char * name, size_t length);
+        Writer & Name(const PString & name) { return Name(name, name.GetLength()); }
+        Writer & AppendString(const char * value, size_t length);
+        Writer & AppendString(const PString & value) { return AppendString(value, value.GetLength()); }
+        Writer & AppendNumber(NumberType value);
+        Writer & AppendBoolean(bool value);
+        Writer & AppendNull();
+        Writer & Append(const Base & value);
+        Writer & Append(const PJSON & json) { return Append(json.GetAs<Base>()); }
+
+        /// Get the JSON text written, not '\0' terminated.
+        const char * GetPointer() const { return m_buffer.empty() ? "" : &m_buffer[0]; }
+
+        /// Get the length of the JSON text written.
+        size_t GetLength() const { return m_length; }
+
+        /// Get the JSON text written as a string.
+        PString AsString() const { return PString(GetPointer(), m_length); }
+
+        // Overrides from Handler
+        virtual bool OnStartObject() { StartObject(); return true; }
+        virtual bool OnEndObject() { EndObject(); return true; }
+        virtual bool OnStartArray() { StartArray(); return true; }
+        virtual bool OnEndArray() { EndArray(); return true; }
+        virtual bool OnName(const char * name, size_t length) { Name(name, length); return true; }
+        virtual bool OnString(const char * value, size_t length) { AppendString(value, length); return true; }
+        virtual bool OnNumber(NumberType value) { AppendNumber(value); return true; }
+        virtual bool OnBoolean(bool value) { AppendBoolean(value); return true; }
+        virtual bool OnNull() { AppendNull(); return true; }
+
+      protected:
+        void Separator();
+        char * Reserve(size_t length);
+        void Put(char c) { *Reserve(1) = c; ++m_length; }
+        void Put(const char * str, size_t length) { memcpy(Reserve(length), str, length); m_length += length; }
+        void PutString(const char * str, size_t length);
+
+        std::vector<char> m_buffer;
+        size_t            m_length;
+        std::vector<bool> m_needComma;
+        bool              m_afterName;
+    };
+
     ///< Constructor
     PJSON();
     explicit PJSON(Types type);
@@ -233,6 +329,14 @@ class PJSON : public PObject
       const PString & str
     );
 
+    /**Parse JSON text in memory.
+       This is considerably faster than reading from a stream.
+      */
+    bool FromBuffer(
+      const char * json,    ///< JSON text
+      size_t length         ///< Length of JSON text
+    );
+
     PString AsString(
       std::streamsize initialIndent = 0,
       std::streamsize subsequentIndent = 0) const;
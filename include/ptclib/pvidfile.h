@@ -40,6 +40,7 @@
 #if P_VIDFILE
 
 #include <ptlib/videoio.h>
+#include <ptclib/filecache.h>
 
 
 /**Abstract class for a file containing a sequence of video frames.
@@ -87,6 +88,14 @@ class PVideoFile : public PFile
     unsigned GetFrameRate() const { return m_videoInfo.GetFrameRate(); }
     PString GetColourFormat() const { return m_videoInfo.GetColourFormat(); }
 
+    /**Read frames from a memory mapping of the file via the process wide
+       PFileCache, so concurrent readers of the file share the same pages.
+       The next frame is read ahead asynchronously. Files with write
+       permission are not mapped, see PFileCache::SetMapWritable().
+      */
+    bool SetCached(bool cached = true);
+    bool IsCached() const { return m_cached; }
+
   protected:
     bool   m_fixedFrameSize;
     bool   m_fixedFrameRate;
@@ -94,6 +103,8 @@ class PVideoFile : public PFile
     off_t  m_headerOffset;
     off_t  m_frameHeaderLen;
     PVideoFrameInfo m_videoInfo;
+    bool            m_cached;
+    PFileContentPtr m_content;
 };
 
 typedef PFactory<PVideoFile, PFilePathString> PVideoFileFactory;
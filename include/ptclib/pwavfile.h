@@ -40,6 +40,7 @@
 #ifdef P_WAVFILE
 
 #include <ptlib/pfactory.h>
+#include <ptclib/filecache.h>
 
 class PWAVFile;
 
@@ -408,6 +409,25 @@ public:
      Note, this only applies to ReadOnly files.
    */
   bool SetAutoconvert(bool convert = true);
+
+  /**Enable reading via the process wide PFileCache.
+     When many readers play the same file, they then share one copy of the
+     audio. If no conversion is required the file is memory mapped, and
+     the operating system is advised ahead of the read position so pages
+     are loaded asynchronously, though files with write permission are
+     read into memory instead, see PFileCache::SetMapWritable(). Otherwise,
+     the converted audio, according to SetAutoconvert(), SetSampleRate()
+     and SetChannels(), is decoded once and held in the cache, subject to
+     its size limits. If the audio cannot be cached, reading proceeds as
+     usual from the file.
+
+     Note, this only applies to ReadOnly files, and should be called before
+     the first Read(). The position is reset to the start of the audio.
+   */
+  bool SetCached(bool cached = true);
+
+  /// Indicate reading is via the process wide PFileCache.
+  bool IsCached() const { return m_cached; }
   //@}
 
   // Internal stuff
@@ -429,6 +449,11 @@ protected:
   void Construct(OpenMode mode);
   bool SelectFormat(PWAVFileFormat * handler);
 
+  bool InternalUseContent();
+  bool InternalReadContent(void * buf, PINDEX len);
+  void InternalGetContentUnits(unsigned & bytesPerSecond, unsigned & blockSize) const;
+  void InternalDropContent(unsigned oldBytesPerSecond);
+
   bool ProcessHeader();
   bool GenerateHeader();
   bool UpdateHeader();
@@ -455,6 +480,14 @@ protected:
   PShortArray  m_readBuffer;
   PINDEX       m_readBufCount;
   PINDEX       m_readBufPos;
+
+  // Reading via PFileCache
+  bool            m_cached;
+  PFileContentPtr m_content;
+  off_t           m_contentOffset;
+  off_t           m_contentLength;
+  off_t           m_contentPosition;
+  off_t           m_readAheadPosition;
 };
 
 #endif // P_WAVFILE
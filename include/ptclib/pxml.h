@@ -37,10 +37,17 @@
 
 #include <ptlib/bitwise_enum.h>
 #include <ptclib/http.h>
+#include <map>
+#include <vector>
+#include <list>
 
 
+class PXML;
+class PXMLObject;
+class PXMLData;
 class PXMLElement;
 class PXMLRootElement;
+class PXMLValidator;
 
 
 ////////////////////////////////////////////////////////////
@@ -98,6 +105,57 @@ class PXMLBase : public PObject
 };
 
 
+/**Memory arena for the objects of a PXML document.
+   Elements and data are constructed in large blocks, rather than being
+   individually allocated, and are all destroyed, and the memory released,
+   in one operation by Clear(). Objects allocated on the heap, and added
+   to an element in the arena, are adopted and deleted at the same time.
+
+   Objects in an arena must not outlive it, so cannot be removed from the
+   tree and kept, e.g. via PXMLElement::RemoveSubObject() without disposal.
+  */
+class PXMLArena : public PObject
+{
+    PCLASSINFO(PXMLArena, PObject);
+  public:
+    enum { DefaultBlockSize = 65536 };
+
+    PXMLArena(size_t blockSize = DefaultBlockSize);
+    ~PXMLArena();
+
+    PXMLElement * CreateElement(const PCaselessString & name);
+    PXMLRootElement * CreateRootElement(PXML & doc, const PCaselessString & name);
+    PXMLData * CreateData(const PString & data);
+
+    /// Take ownership of an object allocated on the heap.
+    void Adopt(PXMLObject * obj);
+
+    /// Give up ownership of an adopted object, returns false if not adopted.
+    bool Release(PXMLObject * obj);
+
+    /// Destroy all objects and release all memory.
+    void Clear();
+
+    /// Get the total memory in use by the arena.
+    size_t GetMemoryUsed() const { return m_memoryUsed; }
+
+  protected:
+    void * Allocate(size_t size);
+    void Created(PXMLObject * obj);
+
+    std::vector<BYTE *>       m_blocks;
+    size_t                    m_blockSize;
+    size_t                    m_blockUsed;
+    size_t                    m_memoryUsed;
+    std::vector<PXMLObject *> m_objects;
+    std::vector<PXMLObject *> m_adopted;
+
+  private:
+    PXMLArena(const PXMLArena &) { }
+    void operator=(const PXMLArena &) { }
+};
+
+
 class PXML : public PXMLBase
 {
     PCLASSINFO(PXML, PXMLBase);
@@ -204,10 +262,41 @@ class PXML : public PXMLBase
     bool ValidateElement(ValidationContext & context, PXMLElement * element, const ValidationInfo * elements);
     bool LoadAndValidate(const PString & body, const PXML::ValidationInfo * validator, PString & error, Options options = NoOptions);
 
+    /**Validate the loaded document with a compiled validator.
+       This is a single pass over the elements of the document.
+      */
+    bool Validate(const PXMLValidator & validator);
+
+    /**Load and validate with a compiled validator.
+       The validation is done while parsing, so an invalid document is
+       rejected at the first error, without building the rest of the tree.
+      */
+    bool LoadAndValidate(const PString & body, const PXMLValidator & validator, PString & error, Options options = NoOptions);
+
+    /**Set compiled validator used while loading.
+       If not NULL, Load(), LoadFile() and ReadFrom() check each element as
+       it is parsed, and fail at the first element that is invalid. The
+       validator must not be destroyed while in use by the document.
+      */
+    void SetValidator(const PXMLValidator * validator) { m_validator = validator; }
+
+    /// Get compiled validator used while loading.
+    const PXMLValidator * GetValidator() const { return m_validator; }
+
     const PCaselessString & GetVersion()    const  { return m_version; }
     const PCaselessString & GetEncoding()   const { return m_encoding; }
     StandAloneType          GetStandAlone() const { return m_standAlone; }
 
+    /**Set the document to allocate its elements from a PXMLArena.
+       This is faster for loading large documents, and destroying them, but
+       elements cannot be removed from the document and kept after it is
+       destroyed. Changing the mode removes all elements.
+      */
+    void SetArenaMode(bool enable);
+
+    /// Indicate the document allocates its elements from a PXMLArena.
+    bool IsArenaMode() const { return m_arena != NULL; }
+
     bool IsLoaded() const { return m_rootElement != NULL; }
     PXMLRootElement * GetRootElement() const { return m_rootElement; }
 
@@ -233,6 +322,9 @@ class PXML : public PXMLBase
     PCaselessString   m_dtdURI;
 
     PXMLRootElement * m_rootElement;
+    PXMLArena       * m_arena;
+
+    const PXMLValidator * m_validator;
 
     PStringStream m_errorString;
     unsigned      m_errorLine;
@@ -250,6 +342,111 @@ class PXML : public PXMLBase
 };
 
 
+/**Compiled form of a PXML::ValidationInfo table.
+   The table is compiled once, resolving the namespaces, indexing the
+   permitted sub-elements of each element by name, and compiling the regular
+   expressions, so a document may then be validated in a single pass over its
+   elements, either after loading or while it is being parsed. Validating
+   does not change the compiled form, so one instance may be shared by any
+   number of threads.
+
+   Unlike PXML::Validate(const ValidationInfo *), for a Subtree the
+   m_minCount is the actual minimum number of sub-elements, rather than
+   only requiring at least one when non-zero, and m_maxCount is the actual
+   maximum. Also all of the ...BodyMatching operations check the body of
+   the sub-element, and the ...Ex variants use extended regular expressions.
+  */
+class PXMLValidator : public PObject
+{
+    PCLASSINFO(PXMLValidator, PObject);
+  public:
+    /// Create validator, compiling @a validator if not NULL.
+    PXMLValidator(
+      const PXML::ValidationInfo * validator = NULL ///< Table to compile
+    );
+
+    /// Destroy validator.
+    ~PXMLValidator();
+
+    /**Compile a validation table.
+       @return false if a regular expression in the table is invalid.
+      */
+    bool Compile(
+      const PXML::ValidationInfo * validator  ///< Table to compile
+    );
+
+    /// Indicate a table has been compiled.
+    bool IsCompiled() const { return m_root != NULL; }
+
+    struct Rule;
+
+    /**State of the validation of one document.
+       Elements are passed in document order as they are started and ended,
+       so this may be used while parsing or when walking a loaded document.
+      */
+    class State
+    {
+      public:
+        /// Start validating a document.
+        State(
+          const PXMLValidator & validator ///< Compiled validator
+        );
+
+        /**Check the name and attributes of an element.
+           @return false if the element is invalid.
+          */
+        bool StartElement(
+          const PXMLElement & element     ///< Element with all attributes
+        );
+
+        /**Check the body and sub-element counts of an element.
+           @return false if the element is invalid.
+          */
+        bool EndElement(
+          const PXMLElement & element     ///< Element with all content
+        );
+
+        /// Get the error when StartElement() or EndElement() failed.
+        const PString & GetErrorString() const { return m_errorString; }
+        unsigned GetErrorColumn() const { return m_errorColumn; }
+        unsigned GetErrorLine() const { return m_errorLine; }
+
+      protected:
+        bool SetError(const PXMLElement & element);
+
+        struct Level {
+          const Rule *    m_rule;
+          const void *    m_entry;     // Entry in parent rule index, if any
+          size_t          m_counts;    // Offset of sub-element counts in m_counts
+          PCaselessString m_lastName;  // Last sub-element name looked up, compared by buffer as names are interned
+          const void *    m_lastEntry;
+        };
+
+        const PXMLValidator & m_validator;
+        std::vector<Level>    m_stack;
+        std::vector<PINDEX>   m_counts;
+        PStringStream         m_errorString;
+        unsigned              m_errorColumn;
+        unsigned              m_errorLine;
+    };
+
+  protected:
+    struct Context;
+    bool CompileRule(const PXML::ValidationInfo * validator, Rule & rule, Context & context);
+    Rule * GetRule(const PXML::ValidationInfo * validator, Context & context);
+    PRegularExpression * CompileRegEx(const char * pattern, bool extended);
+    void RemoveAll();
+
+    Rule * m_root;
+    std::vector<Rule *> m_rules;
+    std::vector<PRegularExpression *> m_regexes;
+
+  private:
+    PXMLValidator(const PXMLValidator & other) : PObject(other) { }
+    void operator=(const PXMLValidator &) { }
+};
+
+
 #if P_HTTP
 class PXML_HTTP : public PXML
 {
@@ -340,6 +537,9 @@ class PXMLObject : public PObject
 
     virtual PXMLObject * Clone() const = 0;
 
+    /// Get the arena that owns this object, NULL if on the heap and owned by its parent.
+    PXMLArena * GetArena() const { return m_arena; }
+
 #if PTRACING
     struct PrintTraceClass
     {
@@ -356,11 +556,14 @@ class PXMLObject : public PObject
     bool          m_dirty;
     unsigned      m_lineNumber;
     unsigned      m_column;
+    PXMLArena   * m_arena;
 #if PTRACING
     virtual void InternalPrintTrace(ostream & strm) const = 0;
 #endif
 
   P_REMOVE_VIRTUAL(PXMLObject *, Clone(PXMLElement *) const, 0);
+
+  friend class PXMLArena;
 };
 
 PARRAY(PXMLObjectArray, PXMLObject);
@@ -402,6 +605,14 @@ class PXMLElement : public PXMLObject
     PXMLElement(const PXMLElement & copy);
   public:
     PXMLElement(const char * name = NULL, const char * data = NULL);
+    /// Create element sharing the string buffer of @a name, e.g. an interned name.
+    PXMLElement(const PString & name, const char * data = NULL);
+    ~PXMLElement();
+
+    /**Number of sub-objects before GetElement() by name builds an index of
+       the child elements, rather than searching them in turn.
+      */
+    enum { NameIndexThreshold = 16 };
 
     virtual PINDEX GetObjectCount() const;
 
@@ -413,8 +624,7 @@ class PXMLElement : public PXMLObject
     const PCaselessString & GetName() const
       { return m_name; }
 
-    void SetName(const PString & v)
-      { m_name = v; }
+    void SetName(const PString & v);
 
     /**
         Get the completely qualified name for the element inside the
@@ -484,9 +694,20 @@ class PXMLElement : public PXMLObject
 
     PArray<PXMLObject> m_subObjects;
 
+    // Arena owning the sub-objects, NULL if m_subObjects owns them
+    PXMLArena * m_childArena;
+    void UseArena(PXMLArena * arena);
+
+    typedef std::map<PCaselessString, std::vector<PXMLElement *> > NameIndex;
+    mutable NameIndex * m_nameIndex;
+    const NameIndex & GetNameIndex() const;
+    void InvalidateNameIndex();
+
 #if PTRACING
     virtual void InternalPrintTrace(ostream & strm) const;
 #endif
+
+  friend class PXMLArena;
 };
 
 
@@ -501,6 +722,11 @@ class PXMLRootElement : public PXMLElement
       , m_document(doc)
     { }
 
+    PXMLRootElement(PXML & doc, const PString & name)
+      : PXMLElement(name)
+      , m_document(doc)
+    { }
+
     PXMLRootElement(PXML & doc, const PXMLElement & copy)
       : PXMLElement(copy)
       , m_document(doc)
@@ -552,6 +778,8 @@ class PXMLParserBase
     bool IsParsing() const { return m_parsing; }
 
   protected:
+    void StopParser();
+
     void *   m_context;
     bool     m_parsing;
     off_t    m_total;
@@ -573,6 +801,7 @@ class PXMLParser : public PXMLBase, public PXMLParserBase
       Options options,
       off_t progressTotal
     );
+    ~PXMLParser();
 
     virtual void StartDocTypeDecl(const char * docType, const char * sysid, const char * pubid, int hasInternalSubSet);
     virtual void XmlDecl(const char * version, const char * encoding, int standAlone);
@@ -585,12 +814,26 @@ class PXMLParser : public PXMLBase, public PXMLParserBase
 
     PXML & GetDocument() const { return m_document; }
 
+    void GetErrorInfo(PString & errorString, unsigned & errorCol, unsigned & errorLine) const;
+
   protected:
+    const PString & InternName(const char * name);
+    void ValidationFailed();
+
     PXML & m_document;
+    PXMLValidator::State * m_validation;
+    bool                   m_validationFailed;
 
     PXMLElement   * m_currentElement;
     PXMLData      * m_lastData;
     PStringToString m_nameSpaces;
+
+    // Element and attribute names are shared by all elements using them
+    struct InternCompare {
+      bool operator()(const char * a, const char * b) const { return strcmp(a, b) < 0; }
+    };
+    typedef std::map<const char *, PString, InternCompare> InternedNames;
+    InternedNames m_internedNames;
 };
 
 
@@ -610,6 +853,137 @@ class PXMLStreamParser : public PXMLParser
 };
 
 
+////////////////////////////////////////////////////////////
+
+/**Pull parser for XML.
+   This parses XML without building the document tree, instead returning
+   a sequence of events via Next(), for the start and end of elements and
+   for character data. Data is supplied incrementally via Feed(), e.g. as
+   it is received from a socket, or read by Next() from a stream.
+
+   Memory is bounded: the parser is suspended when MaxQueuedEvents have
+   accumulated, and resumed by Next() when they have been consumed.
+
+   Elements matching a filter added by AddSubtreeFilter() are returned
+   as a single SubtreeEvent containing a complete PXMLElement tree,
+   rather than events for each of the parts.
+  */
+class PXMLPullParser : public PXMLBase, public PXMLParserBase
+{
+    PCLASSINFO(PXMLPullParser, PXMLBase);
+  public:
+    enum { MaxQueuedEvents = 256 };
+
+    PXMLPullParser(
+      Options options = NoOptions,
+      const char * encoding = NULL
+    );
+    ~PXMLPullParser();
+
+    enum EventType {
+      StartElementEvent,
+      EndElementEvent,
+      TextEvent,
+      SubtreeEvent
+    };
+
+    struct Event
+    {
+      Event() : m_type(TextEvent), m_depth(0), m_element(NULL), m_column(0), m_line(0) { }
+
+      EventType       m_type;
+      PCaselessString m_name;       ///< Element name for start, end and subtree
+      PStringToString m_attributes; ///< Attributes for start element
+      PString         m_text;       ///< Character data for text
+      unsigned        m_depth;      ///< Depth of element, root is 1
+      PXMLElement   * m_element;    ///< Subtree, ownership passes to the caller
+      unsigned        m_column;     ///< Position in source
+      unsigned        m_line;       ///< Position in source
+    };
+
+    /**Add a path of elements to be returned as a SubtreeEvent.
+       The path is element names separated by '/', and a name may be "*"
+       to match any element. If the path starts with '/' it must match from
+       the root element, otherwise it matches the innermost elements, e.g.
+       "record" matches any element named record, while "/export/record"
+       only matches those that are children of the root element.
+      */
+    void AddSubtreeFilter(
+      const PString & path
+    );
+
+    /**Supply more XML to the parser.
+       This should only be called when Next() returns false, indicating more
+       data is needed.
+       @return false if there was a syntax error.
+      */
+    bool Feed(
+      const char * data,  ///< XML text
+      size_t length,      ///< Length of XML text
+      bool final = false  ///< This is the last of the document
+    );
+
+    /**Get the next event.
+       @return false if more data must be supplied via Feed(), or if the end
+       of the document has been reached.
+      */
+    bool Next(
+      Event & event   ///< Event returned
+    );
+
+    /**Get the next event, reading the stream as required.
+       @return false if end of document, the stream is ended, or a syntax error.
+      */
+    bool Next(
+      istream & strm, ///< Stream to read XML from
+      Event & event   ///< Event returned
+    );
+
+    /**Get the next event, reading the channel as required.
+       @return false if end of document, the channel is closed, or a syntax error.
+      */
+    bool Next(
+      PChannel & channel, ///< Channel to read XML from
+      Event & event       ///< Event returned
+    );
+
+    /// Indicate the end of the root element has been parsed.
+    bool IsEndOfDocument() const { return m_endOfDocument; }
+
+    /// Indicate there was an error, see GetErrorInfo()
+    bool HasError() const { return m_error; }
+
+    /// Get the path of element names to the current position.
+    PString GetPath() const;
+
+    // Overrides from PXMLParserBase
+    virtual void StartElement(const char * name, const char **attrs);
+    virtual void EndElement(const char * name);
+    virtual void AddCharacterData(const char * data, int len);
+
+  protected:
+    bool MatchFilter() const;
+    void FlushText();
+    void QueueEvent(const Event & event);
+
+    struct Filter {
+      bool                 m_absolute;
+      std::vector<PString> m_names;
+    };
+    std::vector<Filter>  m_filters;
+    std::vector<PString> m_path;
+    std::list<Event>     m_events;
+    PString              m_text;
+    PXMLElement        * m_subtree;
+    PXMLElement        * m_subtreeCurrent;
+    size_t               m_subtreeDepth;
+    bool                 m_suspended;
+    bool                 m_endOfDocument;
+    bool                 m_error;
+    std::vector<char>    m_readBuffer;
+};
+
+
 #else
 
 namespace PXML {
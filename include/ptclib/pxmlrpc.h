@@ -94,6 +94,7 @@ class PXMLRPC : public PObject
 
   protected:
     PBoolean PerformRequest(PXMLRPCBlock & request, PXMLRPCBlock & response);
+    PBoolean PostXML(const PString & requestXML, PString & replyXML);
 
     PURL          m_url;
     PINDEX        m_faultCode;
@@ -284,6 +285,179 @@ class PXMLRPCStructBase : public PObject {
 };
 
 
+/**Direct writer of XML-RPC messages.
+   This produces the same XML-RPC as PXMLRPCBlock does for the variables of
+   a PXMLRPCStructBase, but written straight into a buffer rather than
+   building, and then outputting, a PXMLElement for every value.
+  */
+class PXMLRPCWriter
+{
+  public:
+    /// Create a writer, with initial buffer size.
+    PXMLRPCWriter(
+      PINDEX initialSize = 1024   ///< Initial size of buffer
+    );
+
+    /// Write a complete methodCall.
+    void MethodCall(
+      const PString & method,           ///< Name of method
+      const PXMLRPCStructBase & args    ///< Variables for each parameter
+    );
+
+    /// Write a complete methodResponse.
+    void MethodResponse(
+      const PXMLRPCStructBase & reply   ///< Variables for each parameter
+    );
+
+    /// Write a complete methodResponse containing a fault.
+    void Fault(
+      PINDEX code,                      ///< Fault code
+      const PString & text              ///< Fault string
+    );
+
+    /// Write a params element, with a param for each variable.
+    void Params(const PXMLRPCStructBase & data);
+
+    /// Write a value element for a variable.
+    void Variable(const PXMLRPCVariableBase & variable);
+
+    /// Write a value element containing a struct.
+    void Struct(const PXMLRPCStructBase & data);
+
+    /// Write a value element containing an array.
+    void Array(const PXMLRPCVariableBase & array);
+
+    /// Write a value element containing a scalar.
+    void Scalar(const char * type, const PString & value);
+
+    /// Append text to the buffer, as is.
+    void Append(const char * str, PINDEX len);
+    void Append(const char * str) { Append(str, strlen(str)); }
+
+    /// Append text to the buffer, escaping XML special characters.
+    void AppendEscaped(const char * str, PINDEX len);
+    void AppendEscaped(const PString & str) { AppendEscaped(str, str.GetLength()); }
+
+    /// Get the XML written so far.
+    PString GetString() const { return PString((const char *)m_buffer, m_length); }
+    const char * GetPointer() const { return m_buffer; }
+    PINDEX GetLength() const { return m_length; }
+
+    /// Discard the XML written so far, retaining the buffer.
+    void Clear() { m_length = 0; }
+
+  protected:
+    char * Reserve(PINDEX len);
+
+    PCharArray m_buffer;
+    PINDEX     m_length;
+};
+
+
+/**Streaming decoder of XML-RPC messages.
+   This fills the variables of a PXMLRPCStructBase directly from the parser
+   events, without building a PXML document. The data may be supplied all at
+   once with Decode(), or incrementally, e.g. as it arrives from a socket,
+   with Parse().
+
+   Values are matched to variables the same way as PXMLRPCBlock::GetParams(),
+   including a single struct parameter for all the variables, when it is the
+   only parameter. As that is not known until the end of the parameters, a
+   first parameter that could be either is held and decoded then. Members
+   that have no variable are skipped. A value without a type element is taken as
+   a string, as per the XML-RPC specification.
+  */
+class PXMLRPCDecoder : public PXMLBase, public PXMLParserBase
+{
+    PCLASSINFO(PXMLRPCDecoder, PXMLBase);
+  public:
+    /// Create decoder into variables of @a data
+    PXMLRPCDecoder(
+      PXMLRPCStructBase & data,         ///< Variables for each parameter
+      Options options = NoOptions       ///< Parser options
+    );
+
+    /// Destroy decoder
+    ~PXMLRPCDecoder();
+
+    /**Decode a complete methodCall or methodResponse.
+       @return false if the XML is not valid XML-RPC, the values do not match
+               the variables, or the response is a fault.
+      */
+    bool Decode(
+      const PString & xml               ///< XML-RPC to decode
+    );
+
+    /// Indicate the document is a methodCall
+    bool IsMethodCall() const { return m_isMethodCall; }
+
+    /// Get the method name from a methodCall
+    const PString & GetMethodName() const { return m_methodName; }
+
+    /// Get the fault code, P_MAX_INDEX if no fault
+    PINDEX GetFaultCode() const { return m_faultCode; }
+
+    /// Get the fault text
+    const PString & GetFaultText() const { return m_faultText; }
+
+    virtual void StartElement(const char * name, const char **attrs);
+    virtual void EndElement(const char * name);
+    virtual void AddCharacterData(const char * data, int len);
+
+  protected:
+    void Fail(PINDEX code, const PString & text);
+    bool MayBeSingleStruct() const;
+    void DecodeFirstParam();
+
+    enum Kinds {
+      e_Ignore,
+      e_Document,
+      e_MethodName,
+      e_Params,
+      e_Param,
+      e_Fault,
+      e_Value,
+      e_Scalar,
+      e_Struct,
+      e_Member,
+      e_MemberName,
+      e_Array,
+      e_Data
+    };
+
+    struct Frame {
+      Kinds                 m_kind;
+      PXMLRPCStructBase   * m_struct;    // Struct members are looked up in
+      PXMLRPCVariableBase * m_variable;  // Variable receiving value
+      PINDEX                m_index;     // Array element, or count of children
+      bool                  m_isElement; // Value is array element
+      bool                  m_hasChild;  // Value had a type element
+    };
+
+    // Parser event for the held first parameter
+    struct Event {
+      enum { e_Start, e_End, e_Data } m_type;
+      std::string m_text;
+    };
+
+    PXMLRPCStructBase & m_data;
+    std::vector<Frame>  m_stack;
+    std::vector<Event>  m_firstParam;
+    unsigned            m_holdDepth;
+    bool                m_decodingFirst;
+    bool                m_singleStruct;
+    std::string         m_text;
+    PCaselessString     m_type;
+    bool                m_isMethodCall;
+    bool                m_wholeStruct;
+    PINDEX              m_paramCount;
+    PString             m_methodName;
+    PXMLRPCStructBase * m_faultInfo;
+    PINDEX              m_faultCode;
+    PString             m_faultText;
+};
+
+
 #define PXMLRPC_STRUCT_BEGIN(name) \
   class name : public PXMLRPCStructBase { \
     public: name() { EndConstructor(); } \
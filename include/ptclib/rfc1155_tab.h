@@ -0,0 +1,154 @@
+//
+// rfc1155_tab.h
+//
+// Code automatically generated by asnparse.
+//
+
+#ifdef P_SNMP
+
+#ifndef PTLIB_RFC1155_TAB_H
+#define PTLIB_RFC1155_TAB_H
+
+#include <ptclib/asntable.h>
+
+
+struct PRFC1155_SimpleSyntax_Value;
+struct PRFC1155_NetworkAddress_Value;
+struct PRFC1155_ApplicationSyntax_Value;
+struct PRFC1155_ObjectSyntax_Value;
+
+
+//
+// ObjectName
+//
+
+typedef PASN_TableObjectId PRFC1155_ObjectName_Value;
+extern const PASN_TypeDescriptor PRFC1155_ObjectName_Descriptor;
+
+
+//
+// SimpleSyntax
+//
+
+struct PRFC1155_SimpleSyntax_Value
+{
+  enum Choices {
+    e_number,
+    e_string,
+    e_object,
+    e_empty
+  };
+
+  unsigned m_choice;
+  PInt64 m_number;
+  PASN_TableOctets m_string;
+  PASN_TableObjectId m_object;
+  PASN_TableNull m_empty;
+};
+extern const PASN_TypeDescriptor PRFC1155_SimpleSyntax_Descriptor;
+
+
+//
+// IpAddress
+//
+
+typedef PASN_TableOctets PRFC1155_IpAddress_Value;
+extern const PASN_TypeDescriptor PRFC1155_IpAddress_Descriptor;
+
+
+//
+// Counter
+//
+
+typedef PInt64 PRFC1155_Counter_Value;
+extern const PASN_TypeDescriptor PRFC1155_Counter_Descriptor;
+
+
+//
+// Gauge
+//
+
+typedef PInt64 PRFC1155_Gauge_Value;
+extern const PASN_TypeDescriptor PRFC1155_Gauge_Descriptor;
+
+
+//
+// TimeTicks
+//
+
+typedef PInt64 PRFC1155_TimeTicks_Value;
+extern const PASN_TypeDescriptor PRFC1155_TimeTicks_Descriptor;
+
+
+//
+// Opaque
+//
+
+typedef PASN_TableOctets PRFC1155_Opaque_Value;
+extern const PASN_TypeDescriptor PRFC1155_Opaque_Descriptor;
+
+
+//
+// NetworkAddress
+//
+
+struct PRFC1155_NetworkAddress_Value
+{
+  enum Choices {
+    e_internet
+  };
+
+  unsigned m_choice;
+  PRFC1155_IpAddress_Value m_internet;
+};
+extern const PASN_TypeDescriptor PRFC1155_NetworkAddress_Descriptor;
+
+
+//
+// ApplicationSyntax
+//
+
+struct PRFC1155_ApplicationSyntax_Value
+{
+  enum Choices {
+    e_address,
+    e_counter,
+    e_gauge,
+    e_ticks,
+    e_arbitrary
+  };
+
+  unsigned m_choice;
+  PRFC1155_NetworkAddress_Value m_address;
+  PRFC1155_Counter_Value m_counter;
+  PRFC1155_Gauge_Value m_gauge;
+  PRFC1155_TimeTicks_Value m_ticks;
+  PRFC1155_Opaque_Value m_arbitrary;
+};
+extern const PASN_TypeDescriptor PRFC1155_ApplicationSyntax_Descriptor;
+
+
+//
+// ObjectSyntax
+//
+
+struct PRFC1155_ObjectSyntax_Value
+{
+  enum Choices {
+    e_simple,
+    e_application_wide
+  };
+
+  unsigned m_choice;
+  PRFC1155_SimpleSyntax_Value m_simple;
+  PRFC1155_ApplicationSyntax_Value m_application_wide;
+};
+extern const PASN_TypeDescriptor PRFC1155_ObjectSyntax_Descriptor;
+
+
+#endif // PTLIB_RFC1155_TAB_H
+
+#endif // P_SNMP
+
+
+// End of rfc1155_tab.h
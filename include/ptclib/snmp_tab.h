@@ -0,0 +1,147 @@
+//
+// snmp_tab.h
+//
+// Code automatically generated by asnparse.
+//
+
+#ifdef P_SNMP
+
+#ifndef PTLIB_SNMP_TAB_H
+#define PTLIB_SNMP_TAB_H
+
+#include <ptclib/asntable.h>
+#include <ptclib/rfc1155_tab.h>
+
+
+struct PSNMP_Message_Value;
+struct PSNMP_VarBind_Value;
+struct PSNMP_PDU_Value;
+struct PSNMP_Trap_PDU_Value;
+struct PSNMP_PDUs_Value;
+
+
+//
+// Message
+//
+
+struct PSNMP_Message_Value
+{
+  PInt64 m_version;
+  PASN_TableOctets m_community;
+  PASN_TableOctets m_data;
+};
+extern const PASN_TypeDescriptor PSNMP_Message_Descriptor;
+
+
+//
+// VarBind
+//
+
+struct PSNMP_VarBind_Value
+{
+  PRFC1155_ObjectName_Value m_name;
+  PRFC1155_ObjectSyntax_Value m_value;
+};
+extern const PASN_TypeDescriptor PSNMP_VarBind_Descriptor;
+
+
+//
+// VarBindList
+//
+
+typedef PASN_TableArrayOf<PSNMP_VarBind_Value> PSNMP_VarBindList_Value;
+extern const PASN_TypeDescriptor PSNMP_VarBindList_Descriptor;
+
+
+//
+// PDU
+//
+
+struct PSNMP_PDU_Value
+{
+  PInt64 m_request_id;
+  PInt64 m_error_status;
+  PInt64 m_error_index;
+  PSNMP_VarBindList_Value m_variable_bindings;
+};
+extern const PASN_TypeDescriptor PSNMP_PDU_Descriptor;
+
+
+//
+// Trap-PDU
+//
+
+struct PSNMP_Trap_PDU_Value
+{
+  PASN_TableObjectId m_enterprise;
+  PRFC1155_NetworkAddress_Value m_agent_addr;
+  PInt64 m_generic_trap;
+  PInt64 m_specific_trap;
+  PRFC1155_TimeTicks_Value m_time_stamp;
+  PSNMP_VarBindList_Value m_variable_bindings;
+};
+extern const PASN_TypeDescriptor PSNMP_Trap_PDU_Descriptor;
+
+
+//
+// GetRequest-PDU
+//
+
+typedef PSNMP_PDU_Value PSNMP_GetRequest_PDU_Value;
+extern const PASN_TypeDescriptor PSNMP_GetRequest_PDU_Descriptor;
+
+
+//
+// GetNextRequest-PDU
+//
+
+typedef PSNMP_PDU_Value PSNMP_GetNextRequest_PDU_Value;
+extern const PASN_TypeDescriptor PSNMP_GetNextRequest_PDU_Descriptor;
+
+
+//
+// GetResponse-PDU
+//
+
+typedef PSNMP_PDU_Value PSNMP_GetResponse_PDU_Value;
+extern const PASN_TypeDescriptor PSNMP_GetResponse_PDU_Descriptor;
+
+
+//
+// SetRequest-PDU
+//
+
+typedef PSNMP_PDU_Value PSNMP_SetRequest_PDU_Value;
+extern const PASN_TypeDescriptor PSNMP_SetRequest_PDU_Descriptor;
+
+
+//
+// PDUs
+//
+
+struct PSNMP_PDUs_Value
+{
+  enum Choices {
+    e_get_request,
+    e_get_next_request,
+    e_get_response,
+    e_set_request,
+    e_trap
+  };
+
+  unsigned m_choice;
+  PSNMP_GetRequest_PDU_Value m_get_request;
+  PSNMP_GetNextRequest_PDU_Value m_get_next_request;
+  PSNMP_GetResponse_PDU_Value m_get_response;
+  PSNMP_SetRequest_PDU_Value m_set_request;
+  PSNMP_Trap_PDU_Value m_trap;
+};
+extern const PASN_TypeDescriptor PSNMP_PDUs_Descriptor;
+
+
+#endif // PTLIB_SNMP_TAB_H
+
+#endif // P_SNMP
+
+
+// End of snmp_tab.h
@@ -38,6 +38,7 @@
 
 #include <ptlib/thread.h>
 #include <ptlib/safecoll.h>
+#include <ptlib/histogram.h>
 #include <map>
 #include <queue>
 
@@ -221,6 +222,7 @@ class PThreadPoolBase : public PObject
 #endif
     PString           m_threadName;
     PThread::Priority m_priority;
+    PLatencyHistogram & m_queueWaitHistogram;
 };
 
 
@@ -242,6 +244,12 @@ class PThreadPool : public PThreadPoolBase
     ) : PThreadPoolBase(maxWorkers, maxWorkUnits, threadName, priority)
     { }
 
+    // Workers use the maps below, so must be stopped before they are destroyed
+    ~PThreadPool()
+    {
+      this->Shutdown();
+    }
+
     //
     // define the ancestor of the worker thread
     //
@@ -414,6 +422,11 @@ class PQueuedThreadPool : public PThreadPool<Work_T>
                                       " workerIncreaseLimit=" << workerIncreaseLimit);
     }
 
+    ~PQueuedThreadPool()
+    {
+      this->Shutdown();
+    }
+
     const PTimeInterval & GetWorkerIncreaseLatency() const { return m_workerIncreaseLatency; }
     void SetWorkerIncreaseLatency(const PTimeInterval & time) { m_workerIncreaseLatency = time; }
     unsigned GetWorkerIncreaseLimit() const { return m_workerIncreaseLimit; }
@@ -464,6 +477,7 @@ class PQueuedThreadPool : public PThreadPool<Work_T>
 
           PQueuedThreadPool & pool = dynamic_cast<PQueuedThreadPool &>(this->m_pool);
           PTimeInterval latency = item.m_time.GetElapsed();
+          pool.m_queueWaitHistogram.Record(latency);
 
           item.m_work->Work();
 
@@ -240,6 +240,16 @@ class PAbstractArray : public PContainer
       PINDEX elementSizeInBytes
     );
 
+    /* Allocate a reference with the array data in the same memory block, so
+       a new array is one allocation rather than two, and growing a unique
+       array can be done in place with a single reallocation. */
+    static PContainerReference * AllocateReference(
+      PINDEX size,
+      PINDEX sizeInBytes
+    );
+    char * GetEmbeddedData() const;
+    virtual void DestroyReference();
+
     /// Size of an element in bytes.
     PINDEX elementSize;
 
@@ -51,6 +51,7 @@ class PContainerReference
       , count(1)
       , deleteObjects(true)
       , constObject(isConst)
+      , embeddedData(false)
     {
     }
 
@@ -59,6 +60,7 @@ class PContainerReference
       , count(1)
       , deleteObjects(ref.deleteObjects)
       , constObject(false)
+      , embeddedData(false)
     {  
     }
 
@@ -66,6 +68,7 @@ class PContainerReference
     atomic<uint32_t> count;         // reference count to the container content - guaranteed to be atomic
     bool           deleteObjects; // Used by PCollection but put here for efficiency
     bool           constObject;   // Indicates object is constant/static, copy on write.
+    bool           embeddedData;  // Array data follows this in the same memory block, see PAbstractArray
 
     PDECLARE_POOL_ALLOCATOR(PContainerReference);
 
@@ -606,6 +609,11 @@ class PCollection : public PContainer
 
 #include <ptlib/array.h>
 
+///////////////////////////////////////////////////////////////////////////////
+// The contiguous value array class
+
+#include <ptlib/flatarray.h>
+
 ///////////////////////////////////////////////////////////////////////////////
 // The abstract array class
 
@@ -0,0 +1,459 @@
+/*
+ * flatarray.h
+ *
+ * Contiguous value array container class.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifndef PTLIB_FLATARRAY_H
+#define PTLIB_FLATARRAY_H
+
+#ifdef P_USE_PRAGMA
+#pragma interface
+#endif
+
+#include <utility>
+#include <type_traits>
+
+
+/**\class PFlatArray
+   This template class is an array of objects held by value in contiguous
+   memory.
+
+   Unlike <code>PArray</code>, which holds a pointer to a separately heap
+   allocated object for every element, the elements here are stored one after
+   the other in a single block. Up to \p InlineCount elements are held within
+   the container object itself, so small arrays need no heap allocation at
+   all. This makes iterating over collections of small objects such as
+   addresses or interface entries much kinder to the processor cache.
+
+   The container has value semantics: copying the array copies the elements,
+   there is no reference counting or sharing as in <code>PContainer</code>.
+   Elements may be moved into the array, avoiding a copy, and may be
+   constructed in place with <code>Emplace()</code>.
+
+   The <code>PrintOn()</code> and <code>Compare()</code> functions follow the
+   same conventions as <code>PCollection</code> and
+   <code>PArrayObjects</code>. For elements descended from
+   <code>PObject</code>, <code>PObject::Compare()</code> is used, otherwise
+   the elements must have <code>operator<</code>.
+
+   Note that any operation that changes the size of the array may invalidate
+   references and pointers to elements.
+*/
+template <class T, PINDEX InlineCount = 4>
+class PFlatArray : public PObject
+{
+    PCLASSINFO(PFlatArray, PObject);
+  public:
+    typedef T         value_type;
+    typedef T       * iterator;
+    typedef const T * const_iterator;
+
+  /**@name Construction */
+  //@{
+    /**Create a new array of objects. The array is initially set to the
+       specified size with each entry default constructed.
+     */
+    PFlatArray(
+      PINDEX initialSize = 0  ///< Initial number of objects in the array.
+    ) : m_data(GetInlineData())
+      , m_size(0)
+      , m_capacity(InlineCount)
+    {
+      SetSize(initialSize);
+    }
+
+    /// Copy all the elements of another array.
+    PFlatArray(const PFlatArray & other)
+      : PObject(other)
+      , m_data(GetInlineData())
+      , m_size(0)
+      , m_capacity(InlineCount)
+    {
+      Append(other);
+    }
+
+    /// Take all the elements of another array, leaving it empty.
+    PFlatArray(PFlatArray && other)
+      : m_data(GetInlineData())
+      , m_size(0)
+      , m_capacity(InlineCount)
+    {
+      TakeFrom(other);
+    }
+
+    /// Destroy all elements and free any heap storage.
+    ~PFlatArray()
+    {
+      RemoveAll();
+      FreeData();
+    }
+
+    /// Copy all the elements of another array.
+    PFlatArray & operator=(const PFlatArray & other)
+    {
+      if (this != &other) {
+        RemoveAll();
+        Append(other);
+      }
+      return *this;
+    }
+
+    /// Take all the elements of another array, leaving it empty.
+    PFlatArray & operator=(PFlatArray && other)
+    {
+      if (this != &other) {
+        RemoveAll();
+        FreeData();
+        TakeFrom(other);
+      }
+      return *this;
+    }
+  //@}
+
+  /**@name Overrides from class PObject */
+  //@{
+    /**Make a complete duplicate of the array, all elements are copied.
+     */
+    virtual PObject * Clone() const
+    {
+      return PNEW PFlatArray(*this);
+    }
+
+    /**Compare the two arrays element by element, the first element that
+       differs determines the result. If all elements are the same, the
+       shorter array is less than the longer.
+
+       @return
+       Comparison of the two arrays.
+     */
+    virtual Comparison Compare(
+      const PObject & obj   ///< Other array to compare against.
+    ) const
+    {
+      PAssert(PIsDescendant(&obj, PFlatArray), PInvalidCast);
+      const PFlatArray & other = dynamic_cast<const PFlatArray &>(obj);
+      for (PINDEX i = 0; i < m_size; ++i) {
+        if (i >= other.m_size)
+          return GreaterThan;
+        Comparison result = CompareElements(m_data[i], other.m_data[i], typename std::is_base_of<PObject, T>::type());
+        if (result != EqualTo)
+          return result;
+      }
+      return m_size < other.m_size ? LessThan : EqualTo;
+    }
+
+    /**Output the contents of the array to the stream, as for
+       <code>PCollection::PrintOn()</code>. The stream fill character is
+       used as the separator between elements, and the stream width is
+       applied to each element. A newline separator with a negative width
+       indents each element.
+     */
+    virtual void PrintOn(
+      ostream &strm   ///< Stream to print the object into.
+    ) const
+    {
+      char separator = strm.fill();
+      int width = (int)strm.width();
+
+      for (PINDEX i = 0; i < m_size; ++i) {
+        if (i > 0 && separator != ' ')
+          strm << separator;
+
+        if (separator == '\n' && width < 0)
+          strm << setfill(' ') << setw(-width) << ' ';
+
+        if (separator != ' ')
+          strm.width(width);
+
+        strm << m_data[i];
+      }
+
+      if (separator == '\n')
+        strm << '\n';
+    }
+  //@}
+
+  /**@name Size and storage */
+  //@{
+    /// Get the number of elements in the array.
+    PINDEX GetSize() const { return m_size; }
+
+    /// Indicate the array has no elements.
+    bool IsEmpty() const { return m_size == 0; }
+
+    /**Set the number of elements in the array. New elements are default
+       constructed, excess elements are destroyed.
+
+       @return
+       Always true, for compatibility with <code>PContainer::SetSize()</code>.
+     */
+    bool SetSize(
+      PINDEX newSize  ///< New number of elements in the array.
+    ) {
+      if (newSize < m_size) {
+        while (m_size > newSize)
+          m_data[--m_size].~T();
+      }
+      else {
+        SetCapacity(newSize);
+        while (m_size < newSize)
+          new (m_data + m_size++) T();
+      }
+      return true;
+    }
+
+    /// Get the number of elements that may be held without reallocation.
+    PINDEX GetCapacity() const { return m_capacity; }
+
+    /**Make sure the array can hold at least the specified number of elements
+       without reallocation. The capacity is never reduced.
+     */
+    void SetCapacity(
+      PINDEX minCapacity  ///< Minimum number of elements to hold.
+    ) {
+      if (minCapacity > m_capacity)
+        Relocate(AllocateData(minCapacity), minCapacity);
+    }
+
+    /// Remove all elements from the array, the storage is retained.
+    void RemoveAll() { SetSize(0); }
+  //@}
+
+  /**@name Element access */
+  //@{
+    /**Get a reference to the element in the array. If the index is beyond
+       the end of the array then the function asserts.
+     */
+    T & operator[](
+      PINDEX index  ///< Index position in the array of the element.
+    ) {
+      PAssert(index < m_size, PInvalidArrayIndex);
+      return m_data[index];
+    }
+
+    /**Get a reference to the element in the array. If the index is beyond
+       the end of the array then the function asserts.
+     */
+    const T & operator[](
+      PINDEX index  ///< Index position in the array of the element.
+    ) const {
+      PAssert(index < m_size, PInvalidArrayIndex);
+      return m_data[index];
+    }
+
+    /**Get a pointer to the contiguous elements of the array. The pointer is
+       invalidated by any change to the size of the array.
+     */
+    T * GetPointer() { return m_data; }
+    const T * GetPointer() const { return m_data; }
+
+    /**Search the array for the specified value of the element, using the
+       same comparison as <code>Compare()</code>.
+
+       @return
+       Index position of the element, or <code>P_MAX_INDEX</code>.
+     */
+    PINDEX GetValuesIndex(
+      const T & value   ///< Value to search for.
+    ) const {
+      for (PINDEX i = 0; i < m_size; ++i) {
+        if (CompareElements(m_data[i], value, typename std::is_base_of<PObject, T>::type()) == EqualTo)
+          return i;
+      }
+      return P_MAX_INDEX;
+    }
+  //@}
+
+  /**@name Insertion and removal */
+  //@{
+    /**Construct a new element in place at the end of the array, with the
+       arguments passed to the element constructor. The arguments may refer
+       to an existing element of the array.
+
+       @return
+       Reference to the new element.
+     */
+    template <typename... Args>
+    T & Emplace(Args &&... args)
+    {
+      if (m_size < m_capacity)
+        new (m_data + m_size) T(std::forward<Args>(args)...);
+      else {
+        PINDEX newCapacity = m_capacity > 0 ? m_capacity*2 : 4;
+        T * newData = AllocateData(newCapacity);
+        new (newData + m_size) T(std::forward<Args>(args)...);
+        Relocate(newData, newCapacity);
+      }
+      return m_data[m_size++];
+    }
+
+    /**Append a copy of the element to the end of the array.
+
+       @return
+       Index of the new element.
+     */
+    PINDEX Append(
+      const T & value   ///< Element to copy.
+    ) {
+      Emplace(value);
+      return m_size-1;
+    }
+
+    /**Move the element to the end of the array.
+
+       @return
+       Index of the new element.
+     */
+    PINDEX Append(
+      T && value   ///< Element to move.
+    ) {
+      Emplace(std::move(value));
+      return m_size-1;
+    }
+
+    /// Append copies of all the elements of another array.
+    void Append(
+      const PFlatArray & other  ///< Array to copy elements of.
+    ) {
+      PINDEX count = other.m_size;
+      SetCapacity(m_size + count);
+      for (PINDEX i = 0; i < count; ++i)
+        new (m_data + m_size++) T(other.m_data[i]);
+    }
+
+    /**Move the element into the array before the specified position. If the
+       position is beyond the end of the array, the element is appended.
+
+       @return
+       Reference to the new element.
+     */
+    T & InsertAt(
+      PINDEX index,   ///< Position to insert element before.
+      T && value      ///< Element to move.
+    ) {
+      if (index >= m_size)
+        return Emplace(std::move(value));
+
+      Emplace(std::move(m_data[m_size-1]));
+      for (PINDEX i = m_size-2; i > index; --i)
+        m_data[i] = std::move(m_data[i-1]);
+      m_data[index] = std::move(value);
+      return m_data[index];
+    }
+
+    /**Remove the element at the specified position, elements after it are
+       moved down.
+
+       @return
+       true if an element was removed, false if the index was out of range.
+     */
+    bool RemoveAt(
+      PINDEX index   ///< Position of element to remove.
+    ) {
+      if (index >= m_size)
+        return false;
+
+      for (PINDEX i = index+1; i < m_size; ++i)
+        m_data[i-1] = std::move(m_data[i]);
+      m_data[--m_size].~T();
+      return true;
+    }
+  //@}
+
+  /**@name STL compatibility */
+  //@{
+    iterator       begin()       { return m_data; }
+    iterator       end()         { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end()   const { return m_data + m_size; }
+    PINDEX size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    void clear() { RemoveAll(); }
+    void reserve(PINDEX capacity) { SetCapacity(capacity); }
+    void push_back(const T & value) { Emplace(value); }
+    void push_back(T && value) { Emplace(std::move(value)); }
+    template <typename... Args> void emplace_back(Args &&... args) { Emplace(std::forward<Args>(args)...); }
+  //@}
+
+  protected:
+    T * GetInlineData() { return reinterpret_cast<T *>(m_inline); }
+
+    static T * AllocateData(PINDEX capacity)
+    {
+      return static_cast<T *>(::operator new(capacity*sizeof(T)));
+    }
+
+    void FreeData()
+    {
+      if (m_data != GetInlineData()) {
+        ::operator delete(m_data);
+        m_data = GetInlineData();
+        m_capacity = InlineCount;
+      }
+    }
+
+    // Move existing elements to the new storage, then release the old
+    void Relocate(T * newData, PINDEX newCapacity)
+    {
+      for (PINDEX i = 0; i < m_size; ++i) {
+        new (newData + i) T(std::move(m_data[i]));
+        m_data[i].~T();
+      }
+      FreeData();
+      m_data = newData;
+      m_capacity = newCapacity;
+    }
+
+    // Assumes this is empty with inline storage
+    void TakeFrom(PFlatArray & other)
+    {
+      if (other.m_data != other.GetInlineData()) {
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_data = other.GetInlineData();
+        other.m_size = 0;
+        other.m_capacity = InlineCount;
+      }
+      else {
+        for (PINDEX i = 0; i < other.m_size; ++i)
+          new (m_data + m_size++) T(std::move(other.m_data[i]));
+        other.RemoveAll();
+      }
+    }
+
+    static Comparison CompareElements(const T & a, const T & b, std::true_type) { return a.Compare(b); }
+    static Comparison CompareElements(const T & a, const T & b, std::false_type) { return a < b ? LessThan : (b < a ? GreaterThan : EqualTo); }
+
+    T    * m_data;
+    PINDEX m_size;
+    PINDEX m_capacity;
+    typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_inline[InlineCount > 0 ? InlineCount : 1];
+};
+
+
+#endif // PTLIB_FLATARRAY_H
+
+
+// End Of File ///////////////////////////////////////////////////////////////
@@ -0,0 +1,319 @@
+/*
+ * histogram.h
+ *
+ * Latency histogram instrumentation.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifndef PTLIB_HISTOGRAM_H
+#define PTLIB_HISTOGRAM_H
+
+#ifdef P_USE_PRAGMA
+#pragma interface
+#endif
+
+#include <vector>
+
+
+/**\class PLatencyHistogram
+   This class accumulates a distribution of durations, for example the time
+   taken to service a request, so that percentiles may be reported.
+
+   Values are held in nanoseconds in log-linear buckets, in the manner of an
+   HDR histogram. Each power of two range is split into
+   <code>SubBuckets</code> equal width buckets, so any recorded value is
+   known to within 1/<code>SubBuckets</code> of itself, from one nanosecond
+   up to <code>MaxValueBits</code> bits (about 18 minutes). Larger values are
+   clamped to the top bucket, though the maximum is still exact.
+
+   Recording takes no lock. The counters are spread over several shards, each
+   thread always using the same one, so threads running on different
+   processors rarely write to the same cache line. The shards are only
+   allocated on first use. When a histogram is disabled a record call costs
+   one relaxed load.
+
+   A <code>Snapshot</code> is a merged, point in time copy of the counters,
+   from which the count, mean, minimum, maximum and any percentile can be
+   obtained, and which can be output as text or JSON. Snapshots from several
+   histograms may be merged.
+
+   Histograms may be created stand alone, or obtained by name from a process
+   wide registry with <code>Get()</code>. The registry is what the library
+   uses for its own instrumentation of timer dispatch, thread pool queue
+   wait, mutex hold time and HTTP request service time. Histograms in the
+   registry are never destroyed, so a reference to one may be kept in a
+   static variable. They are created disabled unless the environment
+   variable PTLIB_LATENCY_HISTOGRAMS is set to a non-zero value, or
+   <code>SetDefaultEnabled()</code> has been called.
+
+   The <code>PPROFILE_HISTOGRAM()</code> macro measures the time spent in a
+   scope. Also, every <code>PPROFILE_TIMESCOPE()</code> feeds a registry
+   histogram of the same name.
+  */
+class PLatencyHistogram : public PObject
+{
+    PCLASSINFO(PLatencyHistogram, PObject)
+  public:
+    enum {
+      SubBucketBits = 5,
+      SubBuckets = 1 << SubBucketBits,
+      MaxValueBits = 40,
+      NumBuckets = (MaxValueBits - SubBucketBits + 1) * SubBuckets,
+      NumShards = 8
+    };
+
+    /**Create a new histogram.
+       Note this is not entered into the registry, see <code>Get()</code>.
+      */
+    PLatencyHistogram(
+      const PString & name = PString::Empty(), ///< Name used in output
+      bool enabled = true                      ///< Initial enabled state
+    );
+
+    /// Destroy histogram
+    ~PLatencyHistogram();
+
+    /**@name Overrides from class PObject */
+    //@{
+    /// Output a snapshot of the histogram as text.
+    virtual void PrintOn(
+      ostream & strm  ///< Stream to output to
+    ) const;
+    //@}
+
+    /**@name Recording */
+    //@{
+    /// Record a duration in nanoseconds.
+    __inline void Record(
+      uint64_t nanoseconds ///< Value to record
+    ) {
+      if (m_enabled.load(memory_order_relaxed))
+        InternalRecord(nanoseconds);
+    }
+
+    /// Record a duration.
+    void Record(
+      const PTimeInterval & interval ///< Value to record
+    );
+
+    /**Record the time since a <code>PProfiling::GetCycles()</code> value.
+       If the histogram is disabled, the cycle count is not even read.
+      */
+    __inline void RecordSince(
+      uint64_t startCycle  ///< Value from <code>PProfiling::GetCycles()</code>
+    ) {
+      if (m_enabled.load(memory_order_relaxed))
+        InternalRecordSince(startCycle);
+    }
+
+    /// Indicate histogram is enabled.
+    bool IsEnabled() const { return m_enabled.load(memory_order_relaxed); }
+
+    /// Enable or disable recording
+    void SetEnabled(
+      bool enabled  ///< Flag for recording
+    ) { m_enabled.store(enabled, memory_order_relaxed); }
+
+    /// Get the name of the histogram
+    const PString & GetName() const { return m_name; }
+
+    /**Clear all the counters.
+       Note values recorded concurrently with the reset may be partially lost.
+      */
+    void Reset();
+    //@}
+
+    /**@name Snapshots */
+    //@{
+    /// Merged point in time copy of a histograms counters.
+    class Snapshot : public PObject
+    {
+        PCLASSINFO(Snapshot, PObject)
+      public:
+        /// Create empty snapshot
+        Snapshot(
+          const PString & name = PString::Empty()  ///< Name used in output
+        );
+
+        /// Output as a single line of text with the commonly used percentiles.
+        virtual void PrintOn(ostream & strm) const;
+
+        /// Output as a JSON object, including the non-empty buckets.
+        void ToJSON(
+          ostream & strm  ///< Stream to output to
+        ) const;
+
+        /// Add the counts from another snapshot into this one.
+        void Merge(
+          const Snapshot & other  ///< Snapshot to merge
+        );
+
+        /// Get the name of the source histogram
+        const PString & GetName() const { return m_name; }
+
+        /// Get the number of values recorded.
+        uint64_t GetCount() const { return m_count; }
+
+        /// Get the sum of all values recorded in nanoseconds.
+        uint64_t GetSum() const { return m_sum; }
+
+        /// Get the smallest value recorded in nanoseconds, zero if none.
+        uint64_t GetMinimum() const { return m_count > 0 ? m_minimum : 0; }
+
+        /// Get the largest value recorded in nanoseconds, zero if none.
+        uint64_t GetMaximum() const { return m_maximum; }
+
+        /// Get the mean of the values recorded in nanoseconds, zero if none.
+        uint64_t GetMean() const { return m_count > 0 ? m_sum/m_count : 0; }
+
+        /**Get a percentile in nanoseconds.
+           The result is the middle of the bucket containing the value at that
+           rank, limited to the recorded minimum and maximum. So, zero gives the
+           minimum and 100 the maximum.
+          */
+        uint64_t GetPercentile(
+          double percent  ///< Percentile, 0 to 100, e.g. 99.9
+        ) const;
+
+        /// Get the count in a bucket
+        uint64_t GetBucketCount(
+          unsigned bucket  ///< Bucket index, 0 to NumBuckets-1
+        ) const { return bucket < m_buckets.size() ? m_buckets[bucket] : 0; }
+
+      protected:
+        PString               m_name;
+        uint64_t              m_count;
+        uint64_t              m_sum;
+        uint64_t              m_minimum;
+        uint64_t              m_maximum;
+        std::vector<uint64_t> m_buckets;
+
+      friend class PLatencyHistogram;
+    };
+    typedef std::vector<Snapshot> Snapshots;
+
+    /// Get a copy of the current counters.
+    Snapshot GetSnapshot() const;
+
+    /// Get the bucket index for a value in nanoseconds.
+    static unsigned GetBucketIndex(uint64_t nanoseconds);
+
+    /// Get the lowest value in nanoseconds that falls in the bucket.
+    static uint64_t GetBucketLowest(unsigned bucket);
+
+    /// Get the highest value in nanoseconds that falls in the bucket.
+    static uint64_t GetBucketHighest(unsigned bucket);
+    //@}
+
+    /**@name Registry */
+    //@{
+    /**Get the registry histogram of the name, creating it if necessary.
+       This takes a lock, so the reference should be saved, rather than
+       calling this for every record.
+      */
+    static PLatencyHistogram & Get(
+      const PString & name  ///< Name of histogram
+    );
+
+    /// Get snapshots of all the histograms in the registry, in name order.
+    static Snapshots GetSnapshots();
+
+    /// Output all the non-empty histograms in the registry as text, one per line.
+    static void PrintAll(
+      ostream & strm  ///< Stream to output to
+    );
+
+    /// Output all the histograms in the registry as a JSON object.
+    static void AllToJSON(
+      ostream & strm  ///< Stream to output to
+    );
+
+    /// Reset all the histograms in the registry.
+    static void ResetAll();
+
+    /// Enable or disable all the histograms in the registry.
+    static void SetAllEnabled(
+      bool enabled  ///< Flag for recording
+    );
+
+    /// Set the enabled state used for histograms subsequently added to the registry.
+    static void SetDefaultEnabled(
+      bool enabled  ///< Flag for recording
+    );
+
+    /// Get the enabled state used for histograms added to the registry.
+    static bool GetDefaultEnabled();
+    //@}
+
+    /** Class used by PPROFILE_HISTOGRAM() macro to do the measurement of
+        time between construction and destruction.
+      */
+    class Measure
+    {
+      protected:
+        PLatencyHistogram & m_histogram;
+        uint64_t      const m_startCycle;
+
+      public:
+        Measure(PLatencyHistogram & histogram)
+          : m_histogram(histogram)
+          , m_startCycle(histogram.IsEnabled() ? PProfiling::GetCycles() : 0)
+        {
+        }
+
+        ~Measure()
+        {
+          if (m_startCycle != 0)
+            m_histogram.RecordSince(m_startCycle);
+        }
+    };
+
+  protected:
+    PPROFILE_EXCLUDE(void InternalRecord(uint64_t nanoseconds));
+    PPROFILE_EXCLUDE(void InternalRecordSince(uint64_t startCycle));
+
+    struct Shard;
+    Shard * GetShard();
+
+    PString        m_name;
+    atomic<bool>   m_enabled;
+    atomic<Shard*> m_shards[NumShards];
+
+  private:
+    PLatencyHistogram(const PLatencyHistogram &) { }
+    void operator=(const PLatencyHistogram &) { }
+};
+
+
+/**Measure the time spent in a scope into a registry histogram.
+   The \p name must be a valid identifier, and is also the name of the
+   histogram.
+  */
+#define PPROFILE_HISTOGRAM(name) \
+    static PLatencyHistogram & p_latency_histogram_static_instance##name = PLatencyHistogram::Get(#name); \
+    PLatencyHistogram::Measure p_latency_histogram_instance##name(p_latency_histogram_static_instance##name)
+
+
+#endif // PTLIB_HISTOGRAM_H
+
+
+// End Of File ///////////////////////////////////////////////////////////////
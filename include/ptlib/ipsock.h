@@ -760,7 +760,8 @@ class PIPSocket : public PSocket
       friend class PIPSocket;
     };
 
-    PARRAY(InterfaceTable, InterfaceEntry);
+    /// Table of interfaces, held by value in contiguous memory.
+    typedef PFlatArray<InterfaceEntry, 8> InterfaceTable;
 
     /**Get a list of all interfaces.
        @return
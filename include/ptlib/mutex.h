@@ -44,6 +44,7 @@ class PMutexExcessiveLockInfo
     PDebugLocation m_location;
     unsigned       m_excessiveLockTimeout;
     mutable bool   m_excessiveLockActive;
+    bool           m_contentionProfiled;
     uint64_t       m_startHeldSamplePoint;
 
     PMutexExcessiveLockInfo();
@@ -74,7 +75,220 @@ class PMutexExcessiveLockInfo
 
   public:
     void SetLocationName(const char * name) { m_location.m_extra = name; }
+
+    /// Exclude from <code>PMutexContention</code>, e.g. for a mutex internal to another lock.
+    void SetContentionProfiled(bool profiled) { m_contentionProfiled = profiled; }
+};
+
+
+/**Lock contention profiling for <code>PTimedMutex</code> and <code>PReadWriteMutex</code>.
+   When enabled, every acquisition and release is accumulated against the
+   site the mutex was declared at, that is, the <code>PDebugLocation</code>
+   given to the mutex by <code>PDECLARE_MUTEX()</code>,
+   <code>PDECLARE_READ_WRITE_MUTEX()</code> or the instrumented mutex
+   macros. Mutexes with no location use the location passed to the
+   instrumented wait functions if there is one, or all go into a single
+   "unnamed" site.
+
+   For each site the number of acquisitions, the number of contended
+   acquisitions, and the total, maximum and a coarse distribution of the time
+   spent waiting for and holding the lock are kept. An acquisition is counted
+   as contended if the wait took longer than the contention threshold.
+
+   The counters are in tables allocated the first time profiling is enabled.
+   Each thread uses one of several tables, so no lock is taken and threads
+   rarely write to the same cache line. When profiling is disabled, the cost
+   to a lock is a single load of a flag.
+
+   Profiling may be enabled at start up by setting the environment variable
+   PTLIB_LOCK_CONTENTION to a non-zero value, which is then the contention
+   threshold in nanoseconds.
+
+   Note the strings in the <code>PDebugLocation</code> are not copied, so
+   must remain valid while profiling, as is normally the case for the
+   literals used by the macros.
+  */
+class PMutexContention
+{
+  public:
+    /// Enable or disable profiling.
+    static void SetEnabled(
+      bool enabled  ///< Flag for profiling
+    );
+
+    /// Indicate profiling is enabled.
+    static bool IsEnabled();
+
+    /// Set the wait time, in nanoseconds, above which an acquisition is contended.
+    static void SetThreshold(
+      unsigned nanoseconds  ///< Wait time threshold
+    );
+
+    /// Get the wait time, in nanoseconds, above which an acquisition is contended.
+    static unsigned GetThreshold();
+
+    /// Clear all the counters.
+    static void Reset();
+
+    /// Accumulated counters for a mutex declaration site.
+    struct Site
+    {
+      Site(const PDebugLocation & location);
+
+      PDebugLocation m_location;
+      uint64_t       m_acquisitions;
+      uint64_t       m_contended;
+      uint64_t       m_waitTotal;   ///< Nanoseconds
+      uint64_t       m_waitMaximum; ///< Nanoseconds
+      uint64_t       m_waitPercentile99; ///< Nanoseconds, approximate
+      uint64_t       m_holdTotal;   ///< Nanoseconds
+      uint64_t       m_holdMaximum; ///< Nanoseconds
+      uint64_t       m_holdPercentile99; ///< Nanoseconds, approximate
+    };
+    typedef std::vector<Site> Sites;
+
+    /// Field to sort sites by
+    enum SortOrder {
+      SortByWaitTime,
+      SortByHoldTime,
+      SortByContended,
+      SortByAcquisitions
+    };
+
+    /// Get the sites accumulated so far, hottest first.
+    static Sites GetSites(
+      SortOrder order = SortByWaitTime  ///< Field to sort by
+    );
+
+    /// Output a table of the hottest sites.
+    static void PrintOn(
+      ostream & strm,                   ///< Stream to output to
+      unsigned maxSites = 20,           ///< Maximum number of sites to output
+      SortOrder order = SortByWaitTime  ///< Field to sort by
+    );
+
+  protected:
+    static void Acquired(const PDebugLocation & location, uint64_t startWaitCycle);
+    static void Released(const PDebugLocation & location, uint64_t startHeldCycle);
+
+  friend class PMutexExcessiveLockInfo;
+};
+
+
+#if P_FUTEX_MUTEX
+/**Recursive mutex implemented directly on the Linux futex system call.
+   This is used by <code>PTimedMutex</code> and <code>PCriticalSection</code>
+   when PTLib is configured with --enable-futexmutex.
+
+   Acquiring an unlocked mutex, and releasing one that no thread is waiting
+   for, is a single compare and swap with no system call. A thread finding
+   the mutex locked spins for a while before sleeping in the kernel, as a
+   short critical section is usually left sooner than a sleep and wake up
+   could be done. The spin limit adapts to how long spinning took to
+   succeed on previous occasions, up to <code>MaxSpins</code>.
+
+   In the default mode a released mutex may be taken by any thread,
+   including one that has just arrived, which gives the best throughput.
+   In handoff mode a mutex released while threads are waiting is passed
+   directly to one of them, and new arrivals cannot overtake them, so the
+   lock is granted in approximately first come first served order, at the
+   cost of a context switch on every contended release. Handoff mode is the
+   default if configured with --enable-futexmutex=fair.
+  */
+class PFutexMutex
+{
+  public:
+    enum { MaxSpins = 100 };
+
+    /// Create an unlocked mutex.
+    explicit PFutexMutex(
+      bool handoff = P_FUTEX_MUTEX > 1  ///< Pass lock directly to waiting threads
+    );
+
+    /// Block until the mutex is acquired.
+    __inline void Wait()
+    {
+      pthread_t self = pthread_self();
+      if (m_owner.load(memory_order_relaxed) == self)
+        ++m_recursion;
+      else {
+        uint32_t state = m_state.load(memory_order_relaxed);
+        if (!CanAcquire(state) || !m_state.compare_exchange_strong(state, state|LockedBit, memory_order_acquire, memory_order_relaxed))
+          InternalWait(state, NULL);
+        m_owner.store(self, memory_order_relaxed);
+      }
+    }
+
+    /**Block, for a time, until the mutex is acquired.
+       @return true if acquired, false if timed out.
+      */
+    bool Wait(
+      const PTimeInterval & timeout  ///< Amount of time to wait, PMaxTimeInterval is forever
+    );
+
+    /**Acquire the mutex if it can be done without waiting.
+       @return true if acquired.
+      */
+    __inline bool Try()
+    {
+      pthread_t self = pthread_self();
+      if (m_owner.load(memory_order_relaxed) == self) {
+        ++m_recursion;
+        return true;
+      }
+
+      uint32_t state = m_state.load(memory_order_relaxed);
+      if (!CanAcquire(state) || !m_state.compare_exchange_strong(state, state|LockedBit, memory_order_acquire, memory_order_relaxed))
+        return false;
+
+      m_owner.store(self, memory_order_relaxed);
+      return true;
+    }
+
+    /// Release the mutex, must be called by the thread that acquired it.
+    __inline void Signal()
+    {
+      if (m_recursion > 0) {
+        --m_recursion;
+        return;
+      }
+
+      m_owner.store(pthread_t(), memory_order_relaxed);
+      uint32_t state = m_state.load(memory_order_relaxed);
+      if (state != LockedBit || !m_state.compare_exchange_strong(state, 0, memory_order_release, memory_order_relaxed))
+        InternalSignal(state);
+    }
+
+    /// Indicate mutex is in handoff mode.
+    bool IsHandoff() const { return m_handoff; }
+
+  protected:
+    // The state word is what the futex waits on
+    enum {
+      LockedBit = 1,       // Held by a thread
+      HandoffBit = 2,      // Released to the waiting threads only
+      WakePendingBit = 4,  // A waiter has been woken and not yet run
+      WaiterIncrement = 8  // Remaining bits are count of waiting threads
+    };
+    bool CanAcquire(uint32_t state) const
+    {
+      return m_handoff ? state == 0 : (state & (LockedBit|HandoffBit)) == 0;
+    }
+
+    bool InternalWait(uint32_t state, const PTimeInterval * timeout);
+    void InternalSignal(uint32_t state);
+
+    atomic<uint32_t>  m_state;
+    atomic<pthread_t> m_owner;
+    unsigned          m_recursion;
+    atomic<unsigned>  m_spinEstimate;
+    bool              m_handoff;
+
+  private:
+    PFutexMutex(const PFutexMutex &) { }
+    void operator=(const PFutexMutex &) { }
 };
+#endif // P_FUTEX_MUTEX
 
 
 /**This class defines a thread mutual exclusion object. A mutex is where a
@@ -329,6 +543,8 @@ class PCriticalSection : public PSync
 
 #if _WIN32
     mutable CRITICAL_SECTION criticalSection;
+#elif P_FUTEX_MUTEX
+    mutable PFutexMutex m_mutex;
 #elif defined(P_PTHREADS) || defined(VX_TASKS)
     mutable pthread_mutex_t m_mutex;
 #endif
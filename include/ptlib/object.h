@@ -133,6 +133,12 @@ using namespace std; // Not a good practice (name space polution), but will take
 #endif // _MSC_VER
 #define P_DISABLE_MSVC_WARNINGS(warnings, statement) P_PUSH_MSVC_WARNINGS(warnings) statement P_POP_MSVC_WARNINGS()
 
+#if defined(_MSC_VER) && _MSC_VER < 1900
+  #define P_THREAD_LOCAL __declspec(thread)
+#else
+  #define P_THREAD_LOCAL thread_local
+#endif
+
 #ifdef _MSC_VER
   #define PIGNORE_RETURN(t,e)	(void)(e)
 #else
@@ -1333,6 +1339,12 @@ namespace PProfiling
   void Analyse(Analysis & analysis);
   void Analyse(ostream & strm, bool html);
 
+  /// Output every recorded call in Chrome trace event JSON, for chrome://tracing or Perfetto
+  void ToChromeTrace(ostream & strm);
+
+  /// Output self time in nanoseconds per unique call stack, in folded format for flame graphs
+  void ToFoldedStacks(ostream & strm);
+
   PPROFILE_EXCLUDE(
     void Enable(bool enab)
   );
@@ -1375,7 +1387,7 @@ namespace PProfiling
       PDebugLocation m_location;
   };
 
-  #define PPROFILE_BLOCK(name) ::PProfiling::Block p_profile_block_instance(PDebugLocation(__FILE,__LINE__, name))
+  #define PPROFILE_BLOCK(name) ::PProfiling::Block p_profile_block_instance(PDebugLocation(__FILE__, __LINE__, name))
   #define PPROFILE_FUNCTION() PPROFILE_BLOCK(__PRETTY_FUNCTION__)
 
   #define PPROFILE_PRE_SYSTEM()  ::PProfiling::PreSystem()
@@ -1548,10 +1560,11 @@ class PMemoryHeap {
       {\em not} be the same as the pointer passed into the function.
      */
     static void * Reallocate(
-      void * ptr,         ///< Pointer to memory block to reallocate.
-      size_t nSize,       ///< New number of bytes to allocate.
-      const char * file,  ///< Source file name for allocating function.
-      int line            ///< Source file line for allocating function.
+      void * ptr,                     ///< Pointer to memory block to reallocate.
+      size_t nSize,                   ///< New number of bytes to allocate.
+      const char * file,              ///< Source file name for allocating function.
+      int line,                       ///< Source file line for allocating function.
+      const char * className = NULL   ///< Class name for allocating function.
     );
 
     /** Free a memory block.
@@ -1612,6 +1625,35 @@ class PMemoryHeap {
      */
     static void DumpStatistics(ostream & strm /** Stream to output to */);
 
+    /** Set the allocation sampling interval.
+       When zero, every allocation is tracked, which is the default. When
+       non-zero, approximately one block per <code>bytes</code> allocated, per
+       thread, is tracked in the allocated block list, and only those blocks
+       are included in leak dumps and full heap validation. The rest still
+       have guard bytes, but never take the heap mutex. The statistics are
+       scaled up from the sampled blocks to estimate actual usage.
+
+       The initial value is taken from the PTLIB_MEMORY_SAMPLE environment
+       variable. Combined with PTLIB_MEMORY_CHECK=2, which skips the fill
+       patterns and guard byte checks, the overhead is low enough for
+       production use.
+
+       @return previous sampling interval.
+     */
+    static size_t SetSampleInterval(
+      size_t bytes    ///< Mean bytes allocated between samples, zero disables sampling.
+    );
+
+    /** Dump the allocation sites with the most memory in use.
+       Each allocating source file, line and class is counted separately,
+       ordered by the estimated bytes currently allocated. This is also
+       output by DumpStatistics().
+     */
+    static void DumpAllocationSites(
+      ostream & strm,         ///< Stream to output to
+      unsigned maxSites = 20  ///< Maximum number of sites to output
+    );
+
     typedef unsigned alloc_t;
 
 #if PMEMORY_CHECK
@@ -1676,7 +1718,8 @@ class PMemoryHeap {
       void * ptr,             // Pointer to memory block to reallocate
       size_t nSize,           // Number of bytes to allocate.
       const char * file,      // Source file name for allocating function.
-      int line                // Source file line for allocating function.
+      int line,               // Source file line for allocating function.
+      const char * className  // Class name for allocating function.
     );
     void InternalDeallocate(
       void * ptr,
@@ -1690,6 +1733,7 @@ class PMemoryHeap {
     bool InternalValidateHeap(ostream * error);
     void InternalDumpStatistics(ostream & strm);
     void InternalDumpObjectsSince(DWORD objectNumber, ostream & strm);
+    void InternalDumpAllocationSites(ostream & strm, unsigned maxSites);
 
     enum Flags {
       NoLeakPrint = 1
@@ -1704,6 +1748,7 @@ class PMemoryHeap {
                               sizeof(const char *) +
                               sizeof(const char *) +
                               sizeof(size_t) +
+                              sizeof(size_t) +
                               sizeof(alloc_t) +
                               sizeof(uint16_t) +
                               sizeof(uint8_t) +
@@ -1716,6 +1761,7 @@ class PMemoryHeap {
       const char * m_className;
       const char * m_fileName;
       size_t       m_size;
+      size_t       m_weight;  // Estimated bytes represented, zero if not tracked
       alloc_t      m_request;
       uint16_t     m_line;
       uint8_t      m_flags;
@@ -1726,6 +1772,10 @@ class PMemoryHeap {
     };
 #pragma pack()
 
+    size_t GetSampleWeight(size_t nSize);
+    void TrackBlock(Header * obj, size_t weight);
+    void UntrackBlock(Header * obj);
+
     enum {
       e_Destroyed =-1,
       e_Disabled,
@@ -1744,6 +1794,8 @@ class PMemoryHeap {
     char  m_allocFillChar;
     char  m_freeFillChar;
 
+    size_t  m_sampleInterval;
+
     size_t  m_currentMemoryUsage;
     size_t  m_peakMemoryUsage;
     alloc_t m_currentObjects;
@@ -2076,6 +2128,92 @@ class PSafeSingleton : public PSingleton<Type, atomic<unsigned>, Creator>
     void   cls::operator delete(void * ptr)                    {        PFixedPoolAllocator<cls>()->deallocate((cls *)ptr, 1); } \
     void   cls::operator delete(void * ptr, const char *, int) {        PFixedPoolAllocator<cls>()->deallocate((cls *)ptr, 1); }
 
+#elif P_SLAB_ALLOCATOR && !PMEMORY_HEAP
+
+  /**Thread caching slab allocator for small, frequently created objects.
+     Blocks are grouped into size classes, each thread keeps a free list per
+     size class so most allocations and deallocations take no lock at all.
+     When a thread's free list grows too long, a batch of blocks is returned
+     to a global depot, from which other threads may take whole batches.
+     New blocks are carved from slabs by the thread that first needs them,
+     so the memory is first touched, and thus placed, near that thread.
+
+     One instance exists per class using <code>PDECLARE_POOL_ALLOCATOR</code>,
+     which is used to gather the statistics for that class.
+
+     Note slabs are never returned to the operating system, so the memory
+     held is that of the peak number of live objects of each size class. A
+     failure to obtain memory throws <code>std::bad_alloc</code>, or asserts
+     and aborts if built without exceptions.
+
+     This is only used if PTLib is configured with --with-allocator=slab.
+   */
+  class PSlabAllocator
+  {
+    public:
+      PSlabAllocator(
+        const char * name,  ///< Name of class using allocator
+        size_t size         ///< Size of class using allocator
+      );
+
+      /// Allocate a block, larger than the largest size class uses malloc()
+      void * Allocate(size_t size);
+
+      /// Deallocate a block, size must be the same as passed to Allocate()
+      void Deallocate(void * ptr, size_t size);
+
+      /// Statistics for a class using the slab allocator.
+      struct Statistics
+      {
+        Statistics();
+
+        /// Get percentage of allocations satisfied from the thread cache.
+        double GetCacheHitRate() const;
+
+        const char * m_name;
+        size_t       m_objectSize;
+        uint64_t     m_allocations;
+        uint64_t     m_deallocations;
+        uint64_t     m_cacheHits;
+        size_t       m_liveObjects;
+        size_t       m_liveBytes;
+      };
+      typedef std::vector<Statistics> StatisticsList;
+
+      /**Get the statistics for all classes using the slab allocator. This
+         is a snapshot, with other threads running it is not exact.
+        */
+      static void GetStatistics(
+        StatisticsList & stats
+      );
+
+      /**Output a table of the statistics for all classes using the slab
+         allocator, plus the total memory held in slabs.
+        */
+      static void PrintStatistics(
+        ostream & strm
+      );
+
+    protected:
+      const char * m_name;
+      size_t       m_size;
+      unsigned     m_index;
+  };
+
+  #define PDECLARE_POOL_ALLOCATOR(cls) \
+    virtual ~cls() { } \
+    __inline static const char * Class() { return typeid(cls).name(); } \
+    static PSlabAllocator & GetSlabAllocator(); \
+    void * operator new(size_t nSize)                   { return GetSlabAllocator().Allocate(nSize); } \
+    void * operator new(size_t nSize, const char *, int) { return GetSlabAllocator().Allocate(nSize); } \
+    void operator delete(void * ptr, size_t nSize)      { GetSlabAllocator().Deallocate(ptr, nSize); } \
+    void operator delete(void * ptr, const char *, int) { GetSlabAllocator().Deallocate(ptr, sizeof(cls)); } \
+    void * operator new(size_t, void * placement)       { return placement; } \
+    void operator delete(void *, void *)                { }
+
+  #define PDEFINE_POOL_ALLOCATOR(cls) \
+    PSlabAllocator & cls::GetSlabAllocator() { static PSlabAllocator allocator(#cls, sizeof(cls)); return allocator; }
+
 #else
 
   #define PDECLARE_POOL_ALLOCATOR(cls) \
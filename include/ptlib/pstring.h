@@ -49,6 +49,7 @@
 class PStringArray;
 class PRegularExpression;
 class PString;
+class PCharacterSet;
 
 /**The same as the standard C snprintf(fmt, 1000, ...), but returns a
    PString instead of a const char *.
@@ -1265,6 +1266,15 @@ class PString : public PCharArray
       PINDEX offset = 0     ///< Offset into string to begin search.
     ) const;
 
+    /**Locate the position of one of the characters in the set.
+       This is the most efficient form if the same set is searched for many
+       times, as the set is only built once.
+     */
+    PINDEX FindOneOf(
+      const PCharacterSet & set,  ///< Set of characters to search for in string.
+      PINDEX offset = 0           ///< Offset into string to begin search.
+    ) const;
+
     /** Locate the position of character not in the set. */
     PINDEX FindSpan(
       const PString & set,  ///< String of characters to search for in string.
@@ -1291,6 +1301,12 @@ class PString : public PCharArray
       PINDEX offset = 0     ///< Offset into string to begin search.
     ) const;
 
+    /** Locate the position of character not in the set. */
+    PINDEX FindSpan(
+      const PCharacterSet & set,  ///< Set of characters to search for in string.
+      PINDEX offset = 0           ///< Offset into string to begin search.
+    ) const;
+
     /**Locate the position within the string of one of the regular expression.
        The search will begin at the character offset provided.
 
@@ -1588,6 +1604,9 @@ class PString : public PCharArray
        or more trailing delimeters, they will yeild a single empty string at
        the end of the array.
 
+       Note, every token is allocated as a new PString, if the tokens are
+       only to be examined, PStringTokeniser avoids this.
+
        @return
        an array of substring for each token in the string.
      */
@@ -2143,6 +2162,195 @@ typedef PConstantString<PString>         PConstString;
 typedef PConstantString<PCaselessString> PConstCaselessString;
 
 
+//////////////////////////////////////////////////////////////////////////////
+
+/**A set of 8 bit characters.
+   This is a lookup table, so determining if a character is in the set is a
+   single memory access, rather than searching a string of characters each
+   time, as strchr() does.
+  */
+class PCharacterSet
+{
+  public:
+    /// Create an empty set.
+    PCharacterSet() { memset(m_bits, 0, sizeof(m_bits)); }
+
+    /// Create a set from the characters in the C string.
+    PCharacterSet(
+      const char * cset,      ///< Characters to put in the set
+      bool caseless = false   ///< Include both cases of letters
+    );
+
+    /// Add a character to the set.
+    void Include(char c) { m_bits[(BYTE)c >> 5] |= 1U << (c & 31); }
+
+    /// Determine if the character is in the set.
+    bool Contains(char c) const { return (m_bits[(BYTE)c >> 5] & (1U << (c & 31))) != 0; }
+
+  protected:
+    DWORD m_bits[8];
+};
+
+
+/**A read only view of part of a string.
+   This is simply a pointer and length, no memory is allocated and the
+   characters are not copied, so the string viewed must outlive the view.
+   Note that the characters are not null terminated.
+  */
+class PStringView
+{
+  public:
+    /// Create an empty view.
+    PStringView() : m_pointer(""), m_length(0) { }
+
+    /// Create a view of the characters.
+    PStringView(
+      const char * pointer,   ///< Start of characters
+      PINDEX length           ///< Number of characters
+    ) : m_pointer(pointer), m_length(length) { }
+
+    /// Create a view of the whole string.
+    PStringView(
+      const PString & str     ///< String to view
+    );
+
+    /// Get the pointer to the first character, this is not null terminated.
+    const char * GetPointer() const { return m_pointer; }
+
+    /// Get the number of characters in the view.
+    PINDEX GetLength() const { return m_length; }
+
+    /// Determine if the view has no characters.
+    bool IsEmpty() const { return m_length == 0; }
+
+    /// Get a character in the view, there is no range check.
+    char operator[](PINDEX index) const { return m_pointer[index]; }
+
+    /// Get a view with leading and trailing white space removed.
+    PStringView Trim() const;
+
+    /// Create a new string with a copy of the characters.
+    PString AsString() const;
+
+    /// Determine if the view has exactly the same characters as the C string.
+    bool operator==(const char * cstr) const;
+    bool operator!=(const char * cstr) const { return !operator==(cstr); }
+
+    /// Determine if the view has the same characters as the C string, ignoring case.
+    bool IsCaselessEqual(const char * cstr) const;
+
+    friend ostream & operator<<(ostream & strm, const PStringView & view)
+    { return strm.write(view.m_pointer, view.m_length); }
+
+  protected:
+    const char * m_pointer;
+    PINDEX       m_length;
+};
+
+
+/**Split a string into tokens without allocating memory.
+   This produces the identical tokens to PString::Tokenise(), but each is
+   returned as a PStringView into the original string, one at a time, so
+   nothing is allocated until the caller converts a token into a PString.
+
+   For example:
+   <CODE>
+     PStringTokeniser tokens(line, " \t", false);
+     PStringView token;
+     while (tokens.Next(token)) {
+       if (token == "Basic")
+         ...
+     }
+   </CODE>
+   or
+   <CODE>
+     for (PStringTokeniser::iterator it = tokens.begin(); it != tokens.end(); ++it)
+       cout << *it << endl;
+   </CODE>
+
+   When constructed from a PString, a reference to the string is kept, so the
+   tokens remain valid for the life of the tokeniser, even if the original
+   PString is altered.
+  */
+class PStringTokeniser
+{
+  public:
+    /// Tokenise a string, see PString::Tokenise() for the meaning of the parameters.
+    PStringTokeniser(
+      const PString & str,          ///< String to split into tokens
+      const char * separators,      ///< Set of separator characters that delimit tokens
+      bool onePerSeparator = true   ///< Flag for if there are empty tokens between consecutive separators
+    );
+
+    /// Tokenise a string, see PString::Tokenise() for the meaning of the parameters.
+    PStringTokeniser(
+      const PString & str,              ///< String to split into tokens
+      const PCharacterSet & separators, ///< Set of separator characters that delimit tokens
+      bool onePerSeparator = true       ///< Flag for if there are empty tokens between consecutive separators
+    );
+
+    /**Tokenise the characters, see PString::Tokenise() for the meaning of the parameters.
+       The memory pointed to must outlive the tokeniser.
+      */
+    PStringTokeniser(
+      const char * pointer,             ///< Start of characters to split into tokens
+      PINDEX length,                    ///< Number of characters
+      const PCharacterSet & separators, ///< Set of separator characters that delimit tokens
+      bool onePerSeparator = true       ///< Flag for if there are empty tokens between consecutive separators
+    );
+
+    /**Get the next token.
+       @return false if there are no more tokens.
+      */
+    bool Next(
+      PStringView & token   ///< Next token in string
+    );
+
+    /// Restart from the first token.
+    void Restart();
+
+    /// Get the number of tokens in total, this does not change the current position.
+    PINDEX GetCount() const;
+
+    /// Get all of the tokens as an array of strings, as PString::Tokenise() does.
+    PStringArray AsArray() const;
+
+    class iterator : public std::iterator<std::forward_iterator_tag, PStringView>
+    {
+        PStringTokeniser * m_tokeniser;
+        PStringView        m_token;
+
+        iterator(PStringTokeniser * tokeniser) : m_tokeniser(tokeniser) { operator++(); }
+
+      public:
+        iterator() : m_tokeniser(NULL) { }
+
+        iterator & operator++() { if (m_tokeniser != NULL && !m_tokeniser->Next(m_token)) m_tokeniser = NULL; return *this; }
+        const PStringView & operator*() const { return m_token; }
+        const PStringView * operator->() const { return &m_token; }
+        bool operator==(const iterator & it) const { return m_tokeniser == it.m_tokeniser; }
+        bool operator!=(const iterator & it) const { return m_tokeniser != it.m_tokeniser; }
+
+      friend class PStringTokeniser;
+    };
+
+    /// Iterate over the tokens, this restarts the tokeniser.
+    iterator begin() { Restart(); return iterator(this); }
+    iterator end() { return iterator(); }
+
+  protected:
+    void Initialise(const char * pointer, PINDEX length);
+
+    PString       m_string;
+    PCharacterSet m_separators;
+    bool          m_onePerSeparator;
+    const char  * m_begin;
+    const char  * m_end;
+    const char  * m_position;
+    bool          m_finished;
+};
+
+
 #ifdef _WIN32
 // Now have PConstString can have these definitions
 __inline PWideString::PWideString(const char * str) : PWCharArray(PConstString(str).AsWide()) { }
@@ -2394,10 +2602,10 @@ class PStringArray : public PArray<PString>
       */
     PStringArray(
       const std::vector<PString> & vec
-    )
+    ) : BaseClass(vec.size())
     {
-      for (std::vector<PString>::const_iterator r = vec.begin(); r != vec.end(); ++r)
-        AppendString(*r);
+      for (PINDEX i = 0; i < vec.size(); ++i)
+        (*theArray)[i] = new PString(vec[i]);
     }
 
     /**
@@ -2405,10 +2613,22 @@ class PStringArray : public PArray<PString>
       */
     PStringArray(
       const std::vector<std::string> & vec
-    )
+    ) : BaseClass(vec.size())
+    {
+      for (PINDEX i = 0; i < vec.size(); ++i)
+        (*theArray)[i] = new PString(vec[i]);
+    }
+
+    /**
+      * Create a PStringArray from a flat array of PStrings
+      */
+    template <PINDEX InlineCount>
+    PStringArray(
+      const PFlatArray<PString, InlineCount> & arr
+    ) : BaseClass(arr.GetSize())
     {
-      for (std::vector<std::string>::const_iterator r = vec.begin(); r != vec.end(); ++r)
-        AppendString(PString(*r));
+      for (PINDEX i = 0; i < arr.GetSize(); ++i)
+        (*theArray)[i] = new PString(arr[i]);
     }
 
     /**
@@ -2419,9 +2639,10 @@ class PStringArray : public PArray<PString>
       const stlContainer & vec
     )
     {
-      PStringArray list;
+      PStringArray list(vec.size());
+      PINDEX count = 0;
       for (typename stlContainer::const_iterator r = vec.begin(); r != vec.end(); ++r)
-        list.AppendString(PString(*r));
+        (*list.theArray)[count++] = new PString(*r);
       return list;
     }
 
@@ -3354,6 +3575,24 @@ class PStringOptions : public PStringToString
    patterns in strings. The regular expression string is "compiled" into a
    form that is more efficient during the matching. This compiled form
    exists for the lifetime of the PRegularExpression instance.
+
+   Compiled patterns are kept in a process wide cache, keyed on the pattern
+   and options, so constructing or copying a PRegularExpression for a pattern
+   that has been used before does not compile it again.
+
+   There are two matching engines. Unless the <code>Backtracking</code>
+   option is used, patterns are executed by an engine that guarantees time
+   linear in the length of the string being searched. This simulates a
+   Thompson NFA, using a lazily built DFA with a bounded state cache for
+   finding the extent of a match. The backtracking engine of the POSIX
+   regcomp()/regexec() functions is used only when that option is set, or
+   the pattern uses features the linear engine does not support, e.g. back
+   references or GNU extensions such as "\w".
+
+   The two engines find the same overall match, the leftmost and longest, as
+   POSIX requires. For ambiguous patterns, e.g. "(a|ab)(c|bcd)", the linear
+   engine may report different sub-expression positions, as it gives
+   priority to the earlier alternative rather than the longer.
  */
 class PRegularExpression : public PObject
 {
@@ -3363,14 +3602,16 @@ class PRegularExpression : public PObject
   //@{
     /// Flags for compiler options.
     P_DECLARE_BITWISE_ENUM(
-      CompileOptions, 3,
+      CompileOptions, 4,
       (
         Simple,         ///< No options, simple regex
         Extended,       ///< Use extended regular expressions
         IgnoreCase,     ///< Ignore case in search.
-        AnchorNewLine   /**< If this bit is set, then anchors do not match at
+        AnchorNewLine,  /**< If this bit is set, then anchors do not match at
                               newline characters in the string. If not set,
                               then anchors do match at newlines. */
+        Backtracking    /**< Always use the POSIX backtracking engine, for
+                             its sub-expression semantics. */
       )
     );
 
@@ -3497,6 +3738,9 @@ class PRegularExpression : public PObject
 
     /** Return the string which represents the pattern matched by the regular expression. */
     const PString & GetPattern() const { return m_pattern; }
+
+    /** Indicate the pattern is executed by the linear time engine. */
+    bool IsLinearTime() const;
   //@}
 
   /**@name Compile & Execute functions */
@@ -3607,6 +3851,21 @@ class PRegularExpression : public PObject
       PStringArray & substring,     ///< Array of matched substrings
       ExecOptions options = Normal  ///< Pattern match options
     ) const;
+
+    /** Determine if the whole string matches the pattern. */
+    bool Matches(
+      const PString & str,          ///< Source string to match
+      ExecOptions options = Normal  ///< Pattern match options
+    ) const { return Matches((const char *)str, options); }
+    /**Determine if the whole string matches the pattern.
+       This is equivalent to Execute() returning a match starting at zero
+       with the length of the string, but the linear time engine can give
+       up as soon as no match is possible.
+      */
+    bool Matches(
+      const char * cstr,            ///< Source string to match
+      ExecOptions options = Normal  ///< Pattern match options
+    ) const;
   //@}
 
   /**@name Miscellaneous functions */
@@ -3620,16 +3879,104 @@ class PRegularExpression : public PObject
     static PString EscapeString(
       const PString & str     ///< String to add esacpes to.
     );
+
+    /**Set the maximum number of compiled patterns in the process wide cache.
+       Patterns still in use by a PRegularExpression instance are not
+       removed, so the cache may temporarily exceed this size.
+      */
+    static void SetMaxCacheSize(
+      PINDEX size   ///< Maximum number of patterns
+    );
   //@}
 
   protected:
     bool InternalCompile(bool assertOnFail);
     void InternalClean();
 
+    class Compiled;
+
     PString            m_pattern;
     CompileOptions     m_compileOptions;
-    void             * m_compiledRegex;
+    Compiled         * m_compiled;
     mutable ErrorCodes m_lastError;
+
+  friend class PRegularExpressionSet;
+};
+
+
+/**A set of regular expressions matched against a string at once.
+   This is intended for things like dial plans, where a string is to be
+   checked against many patterns. All of the patterns executed by the linear
+   time engine are combined, so the string is scanned only once, no matter
+   how many patterns are in the set.
+
+   Note that patterns should all be added before the set is used, Add() and
+   RemoveAll() are not thread safe with respect to Execute(). Execute() may
+   be used from any number of threads simultaneously.
+ */
+class PRegularExpressionSet : public PObject
+{
+    PCLASSINFO(PRegularExpressionSet, PObject);
+  public:
+    /// Create an empty set of regular expressions.
+    PRegularExpressionSet();
+
+    /// Release storage for the compiled regular expressions.
+    ~PRegularExpressionSet();
+
+    /**Add a pattern to the set.
+       @return index of the pattern in the set, or P_MAX_INDEX if the
+               pattern did not compile.
+      */
+    PINDEX Add(
+      const PString & pattern,    ///< Pattern to compile
+      PRegularExpression::CompileOptions options = PRegularExpression::IgnoreCase ///< Pattern match options
+    );
+
+    /// Remove all patterns from the set.
+    void RemoveAll();
+
+    /// Get the number of patterns in the set.
+    PINDEX GetSize() const { return (PINDEX)m_patterns.size(); }
+
+    /// Get the regular expression at the index.
+    const PRegularExpression & operator[](PINDEX index) const { return *m_patterns[index]; }
+
+    /** Find all the patterns that match the string. */
+    bool Execute(
+      const PString & str,            ///< Source string to search
+      std::vector<PINDEX> & matches,  ///< Indexes of patterns that matched
+      PRegularExpression::ExecOptions options = PRegularExpression::Normal ///< Pattern match options
+    ) const { return Execute((const char *)str, matches, options); }
+    /**Find all the patterns that match the string.
+       Each pattern is matched as for PRegularExpression::Execute(), i.e. the
+       match may be anywhere in the string unless anchored with "^" and "$".
+
+       @return true if at least one pattern matched.
+      */
+    bool Execute(
+      const char * cstr,              ///< Source string to search
+      std::vector<PINDEX> & matches,  ///< Indexes of patterns that matched, in order
+      PRegularExpression::ExecOptions options = PRegularExpression::Normal ///< Pattern match options
+    ) const;
+
+    /**Find the first pattern, in the order added, that matches the string.
+       @return index of the pattern, or P_MAX_INDEX if none matched.
+      */
+    PINDEX FindFirst(
+      const PString & str,            ///< Source string to search
+      PRegularExpression::ExecOptions options = PRegularExpression::Normal ///< Pattern match options
+    ) const;
+
+  protected:
+    class Combined;
+
+    std::vector<PRegularExpression *> m_patterns;
+    Combined                        * m_combined;
+
+  private:
+    PRegularExpressionSet(const PRegularExpressionSet &) { }
+    void operator=(const PRegularExpressionSet &) { }
 };
 
 
@@ -317,6 +317,7 @@ class PReadWriteMutex : public PObject, public PMutexExcessiveLockInfo
     virtual void PrintOn(ostream &strm) const;
 
   protected:
+    void Construct();
     void InternalStartRead(const PDebugLocation * location);
     void InternalEndRead(const PDebugLocation * location);
     void InternalStartWrite(const PDebugLocation * location);
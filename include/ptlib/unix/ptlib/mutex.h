@@ -34,8 +34,12 @@
   public:
     static void InitialiseRecursiveMutex(pthread_mutex_t *mutex);
   protected:
+#if P_FUTEX_MUTEX
+    mutable PFutexMutex m_mutex;
+#else
     mutable pthread_mutex_t m_mutex;
 #endif
+#endif
 
 
 // End Of File ////////////////////////////////////////////////////////////////
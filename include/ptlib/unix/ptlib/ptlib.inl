@@ -104,7 +104,36 @@ PINLINE PThreadIdentifier PThread::GetCurrentThreadId() { return 0; }
 ///////////////////////////////////////////////////////////////////////////////
 // PCriticalSection
 
-#if defined(P_PTHREADS) || defined(VX_TASKS)
+#if P_FUTEX_MUTEX
+
+PINLINE PCriticalSection::PCriticalSection()
+{
+}
+
+PINLINE PCriticalSection::PCriticalSection(const PCriticalSection &)
+{
+}
+
+PINLINE PCriticalSection::~PCriticalSection()
+{
+}
+
+PINLINE void PCriticalSection::Wait()
+{
+  m_mutex.Wait();
+}
+
+PINLINE void PCriticalSection::Signal()
+{
+  m_mutex.Signal();
+}
+
+PINLINE bool PCriticalSection::Try()
+{
+  return m_mutex.Try();
+}
+
+#elif defined(P_PTHREADS) || defined(VX_TASKS)
 
 PINLINE PCriticalSection::PCriticalSection()
 {
@@ -133,7 +162,7 @@ PINLINE void PCriticalSection::Signal()
 
 PINLINE bool PCriticalSection::Try()
 {
-  return ::pthread_mutex_trylock(&m_mutex) != 0;
+  return ::pthread_mutex_trylock(&m_mutex) == 0;
 }
 
 #endif
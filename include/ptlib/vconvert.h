@@ -40,6 +40,7 @@
 #include <ptlib/videoio.h>
 
 struct jdec_private;
+template <class Work_T> class PQueuedThreadPool;
 
 
 /**This class contains a pair of colour formats for conversion.
@@ -365,6 +366,164 @@ PBoolean cls::Convert(const BYTE *srcFrameBuffer, BYTE *dstFrameBuffer, PINDEX *
 
 
 
+/**Compositor for multi-participant, continuous presence, video layouts.
+   A layout is a set of tiles on a YUV420P canvas, each tile displaying a
+   source frame, cropped and scaled as required, with an optional border.
+
+   When Compose() is called, only the tiles whose source changed since the
+   last call are redrawn, each tile being a separate job executed in
+   parallel on a thread pool. The scaling parameters for each tile are
+   retained from frame to frame, and only recalculated if the source
+   frame size changes.
+  */
+class PVideoCompositor : public PObject
+{
+    PCLASSINFO(PVideoCompositor, PObject);
+  public:
+    /// Description of a tile in the layout
+    struct Tile
+    {
+      Tile(
+        unsigned x = 0,
+        unsigned y = 0,
+        unsigned width = 0,
+        unsigned height = 0,
+        PVideoFrameInfo::ResizeMode resizeMode = PVideoFrameInfo::eScaleKeepAspect
+      );
+
+      unsigned m_x;           ///< Position of tile on canvas
+      unsigned m_y;           ///< Position of tile on canvas
+      unsigned m_width;       ///< Size of tile on canvas
+      unsigned m_height;      ///< Size of tile on canvas
+      unsigned m_cropX;       ///< Area of source frame to use
+      unsigned m_cropY;       ///< Area of source frame to use
+      unsigned m_cropWidth;   ///< Area of source frame to use, zero is whole frame
+      unsigned m_cropHeight;  ///< Area of source frame to use, zero is whole frame
+      PVideoFrameInfo::ResizeMode m_resizeMode; ///< How source is fitted to tile
+      unsigned m_border;      ///< Width of border, inside the tile area
+      BYTE     m_borderRed;   ///< Colour of border
+      BYTE     m_borderGreen; ///< Colour of border
+      BYTE     m_borderBlue;  ///< Colour of border
+    };
+    typedef std::vector<Tile> Layout;
+
+    /**Create a compositor.
+       A @a threads value of zero uses one thread per processor, one does all
+       composition on the thread calling Compose().
+      */
+    PVideoCompositor(
+      unsigned width = PVideoFrameInfo::CIFWidth,   ///< Width of canvas
+      unsigned height = PVideoFrameInfo::CIFHeight, ///< Height of canvas
+      unsigned threads = 0                          ///< Number of threads to use
+    );
+
+    /// Destroy the compositor
+    ~PVideoCompositor();
+
+    /**Set the size of the canvas.
+       All tiles are redrawn on next Compose().
+      */
+    bool SetCanvasSize(
+      unsigned width,   ///< Width of canvas
+      unsigned height   ///< Height of canvas
+    );
+
+    /// Get the width of the canvas
+    unsigned GetCanvasWidth() const { return m_width; }
+
+    /// Get the height of the canvas
+    unsigned GetCanvasHeight() const { return m_height; }
+
+    /**Set the background colour, used where there is no tile, or a tile has
+       no source. All tiles are redrawn on next Compose().
+      */
+    void SetBackground(
+      BYTE red,
+      BYTE green,
+      BYTE blue
+    );
+
+    /**Set the layout.
+       Tile positions and sizes are rounded to even values, as required by
+       YUV420P. Any sources previously set are kept for tiles still present.
+       Tiles may not overlap, as they are drawn independently and in parallel.
+       @return false if a tile is outside the canvas or overlaps another.
+      */
+    bool SetLayout(
+      const Layout & layout   ///< New layout
+    );
+
+    /// Get the current layout
+    const Layout & GetLayout() const { return m_layout; }
+
+    /**Create a simple grid layout.
+      */
+    static Layout MakeGrid(
+      unsigned columns,     ///< Number of tiles across
+      unsigned rows,        ///< Number of tiles down
+      unsigned width,       ///< Width of canvas
+      unsigned height,      ///< Height of canvas
+      unsigned border = 0,  ///< Width of border around each tile
+      PVideoFrameInfo::ResizeMode resizeMode = PVideoFrameInfo::eScaleKeepAspect ///< Tile resize mode
+    );
+
+    /**Set the number of threads used to compose.
+       This includes the thread calling Compose(), which draws its share of
+       the changed tiles.
+      */
+    void SetThreads(
+      unsigned threads      ///< Number of threads, zero is one per processor
+    );
+
+    /**Set the source frame for a tile.
+       The YUV420P frame is copied, and the tile will be redrawn on the next
+       call to Compose().
+      */
+    bool SetSource(
+      PINDEX tile,          ///< Index of tile in layout
+      const BYTE * yuv,     ///< YUV420P frame
+      unsigned width,       ///< Width of frame
+      unsigned height       ///< Height of frame
+    );
+
+    /**Remove the source frame for a tile, it is drawn as background.
+      */
+    bool ClearSource(
+      PINDEX tile           ///< Index of tile in layout
+    );
+
+    /**Redraw all the tiles that have changed since the last call.
+       @return number of tiles redrawn.
+      */
+    PINDEX Compose();
+
+    /**Get the composed canvas, in YUV420P format.
+      */
+    const BYTE * GetCanvas() const { return m_canvas; }
+
+    /**Get the size in bytes of the composed canvas.
+      */
+    PINDEX GetCanvasBytes() const { return m_canvas.GetSize(); }
+
+  protected:
+    struct TileState;
+    struct TileWork;
+
+    void InternalDrawTile(TileState & tile);
+
+    unsigned                    m_width;
+    unsigned                    m_height;
+    BYTE                        m_background[3];
+    unsigned                    m_threads;
+    Layout                      m_layout;
+    std::vector<TileState *>    m_tiles;
+    bool                        m_redrawAll;
+    PBYTEArray                  m_canvas;
+    PQueuedThreadPool<TileWork> * m_pool;
+    PDECLARE_MUTEX(m_mutex);
+};
+
+
 #if P_JPEG_DECODER
 
 /**Class to convert a JPEG image to other formats.
@@ -419,6 +578,19 @@ class PJPEGConverter : public PColourConverter
       PINDEX * bytesReturned = NULL ///< Bytes written to dstFrameBuffer
     );
 
+    /** Set the number of threads used to decode a single JPEG image.
+        A JPEG with restart markers may have each restart interval decoded
+        in parallel. A value of zero uses one thread per processor, the
+        default of one decodes sequentially on the calling thread. This is
+        ignored if the underlying decoder does not support it.
+      */
+    void SetDecodeThreads(
+      unsigned threads  ///< Maximum number of threads to use
+    );
+
+    /// Get the number of threads used to decode a single JPEG image.
+    unsigned GetDecodeThreads() const;
+
     /** Load a file and convert to the output format for the converter.
       */
     bool Load(
@@ -196,7 +196,8 @@ ifeq ($(HAS_VIDEO),1)
              $(COMMON_SRC_DIR)/vconvert.cxx \
              $(COMMON_SRC_DIR)/pvidchan.cxx \
              $(COMMON_SRC_DIR)/tinyjpeg.c \
-             $(COMMON_SRC_DIR)/jidctflt.c
+             $(COMMON_SRC_DIR)/jidctflt.c \
+             $(COMMON_SRC_DIR)/jidctint.c
 
   ifeq ($(HAS_SHM_VIDEO),1)
     SOURCES += $(PLATFORM_SRC_DIR)/shmvideo.cxx
@@ -220,7 +221,8 @@ endif # HAS_VIDEO
 ## Note this is mostly handled by the plugin system
 ifeq ($(HAS_AUDIO),1)
 
-  SOURCES += $(COMMON_SRC_DIR)/sound.cxx 
+  SOURCES += $(COMMON_SRC_DIR)/sound.cxx \
+             $(COMPONENT_SRC_DIR)/audiomix.cxx
 
   ifeq ($(target_os),mingw)
     SOURCES += $(PLATFORM_SRC_DIR)/sound_win32.cxx
@@ -283,6 +285,7 @@ endif
 
 ifeq ($(HAS_ASN),1)
   SOURCES += $(COMPONENT_SRC_DIR)/asner.cxx \
+             $(COMPONENT_SRC_DIR)/asntable.cxx \
              $(COMPONENT_SRC_DIR)/pasn.cxx 
 endif
 
@@ -291,7 +294,9 @@ ifeq ($(HAS_SNMP),1)
              $(COMPONENT_SRC_DIR)/snmpserv.cxx \
              $(COMPONENT_SRC_DIR)/psnmp.cxx \
              $(COMPONENT_SRC_DIR)/snmp.cxx \
-             $(COMPONENT_SRC_DIR)/rfc1155.cxx 
+             $(COMPONENT_SRC_DIR)/snmp_tab.cxx \
+             $(COMPONENT_SRC_DIR)/rfc1155.cxx \
+             $(COMPONENT_SRC_DIR)/rfc1155_tab.cxx 
 endif
 
 ifeq ($(HAS_FTP),1)
@@ -482,6 +487,7 @@ SOURCES	+= \
 	$(COMPONENT_SRC_DIR)/threadpool.cxx \
 	$(COMPONENT_SRC_DIR)/random.cxx \
 	$(COMPONENT_SRC_DIR)/notifier_ext.cxx \
+	$(COMPONENT_SRC_DIR)/filecache.cxx \
 	$(COMMON_SRC_DIR)/safecoll.cxx \
 	$(COMMON_SRC_DIR)/ptime.cxx \
 	$(GETDATE_SOURCE) \
@@ -489,6 +495,9 @@ SOURCES	+= \
 	$(PLATFORM_SRC_DIR)/assert.cxx \
 	$(COMMON_SRC_DIR)/collect.cxx \
 	$(COMMON_SRC_DIR)/contain.cxx \
+	$(COMMON_SRC_DIR)/pregex.cxx \
+	$(COMMON_SRC_DIR)/slaballoc.cxx \
+	$(COMMON_SRC_DIR)/histogram.cxx \
 	$(COMMON_SRC_DIR)/object.cxx   # must be last module
 
 ifneq ($(HAS_REGEX),1)
@@ -0,0 +1,35 @@
+/*
+ * revision.h 
+ *
+ * GIT commit string header file for PTLib
+ *
+ * Copyright (c) 2010-2016 Equivalence Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Windows Library.
+ * Subsequenty renamed to Portalble Tools Library
+ *
+ * The Initial Developer of the Original Code is Equivalence Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifndef _PTLib_REVISION_H
+#define _PTLib_REVISION_H
+
+#define SVN_REVISION 0
+#define GIT_COMMIT "0ec37f8198cafb46276129a2559bd8309d0ab603"
+
+#endif  // _PTLib_REVISION_H
+
+
+// End of File ///////////////////////////////////////////////////////////////
@@ -67,6 +67,13 @@ ThreadSafe::ThreadSafe()
   threadCount = 0;
   totalObjects = 0;
   currentObjects = 0;
+  test4Iterations = 0;
+  test5Lock = Test5CriticalSection;
+  test5Iterations = 0;
+  test5Work = 0;
+  test5Counter = 0;
+  for (PINDEX i = 0; i < Test4Slots; i++)
+    test4Slots[i] = NULL;
 }
 
 
@@ -85,7 +92,14 @@ void ThreadSafe::Usage()
        << "-1 (or --test1) carry out test 1" << endl
        << "-2 (or --test2) carry out test 2" << endl
        << "-3 (or --test3) carry out test 3" << endl 
-       << "The number field is optional, and specifies the number of threads for test 1" << endl
+       << "-4 (or --test4) carry out test 4, small object allocator stress" << endl
+       << "-5 (or --test5) carry out test 5, mutex contention benchmark" << endl
+       << "-6 (or --test6) carry out test 6, sampled heap tracking and allocation sites" << endl
+       << "-c (or --contention) profile lock contention during the test" << endl
+       << "The number field is optional, and specifies the number of threads for test 1, 4 & 5" << endl
+       << "A second number field is the number of iterations per thread for test 4 & 5" << endl
+       << "For test 6 the number field is the sample interval in bytes" << endl
+       << "A third number field is the work done inside and outside the lock for test 5" << endl
        << endl;
   return;
 }
@@ -103,7 +117,11 @@ void ThreadSafe::Main()
 #endif
              "1-test1."       "-no-test1."
              "2-test2."       "-no-test2."
-             "3-test3."       "-no-test3.");
+             "3-test3."       "-no-test3."
+             "4-test4."       "-no-test4."
+             "5-test5."       "-no-test5."
+             "6-test6."       "-no-test6."
+             "c-contention."  "-no-contention.");
 
 #if PTRACING
   PTrace::Initialise(args.GetOptionCount('t'),
@@ -111,14 +129,26 @@ void ThreadSafe::Main()
                      PTrace::Blocks | PTrace::Timestamp | PTrace::Thread | PTrace::FileAndLine);
 #endif
 
+  if (args.HasOption('c'))
+    PMutexContention::SetEnabled(true);
+
   if (args.HasOption('1'))
     Test1(args);
   else if (args.HasOption('2'))
     Test2(args);
   else if (args.HasOption('3'))
     Test3(args);
+  else if (args.HasOption('4'))
+    Test4(args);
+  else if (args.HasOption('5'))
+    Test5(args);
+  else if (args.HasOption('6'))
+    Test6(args);
   else
     Usage();
+
+  if (args.HasOption('c'))
+    PMutexContention::PrintOn(cout);
 }
 
 
@@ -414,4 +444,213 @@ void ThreadSafe::Test3Thread2(PThread &, INT)
 }
 
 
+void ThreadSafe::Test4(PArgList & args)
+{
+  PINDEX threads = args.GetCount() > 0 ? args[0].AsUnsigned() : 64;
+  test4Iterations = args.GetCount() > 1 ? args[1].AsUnsigned() : 100000;
+
+  cout << "Starting " << threads << " threads, " << test4Iterations << " iterations each." << endl;
+
+  PTime start;
+
+  std::vector<PThread *> running;
+  for (PINDEX i = 0; i < threads; i++)
+    running.push_back(PThread::Create(PCREATE_NOTIFIER(Test4Thread), (INT)i, PThread::NoAutoDeleteThread));
+  for (PINDEX i = 0; i < threads; i++) {
+    running[i]->WaitForTermination();
+    delete running[i];
+  }
+
+  PTimeInterval elapsed = PTime() - start;
+
+  for (PINDEX i = 0; i < Test4Slots; i++)
+    delete test4Slots[i].exchange(NULL);
+
+  cout << "Elapsed " << elapsed << " seconds, "
+       << (unsigned)(threads*test4Iterations*1000.0/elapsed.GetMilliSeconds()) << " iterations/second" << endl;
+
+#if !P_GNU_ALLOCATOR && P_SLAB_ALLOCATOR && !PMEMORY_HEAP
+  PSlabAllocator::PrintStatistics(cout);
+#endif
+}
+
+
+void ThreadSafe::Test4Thread(PThread &, INT id)
+{
+  unsigned seed = id;
+
+  for (unsigned i = 0; i < test4Iterations; i++) {
+    // Short lived objects, allocated and freed on this thread
+    PStringList list;
+    for (unsigned j = 0; j < 4; j++)
+      list.AppendString(PString(i+j));
+
+    PStringToString dict;
+    dict.SetAt(list.front(), list.back());
+
+    // Long lived object, usually freed by some other thread
+    seed = seed*1103515245 + 12345;
+    delete test4Slots[(seed >> 16)%Test4Slots].exchange(new PString(list.front()));
+  }
+}
+
+
+void ThreadSafe::Test5(PArgList & args)
+{
+  PINDEX threads = args.GetCount() > 0 ? args[0].AsUnsigned() : 8;
+  test5Iterations = args.GetCount() > 1 ? args[1].AsUnsigned() : 1000000;
+  test5Work = args.GetCount() > 2 ? args[2].AsUnsigned() : 10;
+
+  cout << "Starting " << threads << " threads, " << test5Iterations << " iterations each, "
+       << test5Work << " work units inside and outside the lock, using "
+#if P_FUTEX_MUTEX > 1
+          "futex mutexes with handoff"
+#elif P_FUTEX_MUTEX
+          "futex mutexes"
+#else
+          "platform mutexes"
+#endif
+       << '.' << endl;
+
+  static const char * const LockNames[NumTest5Locks] = { "PCriticalSection", "PTimedMutex", "PSafeObject" };
+  for (int lock = 0; lock < NumTest5Locks; ++lock) {
+    test5Lock = (Test5Locks)lock;
+    test5Counter = 0;
+    test5Finish.assign(threads, 0);
+    test5Start = PTimer::Tick();
+
+    std::vector<PThread *> running;
+    for (PINDEX i = 0; i < threads; i++)
+      running.push_back(PThread::Create(PCREATE_NOTIFIER(Test5Thread), (INT)i, PThread::NoAutoDeleteThread));
+    for (PINDEX i = 0; i < threads; i++) {
+      running[i]->WaitForTermination();
+      delete running[i];
+    }
+
+    PTimeInterval elapsed = PTimer::Tick() - test5Start;
+    PTimeInterval first = *std::min_element(test5Finish.begin(), test5Finish.end());
+
+    /* If the lock is fair, all the threads get through their iterations at
+       about the same rate, so finish at about the same time. */
+    cout << setw(16) << LockNames[lock] << ": "
+         << (test5Counter == threads*test5Iterations ? "" : "COUNT MISMATCH, ")
+         << "elapsed " << elapsed << "s, "
+         << (unsigned)(threads*test5Iterations*1000.0/std::max(elapsed.GetMilliSeconds(), (PInt64)1)) << " locks/second, "
+         << "first thread finished at " << (unsigned)(first.GetMilliSeconds()*100/std::max(elapsed.GetMilliSeconds(), (PInt64)1))
+         << '%' << endl;
+  }
+}
+
+
+template <class Lock> void ThreadSafe::Test5Loop(Lock & lock)
+{
+  unsigned outside = 0;
+  for (unsigned i = 0; i < test5Iterations; i++) {
+    lock.Wait();
+    unsigned inside = test5Counter++;
+    for (unsigned w = 0; w < test5Work; w++)
+      inside = inside*1103515245 + 12345;
+    lock.Signal();
+
+    for (unsigned w = 0; w < test5Work; w++)
+      outside = outside*1103515245 + inside;
+  }
+
+  if (outside == 1)
+    cout << ' ' << flush; // Prevent optimiser removing the work
+}
+
+
+void ThreadSafe::Test5Thread(PThread &, INT id)
+{
+  switch (test5Lock) {
+    case Test5CriticalSection :
+      Test5Loop(test5CriticalSection);
+      break;
+
+    case Test5TimedMutex :
+      Test5Loop(test5TimedMutex);
+      break;
+
+    default : {
+      struct SafeObjectLock {
+        PSafeObject & m_object;
+        SafeObjectLock(PSafeObject & obj) : m_object(obj) { }
+        void Wait() { m_object.LockReadWrite(); }
+        void Signal() { m_object.UnlockReadWrite(); }
+      } safeLock(test5SafeObject);
+      Test5Loop(safeLock);
+    }
+  }
+
+  test5Finish[id] = PTimer::Tick() - test5Start;
+}
+
+
+void ThreadSafe::Test6(PArgList & args)
+{
+#if PMEMORY_CHECK
+  size_t interval = args.GetCount() > 0 ? args[0].AsUnsigned() : 4096;
+  static const unsigned Blocks = 20000;
+
+  cout << "Sampling one block per " << interval << " bytes, " << Blocks << " blocks." << endl;
+  size_t oldInterval = PMemoryHeap::SetSampleInterval(interval);
+
+  // Every block from one site, half grown by realloc() which moves sampled blocks in the list
+  static const int AllocLine = __LINE__ + 3;
+  std::vector<void *> blocks(Blocks);
+  for (unsigned i = 0; i < Blocks; ++i) {
+    blocks[i] = PMemoryHeap::Allocate(100, __FILE__, AllocLine, "Test6");
+    if (i%2 != 0)
+      blocks[i] = PMemoryHeap::Reallocate(blocks[i], 200, __FILE__, AllocLine, "Test6");
+  }
+
+  bool ok = PMemoryHeap::ValidateHeap(&cout);
+
+  // Free three quarters, the site should show about a quarter still live
+  for (unsigned i = 0; i < Blocks*3/4; ++i)
+    PMemoryHeap::Deallocate(blocks[i], "Test6");
+
+  ok = PMemoryHeap::ValidateHeap(&cout) && ok;
+
+  PStringStream sites;
+  PMemoryHeap::DumpAllocationSites(sites, 5);
+  cout << sites;
+
+  // Find our site and check the estimates are within reason, sampling is random
+  PINDEX pos = sites.Find(psprintf("%s(%u)", __FILE__, AllocLine));
+  if (pos == P_MAX_INDEX) {
+    cout << "Allocation site not found" << endl;
+    ok = false;
+  }
+  else {
+    PINDEX lineStart = sites.FindLast('\n', pos);
+    PStringArray fields = sites(lineStart == P_MAX_INDEX ? 0 : lineStart+1, pos-1).Tokenise(" ", false);
+    if (fields.GetSize() < 4)
+      ok = false;
+    else {
+      PInt64 liveObjects = fields[1].AsInt64();
+      PInt64 allocations = fields[3].AsInt64();
+      cout << "Estimated " << allocations << " allocations, " << liveObjects << " live" << endl;
+      // Reallocations count as allocations at the same site
+      if (allocations < Blocks/2 || allocations > Blocks*3 || liveObjects < Blocks/8 || liveObjects > Blocks/2)
+        ok = false;
+    }
+  }
+
+  if (sites.Find("untracked sites") != P_MAX_INDEX)
+    ok = false;
+
+  for (unsigned i = Blocks*3/4; i < Blocks; ++i)
+    PMemoryHeap::Deallocate(blocks[i], "Test6");
+
+  PMemoryHeap::SetSampleInterval(oldInterval);
+
+  cout << "Heap sampling test " << (ok ? "passed" : "FAILED") << endl;
+#else
+  cout << "Memory checking not enabled, configure with --enable-memcheck" << endl;
+#endif
+}
+
+
 // End of File ///////////////////////////////////////////////////////////////
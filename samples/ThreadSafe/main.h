@@ -13,6 +13,8 @@
 #include <ptlib/pprocess.h>
 #include <ptlib/safecoll.h>
 
+#include <atomic>
+
 
 class ThreadSafe;
 
@@ -56,6 +58,15 @@ class ThreadSafe : public PProcess
     PDECLARE_NOTIFIER(PThread, ThreadSafe, Test3Thread1);
     PDECLARE_NOTIFIER(PThread, ThreadSafe, Test3Thread2);
 
+    void Test4(PArgList & args);
+    PDECLARE_NOTIFIER(PThread, ThreadSafe, Test4Thread);
+
+    void Test5(PArgList & args);
+    PDECLARE_NOTIFIER(PThread, ThreadSafe, Test5Thread);
+    template <class Lock> void Test5Loop(Lock & lock);
+
+    void Test6(PArgList & args);
+
     PSafeList<TestObject> unsorted;
     PSafeSortedList<TestObject> sorted;
     PSafeDictionary<POrdinalKey, TestObject> sparse;
@@ -66,6 +77,26 @@ class ThreadSafe : public PProcess
     unsigned      totalObjects;
     unsigned      currentObjects;
 
+    enum { Test4Slots = 256 };
+    unsigned                test4Iterations;
+    std::atomic<PString *>  test4Slots[Test4Slots];
+
+    enum Test5Locks {
+      Test5CriticalSection,
+      Test5TimedMutex,
+      Test5SafeObject,
+      NumTest5Locks
+    };
+    Test5Locks               test5Lock;
+    unsigned                 test5Iterations;
+    unsigned                 test5Work;
+    unsigned                 test5Counter;
+    PCriticalSection         test5CriticalSection;
+    PTimedMutex              test5TimedMutex;
+    PSafeObject              test5SafeObject;
+    PTimeInterval            test5Start;
+    std::vector<PTimeInterval> test5Finish;
+
   friend class TestObject;
 };
 
@@ -19,6 +19,8 @@
 #include <ptlib/sound.h>
 #include <ptclib/cli.h>
 #include <ptclib/qchannel.h>
+#include <ptclib/audiomix.h>
+#include <math.h>
 
 
 // -tttttodebugstream -v 10 -r "Tones:425x25:5/400+450:0.4-0.2-0.4-2-0.4-0.2-0.4-2-0.4-0.2-0.4-2-0.4-0.2-0.4-2-0.4-0.2-0.4-2"
@@ -37,6 +39,9 @@ class AudioTest : public PProcess
     void Main();
 
   private:
+    void MixBenchmark(const PArgList & args);
+    void MixTest(const PArgList & args);
+
     PDECLARE_NOTIFIER(PCLI::Arguments, AudioTest, RecordVolume);
     PDECLARE_NOTIFIER(PCLI::Arguments, AudioTest, PlayerVolume);
     PDECLARE_NOTIFIER(PCLI::Arguments, AudioTest, Statistics);
@@ -122,11 +127,14 @@ void AudioTest::Main()
              "-player-buffer-count: set play back buffer size (default 8)\n"
              "-test-player. perform standard player test\n"
              "-test-recorder. perform standard recorder test\n"
+             "-mix-bench: benchmark mixer with number of participants, e.g. 10,100,1000\n"
+             "-mix-test: run mixer for seconds, arguments are WAV files for participants\n"
+             "-mix-output: prefix for WAV files of mixer output, default is null device\n"
              PTRACE_ARGLIST
              "h-help. help");
 
   if (!args.IsParsed() || args.HasOption('h')) {
-    args.Usage(cerr, "[options]");
+    args.Usage(cerr, "[options] [ wav-file ... ]");
     return;
   }
 
@@ -170,6 +178,16 @@ void AudioTest::Main()
     return;
   }
 
+  if (args.HasOption("mix-bench")) {
+    MixBenchmark(args);
+    return;
+  }
+
+  if (args.HasOption("mix-test")) {
+    MixTest(args);
+    return;
+  }
+
   if (!m_recorder.OpenSoundChannel(PSoundChannel::Recorder, args, 'R', 'r', 'V', "record-buffer-size", "record-buffer-count", "2"))
     return;
 
@@ -404,6 +422,107 @@ void AudioTest::AudioInfo::DisplayStatistics()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+void AudioTest::MixBenchmark(const PArgList & args)
+{
+  unsigned sampleRate = args.GetOptionString('s', "8000").AsUnsigned();
+  PStringArray counts = args.GetOptionString("mix-bench").Tokenise(",");
+
+  for (PINDEX c = 0; c < counts.GetSize(); ++c) {
+    unsigned participants = counts[c].AsUnsigned();
+    if (participants == 0)
+      continue;
+
+    PAudioMixer mixer(sampleRate);
+    PINDEX periodSamples = mixer.GetPeriodSamples();
+
+    // Each participant gets a different tone
+    std::vector<PString> ids(participants);
+    std::vector< std::vector<short> > audio(participants);
+    for (unsigned p = 0; p < participants; ++p) {
+      ids[p] = psprintf("P%u", p);
+      mixer.AddParticipant(ids[p], sampleRate, mixer.GetPeriod());
+      audio[p].resize(periodSamples);
+      for (PINDEX i = 0; i < periodSamples; ++i)
+        audio[p][i] = (short)(4000*sin(2*M_PI*(200+p*10)*i/sampleRate));
+    }
+
+    // Prime the jitter buffers
+    for (unsigned p = 0; p < participants; ++p)
+      mixer.WriteAudio(ids[p], audio[p].data(), periodSamples*sizeof(short));
+
+    static const unsigned Periods = 500;
+    PTimeInterval start = PTimer::Tick();
+    for (unsigned period = 0; period < Periods; ++period) {
+      for (unsigned p = 0; p < participants; ++p)
+        mixer.WriteAudio(ids[p], audio[p].data(), periodSamples*sizeof(short));
+      mixer.MixPeriod();
+    }
+    PTimeInterval duration = PTimer::Tick() - start;
+
+    double msPerPeriod = duration.GetMilliSeconds()/(double)Periods;
+    cout << participants << " participants: " << msPerPeriod << "ms per " << mixer.GetPeriod() << "ms period, ";
+    if (msPerPeriod > 0)
+      cout << (unsigned)(participants*mixer.GetPeriod()/msPerPeriod) << " participants/core";
+    else
+      cout << "too fast to measure";
+    cout << endl;
+  }
+}
+
+
+void AudioTest::MixTest(const PArgList & args)
+{
+  if (args.GetCount() == 0) {
+    cerr << "Need WAV files for mixer input" << endl;
+    return;
+  }
+
+  unsigned sampleRate = args.GetOptionString('s', "8000").AsUnsigned();
+  PString outputPrefix = args.GetOptionString("mix-output");
+
+  PAudioMixer mixer(sampleRate);
+
+  for (PINDEX i = 0; i < args.GetCount(); ++i) {
+    PSoundChannel * recorder = new PSoundChannel;
+    if (!recorder->Open(PSoundChannel::Params(PSoundChannel::Recorder, args[i], "WAVFile", 1, sampleRate, 16))) {
+      cerr << "Could not open WAV file \"" << args[i] << '"' << endl;
+      delete recorder;
+      continue;
+    }
+
+    PSoundChannel * player = new PSoundChannel;
+    bool opened;
+    if (outputPrefix.IsEmpty())
+      opened = player->Open(PSoundChannel::Params(PSoundChannel::Player, "Null", "NullAudio", 1, sampleRate, 16));
+    else
+      opened = player->Open(PSoundChannel::Params(PSoundChannel::Player, psprintf("%s%u.wav", (const char *)outputPrefix, i), "WAVFile", 1, sampleRate, 16));
+    if (!opened) {
+      cerr << "Could not open output for participant " << i << endl;
+      delete recorder;
+      delete player;
+      continue;
+    }
+
+    mixer.AddParticipant(args[i], sampleRate, PAudioMixer::DefaultJitterMS, recorder, player);
+  }
+
+  cout << "Mixing " << mixer.GetParticipants().GetSize() << " participants for "
+       << args.GetOptionString("mix-test") << " seconds." << endl;
+  mixer.Start();
+  PThread::Sleep(args.GetOptionString("mix-test").AsUnsigned()*1000);
+  mixer.Stop();
+
+  PStringArray ids = mixer.GetParticipants();
+  for (PINDEX i = 0; i < ids.GetSize(); ++i) {
+    PAudioMixer::Statistics stats;
+    if (mixer.GetStatistics(ids[i], stats))
+      cout << ids[i] << ": queued=" << stats.m_queued << ", underruns=" << stats.m_underruns << ", overruns=" << stats.m_overruns << endl;
+  }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /* The comment below is magic for those who use emacs to edit this file. 
@@ -63,6 +63,7 @@ void HTTPTest::Main()
 #endif
              "T-theads:  max number of threads in pool(default 10)\n"
              "Q-queue:   max queue size for listening sockets(default 100).\n"
+             "H-histograms. enable latency histograms, served at /histograms.\n"
              PTRACE_ARGLIST
        );
 
@@ -150,6 +151,12 @@ void HTTPTest::Main()
 
   PHTTPSpace httpNameSpace;
   httpNameSpace.AddResource(new PHTTPString("index.html", "Hello", "text/plain"));
+  httpNameSpace.AddResource(new PHTTPLatencyHistograms("histograms"));
+
+  if (args.HasOption('H')) {
+    PLatencyHistogram::SetDefaultEnabled(true);
+    PLatencyHistogram::SetAllEnabled(true);
+  }
 
   cout << "Listening for "
 #if P_SSL
@@ -9,6 +9,7 @@ class JSONTest : public PProcess
  public:
   JSONTest();
   void Main();
+  void Benchmark(unsigned count);
 };
 
 PCREATE_PROCESS(JSONTest);
@@ -22,6 +23,11 @@ JSONTest::JSONTest()
 void JSONTest::Main()
 {
   PArgList & args = GetArguments();
+  if (args.GetCount() > 0 && args[0] == "-b") {
+    Benchmark(args.GetCount() > 1 ? args[1].AsUnsigned() : 100000);
+    return;
+  }
+
   if (args.GetCount() > 0) {
     PJSON json;
     if (args[0] == "-")
@@ -88,3 +94,45 @@ void JSONTest::Main()
 #endif // P_SSL
 }
 
+
+void JSONTest::Benchmark(unsigned count)
+{
+  PStringStream strm;
+  strm << '[';
+  for (unsigned i = 0; i < count; ++i) {
+    if (i > 0)
+      strm << ',';
+    strm << "{\"id\":" << i << ",\"name\":\"item " << i << "\",\"value\":" << i << ".25,"
+            "\"flag\":true,\"tags\":[\"alpha\",\"beta\\ngamma\"],\"none\":null}";
+  }
+  strm << ']';
+  PString text = strm;
+  cout << "Benchmark on " << text.GetLength() << " bytes of JSON" << endl;
+
+  PTimeInterval start = PTimer::Tick();
+  PJSON json1;
+  PStringStream input(text);
+  input >> json1;
+  cout << "Stream parse: " << PTimer::Tick() - start << 's' << endl;
+
+  start = PTimer::Tick();
+  PJSON json2;
+  json2.FromBuffer(text, text.GetLength());
+  cout << "Buffer parse: " << PTimer::Tick() - start << 's' << endl;
+
+  start = PTimer::Tick();
+  PJSON::Handler nullHandler;
+  PJSON::Parse(text, text.GetLength(), nullHandler);
+  cout << "Event parse:  " << PTimer::Tick() - start << 's' << endl;
+
+  start = PTimer::Tick();
+  PStringStream output1;
+  output1 << json1;
+  cout << "Stream write: " << PTimer::Tick() - start << 's' << endl;
+
+  start = PTimer::Tick();
+  PString output2 = json2.AsString();
+  cout << "Buffer write: " << PTimer::Tick() - start << 's' << endl;
+
+  cout << "Output " << (output1 == output2 ? "identical" : "DIFFERENT") << endl;
+}
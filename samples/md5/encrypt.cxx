@@ -19,6 +19,7 @@ class Md5 : public PProcess
 public:
   Md5();
   void Main();
+  void Base64Benchmark(PINDEX size);
 };
 
 PCREATE_PROCESS(Md5);
@@ -32,14 +33,15 @@ Md5::Md5()
 void Md5::Main()
 {
 
-  PConfigArgs args(GetArguments());
+  PArgList & args = GetArguments();
   args.Parse(
-       "a-first: "
-       "b-second: "
-       "h-help. "
+       "a-first:"
+       "b-second:"
+       "B-base64:"
+       "h-help."
 #if PTRACING
        "o-output:"             "-no-output."
-       "t-trace: "             "-no-trace."
+       "t-trace."              "-no-trace."
 #endif
        , false);
 
@@ -57,6 +59,7 @@ void Md5::Main()
          << endl
          << " -a  --first  ## : specify first string to add to md5" << endl
          << " -b  --second ## : specify second string to add to md5" << endl
+         << " -B  --base64 ## : benchmark base 64 on a block of ## bytes" << endl
          << " -h  --help      : print this help out." << endl
 
 #if PTRACING
@@ -74,6 +77,11 @@ void Md5::Main()
 #endif
 
 
+  if (args.HasOption('B')) {
+    Base64Benchmark(args.GetOptionString('B').AsUnsigned());
+    return;
+  }
+
   PString a = args.GetOptionString('a', "127000151");
   PString b = args.GetOptionString('b', "ebey7" );
 
@@ -99,6 +107,67 @@ void Md5::Main()
 #endif
 
 }
+
+
+void Md5::Base64Benchmark(PINDEX size)
+{
+  PBYTEArray data(size);
+  for (PINDEX i = 0; i < size; ++i)
+    data[i] = (BYTE)(i*7 + (i >> 8));
+
+  unsigned iterations = (unsigned)std::max((PINDEX)1, 100000000/(size+100));
+  cout << "Base64 of " << size << " bytes, x" << iterations << endl;
+
+  // Old style, via the incremental object a chunk at a time
+  PTimeInterval start = PTimer::Tick();
+  PString encoded;
+  for (unsigned i = 0; i < iterations; ++i) {
+    PBase64 base;
+    for (PINDEX pos = 0; pos < size; pos += 1000)
+      base.ProcessEncoding((const BYTE *)data + pos, std::min((PINDEX)1000, size - pos));
+    encoded = base.CompleteEncoding();
+  }
+  cout << "Incremental encode : " << PTimer::Tick() - start << 's' << endl;
+
+  start = PTimer::Tick();
+  for (unsigned i = 0; i < iterations; ++i)
+    encoded = PBase64::Encode(data, PBase64::e_CRLF);
+  cout << "One shot encode    : " << PTimer::Tick() - start << 's' << endl;
+
+  PString buffer;
+  char * ptr = buffer.GetPointerAndSetLength(PBase64::GetEncodedLength(size, PBase64::e_CRLF));
+  start = PTimer::Tick();
+  for (unsigned i = 0; i < iterations; ++i)
+    PBase64::EncodeBlock(data, size, ptr, PBase64::e_CRLF);
+  cout << "Block encode       : " << PTimer::Tick() - start << 's'
+       << (buffer == encoded ? "" : " MISMATCH") << endl;
+
+  PBYTEArray decoded;
+  start = PTimer::Tick();
+  for (unsigned i = 0; i < iterations; ++i) {
+    PBase64 base;
+    base.ProcessDecoding(encoded);
+    decoded = base.GetDecodedData();
+  }
+  cout << "Incremental decode : " << PTimer::Tick() - start << 's'
+       << (decoded == data ? "" : " MISMATCH") << endl;
+
+  start = PTimer::Tick();
+  for (unsigned i = 0; i < iterations; ++i)
+    PBase64::Decode(encoded, decoded);
+  cout << "One shot decode    : " << PTimer::Tick() - start << 's'
+       << (decoded == data ? "" : " MISMATCH") << endl;
+
+  decoded.SetSize(PBase64::GetMaxDecodedLength(encoded.GetLength()));
+  PINDEX length = 0;
+  bool perfect = false;
+  start = PTimer::Tick();
+  for (unsigned i = 0; i < iterations; ++i)
+    length = PBase64::DecodeBlock(encoded, encoded.GetLength(), decoded.GetPointer(), &perfect);
+  cout << "Block decode       : " << PTimer::Tick() - start << 's'
+       << (perfect && length == size && memcmp(decoded, data, size) == 0 ? "" : " MISMATCH") << endl;
+}
+
 // End of encrypt.cxx
 
 /***
@@ -50,19 +50,164 @@ static void TestXML(const PArgList & args, const PString & str)
 }
 
 
+static void PullXML(const PArgList & args, PChannel & channel)
+{
+  PXMLPullParser parser(PXML::NoOptions, args.GetOptionString('e'));
+
+  PStringArray filters = args.GetOptionString('p').Lines();
+  for (PINDEX i = 0; i < filters.GetSize(); ++i)
+    parser.AddSubtreeFilter(filters[i]);
+
+  PXMLPullParser::Event event;
+  while (parser.Next(channel, event)) {
+    cout << setw(event.m_depth*2) << "";
+    switch (event.m_type) {
+      case PXMLPullParser::StartElementEvent :
+        cout << "Start: " << event.m_name;
+        for (PStringToString::iterator it = event.m_attributes.begin(); it != event.m_attributes.end(); ++it)
+          cout << ' ' << it->first << "=\"" << it->second << '"';
+        break;
+      case PXMLPullParser::EndElementEvent :
+        cout << "End: " << event.m_name;
+        break;
+      case PXMLPullParser::TextEvent :
+        cout << "Text: " << event.m_text;
+        break;
+      case PXMLPullParser::SubtreeEvent :
+        cout << "Subtree: " << *event.m_element;
+        delete event.m_element;
+        break;
+    }
+    cout << endl;
+  }
+
+  if (parser.HasError()) {
+    PString error;
+    unsigned col, line;
+    parser.GetErrorInfo(error, col, line);
+    cerr << "Parse error: line " << line << ", col " << col << ", " << error << endl;
+  }
+}
+
+
+static PXML::ValidationInfo const ValueValidation[] = {
+  { PXML::OptionalElementWithBodyMatchingEx, "int",     { "-?[0-9]+" }, 0, 1 },
+  { PXML::OptionalElementWithBodyMatchingEx, "i4",      { "-?[0-9]+" }, 0, 1 },
+  { PXML::OptionalElementWithBodyMatchingEx, "boolean", { "[01]" },     0, 1 },
+  { PXML::OptionalElement,                   "string",  { NULL },       0, 1 },
+  { PXML::OptionalElement,                   "double",  { NULL },       0, 1 },
+  { PXML::EndOfValidationList }
+};
+
+static PXML::ValidationInfo const ParamValidation[] = {
+  { PXML::Subtree, "value", { ValueValidation }, 1, 1 },
+  { PXML::EndOfValidationList }
+};
+
+static PXML::ValidationInfo const ParamsValidation[] = {
+  { PXML::Subtree, "param", { ParamValidation }, 0, 0 },
+  { PXML::EndOfValidationList }
+};
+
+static PXML::ValidationInfo const MethodCallValidation[] = {
+  { PXML::ElementName,                       "methodCall" },
+  { PXML::RequiredElementWithBodyMatchingEx, "methodName", { "[A-Za-z0-9_.:/]+" }, 1, 1 },
+  { PXML::Subtree,                           "params",     { ParamsValidation }, 0, 1 },
+  { PXML::EndOfValidationList }
+};
+
+
+static PString MakeMethodCall(unsigned params, bool valid)
+{
+  PStringStream xml;
+  xml << "<?xml version=\"1.0\"?>\n"
+         "<methodCall>\n"
+         "  <methodName>examples.getStateName</methodName>\n"
+         "  <params>\n";
+  for (unsigned i = 0; i < params; ++i) {
+    // An invalid document has a second value in the first param
+    xml << "    <param><value><i4>" << i << "</i4></value>" << (valid || i > 0 ? "" : "<value/>") << "</param>\n"
+           "    <param><value><string>Parameter " << i << "</string></value></param>\n";
+  }
+  xml << "  </params>\n"
+         "</methodCall>\n";
+  return xml;
+}
+
+
+static void ValidationTest(const PArgList & args)
+{
+  unsigned params = args.GetOptionAs('V', 100);
+  unsigned iterations = args.GetOptionAs('i', 1000);
+
+  PXMLValidator validator(MethodCallValidation);
+  if (!validator.IsCompiled()) {
+    cerr << "Could not compile validator" << endl;
+    return;
+  }
+
+  for (int valid = 1; valid >= 0; --valid) {
+    PString str = MakeMethodCall(params, valid != 0);
+    cout << (valid ? "Valid" : "Invalid") << " XML-RPC call with " << params*2 << " parameters, "
+         << str.GetLength() << " bytes, " << iterations << " iterations" << endl;
+
+    PXML xml;
+    PTime start;
+    for (unsigned i = 0; i < iterations; ++i)
+      xml.Load(str);
+    PTimeInterval loadOnly = PTime() - start;
+    cout << "  Load only:            " << setw(8) << loadOnly << 's' << endl;
+
+    bool ok = false;
+    start.SetCurrentTime();
+    for (unsigned i = 0; i < iterations; ++i)
+      ok = xml.Validate(MethodCallValidation);
+    PTimeInterval interpreted = PTime() - start;
+    cout << "  Validate table:       " << setw(8) << interpreted << "s, " << (ok ? "valid" : "invalid: " + xml.GetErrorString()) << endl;
+
+    start.SetCurrentTime();
+    for (unsigned i = 0; i < iterations; ++i)
+      ok = xml.Validate(validator);
+    PTimeInterval compiled = PTime() - start;
+    cout << "  Validate compiled:    " << setw(8) << compiled << "s, " << (ok ? "valid" : "invalid: " + xml.GetErrorString()) << endl;
+
+    PString error;
+    start.SetCurrentTime();
+    for (unsigned i = 0; i < iterations; ++i)
+      ok = xml.LoadAndValidate(str, validator, error);
+    PTimeInterval whileLoading = PTime() - start;
+    cout << "  Validate during load: " << setw(8) << whileLoading << "s, " << (ok ? "valid" : "invalid: " + xml.GetErrorString()) << endl;
+  }
+}
+
+
 void PxmlTest::Main()
 {
   PArgList & args = GetArguments();
   if (!args.Parse("s-simple.         Simple test\n"
                   "b-billion-laughs. Billion laugh test\n"
                   "e-encoding:       Set encoding character set\n"
+                  "p-pull:           Use pull parser, returning subtrees matching path\n"
+                  "V-validate:       Time validation of XML-RPC call with number of parameters\n"
+                  "i-iterations:     Number of iterations for validation timing\n"
                   PTRACE_ARGLIST
-  ))
-    cerr << args.Usage("[ -e ] -s | -b | { file ... }") << endl;
+  ) && !args.HasOption('V'))
+    cerr << args.Usage("[ -e ] [ -p path ] -s | -b | -V n | { file ... }") << endl;
+  else if (args.HasOption('V'))
+    ValidationTest(args);
   else if (args.HasOption('s'))
     TestXML(args, testXML); 
   else if (args.HasOption('b'))
     TestXML(args, billionLaughs); 
+  else if (args.HasOption('p')) {
+    for (PINDEX i = 0; i < args.GetCount(); ++i) {
+      PFile file;
+      if (file.Open(args[i], PFile::ReadOnly))
+        PullXML(args, file);
+      else
+        cerr << "Could not open file: " << args[i] << " - " << file.GetErrorText() << endl;
+    }
+  }
   else {
     for (PINDEX i = 0; i < args.GetCount(); ++i) {
       PTextFile file;
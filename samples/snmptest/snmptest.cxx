@@ -33,16 +33,22 @@ usage on linux with snmpget:
 snmpget -v1 -c public 127.0.0.1:34500 1.3.6.1.2.1.1.1.0
 
 will print PTLIB_VERSION 
+
+"snmptest -b [count]" instead compares the speed of the generated classes
+and the table driven codec, encoding and decoding a response with count
+variable bindings.
 */
 
 
 
 #include "snmptest.h"
 
+#include <ptclib/snmp_tab.h>
+
 /** Start SNMPServer on 127.0.0.1 port 34500
 */
 MySNMPServer::MySNMPServer()
-  :PSNMPServer(PIPSocket::Address::Address(), 34500)
+  :PSNMPServer(PIPSocket::Address(), 34500)
   ,sys_description(PRFC1155_SimpleSyntax::e_string)
 {
   // Create a PRFC1155_ObjectName and set value
@@ -62,7 +68,8 @@ MySNMPServer::MySNMPServer()
   // else, SNMPServer responds with error (noSuchName).
   // since PSNMPServer::MIB_LocalMatch is virtual, you can change this behaviour
 
-  objList.SetAt(obj_name, (PRFC1155_ObjectSyntax *) &sys_description);
+  m_objList.DisallowDeleteObjects();
+  m_objList.SetAt(obj_name, (PRFC1155_ObjectSyntax *) &sys_description);
 
   PTrace::SetLevel(1);
   PTRACE(1, "SNMPServer\tWaiting for requests");
@@ -112,6 +119,14 @@ PCREATE_PROCESS(SNMPSrv)
 
 void SNMPSrv::Main()
 {
+  PArgList & args = GetArguments();
+  if (args.GetCount() > 0 && args[0] == "-b") {
+    Benchmark(args.GetCount() > 1 ? args[1].AsUnsigned() : 100);
+    return;
+  }
+
+  MySNMPServer srv;
+
   // You can set level to 4 for more debug info
   PTrace::SetLevel(1);
   PThread::Suspend();
@@ -121,3 +136,159 @@ SNMPSrv::SNMPSrv()
 {
 	
 }
+
+
+/* The Message data is ANY, so the table driven codec keeps its complete
+   encoding, and the PDUs are decoded from, and encoded into, it separately. */
+static bool DecodeTableMessage(PSNMP_Message_Value & msg, PSNMP_PDUs_Value & pdus, const PBYTEArray & ber)
+{
+  return PASN_TableCodec::DecodeBER(PSNMP_Message_Descriptor, &msg, ber, ber.GetSize()) &&
+         PASN_TableCodec::DecodeBER(PSNMP_PDUs_Descriptor, &pdus, msg.m_data.GetPointer(), msg.m_data.GetSize());
+}
+
+
+static PINDEX EncodeTableMessage(PSNMP_Message_Value & msg, const PSNMP_PDUs_Value & pdus, PBYTEArray & pduBER, PBYTEArray & ber)
+{
+  msg.m_data.SetValue(pduBER, PASN_TableCodec::EncodeBER(PSNMP_PDUs_Descriptor, &pdus, pduBER));
+  return PASN_TableCodec::EncodeBER(PSNMP_Message_Descriptor, &msg, ber);
+}
+
+
+void SNMPSrv::Benchmark(unsigned count)
+{
+  static const unsigned Iterations = 10000;
+
+  // Build a response with a mix of variable binding types, using the classes
+  PSNMP_Message msg;
+  msg.m_version = 0;
+  msg.m_community = "public";
+  msg.m_pdu.SetTag(PSNMP_PDUs::e_get_response);
+  PSNMP_PDU & pdu = (PSNMP_GetResponse_PDU &)msg.m_pdu;
+  pdu.m_request_id = 1234;
+  pdu.m_variable_bindings.SetSize(count);
+  for (unsigned i = 0; i < count; ++i) {
+    PSNMP_VarBind & bind = pdu.m_variable_bindings[i];
+    bind.m_name.SetValue(psprintf("1.3.6.1.2.1.2.2.1.%u.%u", i%6+1, i));
+    // Nested untagged choices are selected by the tag of the final alternative
+    switch (i%6) {
+      case 0 :
+        bind.m_value.SetTag(PRFC1155_SimpleSyntax::e_number);
+        (PASN_Integer &)((PRFC1155_SimpleSyntax &)bind.m_value).GetObject() = i*1000;
+        break;
+      case 1 :
+        bind.m_value.SetTag(PRFC1155_SimpleSyntax::e_string);
+        (PASN_OctetString &)((PRFC1155_SimpleSyntax &)bind.m_value).GetObject() = psprintf("interface %u", i);
+        break;
+      case 2 :
+        bind.m_value.SetTag(PRFC1155_SimpleSyntax::e_object);
+        ((PASN_ObjectId &)((PRFC1155_SimpleSyntax &)bind.m_value).GetObject()).SetValue("1.3.6.1.4.1.9");
+        break;
+      case 3 :
+        bind.m_value.SetTag(PRFC1155_ApplicationSyntax::e_counter, PASN_Object::ApplicationTagClass);
+        (PRFC1155_Counter &)(PRFC1155_ApplicationSyntax &)bind.m_value = 0x7fff0000 + i;
+        break;
+      case 4 :
+        bind.m_value.SetTag(PRFC1155_ApplicationSyntax::e_ticks, PASN_Object::ApplicationTagClass);
+        (PRFC1155_TimeTicks &)(PRFC1155_ApplicationSyntax &)bind.m_value = i*100;
+        break;
+      default :
+        bind.m_value.SetTag(PRFC1155_NetworkAddress::e_internet, PASN_Object::ApplicationTagClass);
+        (PRFC1155_IpAddress &)(PRFC1155_NetworkAddress &)(PRFC1155_ApplicationSyntax &)bind.m_value =
+                                                  PBYTEArray((const BYTE *)"\x0a\x00\x00\x01", 4);
+    }
+  }
+
+  // As for PSNMPServer, the generated Encode() needs a presized buffer
+  static const PINDEX MaxSize = 65536;
+  PBYTEArray classBER(MaxSize);
+  msg.Encode((PASN_Stream &)classBER);
+  cout << "Message of " << count << " bindings, " << classBER.GetSize() << " bytes BER" << endl;
+
+  // The table driven codec must produce exactly the same bytes
+  PSNMP_Message_Value value = PSNMP_Message_Value();
+  PSNMP_PDUs_Value pdus = PSNMP_PDUs_Value();
+  if (!DecodeTableMessage(value, pdus, classBER)) {
+    cout << "Table decode of BER failed" << endl;
+    return;
+  }
+
+  PBYTEArray tableBER, pduBER;
+  PINDEX length = EncodeTableMessage(value, pdus, pduBER, tableBER);
+  if (length != classBER.GetSize() || memcmp(tableBER, classBER, length) != 0) {
+    cout << "Table BER encoding differs from classes" << endl;
+    return;
+  }
+  cout << "Table BER encoding identical to classes" << endl;
+
+  PTimeInterval start = PTimer::Tick();
+  for (unsigned i = 0; i < Iterations; ++i) {
+    PBER_Stream strm(classBER);
+    PSNMP_Message decoded;
+    decoded.Decode(strm);
+    PBYTEArray encoded(MaxSize);
+    decoded.Encode((PASN_Stream &)encoded);
+  }
+  PTimeInterval classTime = PTimer::Tick() - start;
+
+  start = PTimer::Tick();
+  for (unsigned i = 0; i < Iterations; ++i) {
+    DecodeTableMessage(value, pdus, classBER);
+    EncodeTableMessage(value, pdus, pduBER, tableBER);
+  }
+  PTimeInterval tableTime = PTimer::Tick() - start;
+
+  cout << "BER decode+encode x" << Iterations << ": classes " << classTime
+       << "s, tables " << tableTime << "s";
+  if (tableTime > 0)
+    cout << " (" << (double)classTime.GetMilliSeconds()/tableTime.GetMilliSeconds() << "x)";
+  cout << endl;
+
+  // PER round trip of the table driven codec, of the PDUs as ANY has no PER form
+  PPER_Stream perStrm;
+  PASN_TableCodec::EncodePER(PSNMP_PDUs_Descriptor, &pdus, perStrm);
+  perStrm.CompleteEncoding();
+
+  PSNMP_PDUs_Value perValue = PSNMP_PDUs_Value();
+  PPER_Stream perDecode(perStrm);
+  perDecode.ResetDecoder();
+  PPER_Stream perEncode;
+  if (PASN_TableCodec::DecodePER(PSNMP_PDUs_Descriptor, &perValue, perDecode)) {
+    PASN_TableCodec::EncodePER(PSNMP_PDUs_Descriptor, &perValue, perEncode);
+    perEncode.CompleteEncoding();
+  }
+  cout << "Table PER encoding " << perStrm.GetSize() << " bytes, round trip "
+       << (perEncode == perStrm ? "identical" : "FAILED") << endl;
+
+  /* The SNMP classes are BER only, so time PER with the table driven codec,
+     which is dominated by the bit level PPER_Stream functions. */
+  start = PTimer::Tick();
+  for (unsigned i = 0; i < Iterations; ++i) {
+    PPER_Stream strm;
+    PASN_TableCodec::EncodePER(PSNMP_PDUs_Descriptor, &pdus, strm);
+    strm.CompleteEncoding();
+  }
+  PTimeInterval perEncodeTime = PTimer::Tick() - start;
+
+  start = PTimer::Tick();
+  for (unsigned i = 0; i < Iterations; ++i) {
+    PPER_Stream strm;
+    strm.BeginEncoding(perStrm.GetSize());
+    PASN_TableCodec::EncodePER(PSNMP_PDUs_Descriptor, &pdus, strm);
+    strm.CompleteEncoding();
+  }
+  PTimeInterval perReserveTime = PTimer::Tick() - start;
+
+  start = PTimer::Tick();
+  for (unsigned i = 0; i < Iterations; ++i) {
+    PPER_Stream strm(perStrm.GetPointer(), perStrm.GetSize());
+    PASN_TableCodec::DecodePER(PSNMP_PDUs_Descriptor, &perValue, strm);
+  }
+  PTimeInterval perDecodeTime = PTimer::Tick() - start;
+
+  cout << "PER x" << Iterations << ": encode " << perEncodeTime
+       << "s, encode presized " << perReserveTime
+       << "s, decode " << perDecodeTime << 's' << endl;
+
+  PASN_TableCodec::Free(PSNMP_PDUs_Descriptor, &perValue);
+  PASN_TableCodec::Free(PSNMP_PDUs_Descriptor, &pdus);
+}
@@ -49,9 +49,7 @@ class SNMPSrv : public PProcess
   public:
     SNMPSrv();
     void Main();
-
-  protected:
-    MySNMPServer srv;
+    void Benchmark(unsigned count);
 };
 
 
@@ -9,6 +9,7 @@
 
 #include <ptlib.h>
 #include <ptlib/pprocess.h>
+#include <ptlib/sockets.h>
 #include <string>
 
 ////////////////////////////////////////////////
@@ -186,6 +187,300 @@ void Test4()
   delete thread;
 }
 
+////////////////////////////////////////////////
+//
+// test #5 - PString throughput
+//
+
+#define PERF_COUNT 1000000
+
+static void PrintRate(const char * label, const PTimeInterval & duration, unsigned count)
+{
+  cout << setw(24) << left << label << right << fixed << setprecision(1)
+       << (duration.GetMicroSeconds()*1000.0/count) << " ns" << endl;
+}
+
+
+void Test5()
+{
+  static const char * const ShortStrings[] = { "Via", "To", "From", "Call-ID", "CSeq", "tag", "branch", "5060", "INVITE", "z9hG4bK776asdhds" };
+  static const char LongString[] = "SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds;received=192.0.2.1;rport=5060";
+
+  size_t total = 0;
+
+  PTime start;
+  for (unsigned i = 0; i < PERF_COUNT; ++i) {
+    PString str(ShortStrings[i%PARRAYSIZE(ShortStrings)]);
+    total += str.GetLength();
+  }
+  PrintRate("Construct short", PTime() - start, PERF_COUNT);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT; ++i) {
+    PString str(LongString);
+    total += str.GetLength();
+  }
+  PrintRate("Construct long", PTime() - start, PERF_COUNT);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT; ++i) {
+    PString str((int)i);
+    total += str.GetLength();
+  }
+  PrintRate("Construct number", PTime() - start, PERF_COUNT);
+
+  PString original(LongString);
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT; ++i) {
+    PString str(original);
+    total += str.GetLength();
+  }
+  PrintRate("Copy", PTime() - start, PERF_COUNT);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT; ++i) {
+    PString str(original);
+    str[0] = 's'; // Copy on write
+    total += str.GetLength();
+  }
+  PrintRate("Copy and modify", PTime() - start, PERF_COUNT);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i) {
+    PString str;
+    for (PINDEX j = 0; j < 10; ++j)
+      str += ShortStrings[j];
+    total += str.GetLength();
+  }
+  PrintRate("Concatenate x10", PTime() - start, PERF_COUNT/10);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT; ++i) {
+    PString str = original.Left(11);
+    total += str.GetLength();
+  }
+  PrintRate("Left", PTime() - start, PERF_COUNT);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT; ++i)
+    total += original.Find(ShortStrings[i%PARRAYSIZE(ShortStrings)]);
+  PrintRate("Find", PTime() - start, PERF_COUNT);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i)
+    total += original.Tokenise(" ;=", false).GetSize();
+  PrintRate("Tokenise", PTime() - start, PERF_COUNT/10);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i) {
+    PStringTokeniser tokens(original, " ;=", false);
+    PStringView token;
+    while (tokens.Next(token))
+      total += token.GetLength();
+  }
+  PrintRate("Tokeniser", PTime() - start, PERF_COUNT/10);
+
+  cout << "Checksum " << total << endl;
+}
+
+
+////////////////////////////////////////////////
+//
+// test #6 - PRegularExpression engines
+//
+
+void Test6()
+{
+  static const char UriPattern[] = "^(sips?):([^@;>]+@)?([a-z0-9.-]+)(:[0-9]+)?(;[^>]*)?$";
+  static const char * const Uris[] = {
+    "sip:alice@atlanta.com",
+    "sips:bob@biloxi.example.com:5061;transport=tls",
+    "sip:192.0.2.4",
+    "tel:+61-3-9555-1234"
+  };
+
+  PRegularExpression linear(UriPattern, PRegularExpression::Extended|PRegularExpression::IgnoreCase);
+  PRegularExpression backtrack(UriPattern, PRegularExpression::Extended|PRegularExpression::IgnoreCase|PRegularExpression::Backtracking);
+  cout << "Linear engine: " << linear.IsLinearTime() << ", backtracking engine: " << !backtrack.IsLinearTime() << endl;
+
+  // Check both engines agree
+  for (PINDEX i = 0; i < PARRAYSIZE(Uris); ++i) {
+    PStringArray linearParts(6), backtrackParts(6);
+    bool linearMatch = linear.Execute(Uris[i], linearParts);
+    bool backtrackMatch = backtrack.Execute(Uris[i], backtrackParts);
+    cout << Uris[i] << (linearMatch == backtrackMatch && (!linearMatch || linearParts == backtrackParts) ? " agree" : " DISAGREE")
+         << ", host=" << (linearMatch ? linearParts[3] : "(none)") << endl;
+  }
+
+  size_t total = 0;
+
+  PTime start;
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i) {
+    PINDEX pos, len;
+    total += linear.Execute(Uris[i%PARRAYSIZE(Uris)], pos, len) ? len : 0;
+  }
+  PrintRate("URI linear", PTime() - start, PERF_COUNT/10);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i) {
+    PINDEX pos, len;
+    total += backtrack.Execute(Uris[i%PARRAYSIZE(Uris)], pos, len) ? len : 0;
+  }
+  PrintRate("URI backtracking", PTime() - start, PERF_COUNT/10);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i) {
+    PRegularExpression regex(UriPattern, PRegularExpression::Extended|PRegularExpression::IgnoreCase);
+    total += regex.IsLinearTime();
+  }
+  PrintRate("Compile (cached)", PTime() - start, PERF_COUNT/10);
+
+  // Pattern that is exponential for a naive backtracking engine
+  PString pathological = "(a|aa)*b";
+  PString as;
+  for (PINDEX i = 0; i < 1000; ++i)
+    as += 'a';
+  PRegularExpression pathoLinear(pathological, PRegularExpression::Extended);
+  PRegularExpression pathoBacktrack(pathological, PRegularExpression::Extended|PRegularExpression::Backtracking);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/1000; ++i)
+    total += pathoLinear.Matches(as);
+  PrintRate("(a|aa)*b linear", PTime() - start, PERF_COUNT/1000);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/1000; ++i)
+    total += pathoBacktrack.Matches(as);
+  PrintRate("(a|aa)*b backtracking", PTime() - start, PERF_COUNT/1000);
+
+  // Dial plan, find which rules match a number
+  static const char * const DialPlan[] = {
+    "^0[2378][0-9]{8}$",
+    "^04[0-9]{8}$",
+    "^1[38]00[0-9]{6}$",
+    "^13[0-9]{4}$",
+    "^000$",
+    "^112$",
+    "^0011[1-9][0-9]{4,14}$",
+    "^[2-9][0-9]{7}$",
+    "^\\+61[2-478][0-9]{8}$",
+    "^\\+[1-9][0-9]{6,14}$"
+  };
+  static const char * const Numbers[] = { "0395551234", "0412345678", "1800123456", "+61395551234", "112", "12345" };
+
+  PRegularExpressionSet set;
+  PRegularExpression rules[PARRAYSIZE(DialPlan)];
+  for (PINDEX i = 0; i < PARRAYSIZE(DialPlan); ++i) {
+    set.Add(DialPlan[i], PRegularExpression::Extended);
+    rules[i].Compile(DialPlan[i], PRegularExpression::Extended);
+  }
+
+  for (PINDEX i = 0; i < PARRAYSIZE(Numbers); ++i) {
+    std::vector<PINDEX> matches;
+    set.Execute(Numbers[i], matches);
+    cout << Numbers[i] << " matches rules";
+    for (size_t m = 0; m < matches.size(); ++m)
+      cout << ' ' << matches[m];
+    cout << endl;
+  }
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i)
+    total += set.FindFirst(Numbers[i%PARRAYSIZE(Numbers)]);
+  PrintRate("Dial plan set", PTime() - start, PERF_COUNT/10);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i) {
+    for (PINDEX r = 0; r < PARRAYSIZE(rules); ++r) {
+      PINDEX pos;
+      if (rules[r].Execute(Numbers[i%PARRAYSIZE(Numbers)], pos)) {
+        total += r;
+        break;
+      }
+    }
+  }
+  PrintRate("Dial plan loop", PTime() - start, PERF_COUNT/10);
+
+  cout << "Checksum " << total << endl;
+}
+
+
+////////////////////////////////////////////////
+//
+// test #7 - PFlatArray
+//
+
+void Test7()
+{
+  static const char * const Words[] = { "Via", "To", "From", "Call-ID", "CSeq", "tag", "branch", "5060", "INVITE", "z9hG4bK776asdhds" };
+
+  PFlatArray<PString, 2> flat;
+  for (PINDEX i = 0; i < PARRAYSIZE(Words); ++i)
+    flat.Append(PString(Words[i]));
+  flat.Emplace(flat[0]); // Self reference across a reallocation
+  flat.InsertAt(1, PString("SIP/2.0"));
+  flat.RemoveAt(3);
+  cout << "Flat array: " << setfill(',') << flat << setfill(' ') << endl;
+
+  PFlatArray<PString, 2> copy = flat;
+  PFlatArray<PString, 2> moved = std::move(copy);
+  cout << "Copy " << (moved == flat ? "matches" : "differs")
+       << ", moved from size " << copy.GetSize()
+       << ", index of CSeq " << flat.GetValuesIndex("CSeq") << endl;
+  moved.RemoveAt(moved.GetSize()-1);
+  cout << "Shorter " << (moved < flat ? "less" : "not less") << endl;
+
+  PStringArray array = flat;
+  cout << "PStringArray: " << setfill(',') << array << setfill(' ') << endl;
+
+  size_t total = 0;
+
+  PTime start;
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i) {
+    PStringArray strings;
+    for (PINDEX j = 0; j < PARRAYSIZE(Words); ++j)
+      strings.AppendString(Words[j]);
+    for (PINDEX j = 0; j < strings.GetSize(); ++j)
+      total += strings[j].GetLength();
+  }
+  PrintRate("PStringArray x10", PTime() - start, PERF_COUNT/10);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT/10; ++i) {
+    PFlatArray<PString, PARRAYSIZE(Words)> strings;
+    for (PINDEX j = 0; j < PARRAYSIZE(Words); ++j)
+      strings.Append(PString(Words[j]));
+    for (PINDEX j = 0; j < strings.GetSize(); ++j)
+      total += strings[j].GetLength();
+  }
+  PrintRate("PFlatArray x10", PTime() - start, PERF_COUNT/10);
+
+  PArray<PIPSocket::InterfaceEntry> oldInterfaces;
+  PIPSocket::InterfaceTable interfaces;
+  for (unsigned i = 0; i < 16; ++i) {
+    PIPSocket::InterfaceEntry entry(psprintf("eth%u", i), PIPSocket::Address(192, 0, 2, (BYTE)i), PIPSocket::Address(255, 255, 255, 0), PString::Empty());
+    oldInterfaces.Append(new PIPSocket::InterfaceEntry(entry));
+    interfaces.Append(entry);
+  }
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT; ++i) {
+    for (PINDEX j = 0; j < oldInterfaces.GetSize(); ++j)
+      total += oldInterfaces[j].GetAddress().IsLoopback();
+  }
+  PrintRate("PArray scan x16", PTime() - start, PERF_COUNT);
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < PERF_COUNT; ++i) {
+    for (PINDEX j = 0; j < interfaces.GetSize(); ++j)
+      total += interfaces[j].GetAddress().IsLoopback();
+  }
+  PrintRate("PFlatArray scan x16", PTime() - start, PERF_COUNT);
+
+  cout << "Checksum " << total << endl;
+}
+
+
 ////////////////////////////////////////////////
 //
 // main
@@ -207,4 +502,7 @@ void StringTest::Main()
   Test2(); cout << "End of test #2\n" << endl;
   Test3(); cout << "End of test #3\n" << endl;
   Test4(); cout << "End of test #4\n" << endl;
+  Test5(); cout << "End of test #5\n" << endl;
+  Test6(); cout << "End of test #6\n" << endl;
+  Test7(); cout << "End of test #7\n" << endl;
 }
@@ -41,9 +41,81 @@ PCREATE_PROCESS(TimingTest);
 
 #define TEST_TIME(t) cout << t << " => " << PTime(t) << '\n'
 
+
+static void Benchmark(unsigned iterations)
+{
+  static const PTime::TimeFormat StandardFormats[] = {
+    PTime::RFC1123, PTime::RFC3339, PTime::ShortISO8601, PTime::LongISO8601
+  };
+
+  // Check the fast parser reads back what the formatters write
+  PTime now;
+  for (PINDEX i = 0; i < PARRAYSIZE(StandardFormats); ++i) {
+    for (int zone = -13; zone <= 13; zone += 13) {
+      PString str = now.AsString(StandardFormats[i], zone);
+      PTime parsed(0);
+      if (!parsed.ParseStandard(str) ||
+            parsed.GetTimeInSeconds() != now.GetTimeInSeconds() ||
+            (StandardFormats[i] == PTime::LongISO8601 && parsed.GetMicrosecond()/1000 != now.GetMicrosecond()/1000)) {
+        cout << "Fast parse of \"" << str << "\" failed, got " << parsed.AsString(PTime::LongISO8601, zone) << endl;
+        return;
+      }
+    }
+  }
+
+  cout << "Formatting and parsing, " << iterations << " iterations" << endl;
+
+  PTime start;
+  for (unsigned i = 0; i < iterations; ++i)
+    now.AsString("yyyy/MM/dd hh:mm:ss.uuu");
+  PTimeInterval interpreted = PTime() - start;
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < iterations; ++i)
+    now.AsString(PTime::LoggingFormat);
+  PTimeInterval compiled = PTime() - start;
+
+  PTimeFormatter formatter("yyyy/MM/dd hh:mm:ss.uuu");
+  char buffer[50];
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < iterations; ++i)
+    formatter.Format(now, buffer, sizeof(buffer));
+  PTimeInterval buffered = PTime() - start;
+
+  PString rfc1123 = now.AsString(PTime::RFC1123, PTime::GMT);
+  PTime parsed;
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < iterations; ++i) {
+    PStringStream strm(rfc1123);
+    parsed.ReadFrom(strm);
+  }
+  PTimeInterval general = PTime() - start;
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < iterations; ++i)
+    parsed.ParseStandard(rfc1123);
+  PTimeInterval standard = PTime() - start;
+
+  double count = iterations;
+  cout << fixed << setprecision(3)
+       << "Format string: " << interpreted.GetMicroSeconds()/count << "us\n"
+          "LoggingFormat: " << compiled.GetMicroSeconds()/count << "us\n"
+          "Formatter to buffer: " << buffered.GetMicroSeconds()/count << "us\n"
+          "General parse: " << general.GetMicroSeconds()/count << "us\n"
+          "Standard parse: " << standard.GetMicroSeconds()/count << "us" << endl;
+}
+
+
 // The main program
 void TimingTest::Main()
 {
+  PArgList & args = GetArguments();
+  args.Parse("b-benchmark:");
+  if (args.IsParsed() && args.HasOption('b')) {
+    Benchmark(args.GetOptionString('b').AsUnsigned());
+    return;
+  }
+
   cout << "Timing Test Program\n" << endl;
 
   PTimeInterval nano(0,10);
@@ -36,6 +36,7 @@ class Test : public PProcess
   PCLASSINFO(Test, PProcess)
   public:
     void Main();
+    void CorpusBenchmark(const PFilePath & filename, unsigned iterations);
 };
 
 
@@ -46,15 +47,22 @@ void Test::Main()
   cout << "URL Test Utility" << endl;
 
   PArgList & args = GetArguments();
-  if (!args.Parse("v-verbose. Verbose output\n"
-                  "T-time: time PURL parsing for number of iterations\n"
-                  PTRACE_ARGLIST)) {
+  args.Parse("v-verbose. Verbose output\n"
+             "T-time: time PURL parsing for number of iterations\n"
+             "C-corpus: time PURL parsing of every URL in file, one per line\n"
+             PTRACE_ARGLIST);
+  if (!args.IsParsed() || (args.GetCount() == 0 && !args.HasOption('C'))) {
     args.Usage(cerr);
     return;
   }
 
   PTRACE_INITIALISE(args);
 
+  if (args.HasOption('C')) {
+    CorpusBenchmark(args.GetOptionString('C'), args.GetOptionString('T', "10").AsUnsigned());
+    return;
+  }
+
   PURL url;
 
   unsigned total = args.GetOptionString('T').AsUnsigned();
@@ -126,4 +134,51 @@ void Test::Main()
 }
 
 
+void Test::CorpusBenchmark(const PFilePath & filename, unsigned iterations)
+{
+  PTextFile file;
+  if (!file.Open(filename, PFile::ReadOnly)) {
+    cerr << "Could not open corpus file \"" << filename << '"' << endl;
+    return;
+  }
+
+  PStringArray corpus;
+  PString line;
+  while (file.ReadLine(line)) {
+    line.Trim();
+    if (!line.IsEmpty())
+      corpus.AppendString(line);
+  }
+
+  if (corpus.IsEmpty()) {
+    cerr << "No URLs in corpus file \"" << filename << '"' << endl;
+    return;
+  }
+
+  if (iterations == 0)
+    iterations = 1;
+
+  PURL url;
+  PINDEX failed = 0;
+  PINDEX queryVars = 0;
+  PTime start;
+
+  for (unsigned i = 0; i < iterations; ++i) {
+    for (PINDEX j = 0; j < corpus.GetSize(); ++j) {
+      if (url.Parse(corpus[j], "http"))
+        queryVars += url.GetQueryVars().GetSize();
+      else
+        ++failed;
+    }
+  }
+
+  PTimeInterval elapsed = PTime() - start;
+  PUInt64 parses = (PUInt64)iterations*corpus.GetSize();
+  cout << "Parsed " << corpus.GetSize() << " URLs " << iterations << " times in " << elapsed << "s, "
+       << (1000.0*elapsed.GetMilliSeconds()/parses) << "us per URL, "
+       << (parses*1000/std::max(elapsed.GetMilliSeconds(), (PInt64)1)) << " URLs/s, "
+       << failed/iterations << " failed, " << queryVars/iterations << " query variables" << endl;
+}
+
+
 // End of file
@@ -54,6 +54,12 @@ void VidTest::Main()
              "-output-driver: video display driver to use.\n"
              "O-output-device: video display device to use.\n"
              "T-time: time in seconds to run test, no command line\n"
+             "-jpeg-bench. benchmark JPEG decode of file arguments, or bundled test image\n"
+             "-jpeg-threads: threads for JPEG benchmark decode, zero is one per processor\n"
+             "-jpeg-frames: frames to decode in JPEG benchmark, default 100\n"
+             "-compose-bench. benchmark video compositor, 3x3 grid of 704x480 onto 720p\n"
+             "-compose-threads: threads for compositor benchmark, zero is one per processor\n"
+             "-compose-output: write final composed frame to YUV file\n"
 #if PTRACING
              "o-output: file name for output of log messages\n"
              "t-trace. degree of verbosity in log (more times for more detail)\n"
@@ -85,6 +91,18 @@ void VidTest::Main()
 
   PTRACE_INITIALISE(args, PTrace::Blocks|PTrace::Timestamp|PTrace::Thread|PTrace::FileAndLine);
 
+#if P_JPEG_DECODER
+  if (args.HasOption("jpeg-bench")) {
+    JpegBenchmark(args);
+    return;
+  }
+#endif
+
+  if (args.HasOption("compose-bench")) {
+    ComposeBenchmark(args);
+    return;
+  }
+
 
   /////////////////////////////////////////////////////////////////////
 
@@ -445,5 +463,126 @@ void VidTest::GrabAndDisplay(PThread &, P_INT_PTR)
 }
 
 
+#if P_JPEG_DECODER
+void VidTest::JpegBenchmark(PArgList & args)
+{
+  PStringArray files;
+  if (args.GetCount() > 0)
+    files = args.GetParameters();
+  else
+    files.AppendString(GetFile().GetDirectory() + "test720p.jpg");
+
+  unsigned frames = args.GetOptionAs("jpeg-frames", 100U);
+  unsigned threads = args.GetOptionAs("jpeg-threads", 0U);
+
+  for (PINDEX f = 0; f < files.GetSize(); ++f) {
+    PFile file;
+    PBYTEArray jpeg;
+    if (!file.Open(files[f], PFile::ReadOnly) ||
+        !jpeg.SetSize((PINDEX)file.GetLength()) ||
+        !file.Read(jpeg.GetPointer(), jpeg.GetSize())) {
+      cerr << "Could not read JPEG file \"" << files[f] << '"' << endl;
+      continue;
+    }
+
+    PBYTEArray reference;
+    for (unsigned pass = 0; pass < 2; ++pass) {
+      PJPEGConverter converter;
+      converter.SetSrcFrameBytes(jpeg.GetSize());
+      converter.SetDecodeThreads(pass == 0 ? 1 : threads);
+
+      // First decode determines the size
+      PBYTEArray yuv;
+      unsigned width, height;
+      if (!converter.Load(files[f], yuv) || !converter.GetDstFrameSize(width, height)) {
+        cerr << "Could not decode JPEG file \"" << files[f] << '"' << endl;
+        break;
+      }
+      converter.SetDstFrameSize(width, height);
+
+      PTimeInterval startTick = PTimer::Tick();
+      for (unsigned i = 0; i < frames; ++i) {
+        if (!converter.Convert(jpeg, yuv.GetPointer())) {
+          cerr << "Decode error on frame " << i << " of \"" << files[f] << '"' << endl;
+          break;
+        }
+      }
+      PTimeInterval duration = PTimer::Tick() - startTick;
+
+      cout << files[f] << ' ' << width << 'x' << height
+           << ", threads=" << (pass == 0 ? "1" : (threads == 0 ? PString("auto") : PString(threads)))
+           << ": " << frames << " frames in " << duration << " seconds, "
+           << (frames*1000.0/std::max(duration.GetMilliSeconds(), (PInt64)1)) << " fps" << endl;
+
+      if (pass == 0)
+        reference = yuv;
+      else if (reference != yuv)
+        cout << "Parallel decode output differs from sequential!" << endl;
+    }
+  }
+}
+#endif // P_JPEG_DECODER
+
+
+void VidTest::ComposeBenchmark(PArgList & args)
+{
+  static const unsigned Columns = 3;
+  static const unsigned Rows = 3;
+  static const unsigned Frames = 100;
+  static const unsigned SrcWidth = PVideoFrameInfo::HD480Width;
+  static const unsigned SrcHeight = PVideoFrameInfo::HD480Height;
+
+  unsigned threads = args.GetOptionAs("compose-threads", 0U);
+
+  // Different colour bars for each participant
+  std::vector<PBYTEArray> sources(Columns*Rows);
+  for (size_t i = 0; i < sources.size(); ++i) {
+    BYTE * yuv = sources[i].GetPointer(PVideoFrameInfo::CalculateFrameBytes(SrcWidth, SrcHeight));
+    for (unsigned bar = 0; bar < 8; ++bar)
+      PColourConverter::FillYUV420P(bar*SrcWidth/8, 0, SrcWidth/8, SrcHeight, SrcWidth, SrcHeight, yuv,
+                                    (bar+i)&1 ? 255 : 0, (bar+i)&2 ? 255 : 0, (bar+i)&4 ? 255 : 0);
+  }
+
+  PBYTEArray reference;
+  for (unsigned pass = 0; pass < 2; ++pass) {
+    PVideoCompositor compositor(PVideoFrameInfo::HD720Width, PVideoFrameInfo::HD720Height, pass == 0 ? 1 : threads);
+    compositor.SetBackground(32, 32, 32);
+    compositor.SetLayout(PVideoCompositor::MakeGrid(Columns, Rows, PVideoFrameInfo::HD720Width, PVideoFrameInfo::HD720Height, 4));
+
+    const char * const Modes[] = { "all tiles", "one tile" };
+    for (unsigned mode = 0; mode < 2; ++mode) {
+      PINDEX drawn = 0;
+      PTimeInterval startTick = PTimer::Tick();
+      for (unsigned frame = 0; frame < Frames; ++frame) {
+        for (size_t i = 0; i < sources.size(); ++i) {
+          if (mode == 0 || i == frame%sources.size())
+            compositor.SetSource(i, sources[i], SrcWidth, SrcHeight);
+        }
+        drawn += compositor.Compose();
+      }
+      PTimeInterval duration = PTimer::Tick() - startTick;
+
+      cout << "Compose " << Modes[mode]
+           << ", threads=" << (pass == 0 ? "1" : (threads == 0 ? PString("auto") : PString(threads)))
+           << ": " << Frames << " frames, " << drawn << " tiles, in " << duration << " seconds, "
+           << (Frames*1000.0/std::max(duration.GetMilliSeconds(), (PInt64)1)) << " fps" << endl;
+    }
+
+    PBYTEArray canvas(compositor.GetCanvas(), compositor.GetCanvasBytes());
+    if (pass == 0)
+      reference = canvas;
+    else if (reference != canvas)
+      cout << "Parallel composition output differs from sequential!" << endl;
+  }
+
+  if (args.HasOption("compose-output")) {
+    PFile file;
+    if (file.Open(args.GetOptionString("compose-output"), PFile::WriteOnly))
+      file.Write(reference, reference.GetSize());
+    else
+      cerr << "Could not write \"" << file.GetFilePath() << '"' << endl;
+  }
+}
+
 
 // End of File ///////////////////////////////////////////////////////////////
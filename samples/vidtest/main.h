@@ -39,6 +39,10 @@ class VidTest : public PProcess
 
  protected:
    PDECLARE_NOTIFIER(PThread, VidTest, GrabAndDisplay);
+#if P_JPEG_DECODER
+   void JpegBenchmark(PArgList & args);
+#endif
+   void ComposeBenchmark(PArgList & args);
 
   PVideoInputDevice     * m_grabber;
   PVideoOutputDevice    * m_display;
@@ -18,6 +18,8 @@
     --test-struct http://xmlrpc.usefulinc.com/demo/server.php interopEchoTests.echoStruct
     -s http://10.0.2.13:6666/RPC2 Function1 key value
 
+    --benchmark 10000
+
 
  */
 
@@ -54,6 +56,156 @@ PXMLRPC_STRUCT_BEGIN     (TestStruct)
     PXMLRPC_ARRAY_STRUCT (TestStruct, NestedStruct, array_struct);
 PXMLRPC_STRUCT_END()
 
+PXMLRPC_STRUCT_BEGIN(StructFirst)
+    PXMLRPC_STRUCT  (StructFirst, NestedStruct, first);
+    PXMLRPC_INTEGER (StructFirst, int, second);
+PXMLRPC_STRUCT_END()
+
+
+static void FillTestStruct(TestStruct & ts)
+{
+  ts.a_date -= PTimeInterval(0, 0, 0, 0, 5);
+
+  ts.a_binary.SetSize(10);
+  for (PINDEX i = 0; i < 10; i++)
+    ts.a_binary[i] = (BYTE)(i+1);
+
+  ts.a_string_array.SetSize(3);
+  ts.a_string_array[0] = "first";
+  ts.a_string_array[1] = "second";
+  ts.a_string_array[2] = "third";
+
+  ts.an_integer_array.SetSize(7);
+  for (PINDEX i = 0; i < ts.an_integer_array.GetSize(); i++)
+    ts.an_integer_array[i] = i+1;
+
+  ts.a_float_array.SetSize(5);
+  for (PINDEX i = 0; i < ts.a_float_array.GetSize(); i++)
+    ts.a_float_array[i] = (float)(1.0/(i+2));
+
+  ts.nested_struct.another_string = "Another string!";
+  ts.nested_struct.another_integer = 345;
+
+  ts.array_struct.SetSize(2);
+  ts.array_struct.SetAt(0, new NestedStruct);
+  ts.array_struct[0].another_string = "Structure one";
+  ts.array_struct[0].another_integer = 11111;
+  ts.array_struct.SetAt(1, new NestedStruct);
+  ts.array_struct[1].another_string = "Structure two";
+  ts.array_struct[1].another_integer = 22222;
+}
+
+
+static PString StructAsString(const PXMLRPCStructBase & data)
+{
+  PStringStream strm;
+  strm << data;
+  return strm;
+}
+
+
+static void Benchmark(unsigned iterations)
+{
+  TestStruct ts;
+  FillTestStruct(ts);
+  ts.a_date = PTime(0, 0, 0, 1, 1, 2024, PTime::UTC);
+
+  // Check the decoder reads what the DOM writes
+  PXMLRPCBlock domRequest("benchmark", ts);
+  PString domXML = domRequest.AsString();
+  TestStruct check;
+  check.a_date = PTime(0);
+  PXMLRPCDecoder checkDecoder(check);
+  if (!checkDecoder.Decode(domXML) || !checkDecoder.IsMethodCall() || StructAsString(check) != StructAsString(ts)) {
+    cout << "Decoder could not read DOM request: " << checkDecoder.GetFaultText() << endl;
+    return;
+  }
+
+  // Check the DOM reads what the writer writes, including escaped text
+  ts.a_string = "Needs <escaping> & \"quoting\"";
+  PXMLRPCWriter writer;
+  writer.MethodResponse(ts);
+
+  PXMLRPCBlock domResponse;
+  check = TestStruct();
+  check.a_date = PTime(0);
+  if (!domResponse.Load(writer.GetString()) || !domResponse.ValidateResponse() ||
+      !domResponse.GetParams(check) || StructAsString(check) != StructAsString(ts)) {
+    cout << "DOM could not read streamed response: " << domResponse.GetFaultText() << endl;
+    return;
+  }
+
+  // Check both read the variables as one struct parameter, or as separate parameters
+  static const char * const ParamsXML[] = {
+    "<methodResponse><params><param><value><struct>"
+      "<member><name>first</name><value><struct>"
+        "<member><name>another_string</name><value><string>one</string></value></member>"
+        "<member><name>another_integer</name><value><int>1</int></value></member>"
+      "</struct></value></member>"
+      "<member><name>second</name><value><int>2</int></value></member>"
+    "</struct></value></param></params></methodResponse>",
+    "<methodResponse><params>"
+      "<param><value><struct>"
+        "<member><name>another_string</name><value><string>one</string></value></member>"
+        "<member><name>another_integer</name><value><int>1</int></value></member>"
+      "</struct></value></param>"
+      "<param><value><int>2</int></value></param>"
+    "</params></methodResponse>"
+  };
+  for (PINDEX i = 0; i < PARRAYSIZE(ParamsXML); ++i) {
+    StructFirst streamed, dom;
+    PXMLRPCDecoder decoder(streamed);
+    PXMLRPCBlock block;
+    if (!decoder.Decode(ParamsXML[i]) || !block.Load(ParamsXML[i]) || !block.ValidateResponse() || !block.GetParams(dom) ||
+        StructAsString(streamed) != StructAsString(dom) || streamed.first.another_integer != 1 || streamed.second != 2) {
+      cout << "Decoder and DOM differ on parameters " << i << ": " << decoder.GetFaultText() << endl;
+      return;
+    }
+  }
+
+  PString responseXML = writer.GetString();
+
+  cout << "Request " << domXML.GetLength() << " bytes, " << iterations << " iterations" << endl;
+
+  PTime start;
+  for (unsigned i = 0; i < iterations; ++i) {
+    PXMLRPCBlock request("benchmark", ts);
+    request.AsString();
+  }
+  PTimeInterval domEncode = PTime() - start;
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < iterations; ++i) {
+    writer.Clear();
+    writer.MethodCall("benchmark", ts);
+  }
+  PTimeInterval streamEncode = PTime() - start;
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < iterations; ++i) {
+    PXMLRPCBlock response;
+    response.Load(responseXML);
+    response.ValidateResponse();
+    response.GetParams(check);
+  }
+  PTimeInterval domDecode = PTime() - start;
+
+  start.SetCurrentTime();
+  for (unsigned i = 0; i < iterations; ++i) {
+    PXMLRPCDecoder decoder(check);
+    decoder.Decode(responseXML);
+  }
+  PTimeInterval streamDecode = PTime() - start;
+
+  double count = iterations;
+  cout << fixed << setprecision(2)
+       << "Encode: DOM " << domEncode.GetMicroSeconds()/count << "us,"
+          " streamed " << streamEncode.GetMicroSeconds()/count << "us\n"
+          "Decode: DOM " << domDecode.GetMicroSeconds()/count << "us,"
+          " streamed " << streamDecode.GetMicroSeconds()/count << "us"
+       << endl;
+}
+
 
 bool AddParam(PXMLRPCBlock & request, PArgList & args,PXMLElement * params)
 {
@@ -90,7 +242,7 @@ bool AddParam(PXMLRPCBlock & request, PArgList & args,PXMLElement * params)
   }
 
   if (args.HasOption('i'))
-    params->AddSubObject(request.CreateScalar(args[arg++].AsInteger()));
+    params->AddSubObject(request.CreateScalar((int)args[arg++].AsInteger()));
   else if (args.HasOption('f'))
     params->AddSubObject(request.CreateScalar(args[arg++].AsReal()));
 
@@ -117,6 +269,7 @@ void XMLRPCApp::Main()
 #endif
              "v-verbose."
              "-test-struct."
+             "-benchmark:"
              );
 
 #if PTRACING
@@ -124,9 +277,15 @@ void XMLRPCApp::Main()
                      args.HasOption('o') ? (const char *)args.GetOptionString('o') : NULL);
 #endif
 
+  if (args.HasOption("benchmark")) {
+    Benchmark(args.GetOptionString("benchmark").AsUnsigned());
+    return;
+  }
+
   if (args.GetCount() < 2) {
     PError << "usage: xmlrpc [ -v -t ] url method [ <param> ... ]\n"
               "       xmlrpc --test-struct url method\n"
+              "       xmlrpc --benchmark iterations\n"
               "\n"
               "Options:\n"
               "  -v or --version              Verbose output\n"
@@ -155,35 +314,7 @@ void XMLRPCApp::Main()
 
   if (args.HasOption("test-struct")) {
     TestStruct ts;
-    ts.a_date -= PTimeInterval(0, 0, 0, 0, 5);
-
-    ts.a_binary.SetSize(10);
-    for (PINDEX i = 0; i < 10; i++)
-      ts.a_binary[i] = (BYTE)(i+1);
-
-    ts.a_string_array.SetSize(3);
-    ts.a_string_array[0] = "first";
-    ts.a_string_array[1] = "second";
-    ts.a_string_array[2] = "third";
-
-    ts.an_integer_array.SetSize(7);
-    for (PINDEX i = 0; i < ts.an_integer_array.GetSize(); i++)
-      ts.an_integer_array[i] = i+1;
-
-    ts.a_float_array.SetSize(5);
-    for (PINDEX i = 0; i < ts.a_float_array.GetSize(); i++)
-      ts.a_float_array[i] = (float)(1.0/(i+2));
-
-    ts.nested_struct.another_string = "Another string!";
-    ts.nested_struct.another_integer = 345;
-
-    ts.array_struct.SetSize(2);
-    ts.array_struct.SetAt(0, new NestedStruct);
-    ts.array_struct[0].another_string = "Structure one";
-    ts.array_struct[0].another_integer = 11111;
-    ts.array_struct.SetAt(1, new NestedStruct);
-    ts.array_struct[1].another_string = "Structure two";
-    ts.array_struct[1].another_integer = 22222;
+    FillTestStruct(ts);
     request.AddParam(ts);
   }
   else {
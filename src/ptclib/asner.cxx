@@ -2396,10 +2396,27 @@ void PASN_Stream::ResetDecoder()
 
 
 void PASN_Stream::BeginEncoding()
+{
+  BeginEncoding(20);
+}
+
+
+void PASN_Stream::BeginEncoding(PINDEX reserve)
 {
   bitOffset = 8;
   byteOffset = 0;
-  PBYTEArray::operator=(PBYTEArray(20));
+  PBYTEArray::operator=(PBYTEArray(reserve));
+}
+
+
+void PASN_Stream::GrowEncoding(PINDEX minSize)
+{
+  /* Every SetSize() is a new allocation and copy, so grow geometrically
+     rather than by a few bytes, or encoding a large PDU is quadratic. */
+  PINDEX newSize = GetSize()*2;
+  if (newSize < minSize+8)
+    newSize = minSize+8;
+  SetSize(newSize);
 }
 
 
@@ -2435,8 +2452,7 @@ void PASN_Stream::ByteEncode(unsigned value)
     bitOffset = 8;
     byteOffset++;
   }
-  if (byteOffset >= GetSize())
-    SetSize(byteOffset+10);
+  EncodeSpace(1);
   theArray[byteOffset++] = (BYTE)value;
 }
 
@@ -2470,8 +2486,7 @@ void PASN_Stream::BlockEncode(const BYTE * bufptr, PINDEX nBytes)
 
   ByteAlign();
 
-  if (byteOffset+nBytes >= GetSize())
-    SetSize(byteOffset+nBytes+10);
+  EncodeSpace(nBytes);
 
   memcpy(theArray+byteOffset, bufptr, nBytes);
   byteOffset += nBytes;
@@ -409,8 +409,7 @@ PBoolean PASN_OctetString::DecodeSubType(PASN_Object & obj) const
 void PASN_OctetString::EncodeSubType(const PASN_Object & obj)
 {
   PPER_Stream stream;
-  obj.Encode(stream);
-  stream.CompleteEncoding();
+  stream.EncodeObject(obj);
   SetValue(stream);
 }
 
@@ -1069,8 +1068,7 @@ void PPER_Stream::SingleBitEncode(PBoolean value)
   if (!CheckByteOffset(byteOffset))
     return;
 
-  if (byteOffset >= GetSize())
-    SetSize(byteOffset+10);
+  EncodeSpace(1);
 
   bitOffset--;
 
@@ -1082,12 +1080,19 @@ void PPER_Stream::SingleBitEncode(PBoolean value)
 }
 
 
+/* The multi-bit functions use a 64 bit, big endian, window starting at the
+   current byte. As at most 7 bits of that byte have been used, and at most
+   32 bits are read or written, the value always fits in the window, and is
+   extracted or inserted with a pair of shifts rather than a byte at a time.
+ */
+
 PBoolean PPER_Stream::MultiBitDecode(unsigned nBits, unsigned & value)
 {
   if (nBits > sizeof(value)*8)
     return false;
 
-  unsigned bitsLeft = (GetSize() - byteOffset)*8 - (8 - bitOffset);
+  PINDEX size = GetSize();
+  unsigned bitsLeft = (size - byteOffset)*8 - (8 - bitOffset);
   if (nBits > bitsLeft)
     return false;
 
@@ -1099,28 +1104,31 @@ PBoolean PPER_Stream::MultiBitDecode(unsigned nBits, unsigned & value)
   if (!CheckByteOffset(byteOffset))
     return false;
 
+  // Common case of a few bits within the current byte
   if (nBits < bitOffset) {
     bitOffset -= nBits;
-    value = (theArray[byteOffset] >> bitOffset) & ((1 << nBits) - 1);
+    value = ((BYTE)theArray[byteOffset] >> bitOffset) & ((1 << nBits) - 1);
     return true;
   }
 
-  value = theArray[byteOffset] & ((1 << bitOffset) - 1);
-  nBits -= bitOffset;
-  bitOffset = 8;
-  byteOffset++;
-
-  while (nBits >= 8) {
-    value = (value << 8) | (BYTE)theArray[byteOffset];
-    byteOffset++;
-    nBits -= 8;
+  const BYTE * ptr = (const BYTE *)theArray+byteOffset;
+  PUInt64 window;
+  if (byteOffset+8 <= size)
+    window = *(const PUInt64b *)ptr;
+  else {
+    // Near the end of the buffer, do not read past it
+    PINDEX available = size - byteOffset;
+    window = 0;
+    for (PINDEX i = 0; i < 8; ++i)
+      window = (window << 8) | (i < available ? ptr[i] : 0);
   }
 
-  if (nBits > 0) {
-    bitOffset = 8 - nBits;
-    value = (value << nBits) | ((BYTE)theArray[byteOffset] >> bitOffset);
-  }
+  unsigned used = 8 - bitOffset;
+  value = (unsigned)((window << used) >> (64 - nBits));
 
+  used += nBits;
+  byteOffset += used/8;
+  bitOffset = 8 - used%8;
   return true;
 }
 
@@ -1132,9 +1140,6 @@ void PPER_Stream::MultiBitEncode(unsigned value, unsigned nBits)
   if (nBits == 0 || !PAssert(!((nBits < sizeof(value)*8) && (value > (value & ((1 << nBits) - 1)))), PInvalidParameter))
     return;
 
-  if (byteOffset+nBits/8+1 >= (unsigned)GetSize())
-    SetSize(byteOffset+10);
-
   // Make sure value is in bounds of bit available.
   if (nBits < sizeof(value)*8)
     value &= ((1 << nBits) - 1);
@@ -1142,27 +1147,16 @@ void PPER_Stream::MultiBitEncode(unsigned value, unsigned nBits)
   if (!CheckByteOffset(byteOffset))
     return;
 
-  if (nBits < bitOffset) {
-    bitOffset -= nBits;
-    theArray[byteOffset] |= value << bitOffset;
-    return;
-  }
+  // Everything after the current bit is still zero, so can just OR in
+  EncodeSpace(8);
+  PUInt64b & window = *(PUInt64b *)(theArray+byteOffset);
 
-  nBits -= bitOffset;
-  theArray[byteOffset] |= (BYTE)(value >> nBits);
-  bitOffset = 8;
-  byteOffset++;
+  unsigned used = 8 - bitOffset;
+  window = window | ((PUInt64)value << (64 - used - nBits));
 
-  while (nBits >= 8) {
-    nBits -= 8;
-    theArray[byteOffset] = (BYTE)(value >> nBits);
-    byteOffset++;
-  }
-
-  if (nBits > 0) {
-    bitOffset = 8 - nBits;
-    theArray[byteOffset] |= (BYTE)((value & ((1 << nBits)-1)) << bitOffset);
-  }
+  used += nBits;
+  byteOffset += used/8;
+  bitOffset = 8 - used%8;
 }
 
 
@@ -1357,9 +1351,9 @@ void PPER_Stream::AnyTypeEncode(const PASN_Object * value)
   PPER_Stream substream;
 
   if (value != NULL)
-    value->Encode(substream);
-
-  substream.CompleteEncoding();
+    substream.EncodeObject(*value);
+  else
+    substream.CompleteEncoding();
 
   PINDEX nBytes = substream.GetSize();
   if (nBytes == 0) {
@@ -1372,4 +1366,29 @@ void PPER_Stream::AnyTypeEncode(const PASN_Object * value)
   BlockEncode(substream.GetPointer(), nBytes);
 }
 
+
+void PPER_Stream::EncodeObject(const PASN_Object & obj)
+{
+  // Size of last encoding, keyed by the class name, which is a static string
+  static PCriticalSection mutex;
+  static std::map<const char *, PINDEX> sizeHints;
+
+  const char * type = obj.GetClass();
+
+  PINDEX reserve = 20;
+  mutex.Wait();
+  std::map<const char *, PINDEX>::iterator it = sizeHints.find(type);
+  if (it != sizeHints.end())
+    reserve = it->second + 8;
+  mutex.Signal();
+
+  BeginEncoding(reserve);
+  obj.Encode(*this);
+  CompleteEncoding();
+
+  mutex.Wait();
+  sizeHints[type] = GetSize();
+  mutex.Signal();
+}
+
 ///////////////////////////////////////////////////////////////////////
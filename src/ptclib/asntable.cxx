@@ -0,0 +1,1282 @@
+/*
+ * asntable.cxx
+ *
+ * Table driven Abstract Syntax Notation 1 encoding rules.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifdef __GNUC__
+#pragma implementation "asntable.h"
+#endif
+
+#include <ptlib.h>
+
+#if P_ASN
+
+#include <ptclib/asntable.h>
+
+
+#define PTraceModule() "ASN"
+
+
+typedef PASN_TypeDescriptor Desc;
+
+static __inline void * FieldValue(void * value, const PASN_FieldDescriptor & field)
+{
+  return (BYTE *)value + field.m_offset;
+}
+
+
+static __inline const void * FieldValue(const void * value, const PASN_FieldDescriptor & field)
+{
+  return (const BYTE *)value + field.m_offset;
+}
+
+
+static __inline void * ElementValue(const PASN_TableArray & array, const Desc & element, unsigned idx)
+{
+  return (BYTE *)array.m_elements + idx*element.m_size;
+}
+
+
+static __inline bool HasOptionMask(const Desc & type)
+{
+  return type.m_optionalCount > 0 || type.m_fieldCount > type.m_rootCount;
+}
+
+
+static __inline bool IsPresent(const Desc & type, const void * value, const PASN_FieldDescriptor & field)
+{
+  return field.m_optional < 0 || (HasOptionMask(type) && (*(const PUInt64 *)value & ((PUInt64)1 << field.m_optional)) != 0);
+}
+
+
+static __inline bool IsUnsigned(const Desc & type)
+{
+  return type.m_constraint != PASN_Object::Unconstrained && type.m_lowerLimit >= 0;
+}
+
+
+// Same as the function in asner.cxx, which is not exported
+static PINDEX CountBits(unsigned range)
+{
+  switch (range) {
+    case 0 :
+      return sizeof(unsigned)*8;
+    case 1:
+      return 1;
+  }
+
+  size_t nBits = 0;
+  while (nBits < (sizeof(unsigned)*8) && range > (unsigned)(1 << nBits))
+    nBits++;
+  return nBits;
+}
+
+
+///////////////////////////////////////////////////////////////////////
+
+bool PASN_TableObjectId::SetValue(const PString & dotted)
+{
+  m_size = 0;
+
+  const char * ptr = dotted;
+  while (*ptr != '\0') {
+    if (m_size >= MaxSize || !isdigit(*ptr))
+      return false;
+
+    char * end;
+    m_value[m_size++] = strtoul(ptr, &end, 10);
+    ptr = end;
+    if (*ptr == '.')
+      ++ptr;
+    else if (*ptr != '\0')
+      return false;
+  }
+
+  return true;
+}
+
+
+PString PASN_TableObjectId::AsString() const
+{
+  PStringStream str;
+  for (unsigned i = 0; i < m_size; ++i) {
+    if (i > 0)
+      str << '.';
+    str << m_value[i];
+  }
+  return str;
+}
+
+
+static bool ObjectIdDecode(PASN_TableObjectId & oid, const BYTE * ptr, unsigned len)
+{
+  oid.m_size = 0;
+  if (len == 0)
+    return true;
+
+  // Start at the second identifier, the first encoded value is split into two
+  const BYTE * end = ptr + len;
+  unsigned count = 1;
+  while (ptr < end) {
+    unsigned subId = 0;
+    BYTE b;
+    do {
+      if (ptr >= end)
+        return false;
+      b = *ptr++;
+      subId = (subId << 7) + (b & 0x7f);
+    } while ((b & 0x80) != 0);
+
+    if (count >= PASN_TableObjectId::MaxSize)
+      return false;
+    oid.m_value[count++] = subId;
+  }
+
+  unsigned subId = oid.m_value[1];
+  if (subId < 40) {
+    oid.m_value[0] = 0;
+    oid.m_value[1] = subId;
+  }
+  else if (subId < 80) {
+    oid.m_value[0] = 1;
+    oid.m_value[1] = subId-40;
+  }
+  else {
+    oid.m_value[0] = 2;
+    oid.m_value[1] = subId-80;
+  }
+
+  oid.m_size = count;
+  return true;
+}
+
+
+// Buffer must be at least MaxSize*5 bytes
+static unsigned ObjectIdEncode(const PASN_TableObjectId & oid, BYTE * buffer)
+{
+  if (oid.m_size < 2 || oid.m_size > PASN_TableObjectId::MaxSize)
+    return 0; // Really illegal, but have to do something
+
+  unsigned len = 0;
+  for (unsigned i = 1; i < oid.m_size; ++i) {
+    unsigned subId = i == 1 ? oid.m_value[0]*40 + oid.m_value[1] : oid.m_value[i];
+
+    BYTE septets[5];
+    unsigned count = 0;
+    do {
+      septets[count++] = (BYTE)(subId & 0x7f);
+      subId >>= 7;
+    } while (subId != 0);
+
+    while (count > 1)
+      buffer[len++] = septets[--count] | 0x80;
+    buffer[len++] = septets[0];
+  }
+
+  return len;
+}
+
+
+///////////////////////////////////////////////////////////////////////
+
+bool PASN_TableArray::SetSize(unsigned size, unsigned elementSize)
+{
+  if (size > m_capacity) {
+    if (size > (unsigned)PASN_Object::GetMaximumArraySize())
+      return false;
+
+    unsigned newCapacity = std::max(size, m_capacity*2);
+    void * newElements = realloc(m_elements, newCapacity*elementSize);
+    if (newElements == NULL)
+      return false;
+
+    memset((BYTE *)newElements + m_capacity*elementSize, 0, (newCapacity - m_capacity)*elementSize);
+    m_elements = newElements;
+    m_capacity = newCapacity;
+  }
+
+  m_size = size;
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////
+// BER
+
+static bool BERHeaderDecode(const BYTE * & ptr,
+                            const BYTE * end,
+                            unsigned & tag,
+                            PASN_Object::TagClass & tagClass,
+                            bool & primitive,
+                            unsigned & len)
+{
+  if (ptr >= end)
+    return false;
+
+  BYTE ident = *ptr++;
+  tagClass = (PASN_Object::TagClass)(ident >> 6);
+  primitive = (ident & 0x20) == 0;
+  tag = ident & 31;
+  if (tag == 31) {
+    BYTE b;
+    tag = 0;
+    do {
+      if (ptr >= end)
+        return false;
+      b = *ptr++;
+      tag = (tag << 7) | (b & 0x7f);
+    } while ((b & 0x80) != 0);
+  }
+
+  if (ptr >= end)
+    return false;
+
+  BYTE lenLen = *ptr++;
+  if ((lenLen & 0x80) == 0)
+    len = lenLen;
+  else {
+    lenLen &= 0x7f;
+    if (lenLen > sizeof(unsigned))
+      return false;
+
+    len = 0;
+    while (lenLen-- > 0) {
+      if (ptr >= end)
+        return false;
+      len = (len << 8) | *ptr++;
+    }
+  }
+
+  return len <= (unsigned)(end - ptr);
+}
+
+
+static bool BERMatchesTag(const Desc & type, unsigned tag, PASN_Object::TagClass tagClass)
+{
+  if (type.m_kind == Desc::e_Any)
+    return true;
+
+  if (type.m_kind != Desc::e_Choice)
+    return type.m_tag == tag && type.m_tagClass == tagClass;
+
+  // Untagged CHOICE matches any of its alternatives
+  for (unsigned i = 0; i < type.m_fieldCount; ++i) {
+    if (BERMatchesTag(*type.m_fields[i].m_type, tag, tagClass))
+      return true;
+  }
+  return false;
+}
+
+
+static bool BERPeekTag(const BYTE * ptr, const BYTE * end, unsigned & tag, PASN_Object::TagClass & tagClass)
+{
+  bool primitive;
+  unsigned len;
+  return BERHeaderDecode(ptr, end, tag, tagClass, primitive, len);
+}
+
+
+static bool BERDecodeValue(const Desc & type, void * value, const BYTE * & ptr, const BYTE * end);
+
+static bool BERDecodeSequence(const Desc & type, void * value, const BYTE * ptr, const BYTE * end)
+{
+  PUInt64 options = 0;
+
+  for (unsigned i = 0; i < type.m_fieldCount; ++i) {
+    const PASN_FieldDescriptor & field = type.m_fields[i];
+    if (field.m_optional >= 0) {
+      unsigned tag;
+      PASN_Object::TagClass tagClass;
+      if (!BERPeekTag(ptr, end, tag, tagClass) || !BERMatchesTag(*field.m_type, tag, tagClass))
+        continue;
+      options |= (PUInt64)1 << field.m_optional;
+    }
+
+    if (!BERDecodeValue(*field.m_type, FieldValue(value, field), ptr, end))
+      return false;
+  }
+
+  if (HasOptionMask(type))
+    *(PUInt64 *)value = options;
+
+  // Anything left is unknown extensions, which are ignored
+  return true;
+}
+
+
+static bool BERDecodeValue(const Desc & type, void * value, const BYTE * & ptr, const BYTE * end)
+{
+  unsigned tag;
+  PASN_Object::TagClass tagClass;
+
+  if (type.m_kind == Desc::e_Choice) {
+    // Alternative is selected by the tag of the next element
+    if (!BERPeekTag(ptr, end, tag, tagClass))
+      return false;
+
+    for (unsigned i = 0; i < type.m_fieldCount; ++i) {
+      const PASN_FieldDescriptor & alternative = type.m_fields[i];
+      if (BERMatchesTag(*alternative.m_type, tag, tagClass)) {
+        *(unsigned *)value = i;
+        return BERDecodeValue(*alternative.m_type, FieldValue(value, alternative), ptr, end);
+      }
+    }
+    return false;
+  }
+
+  bool primitive;
+  unsigned len;
+
+  if (type.m_kind == Desc::e_Any) {
+    // Whatever the next element is, tag and length included
+    const BYTE * start = ptr;
+    if (!BERHeaderDecode(ptr, end, tag, tagClass, primitive, len))
+      return false;
+    ptr += len;
+    ((PASN_TableOctets *)value)->SetValue(start, ptr - start);
+    return true;
+  }
+
+  if (!BERHeaderDecode(ptr, end, tag, tagClass, primitive, len) || tag != type.m_tag || tagClass != type.m_tagClass)
+    return false;
+
+  const BYTE * contentEnd = ptr + len;
+
+  switch (type.m_kind) {
+    case Desc::e_Null :
+      break;
+
+    case Desc::e_Boolean :
+      if (len > 0)
+        *(bool *)value = ptr[len-1] != 0;
+      break;
+
+    case Desc::e_Integer :
+    {
+      if (len == 0 || len > sizeof(PInt64))
+        return false;
+
+      PUInt64 accumulator = (*ptr & 0x80) != 0 ? ~(PUInt64)0 : 0; // sign extend
+      while (ptr < contentEnd)
+        accumulator = (accumulator << 8) | *ptr++;
+      *(PInt64 *)value = (PInt64)accumulator;
+      break;
+    }
+
+    case Desc::e_Enumeration :
+    {
+      if (len == 0 || len > sizeof(unsigned)+1)
+        return false;
+
+      unsigned accumulator = 0;
+      while (ptr < contentEnd)
+        accumulator = (accumulator << 8) | *ptr++;
+      *(unsigned *)value = accumulator;
+      break;
+    }
+
+    case Desc::e_ObjectId :
+      if (!ObjectIdDecode(*(PASN_TableObjectId *)value, ptr, len))
+        return false;
+      break;
+
+    case Desc::e_OctetString :
+      if (!primitive)
+        return false; // Constructed form not supported
+
+      ((PASN_TableOctets *)value)->SetValue(ptr, len);
+      break;
+
+    case Desc::e_Sequence :
+      if (!BERDecodeSequence(type, value, ptr, contentEnd))
+        return false;
+      break;
+
+    case Desc::e_SequenceOf :
+    {
+      PASN_TableArray & array = *(PASN_TableArray *)value;
+      const Desc & element = *type.m_element;
+      array.m_size = 0;
+      unsigned count = 0;
+      while (ptr < contentEnd) {
+        if (!array.SetSize(count+1, element.m_size))
+          return false;
+        if (!BERDecodeValue(element, ElementValue(array, element, count), ptr, contentEnd))
+          return false;
+        ++count;
+      }
+      break;
+    }
+
+    default :
+      return false;
+  }
+
+  ptr = contentEnd;
+  return true;
+}
+
+
+class PASN_TableBERWriter
+{
+  public:
+    PASN_TableBERWriter(PBYTEArray & buffer)
+      : m_buffer(buffer)
+      , m_data(buffer.GetPointer())
+      , m_size(buffer.GetSize())
+      , m_position(0)
+    {
+    }
+
+    BYTE * Reserve(PINDEX count)
+    {
+      if (m_position + count > m_size) {
+        m_size = std::max(m_size*2, m_position + count + 64);
+        m_data = m_buffer.GetPointer(m_size);
+      }
+      return m_data + m_position;
+    }
+
+    void Byte(unsigned value)
+    {
+      *Reserve(1) = (BYTE)value;
+      ++m_position;
+    }
+
+    void Block(const BYTE * data, PINDEX length)
+    {
+      if (length > 0) {
+        memcpy(Reserve(length), data, length);
+        m_position += length;
+      }
+    }
+
+    /* The length is not known until the content is encoded, so one byte is
+       reserved for it, and the content moved up in the rare case that the
+       long form of the length is needed. */
+    PINDEX BeginTLV(const Desc & type, bool constructed)
+    {
+      BYTE ident = (BYTE)(type.m_tagClass << 6);
+      if (constructed)
+        ident |= 0x20;
+
+      unsigned tag = type.m_tag;
+      if (tag < 31)
+        Byte(ident|tag);
+      else {
+        Byte(ident|31);
+        unsigned count = (CountBits(tag)+6)/7;
+        while (count-- > 1)
+          Byte((tag >> (count*7))&0x7f);
+        Byte(tag&0x7f);
+      }
+
+      Byte(0);
+      return m_position;
+    }
+
+    void EndTLV(PINDEX contentStart)
+    {
+      PINDEX length = m_position - contentStart;
+      if (length < 128) {
+        m_data[contentStart-1] = (BYTE)length;
+        return;
+      }
+
+      unsigned count = length < 0x100 ? 1 : length < 0x10000 ? 2 : length < 0x1000000 ? 3 : 4;
+      Reserve(count);
+      memmove(m_data + contentStart + count, m_data + contentStart, length);
+      m_data[contentStart-1] = (BYTE)(0x80|count);
+      for (unsigned i = 0; i < count; ++i)
+        m_data[contentStart+i] = (BYTE)(length >> ((count-i-1)*8));
+      m_position += count;
+    }
+
+    PINDEX GetPosition() const { return m_position; }
+
+  protected:
+    PBYTEArray & m_buffer;
+    BYTE       * m_data;
+    PINDEX       m_size;
+    PINDEX       m_position;
+};
+
+
+static void BEREncodeInteger(PASN_TableBERWriter & writer, PInt64 value)
+{
+  // Minimum number of octets for two's complement
+  unsigned count = 1;
+  while (count < sizeof(value) && (value < -((PInt64)1 << (count*8-1)) || value >= ((PInt64)1 << (count*8-1))))
+    ++count;
+
+  while (count-- > 0)
+    writer.Byte((unsigned)(value >> (count*8)));
+}
+
+
+static void BEREncodeValue(PASN_TableBERWriter & writer, const Desc & type, const void * value)
+{
+  if (type.m_kind == Desc::e_Choice) {
+    unsigned choice = *(const unsigned *)value;
+    if (PAssert(choice < type.m_fieldCount, PInvalidParameter))
+      BEREncodeValue(writer, *type.m_fields[choice].m_type, FieldValue(value, type.m_fields[choice]));
+    return;
+  }
+
+  if (type.m_kind == Desc::e_Any) {
+    const PASN_TableOctets & octets = *(const PASN_TableOctets *)value;
+    writer.Block(octets.GetPointer(), octets.GetSize());
+    return;
+  }
+
+  PINDEX contentStart = writer.BeginTLV(type, type.m_kind == Desc::e_Sequence || type.m_kind == Desc::e_SequenceOf);
+
+  switch (type.m_kind) {
+    case Desc::e_Boolean :
+      writer.Byte(*(const bool *)value);
+      break;
+
+    case Desc::e_Integer :
+      BEREncodeInteger(writer, *(const PInt64 *)value);
+      break;
+
+    case Desc::e_Enumeration :
+      BEREncodeInteger(writer, *(const unsigned *)value);
+      break;
+
+    case Desc::e_ObjectId :
+    {
+      BYTE buffer[PASN_TableObjectId::MaxSize*5];
+      writer.Block(buffer, ObjectIdEncode(*(const PASN_TableObjectId *)value, buffer));
+      break;
+    }
+
+    case Desc::e_OctetString :
+    {
+      const PASN_TableOctets & octets = *(const PASN_TableOctets *)value;
+      writer.Block(octets.GetPointer(), octets.GetSize());
+      break;
+    }
+
+    case Desc::e_Sequence :
+      for (unsigned i = 0; i < type.m_fieldCount; ++i) {
+        const PASN_FieldDescriptor & field = type.m_fields[i];
+        if (IsPresent(type, value, field))
+          BEREncodeValue(writer, *field.m_type, FieldValue(value, field));
+      }
+      break;
+
+    case Desc::e_SequenceOf :
+    {
+      const PASN_TableArray & array = *(const PASN_TableArray *)value;
+      for (unsigned i = 0; i < array.m_size; ++i)
+        BEREncodeValue(writer, *type.m_element, ElementValue(array, *type.m_element, i));
+      break;
+    }
+
+    default :
+      break;
+  }
+
+  writer.EndTLV(contentStart);
+}
+
+
+bool PASN_TableCodec::DecodeBER(const PASN_TypeDescriptor & type, void * value, const BYTE * data, PINDEX size, PINDEX * used)
+{
+  const BYTE * ptr = data;
+  if (!BERDecodeValue(type, value, ptr, data + size)) {
+    PTRACE(4, "Could not decode BER for " << type.m_name);
+    return false;
+  }
+
+  if (used != NULL)
+    *used = ptr - data;
+  return true;
+}
+
+
+bool PASN_TableCodec::DecodeBER(const PASN_TypeDescriptor & type, void * value, PBER_Stream & strm)
+{
+  PINDEX position = strm.GetPosition();
+  PINDEX used;
+  if (!DecodeBER(type, value, (const BYTE *)strm + position, strm.GetSize() - position, &used))
+    return false;
+
+  strm.SetPosition(position + used);
+  return true;
+}
+
+
+PINDEX PASN_TableCodec::EncodeBER(const PASN_TypeDescriptor & type, const void * value, PBYTEArray & buffer)
+{
+  PASN_TableBERWriter writer(buffer);
+  BEREncodeValue(writer, type, value);
+  return writer.GetPosition();
+}
+
+
+void PASN_TableCodec::EncodeBER(const PASN_TypeDescriptor & type, const void * value, PBER_Stream & strm)
+{
+  PBYTEArray buffer;
+  PINDEX length = EncodeBER(type, value, buffer);
+  strm.BlockEncode(buffer, length);
+}
+
+
+///////////////////////////////////////////////////////////////////////
+// PER, these mirror the PASN_Object classes exactly, see asnper.cxx
+
+static bool PERConstraintEncode(const Desc & type, PPER_Stream & strm, unsigned value)
+{
+  if (!type.m_extendable)
+    return type.m_constraint != PASN_Object::FixedConstraint;
+
+  bool needsExtending = value > type.m_upperLimit;
+
+  if (!needsExtending) {
+    if (type.m_lowerLimit < 0) {
+      if ((int)value < type.m_lowerLimit)
+        needsExtending = true;
+    }
+    else {
+      if (value < (unsigned)type.m_lowerLimit)
+        needsExtending = true;
+    }
+  }
+
+  strm.SingleBitEncode(needsExtending);
+
+  return needsExtending;
+}
+
+
+static bool PERConstrainedLengthDecode(const Desc & type, PPER_Stream & strm, unsigned & length)
+{
+  // The SingleBitDecode() function must be called if extendable is true, no matter what.
+  if ((type.m_extendable && strm.SingleBitDecode()) || type.m_constraint == PASN_Object::Unconstrained)
+    return strm.LengthDecode(0, INT_MAX, length);
+  else
+    return strm.LengthDecode(type.m_lowerLimit, type.m_upperLimit, length);
+}
+
+
+static void PERConstrainedLengthEncode(const Desc & type, PPER_Stream & strm, unsigned length)
+{
+  if (PERConstraintEncode(type, strm, length)) // 26.4
+    strm.LengthEncode(length, 0, INT_MAX);
+  else
+    strm.LengthEncode(length, type.m_lowerLimit, type.m_upperLimit);
+}
+
+
+// Equivalent of BlockDecode() but refers to the stream buffer instead of copying
+static bool PERBlockRef(PPER_Stream & strm, const BYTE * & data, unsigned length)
+{
+  data = NULL;
+  if (length == 0)
+    return true;
+
+  strm.ByteAlign();
+  PINDEX position = strm.GetPosition();
+  if (position + length > (PINDEX)strm.GetSize())
+    return false;
+
+  data = (const BYTE *)strm + position;
+  strm.SetPosition(position + length);
+  return true;
+}
+
+
+// Fixed size bitmap, as used for the option map, X.691 Section 15
+static bool PERBitmapDecode(PPER_Stream & strm, unsigned size, BYTE * bits)
+{
+  unsigned totalBits;
+  if (!strm.LengthDecode(size, size, totalBits))
+    return false;
+
+  if (totalBits == 0)
+    return true;
+
+  if (totalBits > strm.GetBitsLeft())
+    return false;
+
+  unsigned nBytes = (totalBits+7)/8;
+  if (totalBits > 16)
+    return strm.BlockDecode(bits, nBytes) == nBytes;   // 15.9
+
+  for (unsigned i = 0; i < nBytes; ++i) {
+    unsigned count = std::min(totalBits - i*8, 8U);
+    unsigned theBits;
+    if (!strm.MultiBitDecode(count, theBits))
+      return false;
+    bits[i] = (BYTE)(theBits << (8-count));
+  }
+  return true;
+}
+
+
+static void PERBitmapEncode(PPER_Stream & strm, unsigned size, const BYTE * bits)
+{
+  strm.LengthEncode(size, size, size);
+
+  if (size == 0)
+    return;
+
+  if (size > 16) {
+    strm.BlockEncode(bits, (size+7)/8);   // 15.9
+    return;
+  }
+
+  for (unsigned i = 0; i < (size+7)/8; ++i) {
+    unsigned count = std::min(size - i*8, 8U);
+    strm.MultiBitEncode(bits[i] >> (8-count), count);
+  }
+}
+
+
+static __inline bool GetBit(const BYTE * bits, unsigned idx)
+{
+  return (bits[idx>>3] & (1 << (7 - (idx&7)))) != 0;
+}
+
+
+static __inline void SetBit(BYTE * bits, unsigned idx)
+{
+  bits[idx>>3] |= (BYTE)(1 << (7 - (idx&7)));
+}
+
+
+static bool PERDecodeValue(const Desc & type, void * value, PPER_Stream & strm);
+static void PEREncodeValue(const Desc & type, const void * value, PPER_Stream & strm);
+
+
+static void PEREncodeOpenType(const Desc & type, const void * value, PPER_Stream & strm)
+{
+  PPER_Stream substream;
+  PEREncodeValue(type, value, substream);
+  substream.CompleteEncoding();
+
+  PINDEX nBytes = substream.GetSize();
+  if (nBytes == 0) {
+    static const BYTE null[1] = { 0 };
+    strm.LengthEncode(sizeof(null), 0, INT_MAX);
+    strm.BlockEncode(null, sizeof(null));
+  }
+  else {
+    strm.LengthEncode(nBytes, 0, INT_MAX);
+    strm.BlockEncode(substream, nBytes);
+  }
+}
+
+
+static bool PERDecodeSequence(const Desc & type, void * value, PPER_Stream & strm)
+{
+  // X.691 Section 18
+
+  bool hasExtensions = false;
+  if (type.m_extendable) {
+    if (strm.IsAtEnd())
+      return false;
+    hasExtensions = strm.SingleBitDecode(); // 18.1
+  }
+
+  BYTE optionBits[8] = { 0 };
+  if (type.m_optionalCount > sizeof(optionBits)*8 || !PERBitmapDecode(strm, type.m_optionalCount, optionBits)) // 18.2
+    return false;
+
+  PUInt64 options = 0;
+  for (unsigned i = 0; i < type.m_optionalCount; ++i) {
+    if (GetBit(optionBits, i))
+      options |= (PUInt64)1 << i;
+  }
+
+  unsigned i;
+  for (i = 0; i < type.m_rootCount; ++i) {
+    const PASN_FieldDescriptor & field = type.m_fields[i];
+    if (field.m_optional < 0 || (options & ((PUInt64)1 << field.m_optional)) != 0) {
+      if (!PERDecodeValue(*field.m_type, FieldValue(value, field), strm))
+        return false;
+    }
+  }
+
+  if (hasExtensions) {
+    unsigned totalExtensions;
+    if (!strm.SmallUnsignedDecode(totalExtensions))
+      return false;
+    ++totalExtensions;
+
+    BYTE extensionBits[64] = { 0 };
+    if (totalExtensions > sizeof(extensionBits)*8 || totalExtensions > strm.GetBitsLeft())
+      return false;
+
+    for (i = 0; i < totalExtensions; ++i) {
+      if (strm.SingleBitDecode())
+        SetBit(extensionBits, i);
+    }
+
+    // Each extension is an open type, unknown ones are skipped
+    for (i = 0; i < totalExtensions; ++i) {
+      if (!GetBit(extensionBits, i))
+        continue;
+
+      unsigned len;
+      if (!strm.LengthDecode(0, INT_MAX, len))
+        return false;
+
+      PINDEX nextExtensionPosition = strm.GetPosition() + len;
+      if (type.m_rootCount + i < type.m_fieldCount) {
+        const PASN_FieldDescriptor & field = type.m_fields[type.m_rootCount + i];
+        if (!PERDecodeValue(*field.m_type, FieldValue(value, field), strm))
+          return false;
+        options |= (PUInt64)1 << field.m_optional;
+      }
+      strm.SetPosition(nextExtensionPosition);
+    }
+  }
+
+  if (HasOptionMask(type))
+    *(PUInt64 *)value = options;
+
+  return true;
+}
+
+
+static void PEREncodeSequence(const Desc & type, const void * value, PPER_Stream & strm)
+{
+  // X.691 Section 18
+
+  unsigned i, totalExtensions = 0;
+  for (i = type.m_rootCount; i < type.m_fieldCount; ++i) {
+    if (IsPresent(type, value, type.m_fields[i]))
+      totalExtensions = i - type.m_rootCount + 1;
+  }
+
+  if (type.m_extendable)
+    strm.SingleBitEncode(totalExtensions > 0);  // 18.1
+
+  BYTE optionBits[8] = { 0 };
+  unsigned optionalCount = std::min(type.m_optionalCount, (unsigned)sizeof(optionBits)*8);
+  for (i = 0; i < type.m_rootCount; ++i) {
+    const PASN_FieldDescriptor & field = type.m_fields[i];
+    if (field.m_optional >= 0 && field.m_optional < (int)optionalCount && IsPresent(type, value, field))
+      SetBit(optionBits, field.m_optional);
+  }
+  PERBitmapEncode(strm, optionalCount, optionBits);  // 18.2
+
+  for (i = 0; i < type.m_rootCount; ++i) {
+    const PASN_FieldDescriptor & field = type.m_fields[i];
+    if (IsPresent(type, value, field))
+      PEREncodeValue(*field.m_type, FieldValue(value, field), strm);
+  }
+
+  if (totalExtensions == 0)
+    return;
+
+  strm.SmallUnsignedEncode(totalExtensions-1);
+  for (i = 0; i < totalExtensions; ++i)
+    strm.SingleBitEncode(IsPresent(type, value, type.m_fields[type.m_rootCount + i]));
+
+  for (i = 0; i < totalExtensions; ++i) {
+    const PASN_FieldDescriptor & field = type.m_fields[type.m_rootCount + i];
+    if (IsPresent(type, value, field))
+      PEREncodeOpenType(*field.m_type, FieldValue(value, field), strm);
+  }
+}
+
+
+static bool PERDecodeValue(const Desc & type, void * value, PPER_Stream & strm)
+{
+  switch (type.m_kind) {
+    case Desc::e_Null :
+      return true;
+
+    case Desc::e_Boolean :
+      // X.691 Section 11
+      if (strm.IsAtEnd())
+        return false;
+      *(bool *)value = strm.SingleBitDecode();
+      return true;
+
+    case Desc::e_Integer :
+    {
+      // X.691 Sections 12
+      unsigned intValue;
+      switch (type.m_constraint) {
+        case PASN_Object::FixedConstraint : // 12.2.1 & 12.2.2
+          break;
+
+        case PASN_Object::ExtendableConstraint :
+          if (!strm.SingleBitDecode()) //  12.1
+            break;
+          // Fall into default case for unconstrained or partially constrained
+
+        default : // 12.2.6
+          unsigned len;
+          if (!strm.LengthDecode(0, INT_MAX, len))
+            return false;
+
+          len *= 8;
+          if (!strm.MultiBitDecode(len, intValue))
+            return false;
+
+          if (IsUnsigned(type))
+            *(PInt64 *)value = (unsigned)(intValue + type.m_lowerLimit);
+          else {
+            if (len > 0 && len < 32 && (intValue&(1<<(len-1))) != 0) // Negative
+              intValue |= UINT_MAX << len;                          // Sign extend
+            *(PInt64 *)value = (int)intValue;
+          }
+          return true;
+      }
+
+      if ((unsigned)type.m_lowerLimit != type.m_upperLimit) { // 12.2.2
+        if (!strm.UnsignedDecode(type.m_lowerLimit, type.m_upperLimit, intValue)) // which devolves to 10.5
+          return false;
+      }
+      else
+        intValue = type.m_lowerLimit; // 12.2.1
+
+      *(PInt64 *)value = IsUnsigned(type) ? (PInt64)intValue : (PInt64)(int)intValue;
+      return true;
+    }
+
+    case Desc::e_Enumeration :
+    {
+      // X.691 Section 13
+      unsigned & enumValue = *(unsigned *)value;
+      if (type.m_extendable) {  // 13.3
+        if (strm.SingleBitDecode()) {
+          unsigned len = 0;
+          return strm.SmallUnsignedDecode(len) &&
+                 len > 0 &&
+                 strm.UnsignedDecode(0, len-1, enumValue);
+        }
+      }
+
+      return strm.UnsignedDecode(0, type.m_upperLimit, enumValue);  // 13.2
+    }
+
+    case Desc::e_ObjectId :
+    {
+      // X.691 Section 23
+      unsigned dataLen;
+      if (!strm.LengthDecode(0, 255, dataLen))
+        return false;
+
+      strm.ByteAlign();
+
+      const BYTE * data;
+      return PERBlockRef(strm, data, dataLen) && ObjectIdDecode(*(PASN_TableObjectId *)value, data, dataLen);
+    }
+
+    case Desc::e_OctetString :
+    case Desc::e_Any : // Unconstrained, so as for the generated PASN_OctetString
+    {
+      // X.691 Section 16
+      PASN_TableOctets & octets = *(PASN_TableOctets *)value;
+
+      unsigned nBytes;
+      if (!PERConstrainedLengthDecode(type, strm, nBytes))
+        return false;
+
+      if (nBytes > (unsigned)PASN_Object::GetMaximumStringSize())
+        return false;
+
+      octets.m_size = nBytes;
+
+      if (nBytes > 2 || (int)type.m_upperLimit != type.m_lowerLimit) // 16.7
+        return PERBlockRef(strm, octets.m_data, nBytes);
+
+      // 16.6, not octet aligned, so copy
+      unsigned theBits = 0;
+      if (nBytes > 0 && !strm.MultiBitDecode(nBytes*8, theBits))
+        return false;
+      octets.m_data = NULL;
+      octets.m_inline[0] = (BYTE)(theBits >> (nBytes > 1 ? 8 : 0));
+      octets.m_inline[1] = (BYTE)theBits;
+      return true;
+    }
+
+    case Desc::e_Sequence :
+      return PERDecodeSequence(type, value, strm);
+
+    case Desc::e_SequenceOf :
+    {
+      PASN_TableArray & array = *(PASN_TableArray *)value;
+      const Desc & element = *type.m_element;
+
+      unsigned size = 0;
+      if (!PERConstrainedLengthDecode(type, strm, size))
+        return false;
+
+      if (!array.SetSize(size, element.m_size))
+        return false;
+
+      for (unsigned i = 0; i < size; ++i) {
+        if (!PERDecodeValue(element, ElementValue(array, element, i), strm))
+          return false;
+      }
+      return true;
+    }
+
+    case Desc::e_Choice :
+    {
+      // X.691 Section 22
+      if (strm.IsAtEnd())
+        return false;
+
+      unsigned & choice = *(unsigned *)value;
+
+      if (type.m_extendable) {
+        if (strm.SingleBitDecode()) {
+          if (!strm.SmallUnsignedDecode(choice))
+            return false;
+
+          choice += type.m_rootCount;
+
+          unsigned len = 0;
+          if (!strm.LengthDecode(0, INT_MAX, len))
+            return false;
+
+          // Unknown alternatives are skipped, leaving choice out of range
+          bool ok = true;
+          PINDEX nextPos = strm.GetPosition() + len;
+          if (choice < type.m_fieldCount)
+            ok = PERDecodeValue(*type.m_fields[choice].m_type, FieldValue(value, type.m_fields[choice]), strm);
+          strm.SetPosition(nextPos);
+          return ok;
+        }
+      }
+
+      if (type.m_rootCount < 2)
+        choice = 0;
+      else {
+        if (!strm.UnsignedDecode(0, type.m_rootCount-1, choice))
+          return false;
+      }
+
+      return choice < type.m_fieldCount &&
+             PERDecodeValue(*type.m_fields[choice].m_type, FieldValue(value, type.m_fields[choice]), strm);
+    }
+  }
+
+  return false;
+}
+
+
+static void PEREncodeValue(const Desc & type, const void * value, PPER_Stream & strm)
+{
+  switch (type.m_kind) {
+    case Desc::e_Null :
+      break;
+
+    case Desc::e_Boolean :
+      // X.691 Section 11
+      strm.SingleBitEncode(*(const bool *)value);
+      break;
+
+    case Desc::e_Integer :
+    {
+      // X.691 Sections 12
+      unsigned intValue = (unsigned)*(const PInt64 *)value;
+
+      //  12.1
+      if (PERConstraintEncode(type, strm, intValue)) {
+        // 12.2.6
+        unsigned adjusted_value = intValue - type.m_lowerLimit;
+
+        PINDEX nBits = 1; // Allow for sign bit
+        if (IsUnsigned(type))
+          nBits = CountBits(adjusted_value+1);
+        else if ((int)adjusted_value > 0)
+          nBits += CountBits(adjusted_value+1);
+        else
+          nBits += CountBits(-(int)adjusted_value+1);
+
+        // Round up to nearest number of whole octets
+        PINDEX nBytes = (nBits+7)/8;
+        strm.LengthEncode(nBytes, 0, INT_MAX);
+        strm.MultiBitEncode(adjusted_value, nBytes*8);
+      }
+      else if ((unsigned)type.m_lowerLimit != type.m_upperLimit) // 12.2.1
+        strm.UnsignedEncode(intValue, type.m_lowerLimit, type.m_upperLimit); // 12.2.2 which devolves to 10.5
+      break;
+    }
+
+    case Desc::e_Enumeration :
+    {
+      // X.691 Section 13
+      unsigned enumValue = *(const unsigned *)value;
+      if (type.m_extendable) {  // 13.3
+        bool extended = enumValue > type.m_upperLimit;
+        strm.SingleBitEncode(extended);
+        if (extended) {
+          strm.SmallUnsignedEncode(1+enumValue);
+          strm.UnsignedEncode(enumValue, 0, enumValue);
+          break;
+        }
+      }
+
+      strm.UnsignedEncode(enumValue, 0, type.m_upperLimit);  // 13.2
+      break;
+    }
+
+    case Desc::e_ObjectId :
+    {
+      // X.691 Section 23
+      BYTE buffer[PASN_TableObjectId::MaxSize*5];
+      unsigned length = ObjectIdEncode(*(const PASN_TableObjectId *)value, buffer);
+      strm.LengthEncode(length, 0, 255);
+      strm.BlockEncode(buffer, length);
+      break;
+    }
+
+    case Desc::e_OctetString :
+    case Desc::e_Any :
+    {
+      // X.691 Section 16
+      const PASN_TableOctets & octets = *(const PASN_TableOctets *)value;
+      unsigned nBytes = octets.GetSize();
+      PERConstrainedLengthEncode(type, strm, nBytes);
+
+      if ((int)type.m_upperLimit != type.m_lowerLimit || nBytes > 2) // 16.7
+        strm.BlockEncode(octets.GetPointer(), nBytes);
+      else {
+        for (unsigned i = 0; i < nBytes; ++i) // 16.6
+          strm.MultiBitEncode(octets.GetPointer()[i], 8);
+      }
+      break;
+    }
+
+    case Desc::e_Sequence :
+      PEREncodeSequence(type, value, strm);
+      break;
+
+    case Desc::e_SequenceOf :
+    {
+      const PASN_TableArray & array = *(const PASN_TableArray *)value;
+      PERConstrainedLengthEncode(type, strm, array.m_size);
+      for (unsigned i = 0; i < array.m_size; ++i)
+        PEREncodeValue(*type.m_element, ElementValue(array, *type.m_element, i), strm);
+      break;
+    }
+
+    case Desc::e_Choice :
+    {
+      // X.691 Section 22
+      unsigned choice = *(const unsigned *)value;
+      if (!PAssert(choice < type.m_fieldCount, PInvalidParameter))
+        break;
+
+      const PASN_FieldDescriptor & alternative = type.m_fields[choice];
+
+      if (type.m_extendable) {
+        bool extended = choice >= type.m_rootCount;
+        strm.SingleBitEncode(extended);
+        if (extended) {
+          strm.SmallUnsignedEncode(choice - type.m_rootCount);
+          PEREncodeOpenType(*alternative.m_type, FieldValue(value, alternative), strm);
+          break;
+        }
+      }
+
+      if (type.m_rootCount > 1)
+        strm.UnsignedEncode(choice, 0, type.m_rootCount-1);
+
+      PEREncodeValue(*alternative.m_type, FieldValue(value, alternative), strm);
+      break;
+    }
+  }
+}
+
+
+bool PASN_TableCodec::DecodePER(const PASN_TypeDescriptor & type, void * value, PPER_Stream & strm)
+{
+  if (PERDecodeValue(type, value, strm))
+    return true;
+
+  PTRACE(4, "Could not decode PER for " << type.m_name);
+  return false;
+}
+
+
+void PASN_TableCodec::EncodePER(const PASN_TypeDescriptor & type, const void * value, PPER_Stream & strm)
+{
+  PEREncodeValue(type, value, strm);
+}
+
+
+///////////////////////////////////////////////////////////////////////
+
+bool PASN_TableCodec::ToObject(const PASN_TypeDescriptor & type, const void * value, PASN_Object & obj)
+{
+  PBYTEArray buffer;
+  PINDEX length = EncodeBER(type, value, buffer);
+  PBER_Stream strm((const BYTE *)buffer, length);
+  return obj.Decode(strm);
+}
+
+
+bool PASN_TableCodec::FromObject(const PASN_TypeDescriptor & type, const PASN_Object & obj, void * value, PBYTEArray & storage)
+{
+  PBER_Stream strm;
+  obj.Encode(strm);
+  strm.CompleteEncoding();
+  storage = strm;
+  return DecodeBER(type, value, storage, storage.GetSize());
+}
+
+
+void PASN_TableCodec::Free(const PASN_TypeDescriptor & type, void * value)
+{
+  switch (type.m_kind) {
+    case Desc::e_Sequence :
+    case Desc::e_Choice :
+      for (unsigned i = 0; i < type.m_fieldCount; ++i)
+        Free(*type.m_fields[i].m_type, FieldValue(value, type.m_fields[i]));
+      break;
+
+    case Desc::e_SequenceOf :
+    {
+      // Elements beyond the size may still have memory from previous use
+      PASN_TableArray & array = *(PASN_TableArray *)value;
+      for (unsigned i = 0; i < array.m_capacity; ++i)
+        Free(*type.m_element, ElementValue(array, *type.m_element, i));
+      free(array.m_elements);
+      array.m_elements = NULL;
+      array.m_size = array.m_capacity = 0;
+      break;
+    }
+
+    default :
+      break;
+  }
+}
+
+
+#endif // P_ASN
+
+
+// End Of File ///////////////////////////////////////////////////////////////
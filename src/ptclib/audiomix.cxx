@@ -0,0 +1,475 @@
+/*
+ * audiomix.cxx
+ *
+ * Audio mixing for multi-party conferences.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifdef __GNUC__
+#pragma implementation "audiomix.h"
+#endif
+
+#include <ptlib.h>
+
+#if P_AUDIO
+
+#include <ptclib/audiomix.h>
+
+#define PTraceModule() "AudioMix"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PAudioMixer::Resampler::Resampler(unsigned srcRate, unsigned dstRate)
+  : m_srcRate(srcRate)
+  , m_dstRate(dstRate)
+  , m_step(((PUInt64)srcRate << 32)/dstRate)
+  , m_position(1ULL << 32)
+  , m_last(0)
+{
+}
+
+
+PINDEX PAudioMixer::Resampler::Convert(const short * src, PINDEX count, short * dst)
+{
+  if (count <= 0)
+    return 0;
+
+  // Interpolate between samples at index and index+1, where index zero is
+  // the last sample of the previous block and index N is src[N-1]
+  short * out = dst;
+  PINDEX index;
+  while ((index = (PINDEX)(m_position >> 32)) < count) {
+    int a = index == 0 ? m_last : src[index-1];
+    int b = src[index];
+    int fraction = (int)((m_position >> 16) & 0xffff);
+    *out++ = (short)(a + (((b - a) * fraction) >> 16));
+    m_position += m_step;
+  }
+
+  m_position -= (PUInt64)count << 32;
+  m_last = src[count-1];
+  return out - dst;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PAudioMixer::Participant::Participant(const PString & id,
+                                      unsigned sampleRate,
+                                      unsigned mixerRate,
+                                      PINDEX periodSamples,
+                                      PINDEX jitterSamples,
+                                      PSoundChannel * recorder,
+                                      PSoundChannel * player,
+                                      bool autoDelete)
+  : m_id(id)
+  , m_sampleRate(sampleRate)
+  , m_queue(std::max(jitterSamples, periodSamples)*2 + periodSamples)
+  , m_queuePos(0)
+  , m_queued(0)
+  , m_jitterSamples(std::max(jitterSamples, periodSamples))
+  , m_buffering(true)
+  , m_input(periodSamples)
+  , m_active(false)
+  , m_inputResampler(sampleRate, mixerRate)
+  , m_outputResampler(mixerRate, sampleRate)
+  , m_recorder(recorder)
+  , m_player(player)
+  , m_autoDelete(autoDelete)
+  , m_references(0)
+  , m_removed(false)
+{
+}
+
+
+PAudioMixer::Participant::~Participant()
+{
+  if (m_autoDelete) {
+    delete m_recorder;
+    delete m_player;
+  }
+}
+
+
+void PAudioMixer::Participant::Write(const short * samples, PINDEX count)
+{
+  PINDEX size = m_queue.size();
+
+  // If too much, discard the oldest audio
+  if (count > size) {
+    samples += count - size;
+    count = size;
+  }
+  if (m_queued + count > size) {
+    PINDEX discard = m_queued + count - size;
+    m_queuePos = (m_queuePos + discard) % size;
+    m_queued -= discard;
+    ++m_statistics.m_overruns;
+  }
+
+  PINDEX writePos = (m_queuePos + m_queued) % size;
+  PINDEX chunk = std::min(count, size - writePos);
+  memcpy(&m_queue[writePos], samples, chunk*sizeof(short));
+  if (chunk < count)
+    memcpy(&m_queue[0], samples + chunk, (count - chunk)*sizeof(short));
+  m_queued += count;
+}
+
+
+void PAudioMixer::Participant::WriteResampled(const short * samples, PINDEX count)
+{
+  if (m_inputResampler.m_srcRate == m_inputResampler.m_dstRate)
+    Write(samples, count);
+  else {
+    short * dst = m_resampled.GetPointer(m_inputResampler.GetMaxOutput(count));
+    Write(dst, m_inputResampler.Convert(samples, count, dst));
+  }
+}
+
+
+bool PAudioMixer::Participant::Read(short * samples, PINDEX count)
+{
+  if (m_buffering) {
+    // Wait for jitter buffer to fill before starting to play out
+    if (m_queued < m_jitterSamples)
+      return false;
+    m_buffering = false;
+  }
+
+  if (m_queued < count) {
+    ++m_statistics.m_underruns;
+    m_buffering = true;
+    return false;
+  }
+
+  PINDEX size = m_queue.size();
+  PINDEX chunk = std::min(count, size - m_queuePos);
+  memcpy(samples, &m_queue[m_queuePos], chunk*sizeof(short));
+  if (chunk < count)
+    memcpy(samples + chunk, &m_queue[0], (count - chunk)*sizeof(short));
+  m_queuePos = (m_queuePos + count) % size;
+  m_queued -= count;
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PAudioMixer::PAudioMixer(unsigned sampleRate, unsigned periodMS)
+  : m_sampleRate(sampleRate)
+  , m_periodMS(periodMS)
+  , m_periodSamples(sampleRate*periodMS/1000)
+  , m_sum(m_periodSamples)
+  , m_output(m_periodSamples)
+  , m_thread(NULL)
+  , m_running(false)
+  , m_pacing(1000)
+{
+  PTRACE(4, "Created mixer: rate=" << m_sampleRate << ", period=" << m_periodMS << "ms");
+}
+
+
+PAudioMixer::~PAudioMixer()
+{
+  Stop();
+  RemoveAllParticipants();
+}
+
+
+bool PAudioMixer::AddParticipant(const PString & id,
+                                 unsigned sampleRate,
+                                 unsigned jitterMS,
+                                 PSoundChannel * recorder,
+                                 PSoundChannel * player,
+                                 bool autoDelete)
+{
+  if (sampleRate == 0)
+    sampleRate = m_sampleRate;
+
+  PWaitAndSignal lock(m_mutex);
+
+  if (m_participants.find(id) != m_participants.end()) {
+    PTRACE(2, "Participant \"" << id << "\" already in mixer");
+    return false;
+  }
+
+  m_participants[id] = new Participant(id, sampleRate, m_sampleRate, m_periodSamples, m_sampleRate*jitterMS/1000, recorder, player, autoDelete);
+  PTRACE(3, "Added participant \"" << id << "\", rate=" << sampleRate << ", jitter=" << jitterMS << "ms");
+  return true;
+}
+
+
+bool PAudioMixer::RemoveParticipant(const PString & id)
+{
+  PWaitAndSignal lock(m_mutex);
+
+  ParticipantMap::iterator it = m_participants.find(id);
+  if (it == m_participants.end())
+    return false;
+
+  DeleteParticipant(it->second);
+  m_participants.erase(it);
+  PTRACE(3, "Removed participant \"" << id << '"');
+  return true;
+}
+
+
+void PAudioMixer::RemoveAllParticipants()
+{
+  PWaitAndSignal lock(m_mutex);
+
+  for (ParticipantMap::iterator it = m_participants.begin(); it != m_participants.end(); ++it)
+    DeleteParticipant(it->second);
+  m_participants.clear();
+}
+
+
+void PAudioMixer::DeleteParticipant(Participant * participant)
+{
+  // Called with m_mutex locked, deletion deferred if mix using it
+  participant->m_removed = true;
+  if (participant->m_references == 0)
+    delete participant;
+}
+
+
+void PAudioMixer::ReleaseParticipant(Participant * participant)
+{
+  PWaitAndSignal lock(m_mutex);
+
+  if (--participant->m_references == 0 && participant->m_removed)
+    delete participant;
+}
+
+
+PStringArray PAudioMixer::GetParticipants() const
+{
+  PWaitAndSignal lock(m_mutex);
+
+  PStringArray ids;
+  ids.SetSize(m_participants.size());
+  PINDEX i = 0;
+  for (ParticipantMap::const_iterator it = m_participants.begin(); it != m_participants.end(); ++it)
+    ids[i++] = it->first;
+  return ids;
+}
+
+
+bool PAudioMixer::GetStatistics(const PString & id, Statistics & stats) const
+{
+  PWaitAndSignal lock(m_mutex);
+
+  ParticipantMap::const_iterator it = m_participants.find(id);
+  if (it == m_participants.end())
+    return false;
+
+  stats = it->second->m_statistics;
+  stats.m_queued = it->second->m_queued;
+  return true;
+}
+
+
+bool PAudioMixer::WriteAudio(const PString & id, const void * data, PINDEX size)
+{
+  PWaitAndSignal lock(m_mutex);
+
+  ParticipantMap::iterator it = m_participants.find(id);
+  if (it == m_participants.end())
+    return false;
+
+  it->second->WriteResampled((const short *)data, size/sizeof(short));
+  return true;
+}
+
+
+bool PAudioMixer::Start()
+{
+  PWaitAndSignal lock(m_mutex);
+
+  if (m_thread != NULL)
+    return true;
+
+  if (m_periodSamples == 0) {
+    PTRACE(2, "Cannot start mixer with zero period");
+    return false;
+  }
+
+  m_running = true;
+  m_pacing.Restart();
+  m_thread = new PThreadObj<PAudioMixer>(*this, &PAudioMixer::MixMain, false, "AudioMixer", PThread::HighPriority);
+  return true;
+}
+
+
+void PAudioMixer::Stop()
+{
+  PThread * thread;
+  {
+    PWaitAndSignal lock(m_mutex);
+    thread = m_thread;
+    m_running = false;
+  }
+
+  if (thread == NULL)
+    return;
+
+  thread->WaitForTermination();
+  delete thread;
+
+  PWaitAndSignal lock(m_mutex);
+  m_thread = NULL;
+}
+
+
+void PAudioMixer::MixMain()
+{
+  PTRACE(3, "Mixer thread started");
+
+  while (m_running) {
+    MixPeriod();
+    m_pacing.Delay(m_periodMS);
+  }
+
+  PTRACE(3, "Mixer thread ended");
+}
+
+
+void PAudioMixer::MixPeriod()
+{
+  // Nothing to mix, and the buffers are empty so must not be indexed
+  if (m_periodSamples == 0)
+    return;
+
+  PWaitAndSignal mixing(m_mixMutex);
+
+  // Take a reference to everyone, so can do device I/O without the lock
+  std::vector<Participant *> participants;
+  {
+    PWaitAndSignal lock(m_mutex);
+    participants.reserve(m_participants.size());
+    for (ParticipantMap::iterator it = m_participants.begin(); it != m_participants.end(); ++it) {
+      ++it->second->m_references;
+      participants.push_back(it->second);
+    }
+  }
+
+  std::vector<Participant *>::iterator it;
+
+  // Read any attached recording devices
+  for (it = participants.begin(); it != participants.end(); ++it) {
+    Participant & participant = **it;
+    if (participant.m_recorder == NULL)
+      continue;
+
+    PINDEX count = m_periodSamples*participant.m_sampleRate/m_sampleRate;
+    short * buffer = participant.m_recorded.GetPointer(count);
+    if (participant.m_recorder->Read(buffer, count*sizeof(short))) {
+      PWaitAndSignal lock(m_mutex);
+      participant.WriteResampled(buffer, participant.m_recorder->GetLastReadCount()/sizeof(short));
+    }
+  }
+
+  // Sum everyone who has audio this period
+  std::fill(m_sum.begin(), m_sum.end(), 0);
+  {
+    PWaitAndSignal lock(m_mutex);
+    for (it = participants.begin(); it != participants.end(); ++it) {
+      Participant & participant = **it;
+      participant.m_active = !participant.m_removed && participant.Read(&participant.m_input[0], m_periodSamples);
+      if (participant.m_active)
+        AccumulateSamples(&m_sum[0], &participant.m_input[0], m_periodSamples);
+    }
+  }
+
+  /* Then everyone gets the sum less their own contribution. The sum, input
+     and output resampler are only touched by the mixer, which m_mixMutex
+     serialises, so no lock is needed here. */
+  for (it = participants.begin(); it != participants.end(); ++it) {
+    Participant & participant = **it;
+    SubtractAndSaturate(&m_output[0], &m_sum[0], participant.m_active ? &participant.m_input[0] : NULL, m_periodSamples);
+
+    if (participant.m_sampleRate == m_sampleRate)
+      OnMixed(participant.m_id, &m_output[0], m_periodSamples);
+    else {
+      short * dst = participant.m_mixed.GetPointer(participant.m_outputResampler.GetMaxOutput(m_periodSamples));
+      OnMixed(participant.m_id, dst, participant.m_outputResampler.Convert(&m_output[0], m_periodSamples, dst));
+    }
+  }
+
+  for (it = participants.begin(); it != participants.end(); ++it)
+    ReleaseParticipant(*it);
+}
+
+
+void PAudioMixer::OnMixed(const PString & id, const short * samples, PINDEX count)
+{
+  Participant * participant;
+  {
+    PWaitAndSignal lock(m_mutex);
+
+    ParticipantMap::iterator it = m_participants.find(id);
+    if (it == m_participants.end() || it->second->m_player == NULL)
+      return;
+
+    participant = it->second;
+    ++participant->m_references;
+  }
+
+  participant->m_player->Write(samples, count*sizeof(short));
+  ReleaseParticipant(participant);
+}
+
+
+/* These are deliberately simple loops without branches, using a 32 bit
+   accumulator and a final clamp, so the compiler can vectorise them. */
+
+void PAudioMixer::AccumulateSamples(int * sum, const short * samples, PINDEX count)
+{
+  for (PINDEX i = 0; i < count; ++i)
+    sum[i] += samples[i];
+}
+
+
+static __inline short SaturateSample(int sample)
+{
+  return (short)std::min(std::max(sample, (int)SHRT_MIN), (int)SHRT_MAX);
+}
+
+
+void PAudioMixer::SubtractAndSaturate(short * output, const int * sum, const short * self, PINDEX count)
+{
+  if (self == NULL) {
+    for (PINDEX i = 0; i < count; ++i)
+      output[i] = SaturateSample(sum[i]);
+  }
+  else {
+    for (PINDEX i = 0; i < count; ++i)
+      output[i] = SaturateSample(sum[i] - self[i]);
+  }
+}
+
+
+#endif // P_AUDIO
+
+
+// End Of File ///////////////////////////////////////////////////////////////
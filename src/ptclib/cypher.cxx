@@ -157,6 +157,253 @@ static const char Alphabet[65] =
 static const char AlphabetURL[65] =
             "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 
+static const BYTE Base642Binary[256] = {
+  96, 99, 99, 99, 99, 99, 99, 99, 99, 99, 98, 99, 99, 98, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 62, 99, 62, 99, 63,
+  52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 99, 99, 99, 97, 99, 99,
+  99,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+  15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 99, 99, 99, 99, 63,
+  99, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+  41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 99, 99, 99, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99
+};
+
+
+struct PBase64EncodeParams
+{
+  const char * m_alphabet;
+  const char * m_endOfLine;
+  PINDEX       m_endOfLineLength;
+  PINDEX       m_maxLineLength;
+
+  PBase64EncodeParams(PBase64::Options options, PINDEX width)
+  {
+    m_alphabet = Alphabet;
+    m_endOfLine = "";
+    m_maxLineLength = UINT_MAX;
+
+    switch (options) {
+      case PBase64::e_CRLF:
+        PAssert(width > 2, PInvalidParameter);
+        m_endOfLine = "\r\n";
+        m_maxLineLength = width - 1;
+        break;
+      case PBase64::e_LF:
+        PAssert(width > 1, PInvalidParameter);
+        m_endOfLine = "\n";
+        m_maxLineLength = width;
+        break;
+      case PBase64::e_NoLF:
+        break;
+      case PBase64::e_URL:
+        m_alphabet = AlphabetURL;
+        break;
+    }
+
+    m_endOfLineLength = (PINDEX)strlen(m_endOfLine);
+  }
+
+  PBase64EncodeParams(const char * eol, PINDEX width)
+  {
+    PAssert(eol != NULL && width > 0, PInvalidParameter);
+
+    m_alphabet = Alphabet;
+    m_endOfLine = eol;
+    m_endOfLineLength = (PINDEX)strlen(eol);
+    m_maxLineLength = width - m_endOfLineLength;
+  }
+
+  PBase64EncodeParams(const char * alphabet, const char * eol, PINDEX maxLineLength)
+    : m_alphabet(alphabet)
+    , m_endOfLine(eol)
+    , m_endOfLineLength((PINDEX)strlen(eol))
+    , m_maxLineLength(maxLineLength)
+  {
+  }
+
+  // A line ends when it reaches the maximum length after a group of four
+  PINDEX QuadsToEndOfLine(PINDEX lineLength) const
+  {
+    return m_maxLineLength > lineLength ? (m_maxLineLength - lineLength + 3)/4 : 1;
+  }
+
+  PINDEX GetLength(PINDEX length) const
+  {
+    PINDEX triples = length/3;
+    PINDEX result = triples*4;
+    if (m_endOfLineLength > 0)
+      result += triples/QuadsToEndOfLine(0)*m_endOfLineLength;
+
+    switch (length%3) {
+      case 1 :
+        result += m_alphabet == AlphabetURL ? 2 : 4;
+        break;
+      case 2 :
+        result += m_alphabet == AlphabetURL ? 3 : 4;
+    }
+    return result;
+  }
+
+  // Encode complete triples, for the whole block before dealing with line ends
+  char * EncodeTriples(char * out, const BYTE * data, PINDEX triples, PINDEX & lineLength) const
+  {
+    while (triples > 0) {
+      PINDEX count = triples;
+      if (m_endOfLineLength > 0) {
+        PINDEX quads = QuadsToEndOfLine(lineLength);
+        if (count > quads)
+          count = quads;
+      }
+
+      triples -= count;
+      lineLength += count*4;
+
+      while (count-- > 0) {
+        unsigned bits = (data[0] << 16) | (data[1] << 8) | data[2];
+        out[0] = m_alphabet[bits >> 18];
+        out[1] = m_alphabet[(bits >> 12) & 0x3f];
+        out[2] = m_alphabet[(bits >> 6) & 0x3f];
+        out[3] = m_alphabet[bits & 0x3f];
+        out += 4;
+        data += 3;
+      }
+
+      if (m_endOfLineLength > 0 && lineLength >= m_maxLineLength) {
+        memcpy(out, m_endOfLine, m_endOfLineLength);
+        out += m_endOfLineLength;
+        lineLength = 0;
+      }
+    }
+
+    return out;
+  }
+
+  // Encode the final one or two bytes, with padding if required
+  char * EncodeTail(char * out, const BYTE * data, PINDEX count) const
+  {
+    switch (count) {
+      case 1 :
+        *out++ = m_alphabet[data[0] >> 2];
+        *out++ = m_alphabet[(data[0]&3)<<4];
+        if (m_alphabet != AlphabetURL) {
+          *out++ = '=';
+          *out++ = '=';
+        }
+        break;
+
+      case 2 :
+        *out++ = m_alphabet[data[0] >> 2];
+        *out++ = m_alphabet[((data[0]&3)<<4) | (data[1]>>4)];
+        *out++ = m_alphabet[((data[1]&15)<<2)];
+        if (m_alphabet != AlphabetURL)
+          *out++ = '=';
+    }
+    return out;
+  }
+
+  PINDEX Encode(const void * data, PINDEX length, char * buffer) const
+  {
+    PINDEX lineLength = 0;
+    char * out = EncodeTriples(buffer, (const BYTE *)data, length/3, lineLength);
+    out = EncodeTail(out, (const BYTE *)data + length/3*3, length%3);
+    return out - buffer;
+  }
+
+  PString Encode(const void * data, PINDEX length) const
+  {
+    PString str;
+    if (length > 0) {
+      PINDEX len = GetLength(length);
+      Encode(data, length, str.GetPointerAndSetLength(len));
+    }
+    return str;
+  }
+};
+
+
+/* Decode as much as possible, returning true if the terminating '=' was
+   found. A group of four valid characters, the vast majority of any string,
+   is converted to three bytes in one step. Anything else, line ends, padding
+   or illegal characters, is handled a character at a time. Note the output
+   must have a spare byte for the partial byte of an incomplete group.
+ */
+static bool DecodeBase64(const char * & ptr,
+                         const char * end,
+                         BYTE * out,
+                         PINDEX & outSize,
+                         PINDEX & quadPosition,
+                         bool & perfect)
+{
+  for (;;) {
+    if (quadPosition == 0) {
+      while (end - ptr >= 4) {
+        unsigned a = Base642Binary[(BYTE)ptr[0]];
+        unsigned b = Base642Binary[(BYTE)ptr[1]];
+        unsigned c = Base642Binary[(BYTE)ptr[2]];
+        unsigned d = Base642Binary[(BYTE)ptr[3]];
+        if ((a|b|c|d) >= 64)
+          break;
+        out[outSize++] = (BYTE)((a << 2) | (b >> 4));
+        out[outSize++] = (BYTE)((b << 4) | (c >> 2));
+        out[outSize++] = (BYTE)((c << 6) | d);
+        ptr += 4;
+      }
+    }
+
+    if (ptr >= end)
+      return false;
+
+    BYTE value = Base642Binary[(BYTE)*ptr++];
+    switch (value) {
+      case 96 : // end of string
+        return false;
+
+      case 97 : // '=' sign
+        if (quadPosition == 3 || (quadPosition == 2 && ptr < end && *ptr == '=')) {
+          quadPosition = 0;  // Reset this to zero, as have a perfect decode
+          return true; // Stop decoding now as must be at end of data
+        }
+        perfect = false;  // Ignore '=' sign but flag decode as suspect
+        break;
+
+      case 98 : // CRLFs
+        break;  // Ignore totally
+
+      case 99 :  // Illegal characters
+        perfect = false;  // Ignore rubbish but flag decode as suspect
+        break;
+
+      default : // legal value from 0 to 63
+        switch (quadPosition) {
+          case 0 :
+            out[outSize] = (BYTE)(value << 2);
+            break;
+          case 1 :
+            out[outSize++] |= (BYTE)(value >> 4);
+            out[outSize] = (BYTE)((value&15) << 4);
+            break;
+          case 2 :
+            out[outSize++] |= (BYTE)(value >> 2);
+            out[outSize] = (BYTE)((value&3) << 6);
+            break;
+          case 3 :
+            out[outSize++] |= (BYTE)value;
+            break;
+        }
+        quadPosition = (quadPosition+1)&3;
+    }
+  }
+}
+
+
 PBase64::PBase64(Options options, PINDEX width)
 {
   StartEncoding(options, width);
@@ -166,51 +413,31 @@ PBase64::PBase64(Options options, PINDEX width)
 
 void PBase64::StartEncoding(Options options, PINDEX width)
 {
+  PBase64EncodeParams params(options, width);
+
   m_encodedString.MakeEmpty();
   m_currentLineLength = m_saveCount = 0;
-
-  switch (options) {
-    case e_CRLF:
-      PAssert(width > 2, PInvalidParameter);
-      m_alphabet = Alphabet;
-      m_endOfLine = "\r\n";
-      m_maxLineLength = width - 1;
-      break;
-    case e_LF:
-      PAssert(width > 1, PInvalidParameter);
-      m_alphabet = Alphabet;
-      m_endOfLine = "\n";
-      m_maxLineLength = width;
-      break;
-    case e_NoLF:
-      m_alphabet = Alphabet;
-      m_endOfLine = "";
-      m_maxLineLength = UINT_MAX;
-      break;
-    case e_URL:
-      m_alphabet = AlphabetURL;
-      m_endOfLine = "";
-      m_maxLineLength = UINT_MAX;
-      break;
-  }
+  m_alphabet = params.m_alphabet;
+  m_endOfLine = params.m_endOfLine;
+  m_maxLineLength = params.m_maxLineLength;
 }
 
 
 void PBase64::StartEncoding(const char * eol, PINDEX width)
 {
-  PAssert(eol != NULL && width > 0, PInvalidParameter);
+  PBase64EncodeParams params(eol, width);
 
   m_encodedString.MakeEmpty();
   m_currentLineLength = m_saveCount = 0;
-  m_alphabet = Alphabet;
-  m_endOfLine = eol;
-  m_maxLineLength = width - m_endOfLine.GetLength();
+  m_alphabet = params.m_alphabet;
+  m_endOfLine = params.m_endOfLine;
+  m_maxLineLength = params.m_maxLineLength;
 }
 
 
 void PBase64::ProcessEncoding(const PString & str)
 {
-  ProcessEncoding((const char *)str);
+  ProcessEncoding((const char *)str, str.GetLength());
 }
 
 
@@ -226,55 +453,50 @@ void PBase64::ProcessEncoding(const PBYTEArray & data)
 }
 
 
-void PBase64::OutputBase64(const BYTE * data)
+void PBase64::ProcessEncoding(const void * dataPtr, PINDEX length)
 {
-  m_encodedString.SetMinSize(((m_encodedString.GetLength()+7)&~255) + 256);
+  if (length == 0)
+    return;
 
-  m_encodedString += m_alphabet[data[0] >> 2];
-  m_encodedString += m_alphabet[((data[0]&3)<<4) | (data[1]>>4)];
-  m_encodedString += m_alphabet[((data[1]&15)<<2) | (data[2]>>6)];
-  m_encodedString += m_alphabet[data[2]&0x3f];
+  const BYTE * data = (const BYTE *)dataPtr;
 
-  m_currentLineLength += 4;
-  if (m_currentLineLength >= m_maxLineLength) {
-    m_encodedString += m_endOfLine;
-    m_currentLineLength = 0;
+  PINDEX triples = (m_saveCount + length)/3;
+  if (triples == 0) {
+    m_saveTriple[m_saveCount++] = *data;
+    if (length > 1)
+      m_saveTriple[m_saveCount++] = data[1];
+    return;
   }
-}
 
+  PBase64EncodeParams params(m_alphabet, m_endOfLine, m_maxLineLength);
 
-void PBase64::ProcessEncoding(const void * dataPtr, PINDEX length)
-{
-  if (length == 0)
-    return;
+  // Make space for the worst case number of line endings, grow geometrically
+  PINDEX oldLength = m_encodedString.GetLength();
+  PINDEX newLength = oldLength + triples*4;
+  if (params.m_endOfLineLength > 0)
+    newLength += (triples/params.QuadsToEndOfLine(0) + 1)*params.m_endOfLineLength;
+  if (m_encodedString.GetSize() <= newLength)
+    m_encodedString.SetMinSize(std::max(newLength+1, m_encodedString.GetSize()*2));
 
-  const BYTE * data = (const BYTE *)dataPtr;
-  while (m_saveCount < 3) {
-    m_saveTriple[m_saveCount++] = *data++;
-    if (--length == 0) {
-      if (m_saveCount == 3) {
-        OutputBase64(m_saveTriple);
-        m_saveCount = 0;
-      }
-      return;
+  char * out = m_encodedString.GetPointerAndSetLength(newLength) + oldLength;
+
+  if (m_saveCount > 0) {
+    while (m_saveCount < 3) {
+      m_saveTriple[m_saveCount++] = *data++;
+      --length;
     }
+    out = params.EncodeTriples(out, m_saveTriple, 1, m_currentLineLength);
+    --triples;
   }
 
-  OutputBase64(m_saveTriple);
+  out = params.EncodeTriples(out, data, triples, m_currentLineLength);
 
-  PINDEX i;
-  for (i = 0; i+2 < length; i += 3)
-    OutputBase64(data+i);
-
-  m_saveCount = length - i;
-  switch (m_saveCount) {
-    case 2 :
-      m_saveTriple[0] = data[i++];
-      m_saveTriple[1] = data[i];
-      break;
-    case 1 :
-      m_saveTriple[0] = data[i];
-  }
+  m_encodedString.GetPointerAndSetLength(out - (const char *)m_encodedString);
+
+  data += triples*3;
+  m_saveCount = length - triples*3;
+  for (PINDEX i = 0; i < m_saveCount; ++i)
+    m_saveTriple[i] = data[i];
 }
 
 
@@ -288,26 +510,12 @@ PString PBase64::GetEncodedString()
 
 PString PBase64::CompleteEncoding()
 {
-  m_encodedString.SetMinSize(m_encodedString.GetLength() + 5);
-
-  switch (m_saveCount) {
-    case 1 :
-      m_encodedString += m_alphabet[m_saveTriple[0] >> 2];
-      m_encodedString += m_alphabet[(m_saveTriple[0]&3)<<4];
-      if (m_alphabet == AlphabetURL)
-        return m_encodedString;
-      m_encodedString += '=';
-      m_encodedString += '=';
-      break;
+  PBase64EncodeParams params(m_alphabet, m_endOfLine, m_maxLineLength);
 
-    case 2 :
-      m_encodedString += m_alphabet[m_saveTriple[0] >> 2];
-      m_encodedString += m_alphabet[((m_saveTriple[0]&3)<<4) | (m_saveTriple[1]>>4)];
-      m_encodedString += m_alphabet[((m_saveTriple[1]&15)<<2)];
-      if (m_alphabet == AlphabetURL)
-        return m_encodedString;
-      m_encodedString += '=';
-  }
+  PINDEX length = m_encodedString.GetLength();
+  char * out = m_encodedString.GetPointerAndSetLength(length+4) + length;
+  out = params.EncodeTail(out, m_saveTriple, m_saveCount);
+  m_encodedString.GetPointerAndSetLength(out - (const char *)m_encodedString);
 
   return m_encodedString;
 }
@@ -315,78 +523,67 @@ PString PBase64::CompleteEncoding()
 
 PString PBase64::Encode(const PString & str, Options options, PINDEX width)
 {
-  if (str.IsEmpty())
-    return PString::Empty();
-
-  return Encode((const char *)str, str.GetLength(), options, width);
+  return PBase64EncodeParams(options, width).Encode((const char *)str, str.GetLength());
 }
 
 
 PString PBase64::Encode(const PString & str, const char * endOfLine, PINDEX width)
 {
-  if (str.IsEmpty())
-    return PString::Empty();
-
-  return Encode((const char *)str, str.GetLength(), endOfLine, width);
+  return PBase64EncodeParams(endOfLine, width).Encode((const char *)str, str.GetLength());
 }
 
 
 PString PBase64::Encode(const char * cstr, Options options, PINDEX width)
 {
-  if (cstr == NULL || *cstr == '\0')
+  if (cstr == NULL)
     return PString::Empty();
 
-  return Encode((const BYTE *)cstr, (PINDEX)strlen(cstr), options, width);
+  return PBase64EncodeParams(options, width).Encode(cstr, (PINDEX)strlen(cstr));
 }
 
 
 PString PBase64::Encode(const char * cstr, const char * endOfLine, PINDEX width)
 {
-  if (cstr == NULL || *cstr == '\0')
+  if (cstr == NULL)
     return PString::Empty();
 
-  return Encode((const BYTE *)cstr, (PINDEX)strlen(cstr), endOfLine, width);
+  return PBase64EncodeParams(endOfLine, width).Encode(cstr, (PINDEX)strlen(cstr));
 }
 
 
 PString PBase64::Encode(const PBYTEArray & data, Options options, PINDEX width)
 {
-  if (data.IsEmpty())
-    return PString::Empty();
-
-  return Encode(data, data.GetSize(), options, width);
+  return PBase64EncodeParams(options, width).Encode(data, data.GetSize());
 }
 
 
 PString PBase64::Encode(const PBYTEArray & data, const char * endOfLine, PINDEX width)
 {
-  if (data.IsEmpty())
-    return PString::Empty();
-
-  return Encode(data, data.GetSize(), endOfLine, width);
+  return PBase64EncodeParams(endOfLine, width).Encode(data, data.GetSize());
 }
 
 
 PString PBase64::Encode(const void * data, PINDEX length, Options options, PINDEX width)
 {
-  if (length == 0)
-    return PString::Empty();
-
-  PBase64 encoder(options, width);
-  encoder.ProcessEncoding(data, length);
-  return encoder.CompleteEncoding();
+  return PBase64EncodeParams(options, width).Encode(data, length);
 }
 
 
 PString PBase64::Encode(const void * data, PINDEX length, const char * endOfLine, PINDEX width)
 {
-  if (length == 0)
-    return PString::Empty();
+  return PBase64EncodeParams(endOfLine, width).Encode(data, length);
+}
+
 
-  PBase64 encoder;
-  encoder.StartEncoding(endOfLine, width);
-  encoder.ProcessEncoding(data, length);
-  return encoder.CompleteEncoding();
+PINDEX PBase64::GetEncodedLength(PINDEX length, Options options, PINDEX width)
+{
+  return PBase64EncodeParams(options, width).GetLength(length);
+}
+
+
+PINDEX PBase64::EncodeBlock(const void * data, PINDEX length, char * buffer, Options options, PINDEX width)
+{
+  return PBase64EncodeParams(options, width).Encode(data, length, buffer);
 }
 
 
@@ -401,73 +598,24 @@ void PBase64::StartDecoding()
 
 PBoolean PBase64::ProcessDecoding(const PString & str)
 {
-  return ProcessDecoding((const char *)str);
+  return InternalProcessDecoding(str, str.GetLength());
 }
 
 
 PBoolean PBase64::ProcessDecoding(const char * cstr)
 {
-  static const BYTE Base642Binary[256] = {
-    96, 99, 99, 99, 99, 99, 99, 99, 99, 99, 98, 99, 99, 98, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 62, 99, 62, 99, 63,
-    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 99, 99, 99, 97, 99, 99,
-    99,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
-    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 99, 99, 99, 99, 63,
-    99, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
-    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 99, 99, 99, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
-    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99
-  };
-
-  for (;;) {
-    BYTE value = Base642Binary[(BYTE)*cstr++];
-    switch (value) {
-      case 96 : // end of string
-        return false;
+  return InternalProcessDecoding(cstr, (PINDEX)strlen(cstr));
+}
 
-      case 97 : // '=' sign
-        if (m_quadPosition == 3 || (m_quadPosition == 2 && *cstr == '=')) {
-          m_quadPosition = 0;  // Reset this to zero, as have a perfect decode
-          return true; // Stop decoding now as must be at end of data
-        }
-        m_perfectDecode = false;  // Ignore '=' sign but flag decode as suspect
-        break;
 
-      case 98 : // CRLFs
-        break;  // Ignore totally
-
-      case 99 :  // Illegal characters
-        m_perfectDecode = false;  // Ignore rubbish but flag decode as suspect
-        break;
+PBoolean PBase64::InternalProcessDecoding(const char * str, PINDEX length)
+{
+  // Room for the worst case, plus the partial byte, grow geometrically
+  PINDEX needed = m_decodeSize + GetMaxDecodedLength(length) + 1;
+  if (m_decodedData.GetSize() < needed)
+    m_decodedData.SetSize(std::max(needed, m_decodedData.GetSize()*2));
 
-      default : // legal value from 0 to 63
-        BYTE * out = m_decodedData.GetPointer(((m_decodeSize+1)&~255) + 256);
-        switch (m_quadPosition) {
-          case 0 :
-            out[m_decodeSize] = (BYTE)(value << 2);
-            break;
-          case 1 :
-            out[m_decodeSize++] |= (BYTE)(value >> 4);
-            out[m_decodeSize] = (BYTE)((value&15) << 4);
-            break;
-          case 2 :
-            out[m_decodeSize++] |= (BYTE)(value >> 2);
-            out[m_decodeSize] = (BYTE)((value&3) << 6);
-            break;
-          case 3 :
-            out[m_decodeSize++] |= (BYTE)value;
-            break;
-        }
-        m_quadPosition = (m_quadPosition+1)&3;
-    }
-  }
+  return DecodeBase64(str, str+length, m_decodedData.GetPointer(), m_decodeSize, m_quadPosition, m_perfectDecode);
 }
 
 
@@ -510,10 +658,13 @@ PBoolean PBase64::Decode(const PString & str, PBYTEArray & data)
   if (str.IsEmpty())
     return false;
 
-  PBase64 decoder;
-  decoder.ProcessDecoding(str);
-  data = decoder.GetDecodedData();
-  return decoder.IsDecodeOK();
+  PINDEX length = str.GetLength();
+  PINDEX size = 0, quadPosition = 0;
+  bool perfect = true;
+  const char * ptr = str;
+  DecodeBase64(ptr, ptr+length, data.GetPointer(GetMaxDecodedLength(length)), size, quadPosition, perfect);
+  data.SetSize(size);
+  return quadPosition == 0;
 }
 
 
@@ -522,9 +673,27 @@ PBoolean PBase64::Decode(const PString & str, void * dataBlock, PINDEX length)
   if (str.IsEmpty())
     return false;
 
-  PBase64 decoder;
-  decoder.ProcessDecoding(str);
-  return decoder.GetDecodedData(dataBlock, length);
+  PINDEX maxLength = GetMaxDecodedLength(str.GetLength());
+  if (length >= maxLength) {
+    DecodeBlock(str, str.GetLength(), (BYTE *)dataBlock);
+    return true;
+  }
+
+  PBYTEArray data;
+  Decode(str, data);
+  memcpy(dataBlock, data, std::min(data.GetSize(), length));
+  return length >= data.GetSize();
+}
+
+
+PINDEX PBase64::DecodeBlock(const char * str, PINDEX length, BYTE * buffer, bool * perfect)
+{
+  PINDEX size = 0, quadPosition = 0;
+  bool ok = true;
+  DecodeBase64(str, str+length, buffer, size, quadPosition, ok);
+  if (perfect != NULL)
+    *perfect = ok && quadPosition == 0;
+  return size;
 }
 
 
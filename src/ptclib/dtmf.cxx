@@ -19,6 +19,8 @@
 #include <ptlib.h>
 #include <ptclib/dtmf.h>
 
+#include <math.h>
+
 #if P_DTMF
 
 #define PTraceModule() "Tones"
@@ -143,99 +145,152 @@ PString PDTMFDecoder::Decode(const short * sampleData, PINDEX numSamples, unsign
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-static int sine(int angle, int freq)
-{
-  static int const sinArray[2000] = {
-    0,0,1,2,3,3,4,5,6,7,7,8,9,10,10,11,12,13,14,14,15,16,17,18,18,19,20,21,21,22,
-    23,24,25,25,26,27,28,29,29,30,31,32,32,33,34,35,36,36,37,38,39,40,40,41,42,43,43,44,45,46,
-    47,47,48,49,50,51,51,52,53,54,54,55,56,57,58,58,59,60,61,62,62,63,64,65,65,66,67,68,69,69,
-    70,71,72,72,73,74,75,76,76,77,78,79,80,80,81,82,83,83,84,85,86,87,87,88,89,90,90,91,92,93,
-    94,94,95,96,97,98,98,99,100,101,101,102,103,104,105,105,106,107,108,108,109,110,111,112,112,113,114,115,115,116,
-    117,118,119,119,120,121,122,122,123,124,125,126,126,127,128,129,130,130,131,132,133,133,134,135,136,137,137,138,139,140,
-    140,141,142,143,144,144,145,146,147,147,148,149,150,151,151,152,153,154,154,155,156,157,157,158,159,160,161,161,162,163,
-    164,164,165,166,167,168,168,169,170,171,171,172,173,174,175,175,176,177,178,178,179,180,181,181,182,183,184,185,185,186,
-    187,188,188,189,190,191,192,192,193,194,195,195,196,197,198,198,199,200,201,202,202,203,204,205,205,206,207,208,208,209,
-    210,211,212,212,213,214,215,215,216,217,218,218,219,220,221,221,222,223,224,225,225,226,227,228,228,229,230,231,231,232,
-    233,234,234,235,236,237,238,238,239,240,241,241,242,243,244,244,245,246,247,247,248,249,250,250,251,252,253,254,254,255,
-    256,257,257,258,259,260,260,261,262,263,263,264,265,266,266,267,268,269,269,270,271,272,272,273,274,275,275,276,277,278,
-    278,279,280,281,282,282,283,284,285,285,286,287,288,288,289,290,291,291,292,293,294,294,295,296,297,297,298,299,300,300,
-    301,302,303,303,304,305,306,306,307,308,309,309,310,311,312,312,313,314,314,315,316,317,317,318,319,320,320,321,322,323,
-    323,324,325,326,326,327,328,329,329,330,331,332,332,333,334,335,335,336,337,337,338,339,340,340,341,342,343,343,344,345,
-    346,346,347,348,349,349,350,351,352,352,353,354,354,355,356,357,357,358,359,360,360,361,362,363,363,364,365,365,366,367,
-    368,368,369,370,371,371,372,373,373,374,375,376,376,377,378,379,379,380,381,381,382,383,384,384,385,386,387,387,388,389,
-    389,390,391,392,392,393,394,394,395,396,397,397,398,399,400,400,401,402,402,403,404,405,405,406,407,407,408,409,410,410,
-    411,412,412,413,414,415,415,416,417,417,418,419,420,420,421,422,422,423,424,425,425,426,427,427,428,429,430,430,431,432,
-    432,433,434,434,435,436,437,437,438,439,439,440,441,442,442,443,444,444,445,446,446,447,448,449,449,450,451,451,452,453,
-    453,454,455,456,456,457,458,458,459,460,460,461,462,463,463,464,465,465,466,467,467,468,469,470,470,471,472,472,473,474,
-    474,475,476,476,477,478,478,479,480,481,481,482,483,483,484,485,485,486,487,487,488,489,489,490,491,492,492,493,494,494,
-    495,496,496,497,498,498,499,500,500,501,502,502,503,504,504,505,506,507,507,508,509,509,510,511,511,512,513,513,514,515,
-    515,516,517,517,518,519,519,520,521,521,522,523,523,524,525,525,526,527,527,528,529,529,530,531,531,532,533,533,534,535,
-    535,536,537,537,538,539,539,540,541,541,542,543,543,544,545,545,546,547,547,548,549,549,550,550,551,552,552,553,554,554,
-    555,556,556,557,558,558,559,560,560,561,562,562,563,564,564,565,565,566,567,567,568,569,569,570,571,571,572,573,573,574,
-    575,575,576,576,577,578,578,579,580,580,581,582,582,583,583,584,585,585,586,587,587,588,589,589,590,590,591,592,592,593,
-    594,594,595,596,596,597,597,598,599,599,600,601,601,602,602,603,604,604,605,606,606,607,607,608,609,609,610,611,611,612,
-    612,613,614,614,615,616,616,617,617,618,619,619,620,620,621,622,622,623,624,624,625,625,626,627,627,628,628,629,630,630,
-    631,631,632,633,633,634,635,635,636,636,637,638,638,639,639,640,641,641,642,642,643,644,644,645,645,646,647,647,648,648,
-    649,650,650,651,651,652,653,653,654,654,655,655,656,657,657,658,658,659,660,660,661,661,662,663,663,664,664,665,666,666,
-    667,667,668,668,669,670,670,671,671,672,673,673,674,674,675,675,676,677,677,678,678,679,679,680,681,681,682,682,683,683,
-    684,685,685,686,686,687,687,688,689,689,690,690,691,691,692,693,693,694,694,695,695,696,697,697,698,698,699,699,700,700,
-    701,702,702,703,703,704,704,705,705,706,707,707,708,708,709,709,710,710,711,712,712,713,713,714,714,715,715,716,717,717,
-    718,718,719,719,720,720,721,721,722,723,723,724,724,725,725,726,726,727,727,728,728,729,730,730,731,731,732,732,733,733,
-    734,734,735,735,736,736,737,738,738,739,739,740,740,741,741,742,742,743,743,744,744,745,745,746,746,747,748,748,749,749,
-    750,750,751,751,752,752,753,753,754,754,755,755,756,756,757,757,758,758,759,759,760,760,761,761,762,762,763,763,764,764,
-    765,765,766,766,767,768,768,769,769,770,770,771,771,772,772,773,773,774,774,774,775,775,776,776,777,777,778,778,779,779,
-    780,780,781,781,782,782,783,783,784,784,785,785,786,786,787,787,788,788,789,789,790,790,791,791,792,792,793,793,793,794,
-    794,795,795,796,796,797,797,798,798,799,799,800,800,801,801,802,802,802,803,803,804,804,805,805,806,806,807,807,808,808,
-    809,809,809,810,810,811,811,812,812,813,813,814,814,814,815,815,816,816,817,817,818,818,819,819,819,820,820,821,821,822,
-    822,823,823,823,824,824,825,825,826,826,827,827,827,828,828,829,829,830,830,831,831,831,832,832,833,833,834,834,834,835,
-    835,836,836,837,837,837,838,838,839,839,840,840,840,841,841,842,842,843,843,843,844,844,845,845,846,846,846,847,847,848,
-    848,848,849,849,850,850,850,851,851,852,852,853,853,853,854,854,855,855,855,856,856,857,857,857,858,858,859,859,859,860,
-    860,861,861,861,862,862,863,863,863,864,864,865,865,865,866,866,867,867,867,868,868,869,869,869,870,870,870,871,871,872,
-    872,872,873,873,874,874,874,875,875,875,876,876,877,877,877,878,878,878,879,879,880,880,880,881,881,881,882,882,883,883,
-    883,884,884,884,885,885,885,886,886,887,887,887,888,888,888,889,889,889,890,890,891,891,891,892,892,892,893,893,893,894,
-    894,894,895,895,895,896,896,896,897,897,898,898,898,899,899,899,900,900,900,901,901,901,902,902,902,903,903,903,904,904,
-    904,905,905,905,906,906,906,907,907,907,908,908,908,909,909,909,910,910,910,911,911,911,912,912,912,913,913,913,913,914,
-    914,914,915,915,915,916,916,916,917,917,917,918,918,918,918,919,919,919,920,920,920,921,921,921,922,922,922,922,923,923,
-    923,924,924,924,925,925,925,925,926,926,926,927,927,927,928,928,928,928,929,929,929,930,930,930,930,931,931,931,932,932,
-    932,932,933,933,933,934,934,934,934,935,935,935,935,936,936,936,937,937,937,937,938,938,938,939,939,939,939,940,940,940,
-    940,941,941,941,941,942,942,942,942,943,943,943,944,944,944,944,945,945,945,945,946,946,946,946,947,947,947,947,948,948,
-    948,948,949,949,949,949,950,950,950,950,951,951,951,951,952,952,952,952,952,953,953,953,953,954,954,954,954,955,955,955,
-    955,956,956,956,956,956,957,957,957,957,958,958,958,958,958,959,959,959,959,960,960,960,960,960,961,961,961,961,962,962,
-    962,962,962,963,963,963,963,963,964,964,964,964,964,965,965,965,965,965,966,966,966,966,967,967,967,967,967,967,968,968,
-    968,968,968,969,969,969,969,969,970,970,970,970,970,971,971,971,971,971,972,972,972,972,972,972,973,973,973,973,973,973,
-    974,974,974,974,974,975,975,975,975,975,975,976,976,976,976,976,976,977,977,977,977,977,977,978,978,978,978,978,978,979,
-    979,979,979,979,979,980,980,980,980,980,980,980,981,981,981,981,981,981,981,982,982,982,982,982,982,983,983,983,983,983,
-    983,983,984,984,984,984,984,984,984,984,985,985,985,985,985,985,985,986,986,986,986,986,986,986,986,987,987,987,987,987,
-    987,987,987,988,988,988,988,988,988,988,988,989,989,989,989,989,989,989,989,989,990,990,990,990,990,990,990,990,990,990,
-    991,991,991,991,991,991,991,991,991,992,992,992,992,992,992,992,992,992,992,992,993,993,993,993,993,993,993,993,993,993,
-    993,994,994,994,994,994,994,994,994,994,994,994,994,995,995,995,995,995,995,995,995,995,995,995,995,995,995,996,996,996,
-    996,996,996,996,996,996,996,996,996,996,996,996,997,997,997,997,997,997,997,997,997,997,997,997,997,997,997,997,997,997,
-    998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,998,999,999,999,999,999,999,
-    999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,
-    999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999,999
+namespace {
+  /* The oscillator is a 32 bit phase accumulator indexing a full cycle sine
+     table, so each sample is an add and a lookup rather than the division and
+     quadrant folding needed to map an angle in Hz onto a quarter wave table. */
+  enum {
+    SineTableBits = 13,
+    SineTableSize = 1 << SineTableBits,
+    SineTableShift = 32 - SineTableBits,
+    BlockSamples = 256
+  };
+
+  struct SineTable
+  {
+    short m_value[SineTableSize];
+
+    SineTable()
+    {
+      for (int i = 0; i < SineTableSize; ++i)
+        m_value[i] = (short)floor(sin(2*M_PI*i/SineTableSize)*(PTones::SineScale-1) + 0.5);
+    }
   };
-  static int const sinArraySize = sizeof(sinArray)/sizeof(sinArray[0]);
-
-  int adjustedAngle = (int)(angle*sinArraySize*4LL/freq);
-  int quadrant = adjustedAngle / sinArraySize;
-  int offset   = adjustedAngle % sinArraySize;
-
-  switch (quadrant) {
-    case 0:
-      return sinArray[offset];
-    case 1:
-      return sinArray[sinArraySize-1-offset];
-    case 2: 
-      return -sinArray[offset];
-    default:
-      return -sinArray[sinArraySize-1-offset];
+
+  static const short * GetSineTable()
+  {
+    static SineTable const table;
+    return table.m_value;
+  }
+
+
+  static uint32_t PhaseIncrement(unsigned frequency, unsigned sampleRate)
+  {
+    return (uint32_t)(((uint64_t)frequency << 32) / sampleRate);
+  }
+
+
+  static void Oscillate(int * output, unsigned count, uint32_t & phase, uint32_t increment)
+  {
+    const short * table = GetSineTable();
+    uint32_t p = phase;
+    for (unsigned i = 0; i < count; ++i) {
+      output[i] = table[p >> SineTableShift];
+      p += increment;
+    }
+    phase = p;
+  }
+
+
+  // Sample values are -1000 to 1000, rescale to short range -32767 to +32767
+  static void ScaleSamples(short * output, const int * input, unsigned count, unsigned volume, unsigned masterVolume)
+  {
+    int const gain = (int)(volume*masterVolume);
+    int const divisor = PTones::SineScale*100*100/SHRT_MAX;
+    for (unsigned i = 0; i < count; ++i)
+      output[i] = (short)(input[i]*gain/divisor);
   }
 }
 
 
 ////////////////////////////////////////////////////////////////////////
 
-    
+namespace {
+  /* Rendered tones keyed by sample rate, master volume and descriptor. As
+     PTones is a reference counted PShortArray, and writing to an element
+     does not copy on write, the cache and the caller each get their own
+     copy of the samples. A copy is still far cheaper than synthesis. The
+     least recently used entry is discarded when full. */
+  class PTonesCache
+  {
+    public:
+      PTonesCache()
+        : m_maxSize(PTones::DefaultCacheSize)
+        , m_useCounter(0)
+      {
+      }
+
+      bool Find(const PString & key, PTones & tones)
+      {
+        PWaitAndSignal lock(m_mutex);
+        EntryMap::iterator it = m_entries.find(key);
+        if (it == m_entries.end())
+          return false;
+        it->second.m_lastUsed = ++m_useCounter;
+        tones = it->second.m_tones;
+        tones.MakeUnique();
+        return true;
+      }
+
+      void Add(const PString & key, const PTones & tones)
+      {
+        PWaitAndSignal lock(m_mutex);
+        if (m_maxSize == 0)
+          return;
+        EntryMap::iterator it = m_entries.find(key);
+        if (it == m_entries.end()) {
+          // Only a new entry needs room made for it
+          while ((PINDEX)m_entries.size() >= m_maxSize)
+            RemoveOldest();
+          it = m_entries.insert(EntryMap::value_type(key, Entry())).first;
+        }
+        Entry & entry = it->second;
+        entry.m_tones = tones;
+        entry.m_tones.MakeUnique();
+        entry.m_lastUsed = ++m_useCounter;
+      }
+
+      void SetMaxSize(PINDEX size)
+      {
+        PWaitAndSignal lock(m_mutex);
+        m_maxSize = size;
+        while ((PINDEX)m_entries.size() > m_maxSize)
+          RemoveOldest();
+      }
+
+    protected:
+      void RemoveOldest()
+      {
+        EntryMap::iterator oldest = m_entries.begin();
+        for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+          if (it->second.m_lastUsed < oldest->second.m_lastUsed)
+            oldest = it;
+        }
+        m_entries.erase(oldest);
+      }
+
+      struct Entry
+      {
+        Entry() : m_lastUsed(0) { }
+        PTones   m_tones;
+        PUInt64  m_lastUsed;
+      };
+      typedef std::map<PString, Entry> EntryMap;
+
+      PDECLARE_MUTEX(m_mutex);
+      PINDEX   m_maxSize;
+      PUInt64  m_useCounter;
+      EntryMap m_entries;
+  };
+
+  static PTonesCache & GetTonesCache()
+  {
+    static PTonesCache cache;
+    return cache;
+  }
+}
+
+
 PTones::PTones(unsigned volume, unsigned sampleRate)
   : m_sampleRate(sampleRate)
   , m_masterVolume(volume)
@@ -276,8 +331,8 @@ void PTones::Reset()
   m_lastOperation = 0;
   m_lastFrequency1 = 0;
   m_lastFrequency2 = 0;
-  m_angle1 = 0;
-  m_angle2 = 0;
+  m_phase1 = 0;
+  m_phase2 = 0;
 
   if (m_sampleRate < 8000)
     m_sampleRate = 8000;
@@ -293,6 +348,12 @@ void PTones::Reset()
 }
 
 
+void PTones::SetCacheSize(PINDEX entries)
+{
+  GetTonesCache().SetMaxSize(entries);
+}
+
+
 bool PTones::Generate(const PString & descriptor, unsigned sampleRate, unsigned masterVolume)
 {
   if (sampleRate != 0)
@@ -304,6 +365,24 @@ bool PTones::Generate(const PString & descriptor, unsigned sampleRate, unsigned
   if (descriptor.IsEmpty())
     return false;
 
+  // Only a tone rendered from the start of the buffer can be shared
+  if (m_addPosition > 0)
+    return InternalGenerate(descriptor);
+
+  PString key = PSTRSTRM(m_sampleRate << ',' << m_masterVolume << ',' << descriptor);
+  if (GetTonesCache().Find(key, *this))
+    return true;
+
+  if (!InternalGenerate(descriptor))
+    return false;
+
+  GetTonesCache().Add(key, *this);
+  return true;
+}
+
+
+bool PTones::InternalGenerate(const PString & descriptor)
+{
   PStringArray toneChunks = descriptor.Tokenise('/');
   if (toneChunks.IsEmpty()) {
     PTRACE(3, "No '/' found in \"" << descriptor << '"');
@@ -446,8 +525,8 @@ bool PTones::Generate(char operation, unsigned frequency1, unsigned frequency2,
     m_lastFrequency1 = frequency1;
     m_lastFrequency2 = frequency2;
 
-    m_angle1 = 0;
-    m_angle2 = 0;
+    m_phase1 = 0;
+    m_phase2 = 0;
   }
 
   switch (operation) {
@@ -487,19 +566,25 @@ bool PTones::Juxtapose(unsigned frequency1, unsigned frequency2, unsigned millis
   }
 
   unsigned samples = CalcSamples(milliseconds, frequency1, frequency2);
-  while (samples-- > 0) {
-    int a1 = sine(m_angle1, m_sampleRate);
-    int a2 = sine(m_angle2, m_sampleRate);
+  short * output = ReserveSamples(samples);
+  if (output == NULL)
+    return false;
+
+  uint32_t increment1 = PhaseIncrement(frequency1, m_sampleRate);
+  uint32_t increment2 = PhaseIncrement(frequency2, m_sampleRate);
 
-    AddSample((a1 + a2) / 2, volume);
+  int a1[BlockSamples], a2[BlockSamples];
+  while (samples > 0) {
+    unsigned count = std::min(samples, (unsigned)BlockSamples);
+    Oscillate(a1, count, m_phase1, increment1);
+    Oscillate(a2, count, m_phase2, increment2);
 
-    m_angle1 += frequency1;
-    if (m_angle1 >= (int)m_sampleRate) 
-      m_angle1 -= m_sampleRate;
+    for (unsigned i = 0; i < count; ++i)
+      a1[i] = (a1[i] + a2[i]) / 2;
 
-    m_angle2 += frequency2;
-    if (m_angle2 >= (int)m_sampleRate) 
-      m_angle2 -= m_sampleRate;
+    ScaleSamples(output, a1, count, volume, m_masterVolume);
+    output += count;
+    samples -= count;
   }
   return true;
 }
@@ -518,19 +603,25 @@ bool PTones::Modulate(unsigned frequency1, unsigned modulator, unsigned millisec
   }
 
   unsigned samples = CalcSamples(milliseconds, frequency1, modulator);
-  while (samples-- > 0) {
-    int a1 = sine(m_angle1, m_sampleRate);   // -999 to 999
-    int a2 = sine(m_angle2, m_sampleRate);   // -999 to 999
+  short * output = ReserveSamples(samples);
+  if (output == NULL)
+    return false;
 
-    AddSample((a1 * (a2 + SineScale)) / SineScale / 2, volume);
+  uint32_t increment1 = PhaseIncrement(frequency1, m_sampleRate);
+  uint32_t increment2 = PhaseIncrement(modulator, m_sampleRate);
 
-    m_angle1 += frequency1;
-    if (m_angle1 >= (int)m_sampleRate) 
-      m_angle1 -= m_sampleRate;
+  int a1[BlockSamples], a2[BlockSamples];
+  while (samples > 0) {
+    unsigned count = std::min(samples, (unsigned)BlockSamples);
+    Oscillate(a1, count, m_phase1, increment1);   // -999 to 999
+    Oscillate(a2, count, m_phase2, increment2);   // -999 to 999
 
-    m_angle2 += modulator;
-    if (m_angle2 >= (int)m_sampleRate) 
-      m_angle2 -= m_sampleRate;
+    for (unsigned i = 0; i < count; ++i)
+      a1[i] = (a1[i] * (a2[i] + SineScale)) / SineScale / 2;
+
+    ScaleSamples(output, a1, count, volume, m_masterVolume);
+    output += count;
+    samples -= count;
   }
   return true;
 }
@@ -561,12 +652,18 @@ static unsigned char tone_2100[320] = {
 
 bool PTones::PureTone(unsigned frequency1, unsigned milliseconds, unsigned volume)
 {
-  if (frequency1 == 2100) {
-    PINDEX samples = milliseconds * 8;
-    short * tone = (short *)tone_2100;
-    unsigned int toneLen  = sizeof(tone_2100) / 2;
-    for (PINDEX length = 0; length < samples; ++length)
-      AddSample(tone[length % toneLen], volume);
+  if (frequency1 == 2100 && m_sampleRate == 8000) {
+    unsigned samples = milliseconds * 8;
+    short * output = ReserveSamples(samples);
+    if (output == NULL)
+      return false;
+
+    // Table is already full scale 16 bit PCM, so only apply the volumes
+    const short * tone = (const short *)tone_2100;
+    unsigned const toneLen = sizeof(tone_2100) / 2;
+    int const gain = (int)(volume*m_masterVolume);
+    for (unsigned i = 0; i < samples; ++i)
+      output[i] = (short)(tone[i % toneLen]*gain/(100*100));
     return true;
   }
 
@@ -576,12 +673,19 @@ bool PTones::PureTone(unsigned frequency1, unsigned milliseconds, unsigned volum
   }
 
   unsigned samples = CalcSamples(milliseconds, frequency1, frequency1);
-  while (samples-- > 0) {
-    AddSample(sine(m_angle1, m_sampleRate), volume);
+  short * output = ReserveSamples(samples);
+  if (output == NULL)
+    return false;
+
+  uint32_t increment = PhaseIncrement(frequency1, m_sampleRate);
 
-    m_angle1 += frequency1;
-    if (m_angle1 >= (int)m_sampleRate) 
-      m_angle1 -= m_sampleRate;
+  int a1[BlockSamples];
+  while (samples > 0) {
+    unsigned count = std::min(samples, (unsigned)BlockSamples);
+    Oscillate(a1, count, m_phase1, increment);
+    ScaleSamples(output, a1, count, volume, m_masterVolume);
+    output += count;
+    samples -= count;
   }
   return true;
 }
@@ -590,8 +694,11 @@ bool PTones::PureTone(unsigned frequency1, unsigned milliseconds, unsigned volum
 bool PTones::Silence(unsigned milliseconds)
 {
   unsigned samples = milliseconds * m_sampleRate/1000;
-  while (samples-- > 0) 
-    AddSample(0, 0);
+  short * output = ReserveSamples(samples);
+  if (output == NULL)
+    return false;
+
+  memset(output, 0, samples*sizeof(short));
   return true;
 }
 
@@ -618,16 +725,77 @@ unsigned PTones::CalcSamples(unsigned ms, unsigned f1, unsigned f2)
 }
 
 
+short * PTones::ReserveSamples(unsigned count)
+{
+  PINDEX position = m_addPosition;
+  if (position + (PINDEX)count > GetSize()) {
+    if (!PShortArray::SetSize(position + count))
+      return NULL;
+  }
+
+  // May be sharing the samples with the tone cache
+  MakeUnique();
+
+  m_addPosition += count;
+  return (short *)theArray + position;
+}
+
+
 void PTones::AddSample(int sample, unsigned volume)
 {
-  if (m_addPosition >= GetSize())
-    SetSize(GetSize() + m_addPosition + m_sampleRate); // Add one seconds worth
-
-  // Sample added is value from -1000 to 1000, rescale to short range -32767 to +32767
-  sample *= volume;
-  sample *= m_masterVolume;
-  sample /= SineScale*100*100/SHRT_MAX;
-  ((short *)theArray)[m_addPosition++] = (short)sample;
+  short * output = ReserveSamples(1);
+  if (output != NULL)
+    ScaleSamples(output, &sample, 1, volume, m_masterVolume);
+}
+
+
+////////////////////////////////////////////////////////////////////////
+
+PTonesGenerator::PTonesGenerator(const PString & descriptor, unsigned masterVolume, unsigned sampleRate, bool autoRepeat)
+  : m_position(0)
+  , m_autoRepeat(autoRepeat)
+{
+  if (!descriptor.IsEmpty())
+    Open(descriptor, masterVolume, sampleRate, autoRepeat);
+}
+
+
+bool PTonesGenerator::Open(const PString & descriptor, unsigned masterVolume, unsigned sampleRate, bool autoRepeat)
+{
+  m_tones.SetSampleRate(sampleRate);
+  m_position = 0;
+  m_autoRepeat = autoRepeat;
+  if (m_tones.Generate(descriptor, sampleRate, masterVolume))
+    return true;
+
+  m_tones.SetSize(0);
+  return false;
+}
+
+
+PINDEX PTonesGenerator::Read(short * buffer, PINDEX count)
+{
+  const short * samples = m_tones;
+  PINDEX size = m_tones.GetSize();
+  PINDEX written = 0;
+
+  while (written < count && size > 0) {
+    if (m_position >= size) {
+      if (!m_autoRepeat)
+        break;
+      m_position = 0;
+    }
+
+    PINDEX chunk = std::min(count - written, size - m_position);
+    memcpy(buffer + written, samples + m_position, chunk*sizeof(short));
+    m_position += chunk;
+    written += chunk;
+  }
+
+  if (written < count)
+    memset(buffer + written, 0, (count - written)*sizeof(short));
+
+  return written;
 }
 
 
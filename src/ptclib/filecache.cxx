@@ -0,0 +1,444 @@
+/*
+ * filecache.cxx
+ *
+ * Process wide cache of shared, read only, file content.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifdef __GNUC__
+#pragma implementation "filecache.h"
+#endif
+
+#include <ptlib.h>
+
+#include <ptclib/filecache.h>
+
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <sys/mman.h>
+#endif
+
+
+#define PTraceModule() "FileCache"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PFileContent::PFileContent()
+  : m_pointer(NULL)
+  , m_size(0)
+  , m_mapped(false)
+#ifdef _WIN32
+  , m_mapping(NULL)
+#endif
+{
+}
+
+
+PFileContent::~PFileContent()
+{
+  Unmap();
+}
+
+
+void PFileContent::Unmap()
+{
+  if (m_mapped) {
+#ifdef _WIN32
+    UnmapViewOfFile(m_pointer);
+    CloseHandle(m_mapping);
+    m_mapping = NULL;
+#else
+    munmap((void *)m_pointer, m_size);
+#endif
+    m_mapped = false;
+  }
+
+  m_data.SetSize(0);
+  m_pointer = NULL;
+  m_size = 0;
+}
+
+
+bool PFileContent::Map(const PFilePath & path, PINDEX maxReadSize)
+{
+  Unmap();
+
+  PFile file;
+  if (!file.Open(path, PFile::ReadOnly)) {
+    PTRACE(2, "Could not open \"" << path << "\" - " << file.GetErrorText());
+    return false;
+  }
+
+  off_t size = file.GetLength();
+  if (size == 0)
+    return true; // Cannot map zero length, but is valid empty content
+
+#ifdef _WIN32
+  HANDLE handle = (HANDLE)_get_osfhandle((int)file.GetHandle());
+  if ((m_mapping = CreateFileMapping(handle, NULL, PAGE_READONLY, 0, 0, NULL)) != NULL) {
+    if ((m_pointer = (const BYTE *)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) != NULL)
+      m_mapped = true;
+    else {
+      CloseHandle(m_mapping);
+      m_mapping = NULL;
+    }
+  }
+#else
+  void * ptr = mmap(NULL, size, PROT_READ, MAP_SHARED, (int)file.GetHandle(), 0);
+  if (ptr != MAP_FAILED) {
+    m_pointer = (const BYTE *)ptr;
+    m_mapped = true;
+  }
+#endif
+
+  if (m_mapped) {
+    m_size = size;
+    PTRACE(4, "Mapped \"" << path << "\", size=" << m_size);
+    return true;
+  }
+
+  PTRACE(3, "Could not map \"" << path << "\", reading instead.");
+  return ReadFile(file, maxReadSize);
+}
+
+
+bool PFileContent::Load(const PFilePath & path, PINDEX maxSize)
+{
+  Unmap();
+
+  PFile file;
+  if (!file.Open(path, PFile::ReadOnly)) {
+    PTRACE(2, "Could not open \"" << path << "\" - " << file.GetErrorText());
+    return false;
+  }
+
+  return ReadFile(file, maxSize);
+}
+
+
+bool PFileContent::ReadFile(PFile & file, PINDEX maxSize)
+{
+  off_t size = file.GetLength();
+  if (size > (off_t)maxSize) {
+    PTRACE(2, "File \"" << file.GetFilePath() << "\" too large to read: " << size << " bytes");
+    return false;
+  }
+
+  if (size == 0)
+    return true; // Valid empty content
+
+  if (!m_data.SetSize((PINDEX)size) || !file.Read(m_data.GetPointer(), m_data.GetSize()) || (off_t)file.GetLastReadCount() != size) {
+    PTRACE(2, "Could not read \"" << file.GetFilePath() << "\" - " << file.GetErrorText(PChannel::LastReadError));
+    m_data.SetSize(0);
+    return false;
+  }
+
+  m_pointer = m_data;
+  m_size = size;
+  return true;
+}
+
+
+void PFileContent::SetData(const PBYTEArray & data)
+{
+  Unmap();
+  m_data = data;
+  m_pointer = m_data;
+  m_size = m_data.GetSize();
+}
+
+
+PINDEX PFileContent::Read(off_t position, void * buffer, PINDEX length) const
+{
+  if (position < 0 || position >= m_size)
+    return 0;
+
+  if ((off_t)length > m_size - position)
+    length = (PINDEX)(m_size - position);
+  memcpy(buffer, m_pointer + position, length);
+  return length;
+}
+
+
+void PFileContent::ReadAhead(off_t position, off_t length) const
+{
+  if (!m_mapped || position < 0 || position >= m_size)
+    return;
+
+  if (length > m_size - position)
+    length = m_size - position;
+
+#ifdef _WIN32
+  // PrefetchVirtualMemory() is not available on all supported versions,
+  // so just touch the first byte of each page, via the OS read ahead
+  static const off_t PageSize = 4096;
+  volatile BYTE dummy = 0;
+  for (off_t offset = position; offset < position + length; offset += PageSize)
+    dummy += m_pointer[offset];
+#elif defined(MADV_WILLNEED)
+  static const off_t PageMask = sysconf(_SC_PAGESIZE) - 1;
+  off_t start = position & ~PageMask;
+  madvise((void *)(m_pointer + start), (size_t)(length + position - start), MADV_WILLNEED);
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PFileCache::PFileCache()
+  : m_maxSize(DefaultMaxSize)
+  , m_maxContentSize(DefaultMaxContentSize)
+  , m_totalSize(0)
+  , m_maxMapped(DefaultMaxMapped)
+  , m_mappedCount(0)
+  , m_mapWritable(false)
+  , m_useCounter(0)
+{
+}
+
+
+PFileCache & PFileCache::GetInstance()
+{
+  return *PSafeSingleton<PFileCache>();
+}
+
+
+PFileContentPtr PFileCache::GetContent(const PFilePath & path, const PString & variant, Loader * loader)
+{
+  PFileInfo info;
+  if (!PFile::GetInfo(path, info)) {
+    PTRACE(2, "Could not get info for \"" << path << '"');
+    return NULL;
+  }
+
+  PString key = path;
+  if (!variant.IsEmpty())
+    key += '\n' + variant;
+
+  PendingPtr pending;
+  PINDEX maxContentSize = 0;
+  bool map = false;
+  {
+    PWaitAndSignal lock(m_mutex);
+
+    EntryMap::iterator it = m_entries.find(key);
+    if (it != m_entries.end()) {
+      if (it->second.m_modified == info.modified && it->second.m_fileSize == info.size) {
+        it->second.m_lastUsed = ++m_useCounter;
+        return it->second.m_content;
+      }
+
+      PTRACE(3, "File \"" << path << "\" changed, reloading");
+      InternalRemove(it->second);
+      m_entries.erase(it);
+    }
+
+    PendingMap::iterator loading = m_pending.find(key);
+    if (loading != m_pending.end()) {
+      pending = loading->second;
+      ++pending->m_waiters;
+    }
+    else {
+      m_pending[key] = new Pending;
+      maxContentSize = m_maxContentSize;
+      map = m_mapWritable || !(info.permissions & (PFileInfo::UserWrite|PFileInfo::GroupWrite|PFileInfo::WorldWrite));
+    }
+  }
+
+  // Someone else is loading it, wait for them
+  if (!pending.IsNULL()) {
+    PTRACE(4, "Waiting for load of \"" << path << '"');
+    pending->m_loaded.Wait();
+    return pending->m_content;
+  }
+
+  // Do the (potentially slow) load without the cache locked
+  PFileContentPtr ptr = InternalLoad(path, variant, loader, maxContentSize, map);
+
+  PWaitAndSignal lock(m_mutex);
+
+  PendingMap::iterator loading = m_pending.find(key);
+  pending = loading->second;
+  m_pending.erase(loading);
+  pending->m_content = ptr;
+  while (pending->m_waiters-- > 0)
+    pending->m_loaded.Signal();
+
+  if (ptr.IsNULL())
+    return NULL;
+
+  if (ptr->IsMapped())
+    ++m_mappedCount;
+  else
+    m_totalSize += ptr->GetSize();
+  if (m_totalSize > m_maxSize || m_mappedCount > m_maxMapped)
+    InternalPurge(m_maxSize, m_maxMapped);
+
+  Entry & entry = m_entries[key];
+  entry.m_content = ptr;
+  entry.m_modified = info.modified;
+  entry.m_fileSize = info.size;
+  entry.m_lastUsed = ++m_useCounter;
+
+  PTRACE(4, "Added \"" << path << "\"" << (variant.IsEmpty() ? "" : ", variant ") << variant
+         << ", size=" << ptr->GetSize() << ", total=" << m_totalSize << ", mapped=" << m_mappedCount);
+  return ptr;
+}
+
+
+PFileContentPtr PFileCache::InternalLoad(const PFilePath & path, const PString & variant, Loader * loader, PINDEX maxContentSize, bool map)
+{
+  PFileContent * content = new PFileContent;
+  PFileContentPtr ptr(content);
+
+  if (loader == NULL) {
+    if (!(map ? content->Map(path, maxContentSize) : content->Load(path, maxContentSize)))
+      return NULL;
+    return ptr;
+  }
+
+  PBYTEArray data;
+  if (!loader->Load(path, data, maxContentSize)) {
+    PTRACE(3, "Could not load \"" << path << "\", variant \"" << variant << '"');
+    return NULL;
+  }
+
+  if (data.GetSize() > maxContentSize) {
+    PTRACE(3, "Content of \"" << path << "\" too large to cache: " << data.GetSize() << " bytes");
+    return NULL;
+  }
+
+  content->SetData(data);
+  return ptr;
+}
+
+
+void PFileCache::Purge()
+{
+  PWaitAndSignal lock(m_mutex);
+  InternalPurge(0, 0);
+}
+
+
+void PFileCache::SetMaxSize(off_t size)
+{
+  PWaitAndSignal lock(m_mutex);
+  m_maxSize = size;
+}
+
+
+off_t PFileCache::GetMaxSize() const
+{
+  PWaitAndSignal lock(m_mutex);
+  return m_maxSize;
+}
+
+
+void PFileCache::SetMaxContentSize(PINDEX size)
+{
+  PWaitAndSignal lock(m_mutex);
+  m_maxContentSize = size;
+}
+
+
+PINDEX PFileCache::GetMaxContentSize() const
+{
+  PWaitAndSignal lock(m_mutex);
+  return m_maxContentSize;
+}
+
+
+off_t PFileCache::GetTotalSize() const
+{
+  PWaitAndSignal lock(m_mutex);
+  return m_totalSize;
+}
+
+
+void PFileCache::SetMaxMapped(PINDEX count)
+{
+  PWaitAndSignal lock(m_mutex);
+  m_maxMapped = count;
+}
+
+
+PINDEX PFileCache::GetMaxMapped() const
+{
+  PWaitAndSignal lock(m_mutex);
+  return m_maxMapped;
+}
+
+
+PINDEX PFileCache::GetMappedCount() const
+{
+  PWaitAndSignal lock(m_mutex);
+  return m_mappedCount;
+}
+
+
+void PFileCache::SetMapWritable(bool map)
+{
+  PWaitAndSignal lock(m_mutex);
+  m_mapWritable = map;
+}
+
+
+bool PFileCache::GetMapWritable() const
+{
+  PWaitAndSignal lock(m_mutex);
+  return m_mapWritable;
+}
+
+
+void PFileCache::InternalPurge(off_t targetSize, PINDEX targetMapped)
+{
+  // Remove least recently used first, skipping any still being read
+  std::multimap<PUInt64, EntryMap::iterator> byAge;
+  for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+    if (!it->second.m_content->IsInUse())
+      byAge.insert(std::make_pair(it->second.m_lastUsed, it));
+  }
+
+  for (std::multimap<PUInt64, EntryMap::iterator>::iterator it = byAge.begin(); it != byAge.end(); ++it) {
+    const PFileContentPtr & content = it->second->second.m_content;
+    if (content->IsMapped() ? (m_mappedCount <= targetMapped) : (targetSize > 0 && m_totalSize <= targetSize))
+      continue;
+
+    PTRACE(4, "Removing \"" << it->second->first.Left(it->second->first.Find('\n')) << "\", size=" << content->GetSize());
+    InternalRemove(it->second->second);
+    m_entries.erase(it->second);
+  }
+}
+
+
+void PFileCache::InternalRemove(const Entry & entry)
+{
+  if (entry.m_content->IsMapped())
+    --m_mappedCount;
+  else
+    m_totalSize -= entry.m_content->GetSize();
+}
+
+
+// End Of File ///////////////////////////////////////////////////////////////
@@ -245,6 +245,9 @@ PBoolean PHTTPServer::ProcessCommand()
   if (!ReadCommand(cmd, args))
     return false;
 
+  static PLatencyHistogram & s_serviceHistogram = PLatencyHistogram::Get("ptlib.http.service");
+  uint64_t startCycle = s_serviceHistogram.IsEnabled() ? PProfiling::GetCycles() : 0;
+
   PTime now;
   PTRACE_IF(5, m_lastCommandTime.IsValid(), "Time since last command: " << now - m_lastCommandTime);
   m_lastCommandTime = now;
@@ -323,6 +326,10 @@ PBoolean PHTTPServer::ProcessCommand()
 
   flush();
 
+  // Web sockets live for the entire connection, so are not included
+  if (startCycle != 0 && !m_connectInfo.IsWebSocket())
+    s_serviceHistogram.RecordSince(startCycle);
+
   // if the function just indicated that the connection is to persist,
   // and so did the client, then return true. Note that all of the OnXXXX
   // routines above must make sure that their return value is false if
@@ -1585,12 +1592,12 @@ PBoolean PHTTPConnectionInfo::Initialise(PHTTPServer & server, PString & args)
 
   // get any connection options
   if (!str.IsEmpty()) {
-    PStringArray tokens = str.Tokenise(", \t\r\n", false);
-    for (PINDEX i = 0; i < tokens.GetSize(); i++) {
-      PCaselessString token(tokens[i]);
-      if (token == PHTTP::KeepAliveTag())
+    PStringTokeniser tokens(str, ", \t\r\n", false);
+    PStringView token;
+    while (tokens.Next(token)) {
+      if (token.IsCaselessEqual(PHTTP::KeepAliveTag()))
         isPersistent = true;
-      else if (token == PHTTP::UpgradeTag()) {
+      else if (token.IsCaselessEqual(PHTTP::UpgradeTag())) {
         PCaselessString protocol = mimeInfo(PHTTP::UpgradeTag());
         if (protocol != PHTTP::WebSocketTag()) {
           PTRACE(4, "Cannot upgrade to protocol \"" << protocol << '"');
@@ -2093,6 +2100,46 @@ PString PHTTPString::LoadText(PHTTPRequest &)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////
+// PHTTPLatencyHistograms
+
+PHTTPLatencyHistograms::PHTTPLatencyHistograms(const PURL & url)
+  : PHTTPResource(url, PMIMEInfo::TextPlain())
+{
+}
+
+
+PHTTPLatencyHistograms::PHTTPLatencyHistograms(const PURL & url, const PHTTPAuthority & auth)
+  : PHTTPResource(url, PMIMEInfo::TextPlain(), auth)
+{
+}
+
+
+bool PHTTPLatencyHistograms::IsJSON(const PHTTPRequest & request)
+{
+  return request.url.GetQueryVars().GetString("format") *= "json";
+}
+
+
+PBoolean PHTTPLatencyHistograms::LoadHeaders(PHTTPRequest & request)
+{
+  if (IsJSON(request))
+    request.outMIME.SetAt(PHTTP::ContentTypeTag(), "application/json");
+  return true;
+}
+
+
+PString PHTTPLatencyHistograms::LoadText(PHTTPRequest & request)
+{
+  PStringStream text;
+  if (IsJSON(request))
+    PLatencyHistogram::AllToJSON(text);
+  else
+    PLatencyHistogram::PrintAll(text);
+  return text;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////
 // PHTTPFile
 
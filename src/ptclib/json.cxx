@@ -105,14 +105,18 @@ PJSON & PJSON::operator=(const PJSON & other)
 
 bool PJSON::FromString(const PString & str)
 {
-  PStringStream strm(str);
-  ReadFrom(strm);
-  return m_valid;
+  return FromBuffer(str, str.GetLength());
 }
 
 
 PString PJSON::AsString(std::streamsize initialIndent, std::streamsize subsequentIndent) const
 {
+  if (initialIndent == 0 && subsequentIndent == 0) {
+    Writer writer;
+    writer.Append(*m_root);
+    return writer.AsString();
+  }
+
   PStringStream strm;
   strm.width(initialIndent);
   strm.precision(subsequentIndent != 0 ? subsequentIndent : (initialIndent != 0 ? 2 : 6));
@@ -130,6 +134,739 @@ void PJSON::Set(Types type)
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+static void AppendUTF8(std::string & str, unsigned code)
+{
+  if (code < 0x80)
+    str += (char)code;
+  else if (code < 0x800) {
+    str += (char)(0xc0 | (code >> 6));
+    str += (char)(0x80 | (code & 0x3f));
+  }
+  else if (code < 0x10000) {
+    str += (char)(0xe0 | (code >> 12));
+    str += (char)(0x80 | ((code >> 6) & 0x3f));
+    str += (char)(0x80 | (code & 0x3f));
+  }
+  else {
+    str += (char)(0xf0 | (code >> 18));
+    str += (char)(0x80 | ((code >> 12) & 0x3f));
+    str += (char)(0x80 | ((code >> 6) & 0x3f));
+    str += (char)(0x80 | (code & 0x3f));
+  }
+}
+
+
+static __inline bool IsWhiteSpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+
+/* Parser working directly on a memory buffer. It is not recursive, the
+   nesting is kept in a small stack, so deep documents cannot overflow the
+   thread stack. Strings without escapes are passed to the handler as a
+   pointer into the buffer, and memchr(), which the C library vectorises,
+   is used to find their end. */
+class PJSONParser
+{
+  public:
+    PJSONParser(const char * json, size_t length, PJSON::Handler & handler)
+      : m_start(json)
+      , m_ptr(json)
+      , m_end(json + length)
+      , m_handler(handler)
+    {
+    }
+
+
+    bool Parse()
+    {
+      for (;;) {
+        // Get next value, which may start a new object/array
+        if (!SkipWhiteSpace())
+          return false;
+
+        switch (*m_ptr) {
+          case '{' :
+            ++m_ptr;
+            if (!m_handler.OnStartObject() || !SkipWhiteSpace())
+              return false;
+            if (*m_ptr != '}') {
+              m_nesting.push_back('}');
+              if (!ParseName())
+                return false;
+              continue;
+            }
+            ++m_ptr;
+            if (!m_handler.OnEndObject())
+              return false;
+            break;
+
+          case '[' :
+            ++m_ptr;
+            if (!m_handler.OnStartArray() || !SkipWhiteSpace())
+              return false;
+            if (*m_ptr != ']') {
+              m_nesting.push_back(']');
+              continue;
+            }
+            ++m_ptr;
+            if (!m_handler.OnEndArray())
+              return false;
+            break;
+
+          default :
+            if (!ParseScalar())
+              return false;
+        }
+
+        // Now look for the next value, or close of object/array
+        for (;;) {
+          if (m_nesting.empty())
+            return !SkipWhiteSpace(); // Only white space may follow the top level value
+
+          if (!SkipWhiteSpace())
+            return false;
+
+          char c = *m_ptr++;
+          if (c == ',') {
+            if (m_nesting.back() == '}' && !ParseName())
+              return false;
+            break;
+          }
+
+          if (c != m_nesting.back())
+            return false;
+
+          m_nesting.pop_back();
+          if (!(c == '}' ? m_handler.OnEndObject() : m_handler.OnEndArray()))
+            return false;
+        }
+      }
+    }
+
+
+    size_t GetPosition() const { return m_ptr - m_start; }
+
+
+  protected:
+    bool SkipWhiteSpace()
+    {
+      while (m_ptr < m_end && IsWhiteSpace(*m_ptr))
+        ++m_ptr;
+      return m_ptr < m_end;
+    }
+
+
+    bool ParseScalar()
+    {
+      switch (*m_ptr) {
+        case '"' :
+          return ParseString(false);
+
+        case 'T' :
+        case 't' :
+          return ParseWord("true", 4) && m_handler.OnBoolean(true);
+
+        case 'F' :
+        case 'f' :
+          return ParseWord("false", 5) && m_handler.OnBoolean(false);
+
+        case 'N' :
+        case 'n' :
+          return ParseWord("null", 4) && m_handler.OnNull();
+
+        default :
+          return ParseNumber();
+      }
+    }
+
+
+    bool ParseName()
+    {
+      if (!SkipWhiteSpace() || *m_ptr != '"' || !ParseString(true) || !SkipWhiteSpace() || *m_ptr != ':')
+        return false;
+      ++m_ptr;
+      return true;
+    }
+
+
+    bool ParseWord(const char * word, size_t length)
+    {
+      if ((size_t)(m_end - m_ptr) < length)
+        return false;
+
+      for (size_t i = 0; i < length; ++i) {
+        if (tolower(m_ptr[i]) != word[i])
+          return false;
+      }
+
+      m_ptr += length;
+      return true;
+    }
+
+
+    bool ParseString(bool name)
+    {
+      const char * start = ++m_ptr;
+      const char * quote = (const char *)memchr(start, '"', m_end - start);
+      if (quote == NULL)
+        return false;
+
+      const char * escape = (const char *)memchr(start, '\\', quote - start);
+      if (escape == NULL) {
+        m_ptr = quote + 1;
+        return name ? m_handler.OnName(start, quote - start) : m_handler.OnString(start, quote - start);
+      }
+
+      // Slow path, unescape into scratch buffer
+      m_scratch.assign(start, escape);
+      m_ptr = escape;
+      while (m_ptr < m_end) {
+        char c = *m_ptr++;
+        if (c == '"')
+          return name ? m_handler.OnName(m_scratch.data(), m_scratch.length())
+                      : m_handler.OnString(m_scratch.data(), m_scratch.length());
+
+        if (c != '\\') {
+          m_scratch += c;
+          continue;
+        }
+
+        if (m_ptr >= m_end)
+          return false;
+
+        switch (c = *m_ptr++) {
+          case '"' :
+          case '\\' :
+          case '/' :
+            m_scratch += c;
+            break;
+          case 'b' :
+            m_scratch += '\b';
+            break;
+          case 'f' :
+            m_scratch += '\f';
+            break;
+          case 'n' :
+            m_scratch += '\n';
+            break;
+          case 'r' :
+            m_scratch += '\r';
+            break;
+          case 't' :
+            m_scratch += '\t';
+            break;
+          case 'u' :
+          {
+            unsigned code;
+            if (!ParseHex(code))
+              return false;
+            // Combine UTF-16 surrogate pair
+            unsigned low;
+            if (code >= 0xd800 && code < 0xdc00 && m_end - m_ptr >= 6 &&
+                    m_ptr[0] == '\\' && m_ptr[1] == 'u' && (m_ptr += 2, ParseHex(low))) {
+              if (low >= 0xdc00 && low < 0xe000)
+                code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+              else {
+                AppendUTF8(m_scratch, code);
+                code = low;
+              }
+            }
+            AppendUTF8(m_scratch, code);
+            break;
+          }
+          default :
+            return false;
+        }
+      }
+
+      return false;
+    }
+
+
+    bool ParseHex(unsigned & code)
+    {
+      if (m_end - m_ptr < 4)
+        return false;
+
+      code = 0;
+      for (int i = 0; i < 4; ++i) {
+        char c = *m_ptr++;
+        code <<= 4;
+        if (c >= '0' && c <= '9')
+          code += c - '0';
+        else if (c >= 'a' && c <= 'f')
+          code += c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+          code += c - 'A' + 10;
+        else
+          return false;
+      }
+      return true;
+    }
+
+
+    bool ParseNumber()
+    {
+      const char * start = m_ptr;
+      bool negative = m_ptr < m_end && *m_ptr == '-';
+      if (negative)
+        ++m_ptr;
+
+      // Integers are very common, so do them without strtold()
+      uint64_t integer = 0;
+      const char * digits = m_ptr;
+      while (m_ptr < m_end && isdigit(*m_ptr))
+        integer = integer*10 + (*m_ptr++ - '0');
+      size_t integerDigits = m_ptr - digits;
+
+      bool isInteger = true;
+      if (m_ptr < m_end && *m_ptr == '.') {
+        isInteger = false;
+        ++m_ptr;
+        while (m_ptr < m_end && isdigit(*m_ptr))
+          ++m_ptr;
+      }
+      if (m_ptr - digits == (isInteger ? 0 : 1))
+        return false; // No digits at all
+
+      if (m_ptr < m_end && (*m_ptr == 'e' || *m_ptr == 'E')) {
+        isInteger = false;
+        ++m_ptr;
+        if (m_ptr < m_end && (*m_ptr == '+' || *m_ptr == '-'))
+          ++m_ptr;
+        if (m_ptr >= m_end || !isdigit(*m_ptr))
+          return false;
+        while (m_ptr < m_end && isdigit(*m_ptr))
+          ++m_ptr;
+      }
+
+      if (isInteger && integerDigits <= 18)
+        return m_handler.OnNumber(negative ? -(PJSON::NumberType)integer : (PJSON::NumberType)integer);
+
+      // Need terminated string for strtold()
+      std::string number(start, m_ptr);
+      return m_handler.OnNumber(strtold(number.c_str(), NULL));
+    }
+
+
+    const char *       m_start;
+    const char *       m_ptr;
+    const char *       m_end;
+    PJSON::Handler   & m_handler;
+    std::vector<char>  m_nesting;
+    std::string        m_scratch;
+};
+
+
+bool PJSON::Parse(const char * json, size_t length, Handler & handler, size_t * errorPosition)
+{
+  PJSONParser parser(json, length, handler);
+  if (parser.Parse())
+    return true;
+
+  PTRACE(4, NULL, PTraceModule(), "Parse error at offset " << parser.GetPosition());
+  if (errorPosition != NULL)
+    *errorPosition = parser.GetPosition();
+  return false;
+}
+
+
+// Build the Object/Array tree from the parse events
+class PJSONBuilder : public PJSON::Handler
+{
+  public:
+    PJSONBuilder()
+      : m_root(NULL)
+    {
+    }
+
+
+    ~PJSONBuilder()
+    {
+      delete m_root;
+      for (std::vector<Frame>::iterator it = m_stack.begin(); it != m_stack.end(); ++it) {
+        if (it->m_orphan)
+          delete it->m_node;
+      }
+    }
+
+
+    PJSON::Base * Detach()
+    {
+      PJSON::Base * root = m_root;
+      m_root = NULL;
+      return root;
+    }
+
+
+    virtual bool OnStartObject()
+    {
+      PJSON::Object * obj = new PJSON::Object;
+      m_stack.push_back(Frame(obj, obj, NULL, !Add(obj)));
+      return true;
+    }
+
+
+    virtual bool OnEndObject()
+    {
+      return Pop();
+    }
+
+
+    virtual bool OnStartArray()
+    {
+      PJSON::Array * arr = new PJSON::Array;
+      m_stack.push_back(Frame(arr, NULL, arr, !Add(arr)));
+      return true;
+    }
+
+
+    virtual bool OnEndArray()
+    {
+      return Pop();
+    }
+
+
+    virtual bool OnName(const char * name, size_t length)
+    {
+      m_name = PString(name, length);
+      return true;
+    }
+
+
+    virtual bool OnString(const char * value, size_t length)
+    {
+      return AddScalar(new PJSON::String(value, length));
+    }
+
+
+    virtual bool OnNumber(PJSON::NumberType value)
+    {
+      return AddScalar(new PJSON::Number(value));
+    }
+
+
+    virtual bool OnBoolean(bool value)
+    {
+      return AddScalar(new PJSON::Boolean(value));
+    }
+
+
+    virtual bool OnNull()
+    {
+      return AddScalar(new PJSON::Null);
+    }
+
+
+  protected:
+    struct Frame
+    {
+      Frame(PJSON::Base * node, PJSON::Object * obj, PJSON::Array * arr, bool orphan)
+        : m_node(node), m_object(obj), m_array(arr), m_orphan(orphan) { }
+      PJSON::Base   * m_node;
+      PJSON::Object * m_object;
+      PJSON::Array  * m_array;
+      bool            m_orphan; // Duplicate name, as std::map keeps first, this is discarded
+    };
+
+
+    // Returns false if node is not owned by the tree
+    bool Add(PJSON::Base * node)
+    {
+      if (m_stack.empty()) {
+        if (m_root != NULL)
+          return false;
+        m_root = node;
+        return true;
+      }
+
+      Frame & top = m_stack.back();
+      if (top.m_array != NULL) {
+        top.m_array->push_back(node);
+        return true;
+      }
+
+      return top.m_object->insert(make_pair(m_name, node)).second;
+    }
+
+
+    bool AddScalar(PJSON::Base * node)
+    {
+      if (!Add(node))
+        delete node;
+      return true;
+    }
+
+
+    bool Pop()
+    {
+      if (m_stack.empty())
+        return false;
+
+      if (m_stack.back().m_orphan)
+        delete m_stack.back().m_node;
+      m_stack.pop_back();
+      return true;
+    }
+
+
+    PJSON::Base      * m_root;
+    std::vector<Frame> m_stack;
+    PString            m_name;
+};
+
+
+bool PJSON::FromBuffer(const char * json, size_t length)
+{
+  PJSONBuilder builder;
+  m_valid = Parse(json, length, builder);
+
+  delete m_root;
+  m_root = builder.Detach();
+  if (m_root == NULL) {
+    m_root = new Null;
+    m_valid = false;
+  }
+
+  return m_valid;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PJSON::Writer::Writer()
+  : m_length(0)
+  , m_afterName(false)
+{
+}
+
+
+void PJSON::Writer::Reset()
+{
+  m_length = 0;
+  m_needComma.clear();
+  m_afterName = false;
+}
+
+
+char * PJSON::Writer::Reserve(size_t length)
+{
+  if (m_length + length > m_buffer.size())
+    m_buffer.resize(std::max(m_buffer.size()*2, m_length + length + 256));
+  return &m_buffer[m_length];
+}
+
+
+void PJSON::Writer::Separator()
+{
+  if (m_afterName)
+    m_afterName = false;
+  else if (!m_needComma.empty()) {
+    if (m_needComma.back())
+      Put(',');
+    else
+      m_needComma.back() = true;
+  }
+}
+
+
+void PJSON::Writer::PutString(const char * str, size_t length)
+{
+  Put('"');
+
+  const char * end = str + length;
+  while (str < end) {
+    // Copy runs of characters that need no escaping in one go
+    const char * run = str;
+    while (run < end && (BYTE)*run >= ' ' && *run != '"' && *run != '\\')
+      ++run;
+    if (run > str) {
+      Put(str, run - str);
+      str = run;
+      if (str >= end)
+        break;
+    }
+
+    char c = *str++;
+    switch (c) {
+      case '"' :
+        Put("\\\"", 2);
+        break;
+      case '\\' :
+        Put("\\\\", 2);
+        break;
+      case '\t' :
+        Put("\\t", 2);
+        break;
+      case '\r' :
+        Put("\\r", 2);
+        break;
+      case '\n' :
+        Put("\\n", 2);
+        break;
+      default :
+        static const char Hex[] = "0123456789abcdef";
+        char * ptr = Reserve(6);
+        ptr[0] = '\\';
+        ptr[1] = 'u';
+        ptr[2] = '0';
+        ptr[3] = '0';
+        ptr[4] = Hex[(c >> 4) & 0xf];
+        ptr[5] = Hex[c & 0xf];
+        m_length += 6;
+    }
+  }
+
+  Put('"');
+}
+
+
+PJSON::Writer & PJSON::Writer::StartObject()
+{
+  Separator();
+  Put('{');
+  m_needComma.push_back(false);
+  return *this;
+}
+
+
+PJSON::Writer & PJSON::Writer::EndObject()
+{
+  Put('}');
+  if (PAssert(!m_needComma.empty(), PLogicError))
+    m_needComma.pop_back();
+  return *this;
+}
+
+
+PJSON::Writer & PJSON::Writer::StartArray()
+{
+  Separator();
+  Put('[');
+  m_needComma.push_back(false);
+  return *this;
+}
+
+
+PJSON::Writer & PJSON::Writer::EndArray()
+{
+  Put(']');
+  if (PAssert(!m_needComma.empty(), PLogicError))
+    m_needComma.pop_back();
+  return *this;
+}
+
+
+PJSON::Writer & PJSON::Writer::Name(const char * name, size_t length)
+{
+  Separator();
+  PutString(name, length);
+  Put(':');
+  m_afterName = true;
+  return *this;
+}
+
+
+PJSON::Writer & PJSON::Writer::AppendString(const char * value, size_t length)
+{
+  Separator();
+  PutString(value, length);
+  return *this;
+}
+
+
+PJSON::Writer & PJSON::Writer::AppendNumber(NumberType value)
+{
+  Separator();
+
+  // Same output as Number::PrintOn()
+  char buffer[64];
+  char * ptr = &buffer[sizeof(buffer)];
+  if (value >= 0 && value < 18446744073709551616.0L && (uint64_t)value == value) {
+    uint64_t integer = (uint64_t)value;
+    do {
+      *--ptr = (char)('0' + integer%10);
+      integer /= 10;
+    } while (integer != 0);
+  }
+  else if (value < 0 && value >= -9223372036854775808.0L && (int64_t)value == value) {
+    uint64_t integer = 0 - (uint64_t)(int64_t)value;
+    do {
+      *--ptr = (char)('0' + integer%10);
+      integer /= 10;
+    } while (integer != 0);
+    *--ptr = '-';
+  }
+  else {
+    int len = snprintf(buffer, sizeof(buffer), "%Lg", value);
+    if (len > 0)
+      Put(buffer, std::min((size_t)len, sizeof(buffer)-1));
+    return *this;
+  }
+
+  Put(ptr, &buffer[sizeof(buffer)] - ptr);
+  return *this;
+}
+
+
+PJSON::Writer & PJSON::Writer::AppendBoolean(bool value)
+{
+  Separator();
+  if (value)
+    Put("true", 4);
+  else
+    Put("false", 5);
+  return *this;
+}
+
+
+PJSON::Writer & PJSON::Writer::AppendNull()
+{
+  Separator();
+  Put("null", 4);
+  return *this;
+}
+
+
+PJSON::Writer & PJSON::Writer::Append(const Base & value)
+{
+  if (value.IsType(e_Object)) {
+    const Object & obj = dynamic_cast<const Object &>(value);
+    StartObject();
+    for (Object::const_iterator it = obj.begin(); it != obj.end(); ++it) {
+      Name(it->first);
+      Append(*it->second);
+    }
+    return EndObject();
+  }
+
+  if (value.IsType(e_Array)) {
+    const Array & arr = dynamic_cast<const Array &>(value);
+    StartArray();
+    for (Array::const_iterator it = arr.begin(); it != arr.end(); ++it)
+      Append(**it);
+    return EndArray();
+  }
+
+  if (value.IsType(e_String))
+    return AppendString(dynamic_cast<const String &>(value));
+
+  if (value.IsType(e_Number))
+    return AppendNumber(dynamic_cast<const Number &>(value).GetValue());
+
+  if (value.IsType(e_Boolean))
+    return AppendBoolean(dynamic_cast<const Boolean &>(value).GetValue());
+
+  return AppendNull();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
 static PJSON::Base * CreateFromStream(istream & strm)
 {
   strm >> ws;
@@ -263,11 +1000,32 @@ static bool ReadString(istream & strm, PString & str)
           str += '\t';
           break;
         case 'u' :
+        {
           char hex[5];
           strm.read(hex, 4);
           hex[4] = '\0';
-          str += (char)strtoul(hex, NULL, 16);
+          unsigned code = strtoul(hex, NULL, 16);
+          // Combine UTF-16 surrogate pair
+          if (code >= 0xd800 && code < 0xdc00 && strm.peek() == '\\') {
+            strm.get(c);
+            if (strm.get() != 'u')
+              return false;
+            strm.read(hex, 4);
+            unsigned low = strtoul(hex, NULL, 16);
+            if (low >= 0xdc00 && low < 0xe000)
+              code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+            else {
+              std::string utf8;
+              AppendUTF8(utf8, code);
+              str += utf8.c_str();
+              code = low;
+            }
+          }
+          std::string utf8;
+          AppendUTF8(utf8, code);
+          str += utf8.c_str();
           break;
+        }
       }
     }
   }
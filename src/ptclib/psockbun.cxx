@@ -131,7 +131,7 @@ static PBoolean IsInterfaceInList(const PIPSocket::InterfaceEntry & entry,
                               const PIPSocket::InterfaceTable & list)
 {
   for (PINDEX i = 0; i < list.GetSize(); ++i) {
-    PIPSocket::InterfaceEntry & listEntry = list[i];
+    const PIPSocket::InterfaceEntry & listEntry = list[i];
     if ((entry.GetName() == listEntry.GetName()) && (entry.GetAddress() == listEntry.GetAddress()))
       return true;
   }
@@ -143,7 +143,7 @@ static PBoolean InterfaceListIsSubsetOf(const PIPSocket::InterfaceTable & subset
                                     const PIPSocket::InterfaceTable & set)
 {
   for (PINDEX i = 0; i < subset.GetSize(); ++i) {
-    PIPSocket::InterfaceEntry & entry = subset[i];
+    const PIPSocket::InterfaceEntry & entry = subset[i];
     if (!IsInterfaceInList(entry, set))
       return false;
   }
@@ -182,7 +182,7 @@ void PInterfaceMonitor::RefreshInterfaceList()
     return;
   }
 
-  PIPSocket::InterfaceTable oldInterfaces = m_interfaces;
+  PIPSocket::InterfaceTable oldInterfaces = std::move(m_interfaces);
   m_interfaces = newInterfaces;
 
   PTRACE(3, "IfaceMon", "Interface change detected, new list:\n" << setfill('\n') << newInterfaces << setfill(' '));
@@ -192,8 +192,6 @@ void PInterfaceMonitor::RefreshInterfaceList()
   // calculate the set of interfaces to add / remove beforehand
   PIPSocket::InterfaceTable interfacesToAdd;
   PIPSocket::InterfaceTable interfacesToRemove;
-  interfacesToAdd.DisallowDeleteObjects();
-  interfacesToRemove.DisallowDeleteObjects();
   
   PINDEX i;
   // look for interfaces to add that are in new list that are not in the old list
@@ -201,14 +199,14 @@ void PInterfaceMonitor::RefreshInterfaceList()
     PIPSocket::InterfaceEntry & newEntry = newInterfaces[i];
     PIPSocket::Address addr = newEntry.GetAddress();
     if (addr.IsValid() && !addr.IsLoopback() && !IsInterfaceInList(newEntry, oldInterfaces))
-      interfacesToAdd.Append(&newEntry);
+      interfacesToAdd.Append(newEntry);
   }
   // look for interfaces to remove that are in old list that are not in the new list
   for (i = 0; i < oldInterfaces.GetSize(); ++i) {
     PIPSocket::InterfaceEntry & oldEntry = oldInterfaces[i];
     PIPSocket::Address addr = oldEntry.GetAddress();
     if (addr.IsValid() && !addr.IsLoopback() && !IsInterfaceInList(oldEntry, newInterfaces))
-      interfacesToRemove.Append(&oldEntry);
+      interfacesToRemove.Append(oldEntry);
   }
 
   PIPSocket::ClearNameCache();
@@ -332,7 +330,7 @@ bool PInterfaceMonitor::GetInterfaceInfo(const PString & iface, PIPSocket::Inter
   PWaitAndSignal guard(m_interfacesMutex);
 
   for (PINDEX i = 0; i < m_interfaces.GetSize(); ++i) {
-    PIPSocket::InterfaceEntry & entry = m_interfaces[i];
+    const PIPSocket::InterfaceEntry & entry = m_interfaces[i];
     if (InterfaceMatches(addr, name, entry)) {
       info = entry;
       return true;
@@ -61,6 +61,7 @@ PVideoFile::PVideoFile()
   , m_fixedFrameRate(false)
   , m_headerOffset(0)
   , m_frameHeaderLen(0)
+  , m_cached(false)
 {
   m_frameBytes = m_videoInfo.CalculateFrameBytes();
 }
@@ -99,8 +100,37 @@ PBoolean PVideoFile::WriteFrame(const void * frame)
 }
 
 
+bool PVideoFile::SetCached(bool cached)
+{
+  m_cached = cached;
+  m_content = NULL;
+  return true;
+}
+
+
 PBoolean PVideoFile::ReadFrame(void * frame)
 {
+  if (m_cached && m_content.IsNULL() && IsOpen()) {
+    m_content = PFileCache::GetInstance().GetContent(GetFilePath());
+    if (m_content.IsNULL()) {
+      PTRACE(3, "Could not use cache for \"" << GetFilePath() << "\", reading directly.");
+      m_cached = false;
+    }
+  }
+
+  if (!m_content.IsNULL()) {
+    // File position still tracks the frame, so headers can be read as usual
+    off_t pos = PFile::GetPosition();
+    PINDEX count = m_content->Read(pos, frame, m_frameBytes);
+    SetLastReadCount(count);
+    if (count == m_frameBytes && PFile::SetPosition(pos + count)) {
+      m_content->ReadAhead(pos + count, m_frameBytes + m_frameHeaderLen);
+      return true;
+    }
+    PTRACE(4, "End of file \"" << GetFilePath() << '"');
+    return false;
+  }
+
   if (Read(frame, m_frameBytes) && (GetLastReadCount() == m_frameBytes))
     return true;
 
@@ -198,6 +228,8 @@ static PString ReadPrintable(PFile & file)
 
 bool PYUVFile::InternalOpen(OpenMode mode, OpenOptions opts, PFileInfo::Permissions permissions)
 {
+  m_content = NULL;
+
   SetFrameSizeFromFilename(GetFilePath());
   SetFPSFromFilename(GetFilePath());
 
@@ -137,6 +137,9 @@ void PWAVFile::Construct(OpenMode mode)
 
   m_readSampleRate = m_readChannels = 0;  // Zero means automatically set in ProcessHeader
   m_readBufCount = m_readBufPos = 0;
+
+  m_cached = false;
+  m_contentOffset = m_contentLength = m_contentPosition = m_readAheadPosition = 0;
 }
 
 
@@ -183,6 +186,8 @@ PBoolean PWAVFile::Close()
   if (m_status == e_Writing)
     UpdateHeader();
 
+  m_content = NULL;
+
   return PFile::Close();
 }
 
@@ -202,13 +207,18 @@ bool PWAVFile::SetAutoconvert(bool convert)
   if (m_status == e_Writing)
     return false;
 
+  unsigned oldBytesPerSecond, blockSize;
+  InternalGetContentUnits(oldBytesPerSecond, blockSize);
+
   delete m_autoConverter;
-  m_autoConverter = NULL;
+  m_autoConverter = convert ? PWAVFileConverterFactory::CreateInstance(m_wavFmtChunk.format) : NULL;
+
+  InternalDropContent(oldBytesPerSecond);
 
   if (!convert)
     return true;
 
-  if ((m_autoConverter = PWAVFileConverterFactory::CreateInstance(m_wavFmtChunk.format)) != NULL) {
+  if (m_autoConverter != NULL) {
     PTRACE(4, "Set format converter for type " << (WORD)m_wavFmtChunk.format);
     return true;
   }
@@ -218,12 +228,173 @@ bool PWAVFile::SetAutoconvert(bool convert)
 }
 
 
+bool PWAVFile::SetCached(bool cached)
+{
+  if (m_status != e_Reading)
+    return false;
+
+  m_cached = cached;
+  m_content = NULL;
+  m_contentPosition = 0;
+  return true;
+}
+
+
+class PWAVFileContentLoader : public PFileCache::Loader
+{
+    bool     m_autoConvert;
+    unsigned m_sampleRate;
+    unsigned m_channels;
+  public:
+    PWAVFileContentLoader(bool autoConvert, unsigned sampleRate, unsigned channels)
+      : m_autoConvert(autoConvert)
+      , m_sampleRate(sampleRate)
+      , m_channels(channels)
+    {
+    }
+
+    virtual bool Load(const PFilePath & path, PBYTEArray & data, PINDEX maxSize)
+    {
+      PWAVFile wav;
+      if (!wav.Open(path, PFile::ReadOnly))
+        return false;
+
+      if (m_autoConvert && !wav.SetAutoconvert())
+        return false;
+
+      wav.SetSampleRate(m_sampleRate);
+      wav.SetChannels(m_channels);
+
+      static const PINDEX ChunkSize = 16384;
+      PINDEX size = 0;
+      for (;;) {
+        if (data.GetSize() < size + ChunkSize && !data.SetSize(std::max(data.GetSize()*2, size + ChunkSize)))
+          return false;
+        if (!wav.Read(data.GetPointer() + size, ChunkSize) || wav.GetLastReadCount() == 0)
+          break;
+        size += wav.GetLastReadCount();
+        if (size > maxSize)
+          return false;
+      }
+
+      return data.SetSize(size);
+    }
+};
+
+
+bool PWAVFile::InternalUseContent()
+{
+  if (!m_cached)
+    return false;
+
+  if (!m_content.IsNULL())
+    return true;
+
+  bool converting = m_autoConverter != NULL ||
+                    m_readSampleRate != m_wavFmtChunk.sampleRate ||
+                    m_readChannels != m_wavFmtChunk.numChannels;
+
+  /* Can share the file pages directly if no conversion, and the format
+     handler does not do anything to the data on the way through. */
+  bool raw = !converting && (m_wavFmtChunk.format == fmt_ALaw ||
+                             m_wavFmtChunk.format == fmt_uLaw ||
+                            (m_wavFmtChunk.format == fmt_PCM && PBYTE_ORDER == PLITTLE_ENDIAN));
+
+  if (raw) {
+    m_content = PFileCache::GetInstance().GetContent(GetFilePath());
+    m_contentOffset = m_headerLength;
+    m_contentLength = m_content.IsNULL() ? 0 : std::min(m_dataLength, m_content->GetSize() - m_headerLength);
+  }
+  else {
+    PWAVFileContentLoader loader(m_autoConverter != NULL, m_readSampleRate, m_readChannels);
+    m_content = PFileCache::GetInstance().GetContent(GetFilePath(),
+                                                     PSTRSTRM((m_autoConverter != NULL ? "PCM-16" : GetFormatString())
+                                                              << ',' << m_readSampleRate << ',' << m_readChannels),
+                                                     &loader);
+    m_contentOffset = 0;
+    m_contentLength = m_content.IsNULL() ? 0 : m_content->GetSize();
+  }
+
+  if (m_content.IsNULL()) {
+    PTRACE(3, "Could not use cache for \"" << GetFilePath() << "\", reading directly.");
+    m_cached = false;
+    return false;
+  }
+
+  m_readAheadPosition = m_contentPosition;
+  PTRACE(4, "Using " << (raw ? "mapped" : "converted") << " cache content for \"" << GetFilePath() << '"');
+  return true;
+}
+
+
+void PWAVFile::InternalGetContentUnits(unsigned & bytesPerSecond, unsigned & blockSize) const
+{
+  if (m_autoConverter == NULL && m_readSampleRate == m_wavFmtChunk.sampleRate && m_readChannels == m_wavFmtChunk.numChannels) {
+    bytesPerSecond = m_wavFmtChunk.bytesPerSec;
+    blockSize = m_wavFmtChunk.bytesPerSample;
+  }
+  else {
+    // Converted to PCM-16
+    bytesPerSecond = m_readSampleRate*m_readChannels*sizeof(short);
+    blockSize = m_readChannels*sizeof(short);
+  }
+}
+
+
+void PWAVFile::InternalDropContent(unsigned oldBytesPerSecond)
+{
+  m_content = NULL;
+
+  /* The position is in the units of the old content, e.g. 8kHz A-Law,
+     move to the same time in the new content, e.g. 16kHz PCM-16. */
+  unsigned newBytesPerSecond, blockSize;
+  InternalGetContentUnits(newBytesPerSecond, blockSize);
+  if (oldBytesPerSecond == 0 || newBytesPerSecond == 0)
+    m_contentPosition = 0;
+  else if (oldBytesPerSecond != newBytesPerSecond) {
+    m_contentPosition = (off_t)((PUInt64)m_contentPosition*newBytesPerSecond/oldBytesPerSecond);
+    if (blockSize > 1)
+      m_contentPosition -= m_contentPosition%blockSize;
+  }
+  m_readAheadPosition = m_contentPosition;
+}
+
+
+bool PWAVFile::InternalReadContent(void * buf, PINDEX len)
+{
+  static const off_t ReadAheadSize = 65536;
+
+  if (m_contentPosition + ReadAheadSize/2 >= m_readAheadPosition && m_readAheadPosition < m_contentLength) {
+    m_content->ReadAhead(m_contentOffset + m_readAheadPosition, ReadAheadSize);
+    m_readAheadPosition += ReadAheadSize;
+  }
+
+  if ((off_t)len > m_contentLength - m_contentPosition)
+    len = (PINDEX)(m_contentLength - m_contentPosition);
+
+  if (len == 0) {
+    // indicate eof (return false, but error=0, last read count=0)
+    SetLastReadCount(0);
+    ConvertOSError(0, LastReadError);
+    return false;
+  }
+
+  memcpy(buf, m_content->GetPointer() + m_contentOffset + m_contentPosition, len);
+  m_contentPosition += len;
+  SetLastReadCount(len);
+  return true;
+}
+
+
 // Performs necessary byte-order swapping on for big-endian platforms.
 PBoolean PWAVFile::Read(void * buf, PINDEX len)
 {
   if (CheckNotOpen())
     return false;
 
+  if (InternalUseContent())
+    return InternalReadContent(buf, len);
+
   if (m_wavFmtChunk.sampleRate == m_readSampleRate && m_wavFmtChunk.numChannels == m_readChannels)
     return m_autoConverter != NULL ? m_autoConverter->Read(*this, buf, len) : RawRead(buf, len);
 
@@ -314,7 +485,7 @@ off_t PWAVFile::GetLength() const
 {
   switch (m_status) {
     case e_Reading:
-      return m_dataLength;
+      return m_content.IsNULL() ? m_dataLength : m_contentLength;
 
     case e_Writing:
       return PFile::GetLength() - m_headerLength;
@@ -334,6 +505,23 @@ PBoolean PWAVFile::SetLength(off_t)
 
 PBoolean PWAVFile::SetPosition(off_t pos, FilePositionOrigin origin)
 {
+  if (InternalUseContent()) {
+    switch (origin) {
+      case Current :
+        pos += m_contentPosition;
+        break;
+      case End :
+        pos += m_contentLength;
+        break;
+      default :
+        break;
+    }
+    if (pos < 0 || pos > m_contentLength)
+      return false;
+    m_contentPosition = m_readAheadPosition = pos;
+    return true;
+  }
+
   if (m_autoConverter != NULL)
     return m_autoConverter->SetPosition(*this, pos, origin);
 
@@ -349,6 +537,9 @@ bool PWAVFile::RawSetPosition(off_t pos, FilePositionOrigin origin)
 
 off_t PWAVFile::GetPosition() const
 {
+  if (m_cached)
+    return m_contentPosition;
+
   if (m_autoConverter != NULL)
     return m_autoConverter->GetPosition(*this);
 
@@ -380,8 +571,13 @@ bool PWAVFile::SetChannels(unsigned channels)
 {
   switch (m_status) {
     case e_Reading :
+    {
+      unsigned oldBytesPerSecond, blockSize;
+      InternalGetContentUnits(oldBytesPerSecond, blockSize);
       m_readChannels = channels;
+      InternalDropContent(oldBytesPerSecond);
       break;
+    }
 
     case e_PreWrite :
       if (m_formatHandler == NULL || m_formatHandler->CanSetChannels(channels)) {
@@ -415,8 +611,13 @@ bool PWAVFile::SetSampleRate(unsigned rate)
 {
   switch (m_status) {
     case e_Reading :
+    {
+      unsigned oldBytesPerSecond, blockSize;
+      InternalGetContentUnits(oldBytesPerSecond, blockSize);
       m_readSampleRate = rate;
+      InternalDropContent(oldBytesPerSecond);
       break;
+    }
 
     case e_PreWrite :
       m_wavFmtChunk.sampleRate = (WORD)rate;
@@ -41,6 +41,120 @@
 
 #include <expat.h>
 
+
+////////////////////////////////////////////////////
+// Before PNEW is defined, as uses placement new
+
+PXMLArena::PXMLArena(size_t blockSize)
+  : m_blockSize(blockSize)
+  , m_blockUsed(blockSize)
+  , m_memoryUsed(0)
+{
+}
+
+
+PXMLArena::~PXMLArena()
+{
+  Clear();
+}
+
+
+void * PXMLArena::Allocate(size_t size)
+{
+  size = (size + 15) & ~(size_t)15;
+
+  if (m_blockUsed + size > m_blockSize) {
+    if (size > m_blockSize/4) {
+      // Large object gets its own block, so current block is not wasted
+      BYTE * block = (BYTE *)malloc(size);
+      m_blocks.insert(m_blocks.end() - (m_blocks.empty() ? 0 : 1), block);
+      m_memoryUsed += size;
+      return block;
+    }
+
+    m_blocks.push_back((BYTE *)malloc(m_blockSize));
+    m_blockUsed = 0;
+    m_memoryUsed += m_blockSize;
+  }
+
+  void * ptr = m_blocks.back() + m_blockUsed;
+  m_blockUsed += size;
+  return ptr;
+}
+
+
+void PXMLArena::Created(PXMLObject * obj)
+{
+  obj->m_arena = this;
+  m_objects.push_back(obj);
+}
+
+
+PXMLElement * PXMLArena::CreateElement(const PCaselessString & name)
+{
+  PXMLElement * element = new (Allocate(sizeof(PXMLElement))) PXMLElement(name);
+  Created(element);
+  element->UseArena(this);
+  return element;
+}
+
+
+PXMLRootElement * PXMLArena::CreateRootElement(PXML & doc, const PCaselessString & name)
+{
+  PXMLRootElement * element = new (Allocate(sizeof(PXMLRootElement))) PXMLRootElement(doc, name);
+  Created(element);
+  element->UseArena(this);
+  return element;
+}
+
+
+PXMLData * PXMLArena::CreateData(const PString & data)
+{
+  PXMLData * obj = new (Allocate(sizeof(PXMLData))) PXMLData(data);
+  Created(obj);
+  return obj;
+}
+
+
+void PXMLArena::Adopt(PXMLObject * obj)
+{
+  obj->m_arena = this;
+  m_adopted.push_back(obj);
+}
+
+
+bool PXMLArena::Release(PXMLObject * obj)
+{
+  std::vector<PXMLObject *>::iterator it = std::find(m_adopted.begin(), m_adopted.end(), obj);
+  if (it == m_adopted.end())
+    return false;
+
+  obj->m_arena = NULL;
+  m_adopted.erase(it);
+  return true;
+}
+
+
+void PXMLArena::Clear()
+{
+  // Elements in the arena do not delete their sub-objects, so order is not important
+  for (std::vector<PXMLObject *>::iterator it = m_objects.begin(); it != m_objects.end(); ++it)
+    (*it)->~PXMLObject();
+  m_objects.clear();
+
+  for (std::vector<PXMLObject *>::iterator it = m_adopted.begin(); it != m_adopted.end(); ++it)
+    delete *it;
+  m_adopted.clear();
+
+  for (std::vector<BYTE *>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    free(*it);
+  m_blocks.clear();
+
+  m_blockUsed = m_blockSize;
+  m_memoryUsed = 0;
+}
+
+
 #define new PNEW
 
 #define CACHE_BUFFER_SIZE   1024
@@ -209,6 +323,12 @@ void PXMLParserBase::EndNamespaceDeclHandler(const char *)
 }
 
 
+void PXMLParserBase::StopParser()
+{
+  XML_StopParser(MY_CONTEXT, XML_FALSE);
+}
+
+
 void PXMLParserBase::GetFilePosition(unsigned & col, unsigned & line) const
 {
   col = XML_GetCurrentColumnNumber(MY_CONTEXT);
@@ -252,6 +372,8 @@ PXMLParser::PXMLParser(PXML & doc, Options options, off_t progressTotal)
   : PXMLBase(options)
   , PXMLParserBase(options, doc.m_encoding.IsEmpty() ? (const char *)NULL : (const char *)doc.m_encoding)
   , m_document(doc)
+  , m_validation(doc.m_validator != NULL ? new PXMLValidator::State(*doc.m_validator) : NULL)
+  , m_validationFailed(false)
   , m_currentElement(NULL)
   , m_lastData(NULL)
 {
@@ -259,6 +381,33 @@ PXMLParser::PXMLParser(PXML & doc, Options options, off_t progressTotal)
 }
 
 
+PXMLParser::~PXMLParser()
+{
+  delete m_validation;
+}
+
+
+void PXMLParser::GetErrorInfo(PString & errorString, unsigned & errorCol, unsigned & errorLine) const
+{
+  if (!m_validationFailed) {
+    PXMLParserBase::GetErrorInfo(errorString, errorCol, errorLine);
+    return;
+  }
+
+  errorString = m_validation->GetErrorString();
+  errorCol = m_validation->GetErrorColumn();
+  errorLine = m_validation->GetErrorLine();
+}
+
+
+void PXMLParser::ValidationFailed()
+{
+  PTRACE(3, "PXML\tValidation failed while parsing: " << m_validation->GetErrorString());
+  m_validationFailed = true;
+  XML_StopParser(MY_CONTEXT, XML_FALSE);
+}
+
+
 void PXMLParser::XmlDecl(const char * version, const char * encoding, int standAlone)
 {
   m_document.m_version    = version;
@@ -290,16 +439,36 @@ void PXMLParser::StartNamespaceDeclHandler(const char * prefix, const char * uri
 }
 
 
+const PString & PXMLParser::InternName(const char * name)
+{
+  InternedNames::iterator it = m_internedNames.find(name);
+  if (it != m_internedNames.end())
+    return it->second;
+
+  // Prevent unbounded growth when parsing a long stream of unusual names
+  static const size_t MaxInternedNames = 1000;
+  if (m_internedNames.size() >= MaxInternedNames)
+    m_internedNames.clear();
+
+  // Key points into the value, which is never modified, so is stable
+  PString str(name);
+  return m_internedNames.insert(InternedNames::value_type(str, str)).first->second;
+}
+
+
 void PXMLParser::StartElement(const char * name, const char **attrs)
 {
+  if (m_validationFailed)
+    return;
+
   PXMLElement * newElement;
   if (m_currentElement == NULL) {
     PAssert(m_document.m_rootElement == NULL, PLogicError);
-    newElement = m_document.m_rootElement = m_document.CreateRootElement(name);
+    newElement = m_document.m_rootElement = m_document.CreateRootElement(InternName(name));
     PAssert(newElement != NULL, PLogicError);
   }
   else {
-    newElement = m_currentElement->CreateElement(name);
+    newElement = m_currentElement->CreateElement(InternName(name));
     if (newElement == NULL)
       return;
     m_currentElement->AddSubObject(newElement, false);
@@ -310,7 +479,7 @@ void PXMLParser::StartElement(const char * name, const char **attrs)
   newElement->SetFilePosition(col, line);
 
   while (attrs[0] != NULL) {
-    newElement->SetAttribute(attrs[0], attrs[1]);
+    newElement->SetAttribute(InternName(attrs[0]), attrs[1]);
     attrs += 2;
   }
 
@@ -321,16 +490,24 @@ void PXMLParser::StartElement(const char * name, const char **attrs)
     m_currentElement->AddNamespace(it->first, it->second);
 
   m_nameSpaces.RemoveAll();
+
+  if (m_validation != NULL && !m_validation->StartElement(*newElement))
+    ValidationFailed();
 }
 
 
 void PXMLParser::EndElement(const char * name)
 {
-  if (m_currentElement == NULL || m_currentElement->GetName() != name)
+  if (m_validationFailed || m_currentElement == NULL || m_currentElement->GetName() != name)
     return;
 
   m_currentElement->EndData();
 
+  if (m_validation != NULL && !m_validation->EndElement(*m_currentElement)) {
+    ValidationFailed();
+    return;
+  }
+
   if (m_currentElement != m_document.m_rootElement)
     m_currentElement = m_currentElement->GetParent();
   else {
@@ -402,6 +579,8 @@ PXML::PXML(Options options, const char * noIndentElementsParam, const char * def
   , m_encoding(defaultEncoding)
   , m_standAlone(UninitialisedStandAlone)
   , m_rootElement(NULL)
+  , m_arena(NULL)
+  , m_validator(NULL)
   , m_errorLine(0)
   , m_errorColumn(0)
   , m_noIndentElements(PString(noIndentElementsParam).Tokenise(' ', false))
@@ -419,6 +598,8 @@ PXML::PXML(const PXML & xml)
   , m_loadFilename(xml.m_loadFilename)
   , m_standAlone(UninitialisedStandAlone)
   , m_rootElement(NULL)
+  , m_arena(NULL)
+  , m_validator(xml.m_validator)
   , m_errorLine(0)
   , m_errorColumn(0)
   , m_noIndentElements(xml.m_noIndentElements)
@@ -435,6 +616,7 @@ PXML::PXML(const PXML & xml)
 PXML::~PXML()
 {
   RemoveAll();
+  delete m_arena;
 }
 
 
@@ -490,8 +672,10 @@ bool PXML::LoadFile(const PFilePath & fn)
 
   PXMLParser parser(*this, m_options, file.GetLength());
   parser.SetMaxEntityLength(m_maxEntityLength);
-  if (!parser.Parse(file))
+  if (!parser.Parse(file)) {
+    parser.GetErrorInfo(m_errorString, m_errorColumn, m_errorLine);
     return false;
+  }
 
   PTRACE(4, "XML\tRead XML <" << GetDocumentType() << '>');
 
@@ -613,19 +797,48 @@ PINDEX PXML::GetObjectCount() const
 
 void PXML::RemoveAll()
 {
-  delete m_rootElement;
+  if (m_rootElement != NULL && m_rootElement->GetArena() == NULL)
+    delete m_rootElement;
   m_rootElement = NULL;
+
+  if (m_arena != NULL)
+    m_arena->Clear();
+}
+
+
+void PXML::SetArenaMode(bool enable)
+{
+  if (enable == (m_arena != NULL))
+    return;
+
+  RemoveAll();
+
+  if (enable)
+    m_arena = new PXMLArena;
+  else {
+    delete m_arena;
+    m_arena = NULL;
+  }
 }
 
 
 PXMLElement * PXML::CreateElement(const PCaselessString & name, const char * data)
 {
-  return new PXMLElement(name, data);
+  if (m_arena == NULL)
+    return new PXMLElement(name, data);
+
+  PXMLElement * element = m_arena->CreateElement(name);
+  if (data != NULL)
+    element->AddData(data);
+  return element;
 }
 
 
 PXMLRootElement * PXML::CreateRootElement(const PCaselessString & name)
 {
+  if (m_arena != NULL)
+    return m_arena->CreateRootElement(*this, name);
+
   return new PXMLRootElement(*this, name);
 }
 
@@ -983,6 +1196,524 @@ bool PXML::LoadAndValidate(const PString & body, const PXML::ValidationInfo * va
 }
 
 
+bool PXML::Validate(const PXMLValidator & validator)
+{
+  m_errorString.MakeEmpty();
+
+  if (m_rootElement == NULL) {
+    m_errorString << "No root element";
+    return false;
+  }
+
+  PXMLValidator::State state(validator);
+
+  // Walk the tree in document order, without recursion
+  PXMLElement * element = m_rootElement;
+  PINDEX index = 0;
+  std::vector<PINDEX> indexes;
+  for (;;) {
+    if (index == 0 && !state.StartElement(*element))
+      break;
+
+    while (index < element->GetSize() && !element->GetSubObject(index)->IsElement())
+      ++index;
+
+    if (index < element->GetSize()) {
+      indexes.push_back(index+1);
+      element = static_cast<PXMLElement *>(element->GetSubObject(index));
+      index = 0;
+      continue;
+    }
+
+    if (!state.EndElement(*element))
+      break;
+
+    if (indexes.empty())
+      return true;
+
+    element = element->GetParent();
+    index = indexes.back();
+    indexes.pop_back();
+  }
+
+  m_errorString << state.GetErrorString();
+  m_errorColumn = state.GetErrorColumn();
+  m_errorLine = state.GetErrorLine();
+  return false;
+}
+
+
+bool PXML::LoadAndValidate(const PString & body, const PXMLValidator & validator, PString & error, Options options)
+{
+  const PXMLValidator * previous = m_validator;
+  m_validator = &validator;
+  bool ok = Load(body, options);
+  m_validator = previous;
+
+  if (ok)
+    return true;
+
+  PStringStream err;
+  err << "XML parse or validation error\n"
+         "Error at line " << GetErrorLine() << ", column " << GetErrorColumn() << '\n'
+      << GetErrorString() << '\n';
+  error = err;
+  return false;
+}
+
+
+///////////////////////////////////////////////////////
+
+struct PXMLValidator::Rule
+{
+  struct Attribute {
+    enum Check { e_Present, e_NonEmpty, e_Values, e_RegEx };
+
+    PCaselessString      m_name;
+    bool                 m_required;
+    Check                m_check;
+    PStringArray         m_values;
+    PRegularExpression * m_regex;
+    const char         * m_pattern;
+  };
+
+  struct SubElement {
+    PCaselessString      m_name;
+    PINDEX               m_minCount;
+    PINDEX               m_maxCount;
+    PRegularExpression * m_regex;
+    const char         * m_pattern;
+  };
+
+  // All the checks for sub-elements of the same name
+  struct Entry {
+    Entry() : m_subtree(NULL) { }
+
+    std::vector<size_t> m_subElements;
+    Rule * m_subtree;
+    std::vector<const PXML::ValidationInfo *> m_tables;
+  };
+  typedef std::map<PCaselessString, Entry> Index;
+
+  PCaselessString         m_name;
+  std::vector<Attribute>  m_attributes;
+  std::vector<SubElement> m_subElements;
+  Index                   m_index;
+};
+
+
+struct PXMLValidator::Context
+{
+  PString         m_defaultNameSpace;
+  PStringToString m_nameSpaces;
+  std::map<const PXML::ValidationInfo *, Rule *> m_compiled;
+
+  PCaselessString Resolve(const char * name) const
+  {
+    PCaselessString nameWithNs(name);
+    PINDEX pos = nameWithNs.FindLast(':');
+    if (pos == P_MAX_INDEX) {
+      if (!m_defaultNameSpace.IsEmpty())
+        nameWithNs = m_defaultNameSpace + "|" + nameWithNs;
+    }
+    else {
+      const PString * uri = m_nameSpaces.GetAt(nameWithNs.Left(pos));
+      if (uri != NULL)
+        nameWithNs = *uri + "|" + nameWithNs.Mid(pos+1);
+    }
+    return nameWithNs;
+  }
+};
+
+
+PXMLValidator::PXMLValidator(const PXML::ValidationInfo * validator)
+  : m_root(NULL)
+{
+  if (validator != NULL)
+    Compile(validator);
+}
+
+
+PXMLValidator::~PXMLValidator()
+{
+  RemoveAll();
+}
+
+
+void PXMLValidator::RemoveAll()
+{
+  for (std::vector<Rule *>::iterator it = m_rules.begin(); it != m_rules.end(); ++it)
+    delete *it;
+  m_rules.clear();
+
+  for (std::vector<PRegularExpression *>::iterator it = m_regexes.begin(); it != m_regexes.end(); ++it)
+    delete *it;
+  m_regexes.clear();
+
+  m_root = NULL;
+}
+
+
+bool PXMLValidator::Compile(const PXML::ValidationInfo * validator)
+{
+  RemoveAll();
+
+  if (PAssertNULL(validator) == NULL)
+    return false;
+
+  Context context;
+  m_root = GetRule(validator, context);
+  if (m_root != NULL) {
+    PTRACE(4, "PXML\tCompiled validator with " << m_rules.size() << " rules");
+    return true;
+  }
+
+  RemoveAll();
+  return false;
+}
+
+
+PXMLValidator::Rule * PXMLValidator::GetRule(const PXML::ValidationInfo * validator, Context & context)
+{
+  // A table used in several places, or recursively, is compiled once
+  std::map<const PXML::ValidationInfo *, Rule *>::iterator it = context.m_compiled.find(validator);
+  if (it != context.m_compiled.end())
+    return it->second;
+
+  Rule * rule = new Rule;
+  m_rules.push_back(rule);
+  context.m_compiled[validator] = rule;
+  return CompileRule(validator, *rule, context) ? rule : NULL;
+}
+
+
+PRegularExpression * PXMLValidator::CompileRegEx(const char * pattern, bool extended)
+{
+  PRegularExpression * regex = new PRegularExpression;
+  m_regexes.push_back(regex);
+  if (regex->Compile(pattern, extended ? PRegularExpression::Extended : PRegularExpression::Simple))
+    return regex;
+
+  PTRACE(2, "PXML\tInvalid regular expression \"" << pattern << "\" in validator: " << regex->GetErrorText());
+  return NULL;
+}
+
+
+bool PXMLValidator::CompileRule(const PXML::ValidationInfo * validator, Rule & rule, Context & context)
+{
+  for (; validator->m_op != PXML::EndOfValidationList; ++validator) {
+    switch (validator->m_op) {
+      case PXML::SetDefaultNamespace :
+        context.m_defaultNameSpace = validator->m_name;
+        break;
+
+      case PXML::SetNamespace :
+        context.m_nameSpaces.SetAt(validator->m_name, validator->m_namespace);
+        break;
+
+      case PXML::ElementName :
+        rule.m_name = context.Resolve(validator->m_name);
+        break;
+
+      case PXML::Subtree :
+      case PXML::RequiredElement :
+      case PXML::RequiredElementWithBodyMatching :
+      case PXML::RequiredElementWithBodyMatchingEx :
+      case PXML::OptionalElement :
+      case PXML::OptionalElementWithBodyMatching :
+      case PXML::OptionalElementWithBodyMatchingEx :
+      {
+        Rule::SubElement subElement;
+        subElement.m_name = context.Resolve(validator->m_name);
+        subElement.m_maxCount = validator->m_maxCount;
+        subElement.m_regex = NULL;
+        subElement.m_pattern = NULL;
+
+        switch (validator->m_op) {
+          case PXML::Subtree :
+            subElement.m_minCount = validator->m_minCount;
+            break;
+          case PXML::RequiredElement :
+          case PXML::RequiredElementWithBodyMatching :
+          case PXML::RequiredElementWithBodyMatchingEx :
+            subElement.m_minCount = 1;
+            break;
+          default :
+            subElement.m_minCount = 0;
+        }
+
+        switch (validator->m_op) {
+          case PXML::RequiredElementWithBodyMatching :
+          case PXML::OptionalElementWithBodyMatching :
+          case PXML::RequiredElementWithBodyMatchingEx :
+          case PXML::OptionalElementWithBodyMatchingEx :
+            subElement.m_pattern = validator->m_attributeValues;
+            subElement.m_regex = CompileRegEx(subElement.m_pattern, validator->m_op == PXML::RequiredElementWithBodyMatchingEx ||
+                                                                    validator->m_op == PXML::OptionalElementWithBodyMatchingEx);
+            if (subElement.m_regex == NULL)
+              return false;
+            break;
+          default :
+            break;
+        }
+
+        Rule::Entry & entry = rule.m_index[subElement.m_name];
+        entry.m_subElements.push_back(rule.m_subElements.size());
+        rule.m_subElements.push_back(subElement);
+
+        if (validator->m_op == PXML::Subtree) {
+          entry.m_tables.push_back(validator->m_subElement);
+          if (entry.m_tables.size() == 1)
+            entry.m_subtree = GetRule(validator->m_subElement, context);
+          else {
+            // More than one subtree for the same name, all must be satisfied
+            entry.m_subtree = new Rule;
+            m_rules.push_back(entry.m_subtree);
+            for (size_t i = 0; i < entry.m_tables.size(); ++i) {
+              if (!CompileRule(entry.m_tables[i], *entry.m_subtree, context))
+                return false;
+            }
+          }
+          if (entry.m_subtree == NULL)
+            return false;
+        }
+        break;
+      }
+
+      case PXML::RequiredAttribute :
+      case PXML::RequiredNonEmptyAttribute :
+      case PXML::RequiredAttributeWithValue :
+      case PXML::RequiredAttributeWithValueMatching :
+      case PXML::RequiredAttributeWithValueMatchingEx :
+      case PXML::OptionalAttribute :
+      case PXML::OptionalNonEmptyAttribute :
+      case PXML::OptionalAttributeWithValue :
+      case PXML::OptionalAttributeWithValueMatching :
+      case PXML::OptionalAttributeWithValueMatchingEx :
+      {
+        Rule::Attribute attribute;
+        attribute.m_name = validator->m_name;
+        attribute.m_regex = NULL;
+        attribute.m_pattern = NULL;
+
+        switch (validator->m_op) {
+          case PXML::RequiredAttribute :
+          case PXML::RequiredNonEmptyAttribute :
+          case PXML::RequiredAttributeWithValue :
+          case PXML::RequiredAttributeWithValueMatching :
+          case PXML::RequiredAttributeWithValueMatchingEx :
+            attribute.m_required = true;
+            break;
+          default :
+            attribute.m_required = false;
+        }
+
+        switch (validator->m_op) {
+          case PXML::RequiredNonEmptyAttribute :
+          case PXML::OptionalNonEmptyAttribute :
+            attribute.m_check = Rule::Attribute::e_NonEmpty;
+            break;
+
+          case PXML::RequiredAttributeWithValue :
+          case PXML::OptionalAttributeWithValue :
+            attribute.m_check = Rule::Attribute::e_Values;
+            attribute.m_values = PString(validator->m_attributeValues).Lines();
+            break;
+
+          case PXML::RequiredAttributeWithValueMatching :
+          case PXML::OptionalAttributeWithValueMatching :
+          case PXML::RequiredAttributeWithValueMatchingEx :
+          case PXML::OptionalAttributeWithValueMatchingEx :
+            attribute.m_check = Rule::Attribute::e_RegEx;
+            attribute.m_pattern = validator->m_attributeValues;
+            attribute.m_regex = CompileRegEx(attribute.m_pattern, validator->m_op == PXML::RequiredAttributeWithValueMatchingEx ||
+                                                                  validator->m_op == PXML::OptionalAttributeWithValueMatchingEx);
+            if (attribute.m_regex == NULL)
+              return false;
+            break;
+
+          default :
+            attribute.m_check = Rule::Attribute::e_Present;
+        }
+
+        rule.m_attributes.push_back(attribute);
+        break;
+      }
+
+      default :
+        break;
+    }
+  }
+
+  return true;
+}
+
+
+PXMLValidator::State::State(const PXMLValidator & validator)
+  : m_validator(validator)
+  , m_errorColumn(0)
+  , m_errorLine(0)
+{
+}
+
+
+bool PXMLValidator::State::SetError(const PXMLElement & element)
+{
+  element.GetFilePosition(m_errorColumn, m_errorLine);
+  return false;
+}
+
+
+bool PXMLValidator::State::StartElement(const PXMLElement & element)
+{
+  Level level;
+  level.m_rule = NULL;
+  level.m_entry = NULL;
+  level.m_counts = m_counts.size();
+  level.m_lastEntry = NULL;
+
+  if (m_stack.empty())
+    level.m_rule = m_validator.m_root;
+  else {
+    Level & parentLevel = m_stack.back();
+    const Rule * parent = parentLevel.m_rule;
+    if (parent != NULL) {
+      /* Elements parsed by PXML share the buffer of an interned name, so
+         comparing pointers is sufficient, and holding a reference means the
+         buffer cannot be freed and reused for some other name. */
+      const PCaselessString & name = element.GetName();
+      if ((const char *)name != (const char *)parentLevel.m_lastName) {
+        Rule::Index::const_iterator it = parent->m_index.find(name);
+        parentLevel.m_lastName = name;
+        parentLevel.m_lastEntry = it != parent->m_index.end() ? &it->second : NULL;
+      }
+
+      const Rule::Entry * entry = static_cast<const Rule::Entry *>(parentLevel.m_lastEntry);
+      if (entry != NULL) {
+        for (size_t i = 0; i < entry->m_subElements.size(); ++i) {
+          size_t idx = entry->m_subElements[i];
+          const Rule::SubElement & subElement = parent->m_subElements[idx];
+          if (++m_counts[parentLevel.m_counts+idx] > subElement.m_maxCount && subElement.m_maxCount > 0) {
+            m_errorString << "Must have no more than " << subElement.m_maxCount << " instances of '" << subElement.m_name << "'";
+            return SetError(element);
+          }
+        }
+        level.m_rule = entry->m_subtree;
+        level.m_entry = entry;
+      }
+    }
+  }
+
+  const Rule * rule = level.m_rule;
+  if (rule != NULL) {
+    if (!rule->m_name.IsEmpty() && rule->m_name != element.GetName()) {
+      m_errorString << "Expected element with name \"" << rule->m_name << '"';
+      return SetError(element);
+    }
+
+    const PStringToString & attributes = element.GetAttributes();
+    for (std::vector<Rule::Attribute>::const_iterator it = rule->m_attributes.begin(); it != rule->m_attributes.end(); ++it) {
+      const PString * value = attributes.GetAt(it->m_name);
+      if (value == NULL) {
+        if (!it->m_required)
+          continue;
+        m_errorString << "Element \"" << element.GetName() << "\" missing required attribute \"" << it->m_name << '"';
+        return SetError(element);
+      }
+
+      switch (it->m_check) {
+        case Rule::Attribute::e_NonEmpty :
+          if (value->IsEmpty()) {
+            m_errorString << "Element \"" << element.GetName() << "\" has attribute \"" << it->m_name << "\" which cannot be empty";
+            return SetError(element);
+          }
+          break;
+
+        case Rule::Attribute::e_Values :
+        {
+          PINDEX i;
+          for (i = 0; i < it->m_values.GetSize(); ++i) {
+            if (*value *= it->m_values[i])
+              break;
+          }
+          if (i == it->m_values.GetSize()) {
+            m_errorString << "Element \"" << element.GetName() << "\" has attribute \"" << it->m_name << "\" which is not one of required values ";
+            for (i = 0; i < it->m_values.GetSize(); ++i) {
+              if (i != 0)
+                m_errorString << " | ";
+              m_errorString << "'" << it->m_values[i] << "'";
+            }
+            return SetError(element);
+          }
+          break;
+        }
+
+        case Rule::Attribute::e_RegEx :
+          if (!value->MatchesRegEx(*it->m_regex)) {
+            m_errorString << "Element \"" << element.GetName() << "\" has attribute \"" << it->m_name << "\" with value \""
+                          << *value << "\" that does not match regex \"" << it->m_pattern << '"';
+            return SetError(element);
+          }
+          break;
+
+        default :
+          break;
+      }
+    }
+
+    m_counts.resize(level.m_counts + rule->m_subElements.size(), 0);
+  }
+
+  m_stack.push_back(level);
+  return true;
+}
+
+
+bool PXMLValidator::State::EndElement(const PXMLElement & element)
+{
+  if (!PAssert(!m_stack.empty(), PLogicError))
+    return false;
+
+  Level level = m_stack.back();
+  m_stack.pop_back();
+
+  const Rule * rule = level.m_rule;
+  if (rule != NULL) {
+    for (size_t i = 0; i < rule->m_subElements.size(); ++i) {
+      const Rule::SubElement & subElement = rule->m_subElements[i];
+      if (m_counts[level.m_counts+i] < subElement.m_minCount) {
+        if (subElement.m_minCount == 1)
+          m_errorString << "Element \"" << element.GetName() << "\" missing required subelement \"" << subElement.m_name << '"';
+        else
+          m_errorString << "Must have at least " << subElement.m_minCount << " instances of '" << subElement.m_name << "'";
+        return SetError(element);
+      }
+    }
+    m_counts.resize(level.m_counts);
+  }
+
+  // Body checks are part of the parent rule
+  const Rule::Entry * entry = static_cast<const Rule::Entry *>(level.m_entry);
+  if (entry != NULL) {
+    const Rule * parent = m_stack.back().m_rule;
+    for (size_t i = 0; i < entry->m_subElements.size(); ++i) {
+      const Rule::SubElement & subElement = parent->m_subElements[entry->m_subElements[i]];
+      if (subElement.m_regex == NULL)
+        continue;
+
+      PString body = element.GetData();
+      if (!body.MatchesRegEx(*subElement.m_regex)) {
+        m_errorString << "Element \"" << element.GetName() << "\" has body with value \"" << body
+                      << "\" that does not match regex \"" << subElement.m_pattern << '"';
+        return SetError(element);
+      }
+    }
+  }
+
+  return true;
+}
+
+
 ///////////////////////////////////////////////////////
 
 #if P_HTTP
@@ -1116,6 +1847,7 @@ PXMLObject::PXMLObject()
   , m_dirty(false)
   , m_lineNumber(1)
   , m_column(1)
+  , m_arena(NULL)
 {
 }
 
@@ -1248,7 +1980,19 @@ void PXMLData::InternalPrintTrace(ostream & strm) const
 ///////////////////////////////////////////////////////
 
 PXMLElement::PXMLElement(const char * name, const char * data)
- : m_name(name)
+  : m_name(name)
+  , m_childArena(NULL)
+  , m_nameIndex(NULL)
+{
+  if (data != NULL)
+    AddData(data);
+}
+
+
+PXMLElement::PXMLElement(const PString & name, const char * data)
+  : m_name(name)
+  , m_childArena(NULL)
+  , m_nameIndex(NULL)
 {
   if (data != NULL)
     AddData(data);
@@ -1258,6 +2002,8 @@ PXMLElement::PXMLElement(const char * name, const char * data)
 PXMLElement::PXMLElement(const PXMLElement & copy)
   : m_name(copy.m_name)
   , m_attributes(copy.m_attributes)
+  , m_childArena(NULL)
+  , m_nameIndex(NULL)
 {
   m_attributes.MakeUnique();
   m_dirty = copy.m_dirty;
@@ -1267,6 +2013,20 @@ PXMLElement::PXMLElement(const PXMLElement & copy)
 }
 
 
+PXMLElement::~PXMLElement()
+{
+  delete m_nameIndex;
+}
+
+
+void PXMLElement::SetName(const PString & v)
+{
+  m_name = v;
+  if (m_parent != NULL)
+    m_parent->InvalidateNameIndex();
+}
+
+
 PINDEX PXMLElement::FindObject(const PXMLObject * ptr) const
 {
   return m_subObjects.GetObjectsIndex(ptr);
@@ -1352,12 +2112,35 @@ PXMLObject * PXMLElement::GetSubObject(PINDEX idx) const
 }
 
 
+const PXMLElement::NameIndex & PXMLElement::GetNameIndex() const
+{
+  if (m_nameIndex == NULL) {
+    m_nameIndex = new NameIndex;
+    for (PINDEX i = 0; i < m_subObjects.GetSize(); i++) {
+      PXMLObject & obj = m_subObjects[i];
+      if (obj.IsElement()) {
+        PXMLElement & element = static_cast<PXMLElement &>(obj);
+        (*m_nameIndex)[element.GetName()].push_back(&element);
+      }
+    }
+  }
+  return *m_nameIndex;
+}
+
+
+void PXMLElement::InvalidateNameIndex()
+{
+  delete m_nameIndex;
+  m_nameIndex = NULL;
+}
+
+
 PXMLElement * PXMLElement::GetElement(PINDEX index) const
 {
   for (PINDEX i = 0; i < m_subObjects.GetSize(); i++) {
-    PXMLElement * element = dynamic_cast<PXMLElement *>(m_subObjects.GetAt(i));
-    if (element != NULL && index-- == 0)
-      return element;
+    PXMLObject & obj = m_subObjects[i];
+    if (obj.IsElement() && index-- == 0)
+      return static_cast<PXMLElement *>(&obj);
   }
   return NULL;
 }
@@ -1366,10 +2149,17 @@ PXMLElement * PXMLElement::GetElement(PINDEX index) const
 PXMLElement * PXMLElement::GetElement(const PCaselessString & name, PINDEX index) const
 {
   PCaselessString extendedName(PrependNamespace(name));
+
+  if (m_subObjects.GetSize() >= NameIndexThreshold) {
+    const NameIndex & nameIndex = GetNameIndex();
+    NameIndex::const_iterator it = nameIndex.find(extendedName);
+    return it != nameIndex.end() && index < it->second.size() ? it->second[index] : NULL;
+  }
+
   for (PINDEX i = 0; i < m_subObjects.GetSize(); i++) {
-    PXMLElement * element = dynamic_cast<PXMLElement *>(m_subObjects.GetAt(i));
-    if (element != NULL && extendedName == element->GetName() && index-- == 0)
-      return element;
+    PXMLObject & obj = m_subObjects[i];
+    if (obj.IsElement() && extendedName == static_cast<PXMLElement &>(obj).GetName() && index-- == 0)
+      return static_cast<PXMLElement *>(&obj);
   }
   return NULL;
 }
@@ -1378,10 +2168,26 @@ PXMLElement * PXMLElement::GetElement(const PCaselessString & name, PINDEX index
 PXMLElement * PXMLElement::GetElement(const PCaselessString & name, const PCaselessString & attr, const PString & attrval) const
 {
   PCaselessString extendedName(PrependNamespace(name));
+
+  if (m_subObjects.GetSize() >= NameIndexThreshold) {
+    const NameIndex & nameIndex = GetNameIndex();
+    NameIndex::const_iterator it = nameIndex.find(extendedName);
+    if (it != nameIndex.end()) {
+      for (std::vector<PXMLElement *>::const_iterator el = it->second.begin(); el != it->second.end(); ++el) {
+        if (attrval == (*el)->GetAttribute(attr))
+          return *el;
+      }
+    }
+    return NULL;
+  }
+
   for (PINDEX i = 0; i < m_subObjects.GetSize(); i++) {
-    PXMLElement * element = dynamic_cast<PXMLElement *>(m_subObjects.GetAt(i));
-    if (element != NULL && extendedName == element->GetName() && attrval == element->GetAttribute(attr))
-      return element;
+    PXMLObject & obj = m_subObjects[i];
+    if (obj.IsElement()) {
+      PXMLElement * element = static_cast<PXMLElement *>(&obj);
+      if (extendedName == element->GetName() && attrval == element->GetAttribute(attr))
+        return element;
+    }
   }
   return NULL;
 }
@@ -1392,7 +2198,16 @@ bool PXMLElement::RemoveSubObject(PINDEX idx, bool dispose)
   if (idx >= m_subObjects.GetSize())
     return false;
 
-  if (dispose)
+  if (m_subObjects[idx].IsElement())
+    InvalidateNameIndex();
+
+  if (m_childArena != NULL) {
+    // Arena owns it, so can only be kept if it was adopted from the heap
+    if (!dispose && !PAssert(m_childArena->Release(&m_subObjects[idx]), "Cannot remove XML object from arena"))
+      return false;
+    m_subObjects.RemoveAt(idx);
+  }
+  else if (dispose)
     m_subObjects.RemoveAt(idx);
   else {
     m_subObjects.DisallowDeleteObjects();
@@ -1493,13 +2308,39 @@ void PXMLElement::InternalPrintTrace(ostream & strm) const
 #endif
 
 
+void PXMLElement::UseArena(PXMLArena * arena)
+{
+  m_childArena = arena;
+  m_subObjects.DisallowDeleteObjects();
+
+  for (PINDEX i = 0; i < m_subObjects.GetSize(); i++) {
+    if (m_subObjects[i].GetArena() == NULL)
+      arena->Adopt(&m_subObjects[i]);
+  }
+}
+
+
 PXMLObject * PXMLElement::AddSubObject(PXMLObject * obj, bool setDirty)
 {
   if (PAssertNULL(obj) == NULL)
     return NULL;
 
-  if (obj->SetParent(this))
+  // Cannot delete arena objects, so they may only be children of elements in the same arena
+  if (obj->GetArena() != NULL && obj->GetArena() != m_childArena) {
+    PAssertAlways(m_childArena != NULL ? "XML object in another arena" : "XML object in an arena added to element not in one");
+    return NULL;
+  }
+
+  if (obj->SetParent(this)) {
+    if (obj->GetArena() == NULL && m_childArena != NULL)
+      m_childArena->Adopt(obj);
+
     m_subObjects.SetAt(m_subObjects.GetSize(), obj);
+    if (m_nameIndex != NULL && obj->IsElement()) {
+      PXMLElement * element = static_cast<PXMLElement *>(obj);
+      (*m_nameIndex)[element->GetName()].push_back(element);
+    }
+  }
 
   if (setDirty)
     SetDirty();
@@ -1572,7 +2413,7 @@ void PXMLElement::SetData(const PString & data)
 
 PXMLData * PXMLElement::AddData(const PString & data)
 {
-  return static_cast<PXMLData *>(AddSubObject(new PXMLData(data)));
+  return static_cast<PXMLData *>(AddSubObject(m_childArena != NULL ? m_childArena->CreateData(data) : new PXMLData(data)));
 }
 
 
@@ -1734,6 +2575,275 @@ PXMLElement * PXMLStreamParser::Read(PChannel * channel)
   return 0;
 }
 
+
+///////////////////////////////////////////////////////
+
+PXMLPullParser::PXMLPullParser(Options options, const char * encoding)
+  : PXMLBase(options)
+  , PXMLParserBase(options, encoding != NULL && *encoding != '\0' ? encoding : NULL)
+  , m_subtree(NULL)
+  , m_subtreeCurrent(NULL)
+  , m_subtreeDepth(0)
+  , m_suspended(false)
+  , m_endOfDocument(false)
+  , m_error(false)
+{
+}
+
+
+PXMLPullParser::~PXMLPullParser()
+{
+  delete m_subtree;
+  for (std::list<Event>::iterator it = m_events.begin(); it != m_events.end(); ++it)
+    delete it->m_element;
+}
+
+
+void PXMLPullParser::AddSubtreeFilter(const PString & path)
+{
+  Filter filter;
+  filter.m_absolute = path.GetLength() > 0 && path[0] == '/';
+
+  PStringArray names = path.Tokenise('/');
+  for (PINDEX i = 0; i < names.GetSize(); ++i) {
+    if (!names[i].IsEmpty())
+      filter.m_names.push_back(names[i]);
+  }
+
+  if (!filter.m_names.empty())
+    m_filters.push_back(filter);
+}
+
+
+bool PXMLPullParser::Feed(const char * data, size_t length, bool final)
+{
+  if (m_error)
+    return false;
+
+  if (Parse(data, length, final))
+    return true;
+
+  m_error = true;
+  return false;
+}
+
+
+bool PXMLPullParser::Next(Event & event)
+{
+  while (m_events.empty()) {
+    if (!m_suspended || m_error)
+      return false;
+
+    m_suspended = false;
+    if (XML_ResumeParser(MY_CONTEXT) == XML_STATUS_ERROR) {
+      m_error = true;
+      return false;
+    }
+  }
+
+  event = m_events.front();
+  m_events.pop_front();
+  return true;
+}
+
+
+bool PXMLPullParser::Next(istream & strm, Event & event)
+{
+  if (m_readBuffer.empty())
+    m_readBuffer.resize(4096);
+
+  while (!Next(event)) {
+    if (m_endOfDocument || m_error || strm.eof())
+      return false;
+
+    strm.read(&m_readBuffer[0], m_readBuffer.size());
+    if (!Feed(&m_readBuffer[0], (size_t)strm.gcount(), strm.eof()))
+      return false;
+  }
+
+  return true;
+}
+
+
+bool PXMLPullParser::Next(PChannel & channel, Event & event)
+{
+  if (m_readBuffer.empty())
+    m_readBuffer.resize(4096);
+
+  while (!Next(event)) {
+    if (m_endOfDocument || m_error)
+      return false;
+
+    if (channel.Read(&m_readBuffer[0], m_readBuffer.size())) {
+      if (!Feed(&m_readBuffer[0], channel.GetLastReadCount()))
+        return false;
+    }
+    else {
+      if (channel.GetErrorCode(PChannel::LastReadError) == PChannel::Timeout)
+        return false;
+      Feed(NULL, 0, true);
+      return Next(event);
+    }
+  }
+
+  return true;
+}
+
+
+PString PXMLPullParser::GetPath() const
+{
+  PStringStream path;
+  for (std::vector<PString>::const_iterator it = m_path.begin(); it != m_path.end(); ++it)
+    path << '/' << *it;
+  return path;
+}
+
+
+bool PXMLPullParser::MatchFilter() const
+{
+  for (std::vector<Filter>::const_iterator filter = m_filters.begin(); filter != m_filters.end(); ++filter) {
+    size_t count = filter->m_names.size();
+    if (count > m_path.size() || (filter->m_absolute && count != m_path.size()))
+      continue;
+
+    size_t offset = m_path.size() - count;
+    size_t i = 0;
+    while (i < count && (filter->m_names[i] == "*" || (filter->m_names[i] *= m_path[offset+i])))
+      ++i;
+    if (i == count)
+      return true;
+  }
+
+  return false;
+}
+
+
+void PXMLPullParser::QueueEvent(const Event & event)
+{
+  m_events.push_back(event);
+
+  // Suspend until the application catches up, to limit memory use
+  if (m_events.size() >= MaxQueuedEvents && !m_suspended) {
+    m_suspended = true;
+    XML_StopParser(MY_CONTEXT, XML_TRUE);
+  }
+}
+
+
+void PXMLPullParser::FlushText()
+{
+  if (m_text.IsEmpty())
+    return;
+
+  PString text = m_text;
+  m_text.MakeEmpty();
+
+  if (!(m_options & NoIgnoreWhiteSpace)) {
+    PINDEX pos = 0;
+    while (pos < text.GetLength() && isspace(text[pos] & 0xff))
+      ++pos;
+    if (pos >= text.GetLength())
+      return;
+    if (pos > 0)
+      text.Delete(0, pos);
+  }
+
+  if (m_subtree != NULL) {
+    m_subtreeCurrent->AddData(text);
+    return;
+  }
+
+  Event event;
+  event.m_type = TextEvent;
+  event.m_text = text;
+  event.m_depth = m_path.size();
+  GetFilePosition(event.m_column, event.m_line);
+  QueueEvent(event);
+}
+
+
+void PXMLPullParser::StartElement(const char * name, const char **attrs)
+{
+  FlushText();
+
+  m_path.push_back(name);
+
+  if (m_subtree == NULL && !MatchFilter()) {
+    Event event;
+    event.m_type = StartElementEvent;
+    event.m_name = name;
+    for (; attrs[0] != NULL; attrs += 2)
+      event.m_attributes.SetAt(attrs[0], attrs[1]);
+    event.m_depth = m_path.size();
+    GetFilePosition(event.m_column, event.m_line);
+    QueueEvent(event);
+    return;
+  }
+
+  PXMLElement * element = new PXMLElement(name);
+  for (; attrs[0] != NULL; attrs += 2)
+    element->SetAttribute(attrs[0], attrs[1], false);
+
+  unsigned col, line;
+  GetFilePosition(col, line);
+  element->SetFilePosition(col, line);
+
+  if (m_subtree == NULL)
+    m_subtree = element;
+  else
+    m_subtreeCurrent->AddSubObject(element, false);
+  m_subtreeCurrent = element;
+  ++m_subtreeDepth;
+}
+
+
+void PXMLPullParser::EndElement(const char * /*name*/)
+{
+  FlushText();
+
+  if (m_subtree == NULL) {
+    Event event;
+    event.m_type = EndElementEvent;
+    event.m_name = m_path.back();
+    event.m_depth = m_path.size();
+    GetFilePosition(event.m_column, event.m_line);
+    QueueEvent(event);
+  }
+  else if (--m_subtreeDepth > 0)
+    m_subtreeCurrent = m_subtreeCurrent->GetParent();
+  else {
+    Event event;
+    event.m_type = SubtreeEvent;
+    event.m_name = m_subtree->GetName();
+    event.m_depth = m_path.size();
+    event.m_element = m_subtree;
+    m_subtree->GetFilePosition(event.m_column, event.m_line);
+    m_subtree = m_subtreeCurrent = NULL;
+    QueueEvent(event);
+  }
+
+  m_path.pop_back();
+  if (m_path.empty())
+    m_endOfDocument = true;
+}
+
+
+void PXMLPullParser::AddCharacterData(const char * data, int len)
+{
+  if (m_path.empty())
+    return;
+
+  if (m_text.GetLength() + len >= m_maxEntityLength) {
+    PTRACE(2, "PXML\tAborting XML parse at size " << m_maxEntityLength << " - possible 'billion laugh' attack");
+    m_error = true;
+    XML_StopParser(MY_CONTEXT, XML_FALSE);
+    return;
+  }
+
+  m_text += PString(data, len);
+}
+
+
 ///////////////////////////////////////////////////////
 #endif
 
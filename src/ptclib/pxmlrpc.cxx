@@ -909,17 +909,29 @@ PBoolean PXMLRPC::MakeRequest(PXMLRPCBlock & request, PXMLRPCBlock & response)
 
 PBoolean PXMLRPC::MakeRequest(const PString & method, const PXMLRPCStructBase & args, PXMLRPCStructBase & reply)
 {
-  PXMLRPCBlock request(method, args);
-  PXMLRPCBlock response;
+  // Structures are written and read directly, without a PXMLRPCBlock
+  PXMLRPCWriter writer;
+  writer.MethodCall(method, args);
 
-  if (!MakeRequest(request, response))
+  PString replyXML;
+  if (!PostXML(writer.GetString(), replyXML))
     return false;
 
-  if (response.GetParams(reply))
-    return true;
+  PXMLRPCDecoder decoder(reply, m_options);
+  if (!decoder.Decode(replyXML)) {
+    m_faultCode = decoder.GetFaultCode();
+    m_faultText = decoder.GetFaultText();
+    return false;
+  }
 
-  PTRACE(1, "XMLRPC\tParsing response failed: " << response.GetFaultText());
-  return false;
+  if (decoder.IsMethodCall()) {
+    m_faultCode = PXMLRPC::ResponseRootNotMethodResponse;
+    m_faultText = "Response root not methodResponse";
+    PTRACE(2, "XMLRPC\t" << m_faultText);
+    return false;
+  }
+
+  return true;
 }
 
 
@@ -941,34 +953,9 @@ PBoolean PXMLRPC::PerformRequest(PXMLRPCBlock & request, PXMLRPCBlock & response
   // make sure the request ends with a newline
   requestXML += "\n";
 
-  // do the request
-  PHTTPClient client;
-  PMIMEInfo sendMIME, replyMIME;
-  sendMIME.SetAt("Server", m_url.GetHostName());
-  sendMIME.SetAt(PHTTP::ContentTypeTag(), "text/xml");
-
-  PTRACE(5, "XMLRPC\tOutgoing XML/RPC:\n" << m_url << '\n' << sendMIME << requestXML);
-
-  // apply the timeout
-  client.SetReadTimeout(m_timeout);
-
   PString replyXML;
-
-  // do the request
-  PBoolean ok = client.PostData(m_url, sendMIME, requestXML, replyMIME, replyXML);
-
-  PTRACE(5, "XMLRPC\tIncoming XML/RPC:\n" << replyMIME << replyXML);
-
-  // make sure the request worked
-  if (!ok) {
-    PStringStream txt;
-    txt << "HTTP POST failed: "
-        << client.GetLastResponseCode() << ' '
-        << client.GetLastResponseInfo() << '\n'
-        << replyMIME << '\n'
-        << replyXML;
-    response.SetFault(PXMLRPC::HTTPPostFailed, txt);
-    PTRACE(2, "XMLRPC\t" << response.GetFaultText());
+  if (!PostXML(requestXML, replyXML)) {
+    response.SetFault(m_faultCode, m_faultText);
     return false;
   }
 
@@ -1001,6 +988,40 @@ PBoolean PXMLRPC::PerformRequest(PXMLRPCBlock & request, PXMLRPCBlock & response
   return true;
 }
 
+PBoolean PXMLRPC::PostXML(const PString & requestXML, PString & replyXML)
+{
+  // do the request
+  PHTTPClient client;
+  PMIMEInfo sendMIME, replyMIME;
+  sendMIME.SetAt("Server", m_url.GetHostName());
+  sendMIME.SetAt(PHTTP::ContentTypeTag(), "text/xml");
+
+  PTRACE(5, "XMLRPC\tOutgoing XML/RPC:\n" << m_url << '\n' << sendMIME << requestXML);
+
+  // apply the timeout
+  client.SetReadTimeout(m_timeout);
+
+  // do the request
+  PBoolean ok = client.PostData(m_url, sendMIME, requestXML, replyMIME, replyXML);
+
+  PTRACE(5, "XMLRPC\tIncoming XML/RPC:\n" << replyMIME << replyXML);
+
+  // make sure the request worked
+  if (ok)
+    return true;
+
+  PStringStream txt;
+  txt << "HTTP POST failed: "
+      << client.GetLastResponseCode() << ' '
+      << client.GetLastResponseInfo() << '\n'
+      << replyMIME << '\n'
+      << replyXML;
+  m_faultCode = PXMLRPC::HTTPPostFailed;
+  m_faultText = txt;
+  PTRACE(2, "XMLRPC\t" << m_faultText);
+  return false;
+}
+
 PBoolean PXMLRPC::ISO8601ToPTime(const PString & iso8601, PTime & val, int tz)
 {
   if ((iso8601.GetLength() != 17) ||
@@ -1028,6 +1049,578 @@ PString PXMLRPC::PTimeToISO8601(const PTime & time)
 }
 
 
+/////////////////////////////////////////////////////////////////
+
+PXMLRPCWriter::PXMLRPCWriter(PINDEX initialSize)
+  : m_buffer(initialSize)
+  , m_length(0)
+{
+}
+
+
+char * PXMLRPCWriter::Reserve(PINDEX len)
+{
+  PINDEX needed = m_length + len + 1;
+  if (needed > m_buffer.GetSize())
+    m_buffer.SetSize(std::max(needed, m_buffer.GetSize()*2));
+
+  char * ptr = m_buffer.GetPointer() + m_length;
+  m_length += len;
+  return ptr;
+}
+
+
+void PXMLRPCWriter::Append(const char * str, PINDEX len)
+{
+  memcpy(Reserve(len), str, len);
+}
+
+
+void PXMLRPCWriter::AppendEscaped(const char * str, PINDEX len)
+{
+  // Same as PXML::EscapeSpecialChars(), but straight into the buffer
+  PINDEX start = 0;
+  for (PINDEX i = 0; i < len; ++i) {
+    const char * entity;
+    char numeric[8];
+    char c = str[i];
+    switch (c) {
+      case '"' :
+        entity = "&quot;";
+        break;
+      case '\'' :
+        entity = "&apos;";
+        break;
+      case '&' :
+        entity = "&amp;";
+        break;
+      case '<' :
+        entity = "&lt;";
+        break;
+      case '>' :
+        entity = "&gt;";
+        break;
+      case '\t' :
+      case '\r' :
+      case '\n' :
+        continue;
+      default :
+        if (c < '\0' || c >= ' ')
+          continue;
+        sprintf(numeric, "&#%u;", (unsigned)c);
+        entity = numeric;
+    }
+
+    Append(str+start, i-start);
+    Append(entity);
+    start = i+1;
+  }
+
+  Append(str+start, len-start);
+}
+
+
+void PXMLRPCWriter::MethodCall(const PString & method, const PXMLRPCStructBase & args)
+{
+  Append("<?xml version=\"1.0\"?>\n<methodCall><methodName>");
+  AppendEscaped(method);
+  Append("</methodName>");
+  Params(args);
+  Append("</methodCall>\n");
+}
+
+
+void PXMLRPCWriter::MethodResponse(const PXMLRPCStructBase & reply)
+{
+  Append("<?xml version=\"1.0\"?>\n<methodResponse>");
+  Params(reply);
+  Append("</methodResponse>\n");
+}
+
+
+void PXMLRPCWriter::Fault(PINDEX code, const PString & text)
+{
+  Append("<?xml version=\"1.0\"?>\n<methodResponse><fault><value><struct>"
+         "<member><name>faultCode</name>");
+  Scalar(IntType, PString(PString::Signed, (int)code));
+  Append("</member><member><name>faultString</name>");
+  Scalar(StringType, text);
+  Append("</member></struct></value></fault></methodResponse>\n");
+}
+
+
+void PXMLRPCWriter::Params(const PXMLRPCStructBase & data)
+{
+  Append("<params>");
+  for (PINDEX i = 0; i < data.GetNumVariables(); i++) {
+    Append("<param>");
+    Variable(data.GetVariable(i));
+    Append("</param>");
+  }
+  Append("</params>");
+}
+
+
+void PXMLRPCWriter::Variable(const PXMLRPCVariableBase & variable)
+{
+  if (variable.IsArray())
+    Array(variable);
+  else {
+    PXMLRPCStructBase * nested = variable.GetStruct(0);
+    if (nested != NULL)
+      Struct(*nested);
+    else
+      Scalar(variable.GetType(), variable.ToString(0));
+  }
+}
+
+
+void PXMLRPCWriter::Struct(const PXMLRPCStructBase & data)
+{
+  Append("<value><struct>");
+  for (PINDEX i = 0; i < data.GetNumVariables(); i++) {
+    PXMLRPCVariableBase & variable = data.GetVariable(i);
+    Append("<member><name>");
+    AppendEscaped(variable.GetName(), strlen(variable.GetName()));
+    Append("</name>");
+    Variable(variable);
+    Append("</member>");
+  }
+  Append("</struct></value>");
+}
+
+
+void PXMLRPCWriter::Array(const PXMLRPCVariableBase & array)
+{
+  Append("<value><array><data>");
+  for (PINDEX i = 0; i < array.GetSize(); i++) {
+    PXMLRPCStructBase * structure = array.GetStruct(i);
+    if (structure != NULL)
+      Struct(*structure);
+    else
+      Scalar(array.GetType(), array.ToString(i));
+  }
+  Append("</data></array></value>");
+}
+
+
+void PXMLRPCWriter::Scalar(const char * type, const PString & value)
+{
+  PINDEX typeLen = strlen(type);
+  Append("<value><");
+  Append(type, typeLen);
+  Append(">");
+  AppendEscaped(value);
+  Append("</");
+  Append(type, typeLen);
+  Append("></value>");
+}
+
+
+/////////////////////////////////////////////////////////////////
+
+PXMLRPC_STRUCT_BEGIN(PXMLRPCFaultInfo)
+    PXMLRPC_INTEGER(PXMLRPCFaultInfo, int, faultCode);
+    PXMLRPC_STRING (PXMLRPCFaultInfo, PString, faultString);
+PXMLRPC_STRUCT_END()
+
+
+PXMLRPCDecoder::PXMLRPCDecoder(PXMLRPCStructBase & data, Options options)
+  : PXMLBase(options)
+  , PXMLParserBase(options, NULL)
+  , m_data(data)
+  , m_holdDepth(0)
+  , m_decodingFirst(false)
+  , m_singleStruct(false)
+  , m_isMethodCall(false)
+  , m_wholeStruct(false)
+  , m_paramCount(0)
+  , m_faultInfo(NULL)
+  , m_faultCode(P_MAX_INDEX)
+{
+}
+
+
+PXMLRPCDecoder::~PXMLRPCDecoder()
+{
+  delete m_faultInfo;
+}
+
+
+bool PXMLRPCDecoder::Decode(const PString & xml)
+{
+  if (!Parse(xml, xml.GetLength(), true)) {
+    if (m_faultCode == P_MAX_INDEX) {
+      PString error;
+      unsigned col, line;
+      GetErrorInfo(error, col, line);
+      PStringStream txt;
+      txt << "Error parsing " << (m_isMethodCall ? "request" : "response") << " XML (" << line << ") :" << error;
+      m_faultCode = m_isMethodCall ? PXMLRPC::CannotParseRequestXML : PXMLRPC::CannotParseResponseXML;
+      m_faultText = txt;
+    }
+    PTRACE(2, "XMLRPC\t" << m_faultText);
+    return false;
+  }
+
+  if (m_faultCode != P_MAX_INDEX)
+    return false;
+
+  if (!m_wholeStruct && m_paramCount < m_data.GetNumVariables()) {
+    PStringStream txt;
+    txt << "Expected " << m_data.GetNumVariables() << " parameters, got " << m_paramCount;
+    Fail(m_isMethodCall ? PXMLRPC::RequestHasNoParms : PXMLRPC::ResponseEmpty, txt);
+    return false;
+  }
+
+  return true;
+}
+
+
+void PXMLRPCDecoder::Fail(PINDEX code, const PString & text)
+{
+  if (m_faultCode == P_MAX_INDEX) {
+    m_faultCode = code;
+    m_faultText = text;
+    PTRACE(2, "XMLRPC\t" << text);
+  }
+  StopParser();
+}
+
+
+// As per PXMLRPCBlock::GetParams(), variables may be sent as one struct
+bool PXMLRPCDecoder::MayBeSingleStruct() const
+{
+  return m_data.GetNumVariables() != 1 || m_data.GetVariable((PINDEX)0).GetStruct(0) == NULL;
+}
+
+
+void PXMLRPCDecoder::DecodeFirstParam()
+{
+  std::vector<Event> events;
+  events.swap(m_firstParam);
+
+  // Only a struct if it is the only parameter, the first element in the value
+  m_singleStruct = false;
+  if (m_paramCount == 1) {
+    for (size_t i = 1; i < events.size(); ++i) {
+      if (events[i].m_type == Event::e_Start) {
+        m_singleStruct = PCaselessString(events[i].m_text) == "struct";
+        break;
+      }
+    }
+  }
+
+  Frame param;
+  param.m_kind = e_Param;
+  param.m_struct = NULL;
+  param.m_variable = NULL;
+  param.m_index = 0;
+  param.m_isElement = false;
+  param.m_hasChild = false;
+  m_stack.push_back(param);
+  m_decodingFirst = true;
+
+  for (std::vector<Event>::iterator it = events.begin(); it != events.end() && m_faultCode == P_MAX_INDEX; ++it) {
+    switch (it->m_type) {
+      case Event::e_Start :
+        StartElement(it->m_text.c_str(), NULL);
+        break;
+      case Event::e_End :
+        EndElement(it->m_text.c_str());
+        break;
+      case Event::e_Data :
+        AddCharacterData(it->m_text.data(), (int)it->m_text.length());
+        break;
+    }
+  }
+
+  if (m_faultCode == P_MAX_INDEX)
+    m_stack.pop_back();
+  m_decodingFirst = m_singleStruct = false;
+}
+
+
+void PXMLRPCDecoder::StartElement(const char * name, const char ** /*attrs*/)
+{
+  if (m_faultCode != P_MAX_INDEX)
+    return;
+
+  if (m_holdDepth > 0) {
+    Event event = { Event::e_Start, name };
+    m_firstParam.push_back(event);
+    ++m_holdDepth;
+    return;
+  }
+
+  m_text.clear();
+
+  Frame frame;
+  frame.m_kind = e_Ignore;
+  frame.m_struct = NULL;
+  frame.m_variable = NULL;
+  frame.m_index = 0;
+  frame.m_isElement = false;
+  frame.m_hasChild = false;
+
+  PConstCaselessString elementName(name);
+
+  if (m_stack.empty()) {
+    if (elementName == "methodCall")
+      m_isMethodCall = true;
+    else if (elementName != "methodResponse") {
+      Fail(PXMLRPC::ResponseRootNotMethodResponse, "Root element not methodResponse or methodCall");
+      return;
+    }
+    frame.m_kind = e_Document;
+  }
+  else {
+    Frame & parent = m_stack.back();
+    switch (parent.m_kind) {
+      case e_Document :
+        if (elementName == "methodName")
+          frame.m_kind = e_MethodName;
+        else if (elementName == "params")
+          frame.m_kind = e_Params;
+        else if (elementName == "fault") {
+          frame.m_kind = e_Fault;
+          delete m_faultInfo;
+          m_faultInfo = new PXMLRPCFaultInfo;
+        }
+        break;
+
+      case e_Params :
+        if (elementName == "param") {
+          frame.m_kind = e_Param;
+          frame.m_index = m_paramCount++;
+        }
+        break;
+
+      case e_Param :
+        if (elementName == "value") {
+          // Hold the first parameter until we know how many there are
+          if (parent.m_index == 0 && !m_decodingFirst && MayBeSingleStruct()) {
+            Event event = { Event::e_Start, name };
+            m_firstParam.push_back(event);
+            m_holdDepth = 1;
+            return;
+          }
+          if (m_singleStruct)
+            frame.m_struct = &m_data;
+          else if (parent.m_index < m_data.GetNumVariables())
+            frame.m_variable = &m_data.GetVariable(parent.m_index);
+          if (frame.m_variable != NULL || frame.m_struct != NULL)
+            frame.m_kind = e_Value;
+        }
+        break;
+
+      case e_Fault :
+        if (elementName == "value") {
+          frame.m_kind = e_Value;
+          frame.m_struct = m_faultInfo;
+        }
+        break;
+
+      case e_Value :
+        parent.m_hasChild = true;
+        if (elementName == "struct") {
+          if (parent.m_variable != NULL && (parent.m_isElement || !parent.m_variable->IsArray()))
+            frame.m_struct = parent.m_variable->GetStruct(parent.m_index);
+          if (frame.m_struct == NULL) {
+            frame.m_struct = parent.m_struct;
+            m_wholeStruct = frame.m_struct == &m_data;
+          }
+          if (frame.m_struct != NULL)
+            frame.m_kind = e_Struct;
+          else {
+            Fail(PXMLRPC::ParamNotStruct, PString("Value for ") + parent.m_variable->GetName() + " is a struct");
+            return;
+          }
+        }
+        else if (elementName == ArrayType) {
+          if (parent.m_variable == NULL)
+            break;
+          if (parent.m_isElement || !parent.m_variable->IsArray()) {
+            Fail(PXMLRPC::ParamNotArray, PString("Value for ") + parent.m_variable->GetName() + " is an array");
+            return;
+          }
+          frame.m_kind = e_Array;
+          frame.m_variable = parent.m_variable;
+        }
+        else {
+          if (parent.m_variable == NULL)
+            break;
+          if (parent.m_isElement ? parent.m_variable->GetStruct(parent.m_index) != NULL
+                                 : (parent.m_variable->IsArray() || parent.m_variable->GetStruct(0) != NULL)) {
+            Fail(PXMLRPC::ParamNotValue, PString("Value for ") + parent.m_variable->GetName() + " is a scalar");
+            return;
+          }
+          frame.m_kind = e_Scalar;
+          frame.m_variable = parent.m_variable;
+          frame.m_index = parent.m_index;
+          m_type = name;
+        }
+        break;
+
+      case e_Struct :
+        if (elementName == "member") {
+          frame.m_kind = e_Member;
+          frame.m_struct = parent.m_struct;
+        }
+        break;
+
+      case e_Member :
+        if (elementName == "name")
+          frame.m_kind = e_MemberName;
+        else if (elementName == "value" && parent.m_variable != NULL) {
+          frame.m_kind = e_Value;
+          frame.m_variable = parent.m_variable;
+        }
+        break;
+
+      case e_Array :
+        if (elementName == DataType) {
+          frame.m_kind = e_Data;
+          frame.m_variable = parent.m_variable;
+        }
+        break;
+
+      case e_Data :
+        if (elementName == "value") {
+          // Grow geometrically, the final size is set at the end of the data
+          PXMLRPCVariableBase & array = *parent.m_variable;
+          if (parent.m_index >= array.GetSize() && !array.SetSize(std::max(parent.m_index*2, (PINDEX)4))) {
+            Fail(PXMLRPC::ParamNotArray, PString("Could not set size of ") + array.GetName());
+            return;
+          }
+          frame.m_kind = e_Value;
+          frame.m_variable = &array;
+          frame.m_index = parent.m_index++;
+          frame.m_isElement = true;
+        }
+        break;
+
+      default :
+        break;
+    }
+  }
+
+  m_stack.push_back(frame);
+}
+
+
+static bool IsCompatibleType(const PCaselessString & type, const char * expected)
+{
+  if (type == expected || type == StringType)
+    return true;
+  return (type == "i4" || type == IntType) && (strcmp(expected, IntType) == 0 || strcmp(expected, "i4") == 0);
+}
+
+
+void PXMLRPCDecoder::EndElement(const char * name)
+{
+  if (m_faultCode != P_MAX_INDEX || m_stack.empty())
+    return;
+
+  if (m_holdDepth > 0) {
+    Event event = { Event::e_End, name };
+    m_firstParam.push_back(event);
+    --m_holdDepth;
+    return;
+  }
+
+  Frame frame = m_stack.back();
+  m_stack.pop_back();
+
+  switch (frame.m_kind) {
+    case e_Document :
+      m_parsing = false;
+      break;
+
+    case e_MethodName :
+      m_methodName = PString(m_text.c_str(), m_text.length()).Trim();
+      break;
+
+    case e_Params :
+      if (!m_firstParam.empty())
+        DecodeFirstParam();
+      break;
+
+    case e_MemberName :
+    {
+      Frame & member = m_stack.back();
+      member.m_variable = member.m_struct->GetVariable(PString(m_text.c_str(), m_text.length()).Trim());
+      break;
+    }
+
+    case e_Value :
+      if (frame.m_hasChild || frame.m_variable == NULL)
+        break;
+      if (frame.m_isElement ? frame.m_variable->GetStruct(frame.m_index) != NULL
+                            : (frame.m_variable->IsArray() || frame.m_variable->GetStruct(0) != NULL)) {
+        Fail(PXMLRPC::ScalarWithoutElement, PString("Value for ") + frame.m_variable->GetName() + " has no type");
+        return;
+      }
+      m_type = StringType;
+      // Untyped value is a string, so fall into scalar
+
+    case e_Scalar :
+      if (!IsCompatibleType(m_type, frame.m_variable->GetType())) {
+        Fail(PXMLRPC::ParamNotValue, PString("Value for ") + frame.m_variable->GetName() + " is " + m_type +
+                                     ", expected " + frame.m_variable->GetType());
+        return;
+      }
+      frame.m_variable->FromString(frame.m_index, PString(m_text.c_str(), m_text.length()).Trim());
+      break;
+
+    case e_Data :
+      frame.m_variable->SetSize(frame.m_index);
+      break;
+
+    case e_Fault :
+    {
+      PXMLRPCFaultInfo & info = *static_cast<PXMLRPCFaultInfo *>(m_faultInfo);
+      Fail((PINDEX)info.faultCode, info.faultString);
+      break;
+    }
+
+    default :
+      break;
+  }
+
+  m_text.clear();
+}
+
+
+void PXMLRPCDecoder::AddCharacterData(const char * data, int len)
+{
+  if (m_stack.empty())
+    return;
+
+  if (m_holdDepth > 0) {
+    Event event = { Event::e_Data, std::string(data, len) };
+    m_firstParam.push_back(event);
+    return;
+  }
+
+  switch (m_stack.back().m_kind) {
+    case e_MethodName :
+    case e_MemberName :
+    case e_Value :
+    case e_Scalar :
+      if (m_text.length() + len > m_maxEntityLength) {
+        Fail(m_isMethodCall ? PXMLRPC::CannotParseRequestXML : PXMLRPC::CannotParseResponseXML, "Value too long");
+        return;
+      }
+      m_text.append(data, len);
+      break;
+
+    default :
+      break;
+  }
+}
+
+
 /////////////////////////////////////////////////////////////////
 
 PXMLRPCVariableBase::PXMLRPCVariableBase(const char * n, const char * t)
@@ -0,0 +1,230 @@
+//
+// rfc1155_tab.cxx
+//
+// Code automatically generated by asnparse.
+//
+
+#include <ptlib.h>
+#include <ptclib/rfc1155_tab.h>
+
+
+#ifdef P_SNMP
+
+//
+// ObjectName
+//
+
+const PASN_TypeDescriptor PRFC1155_ObjectName_Descriptor = {
+  "ObjectName",
+  PASN_TypeDescriptor::e_ObjectId,
+  PASN_Object::UniversalObjectId, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PASN_TableObjectId),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+
+//
+// SimpleSyntax
+//
+
+static const PASN_TypeDescriptor PRFC1155_SimpleSyntax_number_Descriptor = {
+  "number",
+  PASN_TypeDescriptor::e_Integer,
+  PASN_Object::UniversalInteger, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_TypeDescriptor PRFC1155_SimpleSyntax_string_Descriptor = {
+  "string",
+  PASN_TypeDescriptor::e_OctetString,
+  PASN_Object::UniversalOctetString, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PASN_TableOctets),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_TypeDescriptor PRFC1155_SimpleSyntax_object_Descriptor = {
+  "object",
+  PASN_TypeDescriptor::e_ObjectId,
+  PASN_Object::UniversalObjectId, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PASN_TableObjectId),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_TypeDescriptor PRFC1155_SimpleSyntax_empty_Descriptor = {
+  "empty",
+  PASN_TypeDescriptor::e_Null,
+  PASN_Object::UniversalNull, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PASN_TableNull),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_FieldDescriptor PRFC1155_SimpleSyntax_Fields[] = {
+  { "number", &PRFC1155_SimpleSyntax_number_Descriptor, offsetof(PRFC1155_SimpleSyntax_Value, m_number), -1 },
+  { "string", &PRFC1155_SimpleSyntax_string_Descriptor, offsetof(PRFC1155_SimpleSyntax_Value, m_string), -1 },
+  { "object", &PRFC1155_SimpleSyntax_object_Descriptor, offsetof(PRFC1155_SimpleSyntax_Value, m_object), -1 },
+  { "empty", &PRFC1155_SimpleSyntax_empty_Descriptor, offsetof(PRFC1155_SimpleSyntax_Value, m_empty), -1 }
+};
+
+const PASN_TypeDescriptor PRFC1155_SimpleSyntax_Descriptor = {
+  "SimpleSyntax",
+  PASN_TypeDescriptor::e_Choice,
+  0, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PRFC1155_SimpleSyntax_Value),
+  PRFC1155_SimpleSyntax_Fields, 4, 4, 0,
+  NULL
+};
+
+
+//
+// IpAddress
+//
+
+const PASN_TypeDescriptor PRFC1155_IpAddress_Descriptor = {
+  "IpAddress",
+  PASN_TypeDescriptor::e_OctetString,
+  0, PASN_Object::ApplicationTagClass,
+  PASN_Object::FixedConstraint, 4, 4, false,
+  sizeof(PASN_TableOctets),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+
+//
+// Counter
+//
+
+const PASN_TypeDescriptor PRFC1155_Counter_Descriptor = {
+  "Counter",
+  PASN_TypeDescriptor::e_Integer,
+  1, PASN_Object::ApplicationTagClass,
+  PASN_Object::FixedConstraint, 0, 4294967295U, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+
+//
+// Gauge
+//
+
+const PASN_TypeDescriptor PRFC1155_Gauge_Descriptor = {
+  "Gauge",
+  PASN_TypeDescriptor::e_Integer,
+  2, PASN_Object::ApplicationTagClass,
+  PASN_Object::FixedConstraint, 0, 4294967295U, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+
+//
+// TimeTicks
+//
+
+const PASN_TypeDescriptor PRFC1155_TimeTicks_Descriptor = {
+  "TimeTicks",
+  PASN_TypeDescriptor::e_Integer,
+  3, PASN_Object::ApplicationTagClass,
+  PASN_Object::FixedConstraint, 0, 4294967295U, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+
+//
+// Opaque
+//
+
+const PASN_TypeDescriptor PRFC1155_Opaque_Descriptor = {
+  "Opaque",
+  PASN_TypeDescriptor::e_OctetString,
+  4, PASN_Object::ApplicationTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PASN_TableOctets),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+
+//
+// NetworkAddress
+//
+
+static const PASN_FieldDescriptor PRFC1155_NetworkAddress_Fields[] = {
+  { "internet", &PRFC1155_IpAddress_Descriptor, offsetof(PRFC1155_NetworkAddress_Value, m_internet), -1 }
+};
+
+const PASN_TypeDescriptor PRFC1155_NetworkAddress_Descriptor = {
+  "NetworkAddress",
+  PASN_TypeDescriptor::e_Choice,
+  0, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PRFC1155_NetworkAddress_Value),
+  PRFC1155_NetworkAddress_Fields, 1, 1, 0,
+  NULL
+};
+
+
+//
+// ApplicationSyntax
+//
+
+static const PASN_FieldDescriptor PRFC1155_ApplicationSyntax_Fields[] = {
+  { "address", &PRFC1155_NetworkAddress_Descriptor, offsetof(PRFC1155_ApplicationSyntax_Value, m_address), -1 },
+  { "counter", &PRFC1155_Counter_Descriptor, offsetof(PRFC1155_ApplicationSyntax_Value, m_counter), -1 },
+  { "gauge", &PRFC1155_Gauge_Descriptor, offsetof(PRFC1155_ApplicationSyntax_Value, m_gauge), -1 },
+  { "ticks", &PRFC1155_TimeTicks_Descriptor, offsetof(PRFC1155_ApplicationSyntax_Value, m_ticks), -1 },
+  { "arbitrary", &PRFC1155_Opaque_Descriptor, offsetof(PRFC1155_ApplicationSyntax_Value, m_arbitrary), -1 }
+};
+
+const PASN_TypeDescriptor PRFC1155_ApplicationSyntax_Descriptor = {
+  "ApplicationSyntax",
+  PASN_TypeDescriptor::e_Choice,
+  0, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PRFC1155_ApplicationSyntax_Value),
+  PRFC1155_ApplicationSyntax_Fields, 5, 5, 0,
+  NULL
+};
+
+
+//
+// ObjectSyntax
+//
+
+static const PASN_FieldDescriptor PRFC1155_ObjectSyntax_Fields[] = {
+  { "simple", &PRFC1155_SimpleSyntax_Descriptor, offsetof(PRFC1155_ObjectSyntax_Value, m_simple), -1 },
+  { "application-wide", &PRFC1155_ApplicationSyntax_Descriptor, offsetof(PRFC1155_ObjectSyntax_Value, m_application_wide), -1 }
+};
+
+const PASN_TypeDescriptor PRFC1155_ObjectSyntax_Descriptor = {
+  "ObjectSyntax",
+  PASN_TypeDescriptor::e_Choice,
+  0, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PRFC1155_ObjectSyntax_Value),
+  PRFC1155_ObjectSyntax_Fields, 2, 2, 0,
+  NULL
+};
+
+
+#endif // P_SNMP
+
+
+// End of rfc1155_tab.cxx
@@ -0,0 +1,291 @@
+//
+// snmp_tab.cxx
+//
+// Code automatically generated by asnparse.
+//
+
+#include <ptlib.h>
+#include <ptclib/snmp_tab.h>
+
+
+#ifdef P_SNMP
+
+//
+// Message
+//
+
+static const PASN_TypeDescriptor PSNMP_Message_version_Descriptor = {
+  "version",
+  PASN_TypeDescriptor::e_Integer,
+  PASN_Object::UniversalInteger, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_TypeDescriptor PSNMP_Message_community_Descriptor = {
+  "community",
+  PASN_TypeDescriptor::e_OctetString,
+  PASN_Object::UniversalOctetString, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PASN_TableOctets),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_TypeDescriptor PSNMP_Message_data_Descriptor = {
+  "data",
+  PASN_TypeDescriptor::e_Any,
+  PASN_Object::UniversalExternalType, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PASN_TableOctets),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_FieldDescriptor PSNMP_Message_Fields[] = {
+  { "version", &PSNMP_Message_version_Descriptor, offsetof(PSNMP_Message_Value, m_version), -1 },
+  { "community", &PSNMP_Message_community_Descriptor, offsetof(PSNMP_Message_Value, m_community), -1 },
+  { "data", &PSNMP_Message_data_Descriptor, offsetof(PSNMP_Message_Value, m_data), -1 }
+};
+
+const PASN_TypeDescriptor PSNMP_Message_Descriptor = {
+  "Message",
+  PASN_TypeDescriptor::e_Sequence,
+  PASN_Object::UniversalSequence, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PSNMP_Message_Value),
+  PSNMP_Message_Fields, 3, 3, 0,
+  NULL
+};
+
+
+//
+// VarBind
+//
+
+static const PASN_FieldDescriptor PSNMP_VarBind_Fields[] = {
+  { "name", &PRFC1155_ObjectName_Descriptor, offsetof(PSNMP_VarBind_Value, m_name), -1 },
+  { "value", &PRFC1155_ObjectSyntax_Descriptor, offsetof(PSNMP_VarBind_Value, m_value), -1 }
+};
+
+const PASN_TypeDescriptor PSNMP_VarBind_Descriptor = {
+  "VarBind",
+  PASN_TypeDescriptor::e_Sequence,
+  PASN_Object::UniversalSequence, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PSNMP_VarBind_Value),
+  PSNMP_VarBind_Fields, 2, 2, 0,
+  NULL
+};
+
+
+//
+// VarBindList
+//
+
+const PASN_TypeDescriptor PSNMP_VarBindList_Descriptor = {
+  "VarBindList",
+  PASN_TypeDescriptor::e_SequenceOf,
+  PASN_Object::UniversalSequence, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PASN_TableArrayOf<PSNMP_VarBind_Value>),
+  NULL, 0, 0, 0,
+  &PSNMP_VarBind_Descriptor
+};
+
+
+//
+// PDU
+//
+
+static const PASN_TypeDescriptor PSNMP_PDU_request_id_Descriptor = {
+  "request-id",
+  PASN_TypeDescriptor::e_Integer,
+  PASN_Object::UniversalInteger, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_TypeDescriptor PSNMP_PDU_error_status_Descriptor = {
+  "error-status",
+  PASN_TypeDescriptor::e_Integer,
+  PASN_Object::UniversalInteger, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_TypeDescriptor PSNMP_PDU_error_index_Descriptor = {
+  "error-index",
+  PASN_TypeDescriptor::e_Integer,
+  PASN_Object::UniversalInteger, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_FieldDescriptor PSNMP_PDU_Fields[] = {
+  { "request-id", &PSNMP_PDU_request_id_Descriptor, offsetof(PSNMP_PDU_Value, m_request_id), -1 },
+  { "error-status", &PSNMP_PDU_error_status_Descriptor, offsetof(PSNMP_PDU_Value, m_error_status), -1 },
+  { "error-index", &PSNMP_PDU_error_index_Descriptor, offsetof(PSNMP_PDU_Value, m_error_index), -1 },
+  { "variable-bindings", &PSNMP_VarBindList_Descriptor, offsetof(PSNMP_PDU_Value, m_variable_bindings), -1 }
+};
+
+const PASN_TypeDescriptor PSNMP_PDU_Descriptor = {
+  "PDU",
+  PASN_TypeDescriptor::e_Sequence,
+  PASN_Object::UniversalSequence, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PSNMP_PDU_Value),
+  PSNMP_PDU_Fields, 4, 4, 0,
+  NULL
+};
+
+
+//
+// Trap-PDU
+//
+
+static const PASN_TypeDescriptor PSNMP_Trap_PDU_enterprise_Descriptor = {
+  "enterprise",
+  PASN_TypeDescriptor::e_ObjectId,
+  PASN_Object::UniversalObjectId, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PASN_TableObjectId),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_TypeDescriptor PSNMP_Trap_PDU_generic_trap_Descriptor = {
+  "generic-trap",
+  PASN_TypeDescriptor::e_Integer,
+  PASN_Object::UniversalInteger, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_TypeDescriptor PSNMP_Trap_PDU_specific_trap_Descriptor = {
+  "specific-trap",
+  PASN_TypeDescriptor::e_Integer,
+  PASN_Object::UniversalInteger, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PInt64),
+  NULL, 0, 0, 0,
+  NULL
+};
+
+static const PASN_FieldDescriptor PSNMP_Trap_PDU_Fields[] = {
+  { "enterprise", &PSNMP_Trap_PDU_enterprise_Descriptor, offsetof(PSNMP_Trap_PDU_Value, m_enterprise), -1 },
+  { "agent-addr", &PRFC1155_NetworkAddress_Descriptor, offsetof(PSNMP_Trap_PDU_Value, m_agent_addr), -1 },
+  { "generic-trap", &PSNMP_Trap_PDU_generic_trap_Descriptor, offsetof(PSNMP_Trap_PDU_Value, m_generic_trap), -1 },
+  { "specific-trap", &PSNMP_Trap_PDU_specific_trap_Descriptor, offsetof(PSNMP_Trap_PDU_Value, m_specific_trap), -1 },
+  { "time-stamp", &PRFC1155_TimeTicks_Descriptor, offsetof(PSNMP_Trap_PDU_Value, m_time_stamp), -1 },
+  { "variable-bindings", &PSNMP_VarBindList_Descriptor, offsetof(PSNMP_Trap_PDU_Value, m_variable_bindings), -1 }
+};
+
+const PASN_TypeDescriptor PSNMP_Trap_PDU_Descriptor = {
+  "Trap-PDU",
+  PASN_TypeDescriptor::e_Sequence,
+  4, PASN_Object::ContextSpecificTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PSNMP_Trap_PDU_Value),
+  PSNMP_Trap_PDU_Fields, 6, 6, 0,
+  NULL
+};
+
+
+//
+// GetRequest-PDU
+//
+
+const PASN_TypeDescriptor PSNMP_GetRequest_PDU_Descriptor = {
+  "GetRequest-PDU",
+  PASN_TypeDescriptor::e_Sequence,
+  0, PASN_Object::ContextSpecificTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PSNMP_PDU_Value),
+  PSNMP_PDU_Fields, 4, 4, 0,
+  NULL
+};
+
+
+//
+// GetNextRequest-PDU
+//
+
+const PASN_TypeDescriptor PSNMP_GetNextRequest_PDU_Descriptor = {
+  "GetNextRequest-PDU",
+  PASN_TypeDescriptor::e_Sequence,
+  1, PASN_Object::ContextSpecificTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PSNMP_PDU_Value),
+  PSNMP_PDU_Fields, 4, 4, 0,
+  NULL
+};
+
+
+//
+// GetResponse-PDU
+//
+
+const PASN_TypeDescriptor PSNMP_GetResponse_PDU_Descriptor = {
+  "GetResponse-PDU",
+  PASN_TypeDescriptor::e_Sequence,
+  2, PASN_Object::ContextSpecificTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PSNMP_PDU_Value),
+  PSNMP_PDU_Fields, 4, 4, 0,
+  NULL
+};
+
+
+//
+// SetRequest-PDU
+//
+
+const PASN_TypeDescriptor PSNMP_SetRequest_PDU_Descriptor = {
+  "SetRequest-PDU",
+  PASN_TypeDescriptor::e_Sequence,
+  3, PASN_Object::ContextSpecificTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PSNMP_PDU_Value),
+  PSNMP_PDU_Fields, 4, 4, 0,
+  NULL
+};
+
+
+//
+// PDUs
+//
+
+static const PASN_FieldDescriptor PSNMP_PDUs_Fields[] = {
+  { "get-request", &PSNMP_GetRequest_PDU_Descriptor, offsetof(PSNMP_PDUs_Value, m_get_request), -1 },
+  { "get-next-request", &PSNMP_GetNextRequest_PDU_Descriptor, offsetof(PSNMP_PDUs_Value, m_get_next_request), -1 },
+  { "get-response", &PSNMP_GetResponse_PDU_Descriptor, offsetof(PSNMP_PDUs_Value, m_get_response), -1 },
+  { "set-request", &PSNMP_SetRequest_PDU_Descriptor, offsetof(PSNMP_PDUs_Value, m_set_request), -1 },
+  { "trap", &PSNMP_Trap_PDU_Descriptor, offsetof(PSNMP_PDUs_Value, m_trap), -1 }
+};
+
+const PASN_TypeDescriptor PSNMP_PDUs_Descriptor = {
+  "PDUs",
+  PASN_TypeDescriptor::e_Choice,
+  0, PASN_Object::UniversalTagClass,
+  PASN_Object::Unconstrained, 0, UINT_MAX, false,
+  sizeof(PSNMP_PDUs_Value),
+  PSNMP_PDUs_Fields, 5, 5, 0,
+  NULL
+};
+
+
+#endif // P_SNMP
+
+
+// End of snmp_tab.cxx
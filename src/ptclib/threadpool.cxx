@@ -49,6 +49,7 @@ PThreadPoolBase::PThreadPoolBase(unsigned int maxWorkerCount,
 #endif
   , m_threadName(threadName != NULL ? threadName : "Pool")
   , m_priority(priority)
+  , m_queueWaitHistogram(PLatencyHistogram::Get("ptlib.pool." + m_threadName + ".queue_wait"))
 {
 }
 
@@ -211,53 +211,88 @@ void PURL::ReadFrom(istream & stream)
 }
 
 
-PString PURL::TranslateString(const PString & str, TranslationType type)
+/* Characters sets are from RFC2396.
+   The EBNF defines lowalpha, upalpha, digit and mark which are always
+   allowed. The reserved list consisting of ";/?:@&=+$," may or may not be
+   allowed depending on the syntatic element being encoded.
+ */
+static struct PURLCharClasses
 {
-  PString xlat = str;
-
-  /* Characters sets are from RFC2396.
-     The EBNF defines lowalpha, upalpha, digit and mark which are always
-     allowed. The reserved list consisting of ";/?:@&=+$," may or may not be
-     allowed depending on the syntatic element being encoded.
-   */
-  PString safeChars = "abcdefghijklmnopqrstuvwxyz"  // lowalpha
-                      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"  // upalpha
-                      "0123456789"                  // digit
-                      "-_.!~*'()";                  // mark
-  switch (type) {
-    case LoginTranslation :
-      safeChars += ";&=+$,";  // Section 3.2.2
-      break;
-
-    case PathTranslation :
-      safeChars += ":@&=$,|";   // Section 3.3
-      break;
-
-    case ParameterTranslation :
+  bool m_safe[PURL::QuotedParameterTranslation+1][256];
+  signed char m_hex[256];
+
+  PURLCharClasses()
+  {
+    static const char * const Always = "abcdefghijklmnopqrstuvwxyz"  // lowalpha
+                                       "ABCDEFGHIJKLMNOPQRSTUVWXYZ"  // upalpha
+                                       "0123456789"                  // digit
+                                       "-_.!~*'()";                  // mark
+    static const char * const Reserved[PURL::QuotedParameterTranslation+1] = {
+      ";&=+$,",       // LoginTranslation, Section 3.2.2
+      ":@&=$,|",      // PathTranslation, Section 3.3
+      "",             // QueryTranslation, Section 3.4, no reserved characters may be used
       /* By strict RFC2396/3.3 this should be as for PathTranslation, but many
          URI schemes have parameters of the form key=value so we don't allow
          '=' character in the allowed set. Also, including one of "@,|" is
          incompatible with some schemes, leave those out too. */
-      safeChars += ":&+$";
-      break;
+      ":&+$",         // ParameterTranslation
+      "[]/:@&=+$,|"   // QuotedParameterTranslation
+    };
+
+    memset(m_safe, 0, sizeof(m_safe));
+    for (PINDEX type = 0; type <= PURL::QuotedParameterTranslation; ++type) {
+      for (const char * ptr = Always; *ptr != '\0'; ++ptr)
+        m_safe[type][(BYTE)*ptr] = true;
+      for (const char * ptr = Reserved[type]; *ptr != '\0'; ++ptr)
+        m_safe[type][(BYTE)*ptr] = true;
+    }
 
-    case QuotedParameterTranslation :
-      safeChars += "[]/:@&=+$,|";
-      // If already starts and ends with quotes, assume it already formatted correctly.
-      if ((str.GetLength() >= 2 && str[0] == '"' && str[str.GetLength()-1] == '"') ||
-           str.FindSpan(safeChars) == P_MAX_INDEX)
-        return str;
+    memset(m_hex, -1, sizeof(m_hex));
+    for (int i = 0; i < 10; ++i)
+      m_hex['0'+i] = (signed char)i;
+    for (int i = 0; i < 6; ++i)
+      m_hex['a'+i] = m_hex['A'+i] = (signed char)(i+10);
+  }
+} const CharClasses;
 
-      return str.ToLiteral();
 
-    default :
-      break;    // Section 3.4, no reserved characters may be used
+PString PURL::TranslateString(const PString & str, TranslationType type)
+{
+  const bool * safe = CharClasses.m_safe[type];
+  const char * src = str;
+  PINDEX length = str.GetLength();
+
+  PINDEX unsafeCount = 0;
+  for (PINDEX i = 0; i < length; ++i) {
+    if (!safe[(BYTE)src[i]])
+      ++unsafeCount;
   }
-  
-  for (PINDEX pos = 0; (pos = xlat.FindSpan(safeChars, pos)) != P_MAX_INDEX; ++pos) {
-    char buf[10];
-    sprintf(buf, "%%%02X", (BYTE)xlat[pos]);
-    xlat.Splice(buf, pos, 1);
+
+  if (type == QuotedParameterTranslation) {
+    // If already starts and ends with quotes, assume it already formatted correctly.
+    if ((length >= 2 && src[0] == '"' && src[length-1] == '"') || unsafeCount == 0)
+      return str;
+
+    return str.ToLiteral();
+  }
+
+  // Nothing to do, which is most of the time, so avoid the copy
+  if (unsafeCount == 0)
+    return str;
+
+  static const char HexDigits[] = "0123456789ABCDEF";
+
+  PString xlat;
+  char * out = xlat.GetPointerAndSetLength(length + unsafeCount*2);
+  for (PINDEX i = 0; i < length; ++i) {
+    BYTE c = src[i];
+    if (safe[c])
+      *out++ = c;
+    else {
+      *out++ = '%';
+      *out++ = HexDigits[c >> 4];
+      *out++ = HexDigits[c & 15];
+    }
   }
 
   return xlat;
@@ -266,29 +301,45 @@ PString PURL::TranslateString(const PString & str, TranslationType type)
 
 PString PURL::UntranslateString(const PString & str, TranslationType type)
 {
-  PString xlat = str;
-  xlat.MakeUnique();
+  const char * src = str;
+  PINDEX length = str.GetLength();
+  bool plusIsSpace = type == PURL::QueryTranslation; // Even though RFC2396 never mentions this, RFC1630 does.
 
-  PINDEX pos;
-  if (type == PURL::QueryTranslation) {
-    /* Even though RFC2396 never mentions this, RFC1630 does. */
-    for (pos = 0; (pos = xlat.Find('+', pos)) != P_MAX_INDEX; ++pos)
-      xlat[pos] = ' ';
-  }
+  PINDEX pos = 0;
+  while (pos < length && src[pos] != '%' && (src[pos] != '+' || !plusIsSpace))
+    ++pos;
 
-  for (pos = 0; (pos = xlat.Find('%', pos)) != P_MAX_INDEX; ++pos) {
-    int digit1 = xlat[pos+1];
-    int digit2 = xlat[pos+2];
-    if (isxdigit(digit1) && isxdigit(digit2)) {
-      char buf[2];
-      buf[0] = (char)(
-            (isdigit(digit2) ? (digit2-'0') : (toupper(digit2)-'A'+10)) +
-           ((isdigit(digit1) ? (digit1-'0') : (toupper(digit1)-'A'+10)) << 4));
-      buf[1] = '\0';
-      xlat.Splice(buf, pos, 3);
+  // Nothing to do, which is most of the time, so avoid the copy
+  if (pos >= length)
+    return str;
+
+  PString xlat;
+  char * out = xlat.GetPointerAndSetLength(length);
+  memcpy(out, src, pos);
+  out += pos;
+
+  while (pos < length) {
+    char c = src[pos++];
+    if (c == '+' && plusIsSpace)
+      *out++ = ' ';
+    else if (c != '%')
+      *out++ = c;
+    else {
+      // String is null terminated, so this never reads beyond the end
+      int digit1 = CharClasses.m_hex[(BYTE)src[pos]];
+      int digit2 = digit1 < 0 ? -1 : CharClasses.m_hex[(BYTE)src[pos+1]];
+      if (digit1 < 0 || digit2 < 0)
+        *out++ = c;
+      else {
+        c = (char)((digit1 << 4) | digit2);
+        if (c != '\0') // A %00 is dropped altogether
+          *out++ = c;
+        pos += 2;
+      }
     }
   }
 
+  xlat.GetPointerAndSetLength(out - (const char *)xlat);
   return xlat;
 }
 
@@ -297,63 +348,79 @@ void PURL::SplitVars(const PString & str, PStringToString & vars, char sep1, cha
 {
   vars.RemoveAll();
 
-  PINDEX sep1prev = 0;
-  do {
-    PINDEX sep1next = str.Find(sep1, sep1prev);
-    if (sep1next == P_MAX_INDEX)
-      sep1next--; // Implicit assumption string is not a couple of gigabytes long ...
+  const char * const begin = str;
+  const char * const end = begin + str.GetLength();
+  const char * ptr = begin;
 
-    PCaselessString key, data;
+  // Note that every search is bounded by the next separator, so is a single pass
+  for (;;) {
+    const char * next = (const char *)memchr(ptr, sep1, end - ptr);
+    if (next == NULL)
+      next = end;
 
-    PINDEX sep2pos = str.Find(sep2, sep1prev);
-    if (sep2pos > sep1next) {
-      if (sep1next > 0)
-        key = str(sep1prev, sep1next-1);
-    }
+    const char * keyEnd = (const char *)memchr(ptr, sep2, next - ptr);
+    const char * dataStart = next;
+    const char * dataEnd = next;
+    bool literal = false;
+
+    if (keyEnd == NULL)
+      keyEnd = next;
     else {
-      if (sep2pos > 0)
-        key = str(sep1prev, sep2pos-1);
-      if (type != QuotedParameterTranslation)
-        data = str(sep2pos+1, sep1next-1);
-      else {
-        while (isspace(str[++sep2pos]))
-          ;
-        if (str[sep2pos] != '"')
-          data = str(sep2pos, sep1next-1);
-        else {
-          // find the end quote
-          PINDEX endQuote = sep2pos+1;
+      dataStart = keyEnd+1;
+      if (type == QuotedParameterTranslation) {
+        while (isspace(*dataStart & 0xff))
+          ++dataStart;
+        if (dataStart < end && *dataStart == '"') {
+          // find the end quote, note never an empty string
+          const char * endQuote = dataStart+1;
           do {
-            endQuote = str.Find('"', endQuote+1);
-            if (endQuote == P_MAX_INDEX) {
+            endQuote = endQuote+1 < end ? (const char *)memchr(endQuote+1, '"', end - endQuote - 1) : NULL;
+            if (endQuote == NULL) {
               PTRACE2(1, NULL, "URI\tNo closing double quote in parameter: " << str);
-              endQuote = str.GetLength()-1;
+              endQuote = end-1;
               break;
             }
-          } while (str[endQuote-1] == '\\');
+          } while (endQuote[-1] == '\\');
 
-          data = PString(PString::Literal, str(sep2pos, endQuote));
+          dataEnd = endQuote+1;
+          literal = true;
 
-          if (sep1next < endQuote) {
-            sep1next = str.Find(sep1, endQuote);
-            if (sep1next == P_MAX_INDEX)
-              sep1next--; // Implicit assumption string is not a couple of gigabytes long ...
+          if (next < endQuote) {
+            next = (const char *)memchr(endQuote, sep1, end - endQuote);
+            if (next == NULL)
+              next = end;
           }
         }
+        else if (dataStart > next)
+          dataStart = next;
       }
     }
 
-    key = PURL::UntranslateString(key.Trim(), type);
-    if (!key.IsEmpty()) {
-      data = PURL::UntranslateString(data, type);
-      if (vars.Contains(key))
-        vars.SetAt(key, vars[key] + '\n' + data);
-      else
-        vars.SetAt(key, data);
+    // Trim the key
+    const char * keyStart = ptr;
+    while (keyStart < keyEnd && isspace(*keyStart & 0xff))
+      ++keyStart;
+    while (keyEnd > keyStart && isspace(keyEnd[-1] & 0xff))
+      --keyEnd;
+
+    if (keyStart < keyEnd) {
+      PCaselessString key = PURL::UntranslateString(PString(keyStart, keyEnd - keyStart), type);
+      if (!key.IsEmpty()) {
+        PString data(dataStart, dataEnd - dataStart);
+        if (literal)
+          data = PString(PString::Literal, (const char *)data);
+        data = PURL::UntranslateString(data, type);
+        if (vars.Contains(key))
+          vars.SetAt(key, vars[key] + '\n' + data);
+        else
+          vars.SetAt(key, data);
+      }
     }
 
-    sep1prev = sep1next+1;
-  } while (sep1prev != P_MAX_INDEX);
+    if (next >= end)
+      break;
+    ptr = next+1;
+  }
 }
 
 
@@ -3497,8 +3497,11 @@ PChannel * PVXMLChannel::OpenMediaFile(const PFilePath & fn, bool recording)
         PTRACE(2, "WAV file has unsupported sample size " << wav->GetSampleSize());
       else if (wav->GetSampleRate() != GetSampleRate())
         PTRACE(2, "WAV file has unsupported sample rate " << wav->GetSampleRate());
-      else
+      else {
+        // Prompts are typically played to many calls, so share the audio
+        wav->SetCached();
         return wav;
+      }
     }
     delete wav;
     return NULL;
@@ -38,12 +38,6 @@
 extern "C" int vsprintf(char *, const char *, va_list);
 #endif
 
-#if P_REGEX
-  #include <regex.h>
-#else
-  #include "regex/regex.h"
-#endif
-
 #if P_HAS_ICONV
   #include <iconv.h>
 #endif // P_HAS_ICONV
@@ -187,19 +181,58 @@ PBoolean PContainer::MakeUnique()
 
 #endif // PMEMORY_CHECK
 
+// Keep the array data after the reference suitably aligned for any element
+static const size_t EmbeddedHeaderSize = (sizeof(PContainerReference)+2*sizeof(void *)-1)&~(2*sizeof(void *)-1);
+
+
+PContainerReference * PAbstractArray::AllocateReference(PINDEX size, PINDEX sizeInBytes)
+{
+  if (sizeInBytes == 0)
+    return new PContainerReference(size);
+
+  // If out of memory, returns an empty reference and the caller checks embeddedData
+  void * block = PAbstractArrayAllocate(EmbeddedHeaderSize + sizeInBytes);
+  if (block == NULL)
+    return new PContainerReference(size);
+
+#undef new
+  PContainerReference * ref = ::new (block) PContainerReference(size);
+#define new PNEW
+  ref->embeddedData = true;
+  return ref;
+}
+
+
+char * PAbstractArray::GetEmbeddedData() const
+{
+  return reference->embeddedData ? (char *)reference + EmbeddedHeaderSize : NULL;
+}
+
+
+void PAbstractArray::DestroyReference()
+{
+  if (!reference->embeddedData)
+    PContainer::DestroyReference();
+  else {
+    reference->~PContainerReference();
+    PAbstractArrayDeallocate(reference);
+    reference = NULL;
+  }
+}
+
 
 PAbstractArray::PAbstractArray(PINDEX elementSizeInBytes, PINDEX initialSize)
-  : PContainer(initialSize)
+  : PContainer(*AllocateReference(initialSize, initialSize*elementSizeInBytes))
 {
   elementSize = elementSizeInBytes;
   PAssert(elementSize != 0, PInvalidParameter);
 
-  if (GetSize() == 0)
-    theArray = NULL;
-  else {
-    theArray = PAbstractArrayAllocate(GetSize() * elementSize);
-    PAssert(theArray != NULL, POutOfMemory);
+  theArray = GetEmbeddedData();
+  if (theArray != NULL)
     memset(theArray, 0, GetSize() * elementSize);
+  else if (GetSize() > 0) {
+    PAssertAlways(POutOfMemory);
+    reference->size = 0;
   }
 
   allocatedDynamically = true;
@@ -210,7 +243,7 @@ PAbstractArray::PAbstractArray(PINDEX elementSizeInBytes,
                                const void *buffer,
                                PINDEX bufferSizeInElements,
                                PBoolean dynamicAllocation)
-  : PContainer(bufferSizeInElements)
+  : PContainer(*AllocateReference(bufferSizeInElements, dynamicAllocation ? bufferSizeInElements*elementSizeInBytes : 0))
 {
   elementSize = elementSizeInBytes;
   PAssert(elementSize != 0, PInvalidParameter);
@@ -220,10 +253,12 @@ PAbstractArray::PAbstractArray(PINDEX elementSizeInBytes,
   if (GetSize() == 0)
     theArray = NULL;
   else if (dynamicAllocation) {
-    PINDEX sizebytes = elementSize*GetSize();
-    theArray = PAbstractArrayAllocate(sizebytes);
-    PAssert(theArray != NULL, POutOfMemory);
-    memcpy(theArray, PAssertNULL(buffer), sizebytes);
+    if ((theArray = GetEmbeddedData()) != NULL)
+      memcpy(theArray, PAssertNULL(buffer), elementSize*GetSize());
+    else {
+      PAssertAlways(POutOfMemory);
+      reference->size = 0;
+    }
   }
   else
     theArray = (char *)buffer;
@@ -242,7 +277,7 @@ PAbstractArray::PAbstractArray(PContainerReference & reference, PINDEX elementSi
 void PAbstractArray::DestroyContents()
 {
   if (theArray != NULL) {
-    if (allocatedDynamically)
+    if (allocatedDynamically && theArray != GetEmbeddedData())
       PAbstractArrayDeallocate(theArray);
     theArray = NULL;
   }
@@ -264,11 +299,22 @@ void PAbstractArray::CloneContents(const PAbstractArray * array)
 {
   elementSize = array->elementSize;
   PINDEX sizebytes = elementSize*GetSize();
-  char * newArray = PAbstractArrayAllocate(sizebytes);
-  if (newArray == NULL)
+  char * newArray;
+
+  // Reference is new and unique to us, so replace it with one containing the data
+  PContainerReference * newReference;
+  if (sizebytes > 0 && !reference->embeddedData && (newReference = AllocateReference(GetSize(), sizebytes))->embeddedData) {
+    newReference->deleteObjects = reference->deleteObjects;
+    delete reference;
+    reference = newReference;
+    newArray = GetEmbeddedData();
+    memcpy(newArray, array->theArray, sizebytes);
+  }
+  else if ((newArray = PAbstractArrayAllocate(sizebytes)) == NULL)
     reference->size = 0;
   else
     memcpy(newArray, array->theArray, sizebytes);
+
   theArray = newArray;
   allocatedDynamically = true;
 }
@@ -357,15 +403,20 @@ PBoolean PAbstractArray::InternalSetSize(PINDEX newSize, PBoolean force)
     return true;
 
   char * newArray;
+  char * embeddedData = GetEmbeddedData();
 
   if (!IsUnique()) {
 
+    PContainerReference * newReference = AllocateReference(newSize, newsizebytes);
+    if (newsizebytes > 0 && !newReference->embeddedData) {
+      delete newReference;
+      return false;
+    }
+
     if (newsizebytes == 0)
       newArray = NULL;
     else {
-      if ((newArray = PAbstractArrayAllocate(newsizebytes)) == NULL)
-        return false;
-  
+      newArray = (char *)newReference + EmbeddedHeaderSize;
       allocatedDynamically = true;
 
       if (theArray != NULL)
@@ -373,13 +424,53 @@ PBoolean PAbstractArray::InternalSetSize(PINDEX newSize, PBoolean force)
     }
 
     --reference->count;
-    reference = new PContainerReference(newSize);
+    reference = newReference;
+
+  } else if (embeddedData != NULL && (theArray == NULL || theArray == embeddedData)) {
+
+    // Data is in the same block as the reference, resize the lot in place
+    if (newsizebytes == 0)
+      newArray = NULL;
+    else {
+      void * newBlock = PAbstractArrayReallocate((void *)reference, EmbeddedHeaderSize + newsizebytes);
+      if (newBlock == NULL)
+        return false;
+      reference = (PContainerReference *)newBlock;
+      newArray = (char *)newBlock + EmbeddedHeaderSize;
+      if (theArray == NULL)
+        oldsizebytes = 0;
+    }
+
+    reference->size = newSize;
+
+  } else if (newsizebytes != 0 && !reference->constObject) {
+
+    // Move to a single block with the reference
+    PContainerReference * newReference = AllocateReference(newSize, newsizebytes);
+    if (newsizebytes > 0 && !newReference->embeddedData) {
+      delete newReference;
+      return false;
+    }
+
+    newArray = (char *)newReference + EmbeddedHeaderSize;
+    if (theArray != NULL) {
+      memcpy(newArray, theArray, PMIN(newsizebytes, oldsizebytes));
+      if (allocatedDynamically && theArray != embeddedData)
+        PAbstractArrayDeallocate(theArray);
+    }
+    else
+      oldsizebytes = 0;
+
+    newReference->deleteObjects = reference->deleteObjects;
+    PAbstractArray::DestroyReference();
+    reference = newReference;
+    allocatedDynamically = true;
 
   } else {
 
     if (theArray != NULL) {
       if (newsizebytes == 0) {
-        if (allocatedDynamically)
+        if (allocatedDynamically && theArray != embeddedData)
           PAbstractArrayDeallocate(theArray);
         newArray = NULL;
       }
@@ -387,7 +478,7 @@ PBoolean PAbstractArray::InternalSetSize(PINDEX newSize, PBoolean force)
         if ((newArray = PAbstractArrayAllocate(newsizebytes)) == NULL)
           return false;
         memcpy(newArray, theArray, PMIN(newsizebytes, oldsizebytes));
-        if (allocatedDynamically)
+        if (allocatedDynamically && theArray != embeddedData)
           PAbstractArrayDeallocate(theArray);
         allocatedDynamically = true;
       }
@@ -411,7 +502,7 @@ PBoolean PAbstractArray::InternalSetSize(PINDEX newSize, PBoolean force)
 
 void PAbstractArray::Attach(const void *buffer, PINDEX bufferSize)
 {
-  if (allocatedDynamically && theArray != NULL)
+  if (allocatedDynamically && theArray != NULL && theArray != GetEmbeddedData())
     PAbstractArrayDeallocate(theArray);
 
   theArray = (char *)buffer;
@@ -732,12 +823,14 @@ const PString & PString::Empty()
 
 
 PString::PString(const char * cstr)
+  : PCharArray(cstr != NULL ? (PINDEX)strlen(cstr)+1 : 0)
 {
-  if (cstr == NULL)
+  // Size is zero if cstr is NULL or the allocation failed
+  if (GetSize() == 0)
     MakeEmpty();
   else {
-    m_length = (PINDEX)strlen(cstr);
-    if (SetSize(m_length+1) && m_length > 0)
+    m_length = GetSize()-1;
+    if (m_length > 0)
       memcpy(theArray, cstr, m_length);
   }
 }
@@ -1707,47 +1800,48 @@ PINDEX PString::FindLast(const char * cstr, PINDEX offset) const
 
 
 PINDEX PString::FindOneOf(const char * cset, PINDEX offset) const
+{
+  if (cset == NULL || *cset == '\0')
+    return P_MAX_INDEX;
+
+  return FindOneOf(PCharacterSet(cset, PIsDescendant(this, PCaselessString)), offset);
+}
+
+
+PINDEX PString::FindOneOf(const PCharacterSet & set, PINDEX offset) const
 {
 #if PINDEX_SIGNED
   if (offset < 0)
     return P_MAX_INDEX;
 #endif
 
-  if (cset == NULL || *cset == '\0')
-    return P_MAX_INDEX;
-
-  PINDEX len = GetLength();
-  while (offset < len) {
-    const char * p = cset;
-    while (*p != '\0') {
-      if (InternalCompare(offset, *p) == EqualTo)
-        return offset;
-      p++;
-    }
-    offset++;
+  for (PINDEX len = GetLength(); offset < len; ++offset) {
+    if (set.Contains(theArray[offset]))
+      return offset;
   }
   return P_MAX_INDEX;
 }
 
 
 PINDEX PString::FindSpan(const char * cset, PINDEX offset) const
+{
+  if (cset == NULL || *cset == '\0')
+    return P_MAX_INDEX;
+
+  return FindSpan(PCharacterSet(cset, PIsDescendant(this, PCaselessString)), offset);
+}
+
+
+PINDEX PString::FindSpan(const PCharacterSet & set, PINDEX offset) const
 {
 #if PINDEX_SIGNED
   if (offset < 0)
     return P_MAX_INDEX;
 #endif
 
-  if (cset == NULL || *cset == '\0')
-    return P_MAX_INDEX;
-
-  PINDEX len = GetLength();
-  while (offset < len) {
-    const char * p = cset;
-    while (InternalCompare(offset, *p) != EqualTo) {
-      if (*++p == '\0')
-        return offset;
-    }
-    offset++;
+  for (PINDEX len = GetLength(); offset < len; ++offset) {
+    if (!set.Contains(theArray[offset]))
+      return offset;
   }
   return P_MAX_INDEX;
 }
@@ -1802,13 +1896,7 @@ PBoolean PString::FindRegEx(const PRegularExpression & regex,
 
 PBoolean PString::MatchesRegEx(const PRegularExpression & regex) const
 {
-  PINDEX pos = 0;
-  PINDEX len = 0;
-
-  if (!regex.Execute(theArray, pos, len))
-    return false;
-
-  return (pos == 0) && (len == GetLength());
+  return regex.Matches(theArray);
 }
 
 PString & PString::Replace(const PString & target, const PString & subs, PBoolean all, PINDEX offset)
@@ -1896,46 +1984,10 @@ bool PString::InternalSplit(const PString & delimiter, PString & before, PString
 
 PStringArray PString::Tokenise(const char * separators, PBoolean onePerSeparator) const
 {
-  PStringArray tokens;
-  
-  if (separators == NULL || IsEmpty())  // No tokens
-    return tokens;
-    
-  PINDEX token = 0;
-  PINDEX p1 = 0;
-  PINDEX p2 = FindOneOf(separators);
-
-  if (p2 == 0) {
-    if (onePerSeparator) { // first character is a token separator
-      tokens[token] = Empty();
-      token++;                        // make first string in array empty
-      p1 = 1;
-      p2 = FindOneOf(separators, 1);
-    }
-    else {
-      do {
-        p1 = p2 + 1;
-      } while ((p2 = FindOneOf(separators, p1)) == p1);
-    }
-  }
-
-  while (p2 != P_MAX_INDEX) {
-    if (p2 > p1)
-      tokens[token] = operator()(p1, p2-1);
-    else
-      tokens[token] = Empty();
-    token++;
-
-    // Get next separator. If not one token per separator then continue
-    // around loop to skip over all the consecutive separators.
-    do {
-      p1 = p2 + 1;
-    } while ((p2 = FindOneOf(separators, p1)) == p1 && !onePerSeparator);
-  }
+  if (separators == NULL)  // No tokens
+    return PStringArray();
 
-  tokens[token] = operator()(p1, P_MAX_INDEX);
-
-  return tokens;
+  return PStringTokeniser(*this, PCharacterSet(separators, PIsDescendant(this, PCaselessString)), onePerSeparator).AsArray();
 }
 
 
@@ -1946,10 +1998,12 @@ PStringArray PString::Lines() const
   if (IsEmpty())
     return lines;
     
+  static const PCharacterSet LineEnds("\r\n");
+
   PINDEX line = 0;
   PINDEX p1 = 0;
   PINDEX p2;
-  while ((p2 = FindOneOf("\r\n", p1)) != P_MAX_INDEX) {
+  while ((p2 = FindOneOf(LineEnds, p1)) != P_MAX_INDEX) {
     lines[line++] = operator()(p1, p2-1);
     p1 = p2 + 1;
     if (theArray[p2] == '\r' && theArray[p1] == '\n') // CR LF pair
@@ -1961,6 +2015,183 @@ PStringArray PString::Lines() const
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+PCharacterSet::PCharacterSet(const char * cset, bool caseless)
+{
+  memset(m_bits, 0, sizeof(m_bits));
+
+  if (cset == NULL)
+    return;
+
+  while (*cset != '\0') {
+    char c = *cset++;
+    Include(c);
+    if (caseless) {
+      // Same test as PCaselessString::InternalCompare()
+      int upper = toupper(c & 0xff);
+      for (int other = 1; other < 256; ++other) {
+        if (toupper(other) == upper)
+          Include((char)other);
+      }
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PStringView::PStringView(const PString & str)
+  : m_pointer(str)
+  , m_length(str.GetLength())
+{
+}
+
+
+PStringView PStringView::Trim() const
+{
+  const char * first = m_pointer;
+  const char * last = m_pointer + m_length;
+  while (first < last && isspace(*first & 0xff))
+    ++first;
+  while (last > first && isspace(last[-1] & 0xff))
+    --last;
+  return PStringView(first, last - first);
+}
+
+
+PString PStringView::AsString() const
+{
+  return PString(m_pointer, m_length);
+}
+
+
+bool PStringView::operator==(const char * cstr) const
+{
+  if (cstr == NULL)
+    return m_length == 0;
+  return strncmp(m_pointer, cstr, m_length) == 0 && cstr[m_length] == '\0';
+}
+
+
+bool PStringView::IsCaselessEqual(const char * cstr) const
+{
+  if (cstr == NULL)
+    return m_length == 0;
+
+  for (PINDEX i = 0; i < m_length; ++i) {
+    if (cstr[i] == '\0' || toupper(m_pointer[i] & 0xff) != toupper(cstr[i] & 0xff))
+      return false;
+  }
+  return cstr[m_length] == '\0';
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PStringTokeniser::PStringTokeniser(const PString & str, const char * separators, bool onePerSeparator)
+  : m_string(str)
+  , m_separators(separators, PIsDescendant(&str, PCaselessString))
+  , m_onePerSeparator(onePerSeparator)
+{
+  Initialise(m_string, m_string.GetLength());
+}
+
+
+PStringTokeniser::PStringTokeniser(const PString & str, const PCharacterSet & separators, bool onePerSeparator)
+  : m_string(str)
+  , m_separators(separators)
+  , m_onePerSeparator(onePerSeparator)
+{
+  Initialise(m_string, m_string.GetLength());
+}
+
+
+PStringTokeniser::PStringTokeniser(const char * pointer, PINDEX length, const PCharacterSet & separators, bool onePerSeparator)
+  : m_separators(separators)
+  , m_onePerSeparator(onePerSeparator)
+{
+  Initialise(pointer, length);
+}
+
+
+void PStringTokeniser::Initialise(const char * pointer, PINDEX length)
+{
+  m_begin = pointer;
+  m_end = pointer + length;
+  Restart();
+}
+
+
+void PStringTokeniser::Restart()
+{
+  m_position = m_begin;
+
+  // No tokens at all in empty string
+  m_finished = m_begin == m_end;
+
+  // Leading separators are ignored if not one token per separator
+  if (!m_onePerSeparator) {
+    while (m_position < m_end && m_separators.Contains(*m_position))
+      ++m_position;
+  }
+}
+
+
+bool PStringTokeniser::Next(PStringView & token)
+{
+  if (m_finished)
+    return false;
+
+  const char * separator = m_position;
+  while (separator < m_end && !m_separators.Contains(*separator))
+    ++separator;
+
+  token = PStringView(m_position, separator - m_position);
+
+  if (separator == m_end)
+    m_finished = true; // Last token, may be empty if string ended with separator
+  else {
+    m_position = separator + 1;
+    if (!m_onePerSeparator) {
+      while (m_position < m_end && m_separators.Contains(*m_position))
+        ++m_position;
+    }
+  }
+
+  return true;
+}
+
+
+PINDEX PStringTokeniser::GetCount() const
+{
+  PStringTokeniser counter(*this);
+  counter.Restart();
+
+  PINDEX count = 0;
+  PStringView token;
+  while (counter.Next(token))
+    ++count;
+  return count;
+}
+
+
+PStringArray PStringTokeniser::AsArray() const
+{
+  PStringArray tokens(GetCount());
+
+  PStringTokeniser tokeniser(*this);
+  tokeniser.Restart();
+
+  PINDEX index = 0;
+  PStringView token;
+  while (tokeniser.Next(token))
+    tokens.SetAt(index++, new PString(token.GetPointer(), token.GetLength()));
+
+  return tokens;
+}
+
+
 PString PString::LeftTrim() const
 {
   if (IsEmpty())
@@ -2764,9 +2995,11 @@ PStringArray::PStringArray(const PStringSet & set)
 
 PStringArray & PStringArray::operator+=(const PStringArray & v)
 {
-  PINDEX i;
-  for (i = 0; i < v.GetSize(); i++)
-    AppendString(v[i]);
+  PINDEX base = GetSize();
+  PINDEX count = v.GetSize();
+  SetSize(base + count);
+  for (PINDEX i = 0; i < count; i++)
+    (*theArray)[base + i] = new PString(v[i]);
 
   return *this;
 }
@@ -3323,262 +3556,6 @@ void PStringOptions::SetReal(const PCaselessString & key, double value, int deci
 }
 
 
-///////////////////////////////////////////////////////////////////////////////
-
-PRegularExpression::PRegularExpression()
-  : m_compileOptions(IgnoreCase)
-  , m_compiledRegex(NULL)
-  , m_lastError(NotCompiled)
-{
-}
-
-
-PRegularExpression::PRegularExpression(const PString & pattern, CompileOptions options)
-  : m_pattern(pattern)
-  , m_compileOptions(options)
-  , m_compiledRegex(NULL)
-{
-  InternalCompile(true);
-}
-
-
-PRegularExpression::PRegularExpression(const char * pattern, CompileOptions options)
-  : m_pattern(pattern)
-  , m_compileOptions(options)
-  , m_compiledRegex(NULL)
-{
-  InternalCompile(true);
-}
-
-
-PRegularExpression::PRegularExpression(const PRegularExpression & from)
-  : m_pattern(from.m_pattern)
-  , m_compileOptions(from.m_compileOptions)
-  , m_compiledRegex(NULL)
-{
-  InternalCompile(true);
-}
-
-
-PRegularExpression & PRegularExpression::operator=(const PRegularExpression & from)
-{
-  if (&from != this) {
-    m_pattern = from.m_pattern;
-    m_compileOptions = from.m_compileOptions;
-    InternalCompile(true);
-  }
-
-  return *this;
-}
-
-
-PRegularExpression::~PRegularExpression()
-{
-  InternalClean();
-}
-
-
-void PRegularExpression::InternalClean()
-{
-  if (m_compiledRegex != NULL) {
-    regfree((regex_t*)m_compiledRegex);
-    free(m_compiledRegex);
-    m_compiledRegex = NULL;
-  }
-}
-
-
-void PRegularExpression::PrintOn(ostream &strm) const
-{
-  strm << m_pattern;
-}
-
-
-PString PRegularExpression::GetErrorText() const
-{
-  char str[256];
-  regerror(m_lastError, (regex_t*)m_compiledRegex, str, sizeof(str));
-  return str;
-}
-
-
-bool PRegularExpression::Compile(const PString & pattern, CompileOptions options)
-{
-  m_pattern = pattern;
-  m_compileOptions = options;
-  return InternalCompile(false);
-}
-
-
-bool PRegularExpression::Compile(const char * pattern, CompileOptions options)
-{
-  m_pattern = pattern;
-  m_compileOptions = options;
-  return InternalCompile(false);
-}
-
-
-bool PRegularExpression::InternalCompile(bool assertOnFail)
-{
-  InternalClean();
-
-  if (m_pattern.IsEmpty()) {
-    m_lastError = assertOnFail ? NotCompiled : BadPattern;
-    return false;
-  }
-
-  m_compiledRegex = malloc(sizeof(regex_t));
-  m_lastError = (ErrorCodes)regcomp((regex_t*)m_compiledRegex, m_pattern, m_compileOptions);
-  if (m_lastError == NoError)
-    return true;
-
-  InternalClean();
-
-  if (assertOnFail)
-    PAssertAlways(PSTRSTRM("Regular expression " << m_pattern.ToLiteral() << " failed to compile: " << GetErrorText()));
-
-  return false;
-}
-
-
-bool PRegularExpression::Execute(const PString & str, PINDEX & start, ExecOptions options) const
-{
-  PINDEX dummy;
-  return Execute((const char *)str, start, dummy, options);
-}
-
-
-bool PRegularExpression::Execute(const PString & str, PINDEX & start, PINDEX & len, ExecOptions options) const
-{
-  return Execute((const char *)str, start, len, options);
-}
-
-
-bool PRegularExpression::Execute(const char * cstr, PINDEX & start, ExecOptions options) const
-{
-  PINDEX dummy;
-  return Execute(cstr, start, dummy, options);
-}
-
-
-bool PRegularExpression::Execute(const char * cstr, PINDEX & start, PINDEX & len, ExecOptions options) const
-{
-  if (m_compiledRegex == NULL)
-    m_lastError = NotCompiled;
-
-  if (m_lastError != NoError && m_lastError != NoMatch)
-    return false;
-
-  regmatch_t match;
-
-  m_lastError = (ErrorCodes)regexec((regex_t*)m_compiledRegex, cstr, 1, &match, options);
-  if (m_lastError != NoError)
-    return false;
-
-  start = match.rm_so;
-  len = match.rm_eo - start;
-  return true;
-}
-
-
-bool PRegularExpression::Execute(const PString & str, PIntArray & starts, ExecOptions options) const
-{
-  PIntArray dummy;
-  return Execute((const char *)str, starts, dummy, options);
-}
-
-
-bool PRegularExpression::Execute(const PString & str,
-                                 PIntArray & starts,
-                                 PIntArray & ends,
-                                 ExecOptions options) const
-{
-  return Execute((const char *)str, starts, ends, options);
-}
-
-
-bool PRegularExpression::Execute(const char * cstr, PIntArray & starts, ExecOptions options) const
-{
-  PIntArray dummy;
-  return Execute(cstr, starts, dummy, options);
-}
-
-
-bool PRegularExpression::Execute(const char * cstr,
-                                 PIntArray & starts,
-                                 PIntArray & ends,
-                                 ExecOptions options) const
-{
-  if (m_compiledRegex == NULL) {
-    m_lastError = NotCompiled;
-    return false;
-  }
-
-  PINDEX count = starts.GetSize();
-  if (count == 0) {
-    starts.SetSize(1);
-    count = 1;
-  }
-  ends.SetSize(count);
-
-  regmatch_t * matches = new regmatch_t[count];
-
-  m_lastError = (ErrorCodes)::regexec((regex_t*)m_compiledRegex, cstr, count, matches, options);
-  if (m_lastError == NoError) {
-    for (PINDEX i = 0; i < count; i++) {
-      starts[i] = matches[i].rm_so;
-      ends[i] = matches[i].rm_eo;
-    }
-  }
-
-  delete [] matches;
-
-  return m_lastError == NoError;
-}
-
-
-bool PRegularExpression::Execute(const char * cstr, PStringArray & substring, ExecOptions options) const
-{
-  if (m_compiledRegex == NULL) {
-    m_lastError = NotCompiled;
-    return false;
-  }
-
-  PINDEX count = substring.GetSize();
-  if (count == 0) {
-    substring.SetSize(1);
-    count = 1;
-  }
-
-  regmatch_t * matches = new regmatch_t[count];
-
-  m_lastError = (ErrorCodes)::regexec((regex_t*)m_compiledRegex, cstr, count, matches, options);
-  if (m_lastError == NoError) {
-    for (PINDEX i = 0; i < count; i++)
-      substring[i] = PString(cstr+matches[i].rm_so, matches[i].rm_eo-matches[i].rm_so);
-  }
-
-  delete [] matches;
-
-  return m_lastError == NoError;
-}
-
-
-PString PRegularExpression::EscapeString(const PString & str)
-{
-  PString translated = str;
-
-  PINDEX lastPos = 0;
-  PINDEX nextPos;
-  while ((nextPos = translated.FindOneOf("\\^$+?*.[]()|{}", lastPos)) != P_MAX_INDEX) {
-    translated.Splice("\\", nextPos);
-    lastPos = nextPos+2;
-  }
-
-  return translated;
-}
-
-
 ///////////////////////////////////////////////////////////////////////////////
 
 void PPrintEnum(std::ostream & strm, int value, int begin, int end, char const * const * names)
@@ -0,0 +1,515 @@
+/*
+ * histogram.cxx
+ *
+ * Latency histogram instrumentation.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#ifdef __GNUC__
+#pragma implementation "histogram.h"
+#endif
+
+#include <ptlib.h>
+#include <ptlib/histogram.h>
+
+#include <map>
+
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
+
+#define PTraceModule() "Histogram"
+
+
+struct PLatencyHistogram::Shard
+{
+  atomic<uint64_t> m_count;
+  atomic<uint64_t> m_sum;
+  atomic<uint64_t> m_minimum;
+  atomic<uint64_t> m_maximum;
+  atomic<uint64_t> m_buckets[NumBuckets];
+  char             m_padding[64]; // Keep next shard off our cache lines
+
+  Shard()
+  {
+    Reset();
+  }
+
+  void Reset()
+  {
+    m_count.store(0, memory_order_relaxed);
+    m_sum.store(0, memory_order_relaxed);
+    m_minimum.store(UINT64_MAX, memory_order_relaxed);
+    m_maximum.store(0, memory_order_relaxed);
+    for (unsigned i = 0; i < NumBuckets; ++i)
+      m_buckets[i].store(0, memory_order_relaxed);
+  }
+};
+
+
+namespace {
+
+  P_THREAD_LOCAL unsigned t_shardIndex; // Plus one, zero is unassigned
+  atomic<unsigned> s_nextShardIndex;
+
+  __inline unsigned HighestBit(uint64_t value)
+  {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long bit;
+    _BitScanReverse64(&bit, value);
+    return bit;
+#else
+    unsigned bit = 0;
+    while ((value >>= 1) != 0)
+      ++bit;
+    return bit;
+#endif
+  }
+
+
+  void PrintNanoseconds(ostream & strm, uint64_t ns)
+  {
+    static const struct {
+      uint64_t     m_divisor;
+      const char * m_units;
+    } Scales[] = {
+      { 1000000000, "s" },
+      {    1000000, "ms" },
+      {       1000, "us" }
+    };
+
+    for (PINDEX i = 0; i < PARRAYSIZE(Scales); ++i) {
+      if (ns >= Scales[i].m_divisor) {
+        strm << setprecision(3) << (double)ns/Scales[i].m_divisor << Scales[i].m_units;
+        return;
+      }
+    }
+    strm << ns << "ns";
+  }
+
+
+  void PrintJSONString(ostream & strm, const PString & str)
+  {
+    strm << '"';
+    for (const char * ptr = str; *ptr != '\0'; ++ptr) {
+      switch (*ptr) {
+        case '"' :
+        case '\\' :
+          strm << '\\' << *ptr;
+          break;
+        default :
+          if ((unsigned char)*ptr < ' ')
+            strm << "\\u" << hex << setfill('0') << setw(4) << (unsigned)*ptr << dec << setfill(' ');
+          else
+            strm << *ptr;
+      }
+    }
+    strm << '"';
+  }
+
+
+  struct Registry
+  {
+    typedef std::map<PString, PLatencyHistogram *> Map;
+    Map              m_histograms;
+    bool             m_defaultEnabled;
+    PCriticalSection m_mutex;
+
+    Registry()
+    {
+      const char * env = getenv("PTLIB_LATENCY_HISTOGRAMS");
+      m_defaultEnabled = env != NULL && atoi(env) != 0;
+    }
+  };
+
+  Registry * CreateRegistry()
+  {
+    PMEMORY_IGNORE_ALLOCATIONS_FOR_SCOPE;
+    return new Registry;
+  }
+
+  /* Never destroyed, as histograms are typically referenced from statics
+     whose destruction order is unknown. */
+  Registry & GetRegistry()
+  {
+    static Registry * const s_registry = CreateRegistry();
+    return *s_registry;
+  }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PLatencyHistogram::PLatencyHistogram(const PString & name, bool enabled)
+  : m_name(name)
+  , m_enabled(enabled)
+{
+  for (unsigned i = 0; i < NumShards; ++i)
+    m_shards[i].store(NULL, memory_order_relaxed);
+}
+
+
+PLatencyHistogram::~PLatencyHistogram()
+{
+  for (unsigned i = 0; i < NumShards; ++i)
+    delete m_shards[i].load(memory_order_acquire);
+}
+
+
+void PLatencyHistogram::PrintOn(ostream & strm) const
+{
+  strm << GetSnapshot();
+}
+
+
+void PLatencyHistogram::Record(const PTimeInterval & interval)
+{
+  if (m_enabled.load(memory_order_relaxed)) {
+    PInt64 ns = interval.GetNanoSeconds();
+    InternalRecord(ns > 0 ? ns : 0);
+  }
+}
+
+
+void PLatencyHistogram::InternalRecordSince(uint64_t startCycle)
+{
+  int64_t ns = PProfiling::CyclesToNanoseconds(PProfiling::GetCycles() - startCycle);
+  InternalRecord(ns > 0 ? ns : 0);
+}
+
+
+PLatencyHistogram::Shard * PLatencyHistogram::GetShard()
+{
+  unsigned index = t_shardIndex;
+  if (index == 0)
+    t_shardIndex = index = s_nextShardIndex++ % NumShards + 1;
+
+  atomic<Shard*> & slot = m_shards[index-1];
+  Shard * shard = slot.load(memory_order_acquire);
+  if (shard != NULL)
+    return shard;
+
+  Shard * newShard;
+  {
+    // Histograms in the registry live forever
+    PMEMORY_IGNORE_ALLOCATIONS_FOR_SCOPE;
+    newShard = new Shard;
+  }
+
+  if (slot.compare_exchange_strong(shard, newShard, memory_order_acq_rel))
+    return newShard;
+
+  delete newShard; // Another thread got there first
+  return shard;
+}
+
+
+void PLatencyHistogram::InternalRecord(uint64_t nanoseconds)
+{
+  Shard & shard = *GetShard();
+
+  shard.m_buckets[GetBucketIndex(nanoseconds)].fetch_add(1, memory_order_relaxed);
+  shard.m_count.fetch_add(1, memory_order_relaxed);
+  shard.m_sum.fetch_add(nanoseconds, memory_order_relaxed);
+
+  uint64_t value = shard.m_minimum.load(memory_order_relaxed);
+  while (nanoseconds < value && !shard.m_minimum.compare_exchange_weak(value, nanoseconds, memory_order_relaxed))
+    ;
+
+  value = shard.m_maximum.load(memory_order_relaxed);
+  while (nanoseconds > value && !shard.m_maximum.compare_exchange_weak(value, nanoseconds, memory_order_relaxed))
+    ;
+}
+
+
+void PLatencyHistogram::Reset()
+{
+  for (unsigned i = 0; i < NumShards; ++i) {
+    Shard * shard = m_shards[i].load(memory_order_acquire);
+    if (shard != NULL)
+      shard->Reset();
+  }
+}
+
+
+PLatencyHistogram::Snapshot PLatencyHistogram::GetSnapshot() const
+{
+  Snapshot snapshot(m_name);
+
+  for (unsigned i = 0; i < NumShards; ++i) {
+    Shard * shard = m_shards[i].load(memory_order_acquire);
+    if (shard == NULL)
+      continue;
+
+    snapshot.m_count += shard->m_count.load(memory_order_relaxed);
+    snapshot.m_sum += shard->m_sum.load(memory_order_relaxed);
+    snapshot.m_minimum = std::min(snapshot.m_minimum, (uint64_t)shard->m_minimum.load(memory_order_relaxed));
+    snapshot.m_maximum = std::max(snapshot.m_maximum, (uint64_t)shard->m_maximum.load(memory_order_relaxed));
+    for (unsigned b = 0; b < NumBuckets; ++b)
+      snapshot.m_buckets[b] += shard->m_buckets[b].load(memory_order_relaxed);
+  }
+
+  return snapshot;
+}
+
+
+unsigned PLatencyHistogram::GetBucketIndex(uint64_t nanoseconds)
+{
+  if (nanoseconds < SubBuckets)
+    return (unsigned)nanoseconds;
+
+  if (nanoseconds >= (1ULL << MaxValueBits))
+    return NumBuckets-1;
+
+  unsigned shift = HighestBit(nanoseconds) - SubBucketBits;
+  return shift*SubBuckets + (unsigned)(nanoseconds >> shift);
+}
+
+
+uint64_t PLatencyHistogram::GetBucketLowest(unsigned bucket)
+{
+  if (bucket < SubBuckets)
+    return bucket;
+
+  unsigned shift = bucket/SubBuckets - 1;
+  return (uint64_t)(SubBuckets + bucket%SubBuckets) << shift;
+}
+
+
+uint64_t PLatencyHistogram::GetBucketHighest(unsigned bucket)
+{
+  if (bucket < SubBuckets)
+    return bucket;
+
+  unsigned shift = bucket/SubBuckets - 1;
+  return GetBucketLowest(bucket) + (1ULL << shift) - 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PLatencyHistogram::Snapshot::Snapshot(const PString & name)
+  : m_name(name)
+  , m_count(0)
+  , m_sum(0)
+  , m_minimum(UINT64_MAX)
+  , m_maximum(0)
+  , m_buckets(NumBuckets)
+{
+}
+
+
+void PLatencyHistogram::Snapshot::Merge(const Snapshot & other)
+{
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+  m_minimum = std::min(m_minimum, other.m_minimum);
+  m_maximum = std::max(m_maximum, other.m_maximum);
+  for (size_t b = 0; b < m_buckets.size() && b < other.m_buckets.size(); ++b)
+    m_buckets[b] += other.m_buckets[b];
+}
+
+
+uint64_t PLatencyHistogram::Snapshot::GetPercentile(double percent) const
+{
+  if (m_count == 0)
+    return 0;
+  if (percent <= 0)
+    return m_minimum;
+  if (percent >= 100)
+    return m_maximum;
+
+  uint64_t rank = (uint64_t)(percent*m_count/100);
+  if (rank == 0)
+    rank = 1;
+
+  uint64_t accumulated = 0;
+  for (unsigned b = 0; b < m_buckets.size(); ++b) {
+    accumulated += m_buckets[b];
+    if (accumulated >= rank) {
+      uint64_t value = (GetBucketLowest(b) + GetBucketHighest(b))/2;
+      return std::max(m_minimum, std::min(m_maximum, value));
+    }
+  }
+
+  return m_maximum;
+}
+
+
+void PLatencyHistogram::Snapshot::PrintOn(ostream & strm) const
+{
+  std::streamsize precision = strm.precision();
+  ios::fmtflags flags = strm.flags();
+
+  strm.unsetf(ios::floatfield);
+  strm << m_name << ": count=" << m_count;
+  if (m_count > 0) {
+    static const struct {
+      double       m_percent;
+      const char * m_name;
+    } Percentiles[] = {
+      { 50,   " p50=" },
+      { 90,   " p90=" },
+      { 99,   " p99=" },
+      { 99.9, " p99.9=" }
+    };
+
+    strm << " min=";
+    PrintNanoseconds(strm, GetMinimum());
+    strm << " mean=";
+    PrintNanoseconds(strm, GetMean());
+    for (PINDEX i = 0; i < PARRAYSIZE(Percentiles); ++i) {
+      strm << Percentiles[i].m_name;
+      PrintNanoseconds(strm, GetPercentile(Percentiles[i].m_percent));
+    }
+    strm << " max=";
+    PrintNanoseconds(strm, GetMaximum());
+  }
+
+  strm.precision(precision);
+  strm.flags(flags);
+}
+
+
+void PLatencyHistogram::Snapshot::ToJSON(ostream & strm) const
+{
+  strm << "{\"name\":";
+  PrintJSONString(strm, m_name);
+  strm << ",\"count\":" << m_count
+       << ",\"sum\":" << m_sum
+       << ",\"min\":" << GetMinimum()
+       << ",\"mean\":" << GetMean()
+       << ",\"p50\":" << GetPercentile(50)
+       << ",\"p90\":" << GetPercentile(90)
+       << ",\"p99\":" << GetPercentile(99)
+       << ",\"p999\":" << GetPercentile(99.9)
+       << ",\"max\":" << GetMaximum()
+       << ",\"buckets\":[";
+
+  bool first = true;
+  for (unsigned b = 0; b < m_buckets.size(); ++b) {
+    if (m_buckets[b] != 0) {
+      if (!first)
+        strm << ',';
+      first = false;
+      strm << '[' << GetBucketLowest(b) << ',' << GetBucketHighest(b) << ',' << m_buckets[b] << ']';
+    }
+  }
+
+  strm << "]}";
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PLatencyHistogram & PLatencyHistogram::Get(const PString & name)
+{
+  Registry & registry = GetRegistry();
+  PWaitAndSignal lock(registry.m_mutex);
+
+  Registry::Map::iterator it = registry.m_histograms.find(name);
+  if (it != registry.m_histograms.end())
+    return *it->second;
+
+  PMEMORY_IGNORE_ALLOCATIONS_FOR_SCOPE;
+  // Make sure the name is not sharing storage with callers string
+  PLatencyHistogram * histogram = new PLatencyHistogram((const char *)name, registry.m_defaultEnabled);
+  registry.m_histograms[histogram->GetName()] = histogram;
+  return *histogram;
+}
+
+
+PLatencyHistogram::Snapshots PLatencyHistogram::GetSnapshots()
+{
+  Registry & registry = GetRegistry();
+  PWaitAndSignal lock(registry.m_mutex);
+
+  Snapshots snapshots;
+  snapshots.reserve(registry.m_histograms.size());
+  for (Registry::Map::iterator it = registry.m_histograms.begin(); it != registry.m_histograms.end(); ++it)
+    snapshots.push_back(it->second->GetSnapshot());
+  return snapshots;
+}
+
+
+void PLatencyHistogram::PrintAll(ostream & strm)
+{
+  Snapshots snapshots = GetSnapshots();
+  for (Snapshots::iterator it = snapshots.begin(); it != snapshots.end(); ++it) {
+    if (it->GetCount() > 0)
+      strm << *it << '\n';
+  }
+}
+
+
+void PLatencyHistogram::AllToJSON(ostream & strm)
+{
+  Snapshots snapshots = GetSnapshots();
+  strm << "{\"histograms\":[";
+  for (Snapshots::iterator it = snapshots.begin(); it != snapshots.end(); ++it) {
+    if (it != snapshots.begin())
+      strm << ',';
+    it->ToJSON(strm);
+  }
+  strm << "]}";
+}
+
+
+void PLatencyHistogram::ResetAll()
+{
+  Registry & registry = GetRegistry();
+  PWaitAndSignal lock(registry.m_mutex);
+  for (Registry::Map::iterator it = registry.m_histograms.begin(); it != registry.m_histograms.end(); ++it)
+    it->second->Reset();
+}
+
+
+void PLatencyHistogram::SetAllEnabled(bool enabled)
+{
+  Registry & registry = GetRegistry();
+  PWaitAndSignal lock(registry.m_mutex);
+  for (Registry::Map::iterator it = registry.m_histograms.begin(); it != registry.m_histograms.end(); ++it)
+    it->second->SetEnabled(enabled);
+  PTRACE(3, NULL, PTraceModule(), "Latency histograms " << (enabled ? "enabled" : "disabled"));
+}
+
+
+void PLatencyHistogram::SetDefaultEnabled(bool enabled)
+{
+  Registry & registry = GetRegistry();
+  PWaitAndSignal lock(registry.m_mutex);
+  registry.m_defaultEnabled = enabled;
+}
+
+
+bool PLatencyHistogram::GetDefaultEnabled()
+{
+  Registry & registry = GetRegistry();
+  PWaitAndSignal lock(registry.m_mutex);
+  return registry.m_defaultEnabled;
+}
+
+
+// End Of File ///////////////////////////////////////////////////////////////
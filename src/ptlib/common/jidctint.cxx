@@ -0,0 +1,240 @@
+/*
+ * jidctint.cxx
+ *
+ * Copyright (C) 1994-1998, Thomas G. Lane.
+ * This file is part of the Independent JPEG Group's software.
+ *
+ * The authors make NO WARRANTY or representation, either express or implied,
+ * with respect to this software, its quality, accuracy, merchantability, or 
+ * fitness for a particular purpose.  This software is provided "AS IS", and you,
+ * its user, assume the entire risk as to its quality and accuracy.
+ *
+ * This software is copyright (C) 1991-1998, Thomas G. Lane.
+ * All Rights Reserved except as specified below.
+ *
+ * Permission is hereby granted to use, copy, modify, and distribute this
+ * software (or portions thereof) for any purpose, without fee, subject to these
+ * conditions:
+ * (1) If any part of the source code for this software is distributed, then this
+ * README file must be included, with this copyright and no-warranty notice
+ * unaltered; and any additions, deletions, or changes to the original files
+ * must be clearly indicated in accompanying documentation.
+ * (2) If only executable code is distributed, then the accompanying
+ * documentation must state that "this software is based in part on the work of
+ * the Independent JPEG Group".
+ * (3) Permission for use of this software is granted only if the user accepts
+ * full responsibility for any undesirable consequences; the authors accept
+ * NO LIABILITY for damages of any kind.
+ * 
+ * These conditions apply to any software derived from or based on the IJG code,
+ * not just to the unmodified library.  If you use our work, you ought to
+ * acknowledge us.
+ * 
+ * Permission is NOT granted for the use of any IJG author's name or company name
+ * in advertising or publicity relating to this software or products derived from
+ * it.  This software may be referred to only as "the Independent JPEG Group's
+ * software".
+ * 
+ * We specifically permit and encourage the use of this software as the basis of
+ * commercial products, provided that all warranty or liability claims are
+ * assumed by the product vendor.
+ *
+ *
+ * This file contains a fixed point implementation of the inverse DCT
+ * (Discrete Cosine Transform), derived from the IJG "fast integer" method
+ * (jidctfst.c) and modified for use with tinyjpeg. Changes from the IJG
+ * original: the quantization multipliers carry PASS1_BITS of extra
+ * precision so high quality tables do not round to zero, the column pass
+ * has no per column short circuit so the compiler can vectorise it across
+ * all eight columns, and blocks with no AC terms are handled up front.
+ *
+ * This is based on Arai, Agui, and Nakajima's algorithm for scaled DCT, the
+ * same as the floating point version in jidctflt.cxx, so the quantization
+ * tables are built with the same AA&N scale factors. The integer version
+ * avoids the int/float conversions in the inner loops, which dominate the
+ * decode time of MJPEG video.
+ */
+#ifdef _MSC_VER
+#include "stdint.h"
+#else
+#include <inttypes.h>
+#endif
+#include <string.h>
+
+#include "tinyjpeg-internal.h"
+#include "ptlib_config.h"
+
+#ifndef P_MEDIALIB
+
+#define DCTSIZE	   8
+#define DCTSIZE2   (DCTSIZE*DCTSIZE)
+
+/* Fixed point scale of the multiplier constants, and the extra scale that
+   the quantization multipliers (and so the workspace values) carry. With
+   8 bit samples, the intermediate values still fit comfortably in 32 bits. */
+#define CONST_BITS  8
+#define PASS1_BITS  TINYJPEG_IDCT_INT_PASS1_BITS
+
+#define FIX_1_082392200  ((int32_t)277)		/* FIX(1.082392200) */
+#define FIX_1_414213562  ((int32_t)362)		/* FIX(1.414213562) */
+#define FIX_1_847759065  ((int32_t)473)		/* FIX(1.847759065) */
+#define FIX_2_613125930  ((int32_t)669)		/* FIX(2.613125930) */
+
+#define MULTIPLY(var,const)  (((var) * (const)) >> CONST_BITS)
+#define DEQUANTIZE(coef,quantval)  (((int32_t) (coef)) * (quantval))
+
+
+static inline uint8_t descale_and_clamp(int32_t x)
+{
+  x = ((x + (1 << (PASS1_BITS+3-1))) >> (PASS1_BITS+3)) + 128;
+  return (uint8_t)(x < 0 ? 0 : (x > 255 ? 255 : x));
+}
+
+
+/*
+ * Perform dequantization and inverse DCT on one block of coefficients.
+ */
+
+void
+tinyjpeg_idct_int (struct component *compptr, uint8_t *output_buf, int stride)
+{
+  const int16_t *inptr = compptr->DCT;
+  const int32_t *quantptr = compptr->IQ_table;
+  int32_t workspace[DCTSIZE2]; /* buffers data between passes */
+  int32_t *wsptr;
+  uint8_t *outptr;
+  int ctr, acbits;
+
+  /* Video has many blocks where only the DC term survives quantization,
+   * then every output sample is the same value.
+   */
+  acbits = 0;
+  for (ctr = 1; ctr < DCTSIZE2; ctr++)
+    acbits |= inptr[ctr];
+  if (acbits == 0) {
+    uint8_t dcval = descale_and_clamp(DEQUANTIZE(inptr[0], quantptr[0]));
+    for (ctr = 0; ctr < DCTSIZE; ctr++, output_buf += stride)
+      memset(output_buf, dcval, DCTSIZE);
+    return;
+  }
+
+  /* Pass 1: process columns from input, store into work array.
+   * Each column is independent and the loop body is straight line code, so
+   * this is vectorised across the eight columns.
+   */
+
+  for (ctr = 0; ctr < DCTSIZE; ctr++) {
+    int32_t tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+    int32_t tmp10, tmp11, tmp12, tmp13;
+    int32_t z5, z10, z11, z12, z13;
+
+    /* Even part */
+
+    tmp0 = DEQUANTIZE(inptr[DCTSIZE*0+ctr], quantptr[DCTSIZE*0+ctr]);
+    tmp1 = DEQUANTIZE(inptr[DCTSIZE*2+ctr], quantptr[DCTSIZE*2+ctr]);
+    tmp2 = DEQUANTIZE(inptr[DCTSIZE*4+ctr], quantptr[DCTSIZE*4+ctr]);
+    tmp3 = DEQUANTIZE(inptr[DCTSIZE*6+ctr], quantptr[DCTSIZE*6+ctr]);
+
+    tmp10 = tmp0 + tmp2;	/* phase 3 */
+    tmp11 = tmp0 - tmp2;
+
+    tmp13 = tmp1 + tmp3;	/* phases 5-3 */
+    tmp12 = MULTIPLY(tmp1 - tmp3, FIX_1_414213562) - tmp13; /* 2*c4 */
+
+    tmp0 = tmp10 + tmp13;	/* phase 2 */
+    tmp3 = tmp10 - tmp13;
+    tmp1 = tmp11 + tmp12;
+    tmp2 = tmp11 - tmp12;
+
+    /* Odd part */
+
+    tmp4 = DEQUANTIZE(inptr[DCTSIZE*1+ctr], quantptr[DCTSIZE*1+ctr]);
+    tmp5 = DEQUANTIZE(inptr[DCTSIZE*3+ctr], quantptr[DCTSIZE*3+ctr]);
+    tmp6 = DEQUANTIZE(inptr[DCTSIZE*5+ctr], quantptr[DCTSIZE*5+ctr]);
+    tmp7 = DEQUANTIZE(inptr[DCTSIZE*7+ctr], quantptr[DCTSIZE*7+ctr]);
+
+    z13 = tmp6 + tmp5;		/* phase 6 */
+    z10 = tmp6 - tmp5;
+    z11 = tmp4 + tmp7;
+    z12 = tmp4 - tmp7;
+
+    tmp7 = z11 + z13;		/* phase 5 */
+    tmp11 = MULTIPLY(z11 - z13, FIX_1_414213562); /* 2*c4 */
+
+    z5 = MULTIPLY(z10 + z12, FIX_1_847759065); /* 2*c2 */
+    tmp10 = MULTIPLY(z12, FIX_1_082392200) - z5; /* 2*(c2-c6) */
+    tmp12 = MULTIPLY(z10, -FIX_2_613125930) + z5; /* -2*(c2+c6) */
+
+    tmp6 = tmp12 - tmp7;	/* phase 2 */
+    tmp5 = tmp11 - tmp6;
+    tmp4 = tmp10 + tmp5;
+
+    workspace[DCTSIZE*0+ctr] = tmp0 + tmp7;
+    workspace[DCTSIZE*7+ctr] = tmp0 - tmp7;
+    workspace[DCTSIZE*1+ctr] = tmp1 + tmp6;
+    workspace[DCTSIZE*6+ctr] = tmp1 - tmp6;
+    workspace[DCTSIZE*2+ctr] = tmp2 + tmp5;
+    workspace[DCTSIZE*5+ctr] = tmp2 - tmp5;
+    workspace[DCTSIZE*4+ctr] = tmp3 + tmp4;
+    workspace[DCTSIZE*3+ctr] = tmp3 - tmp4;
+  }
+
+  /* Pass 2: process rows from work array, store into output array. */
+  /* Note that we must descale the results by a factor of 8 == 2**3,
+   * and also undo the PASS1_BITS scaling. */
+
+  wsptr = workspace;
+  outptr = output_buf;
+  for (ctr = 0; ctr < DCTSIZE; ctr++) {
+    int32_t tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+    int32_t tmp10, tmp11, tmp12, tmp13;
+    int32_t z5, z10, z11, z12, z13;
+
+    /* Even part */
+
+    tmp10 = wsptr[0] + wsptr[4];
+    tmp11 = wsptr[0] - wsptr[4];
+
+    tmp13 = wsptr[2] + wsptr[6];
+    tmp12 = MULTIPLY(wsptr[2] - wsptr[6], FIX_1_414213562) - tmp13;
+
+    tmp0 = tmp10 + tmp13;
+    tmp3 = tmp10 - tmp13;
+    tmp1 = tmp11 + tmp12;
+    tmp2 = tmp11 - tmp12;
+
+    /* Odd part */
+
+    z13 = wsptr[5] + wsptr[3];
+    z10 = wsptr[5] - wsptr[3];
+    z11 = wsptr[1] + wsptr[7];
+    z12 = wsptr[1] - wsptr[7];
+
+    tmp7 = z11 + z13;
+    tmp11 = MULTIPLY(z11 - z13, FIX_1_414213562);
+
+    z5 = MULTIPLY(z10 + z12, FIX_1_847759065); /* 2*c2 */
+    tmp10 = MULTIPLY(z12, FIX_1_082392200) - z5; /* 2*(c2-c6) */
+    tmp12 = MULTIPLY(z10, -FIX_2_613125930) + z5; /* -2*(c2+c6) */
+
+    tmp6 = tmp12 - tmp7;
+    tmp5 = tmp11 - tmp6;
+    tmp4 = tmp10 + tmp5;
+
+    /* Final output stage: scale down and range-limit */
+
+    outptr[0] = descale_and_clamp(tmp0 + tmp7);
+    outptr[7] = descale_and_clamp(tmp0 - tmp7);
+    outptr[1] = descale_and_clamp(tmp1 + tmp6);
+    outptr[6] = descale_and_clamp(tmp1 - tmp6);
+    outptr[2] = descale_and_clamp(tmp2 + tmp5);
+    outptr[5] = descale_and_clamp(tmp2 - tmp5);
+    outptr[4] = descale_and_clamp(tmp3 + tmp4);
+    outptr[3] = descale_and_clamp(tmp3 - tmp4);
+
+    wsptr += DCTSIZE;		/* advance pointer to next row */
+    outptr += stride;
+  }
+}
+
+#endif // P_MEDIALIB
@@ -34,10 +34,14 @@
 #include <ptlib.h>
 #include <ptlib/pfactory.h>
 #include <ptlib/pprocess.h>
+#include <ptlib/histogram.h>
 #include <sstream>
 #include <fstream>
 #include <ctype.h>
 #include <limits>
+#if PMEMORY_CHECK
+#include <atomic>
+#endif
 #ifdef _WIN32
 #include <ptlib/msos/ptlib/debstrm.h>
 #if defined(_MSC_VER)
@@ -442,6 +446,100 @@ static void * UninitialisedPtr;
 static void * GuardedPtr;
 
 
+/* Per call site statistics. Each thread updates its own shard so hot call
+   sites do not bounce a cache line between cores, and entries are claimed
+   with a compare and swap on the key so the heap mutex is never needed. The
+   shards are merged when the report is generated. All of this is static
+   storage without constructors, so is usable before any initialisation. */
+struct PMemorySiteInfo
+{
+  std::atomic<uint64_t> m_key;
+  std::atomic<bool>     m_ready;
+  const char *          m_fileName;
+  const char *          m_className;
+  unsigned              m_line;
+  std::atomic<uint64_t> m_allocations;
+  std::atomic<uint64_t> m_allocatedBytes;
+  std::atomic<int64_t>  m_liveObjects;
+  std::atomic<int64_t>  m_liveBytes;
+};
+
+enum {
+  NumMemorySiteShards = 8,
+  MemorySitesPerShard = 1024,  // Must be power of two
+  MaxMemorySiteProbes = 32
+};
+
+static PMemorySiteInfo s_memorySites[NumMemorySiteShards][MemorySitesPerShard];
+static std::atomic<uint64_t> s_memorySitesDropped;
+static std::atomic<unsigned> s_memorySiteNextShard;
+
+static P_THREAD_LOCAL unsigned t_memorySiteShard;   // Index plus one, zero is unassigned
+static P_THREAD_LOCAL int64_t  t_bytesUntilSample;
+static P_THREAD_LOCAL uint32_t t_sampleRandom;
+
+
+static uint64_t MemorySiteKey(const char * file, unsigned line, const char * className)
+{
+  uint64_t key = (uint64_t)(uintptr_t)file * 0x9E3779B97F4A7C15ULL;
+  key ^= (key >> 29) + line;
+  key ^= (uint64_t)(uintptr_t)className * 0xC2B2AE3D27D4EB4FULL;
+  key ^= key >> 32;
+  return key != 0 ? key : 1;
+}
+
+
+static PMemorySiteInfo * GetMemorySite(const char * file, unsigned line, const char * className)
+{
+  if (t_memorySiteShard == 0)
+    t_memorySiteShard = s_memorySiteNextShard++ % NumMemorySiteShards + 1;
+
+  PMemorySiteInfo * shard = s_memorySites[t_memorySiteShard-1];
+  uint64_t key = MemorySiteKey(file, line, className);
+
+  for (unsigned probe = 0; probe < MaxMemorySiteProbes; ++probe) {
+    PMemorySiteInfo & site = shard[(key + probe) & (MemorySitesPerShard-1)];
+    uint64_t existing = site.m_key.load(std::memory_order_acquire);
+    if (existing == 0) {
+      if (site.m_key.compare_exchange_strong(existing, key, std::memory_order_acq_rel)) {
+        site.m_fileName = file;
+        site.m_line = line;
+        site.m_className = className;
+        site.m_ready.store(true, std::memory_order_release);
+        return &site;
+      }
+    }
+    if (existing == key)
+      return &site;
+  }
+
+  return NULL;
+}
+
+
+static void UpdateMemorySite(const char * file, unsigned line, const char * className, size_t size, size_t weight, bool allocated)
+{
+  PMemorySiteInfo * site = GetMemorySite(file, line, className);
+  if (site == NULL) {
+    if (allocated)
+      ++s_memorySitesDropped;
+    return;
+  }
+
+  int64_t objects = weight / std::max(size, (size_t)1);
+  if (allocated) {
+    site->m_allocations.fetch_add(objects, std::memory_order_relaxed);
+    site->m_allocatedBytes.fetch_add(weight, std::memory_order_relaxed);
+    site->m_liveObjects.fetch_add(objects, std::memory_order_relaxed);
+    site->m_liveBytes.fetch_add(weight, std::memory_order_relaxed);
+  }
+  else {
+    site->m_liveObjects.fetch_sub(objects, std::memory_order_relaxed);
+    site->m_liveBytes.fetch_sub(weight, std::memory_order_relaxed);
+  }
+}
+
+
 PMemoryHeap & PMemoryHeap::GetInstance()
 {
   // The following is done like this to get over brain dead compilers that cannot
@@ -460,6 +558,7 @@ PMemoryHeap::PMemoryHeap()
   , m_flags(NoLeakPrint)
   , m_allocFillChar('\xCD') // Microsoft debug heap values
   , m_freeFillChar('\xDD')
+  , m_sampleInterval(0)
   , m_currentMemoryUsage(0)
   , m_peakMemoryUsage(0)
   , m_currentObjects(0)
@@ -482,6 +581,9 @@ PMemoryHeap::PMemoryHeap()
       break;
   }
 
+  if ((env = getenv("PTLIB_MEMORY_SAMPLE")) != NULL)
+    m_sampleInterval = strtoul(env, NULL, 10);
+
   for (PINDEX i = 0; i < Header::NumGuardBytes; i++)
     Header::GuardBytes[i] = '\xFD';
 
@@ -577,42 +679,6 @@ void * PMemoryHeap::InternalAllocate(size_t nSize, const char * file, int line,
     return NULL;
   }
 
-  Lock();
-
-  if (m_allocationBreakpoint != 0 && m_allocationRequest == m_allocationBreakpoint)
-    PBreakToDebugger();
-
-  // Ignore all allocations made before main() is called. This is indicated
-  // by PProcess::PreInitialise() clearing the NoLeakPrint flag. Why do we do
-  // this? because the GNU compiler is broken in the way it does static global
-  // C++ object construction and destruction.
-  if (m_firstRealObject == 0 && (m_flags&NoLeakPrint) == 0) {
-    if (m_leakDumpStream != NULL)
-      *m_leakDumpStream << "PTLib memory checking activated." << endl;
-    m_firstRealObject = m_allocationRequest;
-  }
-
-  m_currentMemoryUsage += nSize;
-  if (m_currentMemoryUsage > m_peakMemoryUsage)
-    m_peakMemoryUsage = m_currentMemoryUsage;
-
-  m_currentObjects++;
-  if (m_currentObjects > m_peakObjects)
-    m_peakObjects = m_currentObjects;
-  m_totalObjects++;
-
-  obj->m_request = m_allocationRequest++;
-
-  obj->m_prev = m_listTail;
-  if (m_listTail != NULL)
-    m_listTail->m_next = obj;
-  m_listTail = obj;
-  if (m_listHead == NULL)
-    m_listHead = obj;
-  obj->m_next = NULL;
-
-  Unlock();
-
   obj->m_size      = nSize;
   obj->m_fileName  = file;
   obj->m_line      = (WORD)line;
@@ -620,6 +686,16 @@ void * PMemoryHeap::InternalAllocate(size_t nSize, const char * file, int line,
   obj->m_className = className;
   obj->m_flags     = m_flags;
 
+  size_t weight = GetSampleWeight(nSize);
+  if (weight != 0)
+    TrackBlock(obj, weight);
+  else {
+    obj->m_weight  = 0;
+    obj->m_request = 0;
+    obj->m_prev    = NULL;
+    obj->m_next    = NULL;
+  }
+
   char * data = (char *)&obj[1];
 
   if (m_state == e_Active) {
@@ -634,61 +710,53 @@ void * PMemoryHeap::InternalAllocate(size_t nSize, const char * file, int line,
 }
 
 
-void * PMemoryHeap::Reallocate(void * ptr, size_t nSize, const char * file, int line)
+void * PMemoryHeap::Reallocate(void * ptr, size_t nSize, const char * file, int line, const char * className)
 {
-  return GetInstance().InternalReallocate(ptr, nSize, file, line);
+  return GetInstance().InternalReallocate(ptr, nSize, file, line, className);
 }
 
 
-void * PMemoryHeap::InternalReallocate(void * ptr, size_t nSize, const char * file, int line)
+void * PMemoryHeap::InternalReallocate(void * ptr, size_t nSize, const char * file, int line, const char * className)
 {
   if (m_state <= e_Disabled)
     return realloc(ptr, nSize);
 
   if (ptr == NULL)
-    return Allocate(nSize, file, line, NULL);
+    return Allocate(nSize, file, line, className);
 
   if (nSize == 0) {
-    Deallocate(ptr, NULL);
+    Deallocate(ptr, className);
     return NULL;
   }
 
-  if (InternalValidate(ptr, NULL, m_leakDumpStream) != Ok)
+  if (InternalValidate(ptr, className, m_leakDumpStream) != Ok)
     return NULL;
 
-  Header * obj = (Header *)realloc(((Header *)ptr)-1, sizeof(Header) + nSize + sizeof(obj->m_guard));
+  // Take it out of the list before realloc() moves it, put back afterwards
+  Header * obj = ((Header *)ptr)-1;
+  if (obj->m_weight != 0)
+    UntrackBlock(obj);
+
+  obj = (Header *)realloc(obj, sizeof(Header) + nSize + sizeof(obj->m_guard));
   if (obj == NULL) {
     PAssertAlways(POutOfMemory);
     return NULL;
   }
 
-  Lock();
-
-  if (m_allocationBreakpoint != 0 && m_allocationRequest == m_allocationBreakpoint)
-    PBreakToDebugger();
-
-  m_currentMemoryUsage -= obj->m_size;
-  m_currentMemoryUsage += nSize;
-  if (m_currentMemoryUsage > m_peakMemoryUsage)
-    m_peakMemoryUsage = m_currentMemoryUsage;
-
-  obj->m_request = m_allocationRequest++;
-
-  if (obj->m_prev != NULL)
-    obj->m_prev->m_next = obj;
-  else
-    m_listHead = obj;
-  if (obj->m_next != NULL)
-    obj->m_next->m_prev = obj;
-  else
-    m_listTail = obj;
-
-  Unlock();
-
   obj->m_size     = nSize;
   obj->m_fileName = file;
   obj->m_line     = (WORD)line;
 
+  size_t weight = GetSampleWeight(nSize);
+  if (weight != 0)
+    TrackBlock(obj, weight);
+  else {
+    obj->m_weight  = 0;
+    obj->m_request = 0;
+    obj->m_prev    = NULL;
+    obj->m_next    = NULL;
+  }
+
   char * data = (char *)&obj[1];
 
   if (m_state == e_Active)
@@ -728,6 +796,90 @@ void PMemoryHeap::InternalDeallocate(void * ptr, const char * className)
       break;
   }
 
+  if (obj->m_weight != 0)
+    UntrackBlock(obj);
+
+  if (m_state == e_Active)
+    memset(ptr, m_freeFillChar, obj->m_size);  // Make use of freed data noticable
+
+  free(obj);
+}
+
+
+size_t PMemoryHeap::GetSampleWeight(size_t nSize)
+{
+  size_t interval = m_sampleInterval;
+  if (interval == 0)
+    return std::max(nSize, (size_t)1);
+
+  t_bytesUntilSample -= nSize;
+  if (t_bytesUntilSample > 0)
+    return 0;
+
+  /* Randomise the next sample point between half and one and a half times
+     the interval, so allocation patterns that repeat with the same period
+     as the interval do not always, or never, get sampled. */
+  if (t_sampleRandom == 0)
+    t_sampleRandom = (uint32_t)(uintptr_t)&t_sampleRandom | 1;
+  t_sampleRandom ^= t_sampleRandom << 13;
+  t_sampleRandom ^= t_sampleRandom >> 17;
+  t_sampleRandom ^= t_sampleRandom << 5;
+  t_bytesUntilSample = interval/2 + t_sampleRandom%(interval+1);
+
+  // A sampled block stands for all the bytes allocated since the last one
+  return std::max(nSize, interval);
+}
+
+
+void PMemoryHeap::TrackBlock(Header * obj, size_t weight)
+{
+  obj->m_weight = weight;
+  alloc_t objects = (alloc_t)(weight / std::max(obj->m_size, (size_t)1));
+
+  Lock();
+
+  if (m_allocationBreakpoint != 0 && m_allocationRequest == m_allocationBreakpoint)
+    PBreakToDebugger();
+
+  // Ignore all allocations made before main() is called. This is indicated
+  // by PProcess::PreInitialise() clearing the NoLeakPrint flag. Why do we do
+  // this? because the GNU compiler is broken in the way it does static global
+  // C++ object construction and destruction.
+  if (m_firstRealObject == 0 && (m_flags&NoLeakPrint) == 0) {
+    if (m_leakDumpStream != NULL)
+      *m_leakDumpStream << "PTLib memory checking activated." << endl;
+    m_firstRealObject = m_allocationRequest;
+  }
+
+  m_currentMemoryUsage += weight;
+  if (m_currentMemoryUsage > m_peakMemoryUsage)
+    m_peakMemoryUsage = m_currentMemoryUsage;
+
+  m_currentObjects += objects;
+  if (m_currentObjects > m_peakObjects)
+    m_peakObjects = m_currentObjects;
+  m_totalObjects += objects;
+
+  obj->m_request = m_allocationRequest++;
+
+  obj->m_prev = m_listTail;
+  if (m_listTail != NULL)
+    m_listTail->m_next = obj;
+  m_listTail = obj;
+  if (m_listHead == NULL)
+    m_listHead = obj;
+  obj->m_next = NULL;
+
+  Unlock();
+
+  UpdateMemorySite(obj->m_fileName, obj->m_line, obj->m_className, obj->m_size, weight, true);
+}
+
+
+void PMemoryHeap::UntrackBlock(Header * obj)
+{
+  alloc_t objects = (alloc_t)(obj->m_weight / std::max(obj->m_size, (size_t)1));
+
   Lock();
 
   if (obj->m_prev != NULL)
@@ -739,15 +891,17 @@ void PMemoryHeap::InternalDeallocate(void * ptr, const char * className)
   else
     m_listTail = obj->m_prev;
 
-  m_currentMemoryUsage -= obj->m_size;
-  m_currentObjects--;
+  m_currentMemoryUsage -= obj->m_weight;
+  m_currentObjects -= objects;
 
   Unlock();
 
-  if (m_state == e_Active)
-    memset(ptr, m_freeFillChar, obj->m_size);  // Make use of freed data noticable
+  UpdateMemorySite(obj->m_fileName, obj->m_line, obj->m_className, obj->m_size, obj->m_weight, false);
 
-  free(obj);
+  // No longer in the list, so never untracked again, e.g. if realloc() fails
+  obj->m_weight = 0;
+  obj->m_prev   = NULL;
+  obj->m_next   = NULL;
 }
 
 
@@ -778,7 +932,8 @@ PMemoryHeap::Validation PMemoryHeap::InternalValidate(const void * ptr,
   Header * obj = ((Header *)ptr) - 1;
   Header * link = obj;
 
-  if (m_state == e_Active) {
+  // Untracked blocks, when sampling, are not in the list to be found
+  if (m_state == e_Active && obj->m_weight != 0) {
     Lock();
 
     unsigned count = m_currentObjects;
@@ -941,8 +1096,10 @@ void PMemoryHeap::InternalDumpStatistics(ostream & strm)
 {
   Lock();
 
-  strm << "\n"
-          "Current memory usage     : ";
+  strm << "\n";
+  if (m_sampleInterval != 0)
+    strm << "Sampling interval        : " << m_sampleInterval << " bytes, usage is estimated\n";
+  strm << "Current memory usage     : ";
   OutputMemory(strm, m_currentMemoryUsage);
   strm << "\n"
           "Current objects count    : " << m_currentObjects << "\n"
@@ -955,6 +1112,120 @@ void PMemoryHeap::InternalDumpStatistics(ostream & strm)
        << endl;
 
   Unlock();
+
+  InternalDumpAllocationSites(strm, 20);
+}
+
+
+size_t PMemoryHeap::SetSampleInterval(size_t bytes)
+{
+  PMemoryHeap & mem = GetInstance();
+  size_t previous = mem.m_sampleInterval;
+  mem.m_sampleInterval = bytes;
+  return previous;
+}
+
+
+void PMemoryHeap::DumpAllocationSites(ostream & strm, unsigned maxSites)
+{
+  GetInstance().InternalDumpAllocationSites(strm, maxSites);
+}
+
+
+struct PMemorySiteSummary
+{
+  uint64_t     m_key;
+  const char * m_fileName;
+  const char * m_className;
+  unsigned     m_line;
+  uint64_t     m_allocations;
+  uint64_t     m_allocatedBytes;
+  int64_t      m_liveObjects;
+  int64_t      m_liveBytes;
+
+  bool operator<(const PMemorySiteSummary & other) const { return m_key < other.m_key; }
+};
+
+static bool MoreLiveBytes(const PMemorySiteSummary & first, const PMemorySiteSummary & second)
+{
+  return first.m_liveBytes > second.m_liveBytes;
+}
+
+
+void PMemoryHeap::InternalDumpAllocationSites(ostream & strm, unsigned maxSites)
+{
+  // Disable tracking of our own temporary storage
+  PBoolean ignoreAllocations = SetIgnoreAllocations(true);
+
+  std::vector<PMemorySiteSummary> sites;
+  for (unsigned shard = 0; shard < NumMemorySiteShards; ++shard) {
+    for (unsigned index = 0; index < MemorySitesPerShard; ++index) {
+      PMemorySiteInfo & info = s_memorySites[shard][index];
+      if (!info.m_ready.load(std::memory_order_acquire))
+        continue;
+
+      PMemorySiteSummary summary;
+      summary.m_key = info.m_key.load(std::memory_order_relaxed);
+      summary.m_fileName = info.m_fileName;
+      summary.m_className = info.m_className;
+      summary.m_line = info.m_line;
+      summary.m_allocations = info.m_allocations.load(std::memory_order_relaxed);
+      summary.m_allocatedBytes = info.m_allocatedBytes.load(std::memory_order_relaxed);
+      summary.m_liveObjects = info.m_liveObjects.load(std::memory_order_relaxed);
+      summary.m_liveBytes = info.m_liveBytes.load(std::memory_order_relaxed);
+      sites.push_back(summary);
+    }
+  }
+
+  // Merge the same site from different shards
+  std::sort(sites.begin(), sites.end());
+  size_t merged = 0;
+  for (size_t i = 0; i < sites.size(); ++i) {
+    if (merged > 0 && sites[merged-1].m_key == sites[i].m_key) {
+      PMemorySiteSummary & site = sites[merged-1];
+      site.m_allocations += sites[i].m_allocations;
+      site.m_allocatedBytes += sites[i].m_allocatedBytes;
+      site.m_liveObjects += sites[i].m_liveObjects;
+      site.m_liveBytes += sites[i].m_liveBytes;
+    }
+    else
+      sites[merged++] = sites[i];
+  }
+  sites.resize(merged);
+
+  std::sort(sites.begin(), sites.end(), MoreLiveBytes);
+  if (sites.size() > maxSites)
+    sites.resize(maxSites);
+
+  std::ios::fmtflags flags = strm.flags();
+  strm << "Top allocation sites:\n"
+       << right << setw(12) << "Live bytes"
+       << setw(10) << "Objects"
+       << setw(14) << "Total bytes"
+       << setw(12) << "Allocations"
+       << "  Location\n";
+  for (std::vector<PMemorySiteSummary>::iterator it = sites.begin(); it != sites.end(); ++it) {
+    strm << setw(12) << it->m_liveBytes
+         << setw(10) << it->m_liveObjects
+         << setw(14) << it->m_allocatedBytes
+         << setw(12) << it->m_allocations
+         << "  ";
+    if (it->m_fileName != NULL)
+      strm << it->m_fileName << '(' << it->m_line << ')';
+    else
+      strm << "<unknown>";
+    if (it->m_className != NULL)
+      strm << " class=\"" << it->m_className << '"';
+    strm << '\n';
+  }
+
+  uint64_t dropped = s_memorySitesDropped.load(std::memory_order_relaxed);
+  if (dropped > 0)
+    strm << "Allocations from untracked sites: " << dropped << '\n';
+  strm << endl;
+  strm.flags(flags);
+
+  SetIgnoreAllocations(ignoreAllocations);
 }
 
 
@@ -1084,10 +1355,10 @@ void * PMemoryHeap::Allocate(size_t count, size_t iSize, const char * file, int
 }
 
 
-void * PMemoryHeap::Reallocate(void * ptr, size_t nSize, const char * file, int line)
+void * PMemoryHeap::Reallocate(void * ptr, size_t nSize, const char * file, int line, const char * className)
 {
   CreateInstance();
-  return _realloc_dbg(ptr, nSize, _NORMAL_BLOCK, file, line);
+  return _realloc_dbg(ptr, nSize, className != NULL ? P_CLIENT_BLOCK : _NORMAL_BLOCK, file, line);
 }
 
 
@@ -1145,6 +1416,17 @@ void PMemoryHeap::DumpStatistics(ostream & /*strm*/)
 }
 
 
+size_t PMemoryHeap::SetSampleInterval(size_t /*bytes*/)
+{
+  return 0; // The MSVC debug heap always tracks everything
+}
+
+
+void PMemoryHeap::DumpAllocationSites(ostream & /*strm*/, unsigned /*maxSites*/)
+{
+}
+
+
 void PMemoryHeap::GetState(State & state)
 {
   CreateInstance();
@@ -1518,17 +1800,12 @@ namespace PProfiling
     e_SystemExit
   };
 
-  struct FunctionRawData
-  {
-    PPROFILE_EXCLUDE(FunctionRawData(FunctionType type, void * function, void * caller));
-    PPROFILE_EXCLUDE(FunctionRawData(FunctionType type, const PDebugLocation * location));
-
-    PPROFILE_EXCLUDE(void Dump(ostream & out) const);
+  inline static bool IsEntry(FunctionType type) { return (type&1) == 0; }
 
-    // Do not use memory check allocation
-    PPROFILE_EXCLUDE(void * operator new(size_t nSize));
-    PPROFILE_EXCLUDE(void operator delete(void * ptr));
 
+  // Fixed size record, written into the per thread ring buffer
+  struct FunctionRawData
+  {
     union
     {
       // Note for correct operation m_pointer must overlay m_name
@@ -1545,15 +1822,31 @@ namespace PProfiling
       };
     } m_function;
 
-    FunctionType            m_type;
+    FunctionType m_type;
+    uint64_t     m_when;
+
+    PPROFILE_EXCLUDE(std::string GetName() const);
+    PPROFILE_EXCLUDE(void Dump(ostream & out, PUniqueThreadIdentifier uniqueId) const);
+  };
+
+
+  /* Each thread has its own ring buffer of records, so recording an event is
+     a few stores and no allocation, lock or shared cache line. The buffers are
+     linked together so Analyse() can find them, and are never freed while the
+     process is running. Instead, the buffer of a thread that has ended is
+     reused by a new thread, once its contents have been cleared by Reset(). */
+  struct ThreadBuffer
+  {
     PThreadIdentifier       m_threadIdentifier;
     PUniqueThreadIdentifier m_threadUniqueId;
-    uint64_t                m_when;
-    FunctionRawData       * m_link;
-
-  private:
-    FunctionRawData(const FunctionRawData &) { }
-    void operator=(const FunctionRawData &) { }
+    atomic<uint64_t>        m_written;     // Total records ever written
+    atomic<uint64_t>        m_resetPoint;  // Value of m_written at last Reset()
+    atomic<bool>            m_ended;
+    ThreadBuffer          * m_link;
+    size_t                  m_mask;
+    FunctionRawData         m_records[1];  // Actually m_mask+1 entries
+
+    PPROFILE_EXCLUDE(uint64_t GetFirst() const);
   };
 
 
@@ -1585,61 +1878,40 @@ namespace PProfiling
     PPROFILE_EXCLUDE(~Database());
 
     bool     m_enabled;
-    atomic<FunctionRawData *> m_functions;
-    atomic<ThreadRawData *>   m_threads;
+    size_t   m_bufferSize;
+    atomic<ThreadBuffer *>  m_buffers;
+    atomic<ThreadRawData *> m_threads;
     uint64_t m_start;
   };
   static Database s_database;
 
+  static P_THREAD_LOCAL ThreadBuffer * t_threadBuffer;
+  static P_THREAD_LOCAL bool           t_threadExited;
+  static P_THREAD_LOCAL bool           t_recording;
+
 
   /////////////////////////////////////////////////////////////////////
 
-  FunctionRawData::FunctionRawData(FunctionType type, void * function, void * caller)
-    : m_type(type)
-    , m_threadIdentifier(PThread::GetCurrentThreadId())
-    , m_threadUniqueId(PThread::GetCurrentUniqueIdentifier())
-    , m_when(GetCycles())
+  std::string FunctionRawData::GetName() const
   {
-    m_function.m_pointer = function;
-    m_function.m_caller = caller;
-
-    m_link = s_database.m_functions.exchange(this);
-  }
+    switch (m_type) {
+      case e_ManualEntry :
+      case e_ManualExit :
+        return m_function.m_name != NULL ? m_function.m_name : "<unknown>";
 
+      case e_SystemEntry :
+      case e_SystemExit :
+        return "[system]";
 
-  FunctionRawData::FunctionRawData(FunctionType type, const PDebugLocation * location)
-    : m_type(type)
-    , m_threadIdentifier(PThread::GetCurrentThreadId())
-    , m_threadUniqueId(PThread::GetCurrentUniqueIdentifier())
-    , m_when(GetCycles())
-  {
-    if (location) {
-      m_function.m_name = location->m_extra;
-      m_function.m_file = location->m_file;
-      m_function.m_line = location->m_line;
-    }
-    else {
-      m_function.m_name = NULL;
-      m_function.m_file = NULL;
-      m_function.m_line = 0;
+      default :
+        stringstream strm;
+        strm << m_function.m_pointer;
+        return strm.str();
     }
-
-    m_link = s_database.m_functions.exchange(this);
-  }
-
-
-  void * FunctionRawData::operator new(size_t nSize)
-  {
-    return runtime_malloc(nSize);
-
-  }
-  void FunctionRawData::operator delete(void * ptr)
-  {
-    runtime_free(ptr);
   }
 
 
-   void FunctionRawData::Dump(ostream & out) const
+  void FunctionRawData::Dump(ostream & out, PUniqueThreadIdentifier uniqueId) const
   {
     switch (m_type) {
       case e_AutoEntry:
@@ -1649,16 +1921,172 @@ namespace PProfiling
         out << "AutoExit\t" << m_function.m_pointer << '\t' << m_function.m_caller;
         break;
       case e_ManualEntry:
-        out << "ManualEnter\t" << m_function.m_name << '\t' << m_function.m_file << '(' << m_function.m_line << ')';
+        out << "ManualEnter\t" << GetName() << '\t' << m_function.m_file << '(' << m_function.m_line << ')';
         break;
       case e_ManualExit:
-        out << "ManualExit\t" << m_function.m_name << '\t';
+        out << "ManualExit\t" << GetName() << '\t';
+        break;
+      case e_SystemEntry:
+        out << "SystemEnter\t\t";
+        break;
+      case e_SystemExit:
+        out << "SystemExit\t\t";
         break;
       default :
         PAssertAlways(PLogicError);
     }
 
-    out << '\t' << m_threadUniqueId << '\t' << m_when << '\n';
+    out << '\t' << uniqueId << '\t' << m_when << '\n';
+  }
+
+
+  /////////////////////////////////////////////////////////////////////
+
+  uint64_t ThreadBuffer::GetFirst() const
+  {
+    uint64_t written = m_written.load(memory_order_acquire);
+    uint64_t first = m_resetPoint.load(memory_order_relaxed);
+    if (written - first > m_mask)
+      first = written - m_mask; // Wrapped, oldest records overwritten, skip slot about to be written
+    return first;
+  }
+
+
+  // Marks the buffer as reusable when a thread exits
+  struct ThreadBufferReaper
+  {
+    PPROFILE_EXCLUDE(~ThreadBufferReaper());
+  };
+
+  ThreadBufferReaper::~ThreadBufferReaper()
+  {
+    t_threadExited = true;
+    if (t_threadBuffer != NULL) {
+      t_threadBuffer->m_ended.store(true, memory_order_release);
+      t_threadBuffer = NULL;
+    }
+  }
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+  static thread_local ThreadBufferReaper t_threadBufferReaper;
+#endif
+
+
+  PPROFILE_EXCLUDE(static ThreadBuffer * GetThreadBuffer());
+
+  static ThreadBuffer * GetThreadBuffer()
+  {
+    if (t_threadExited)
+      return NULL;
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+    (void)&t_threadBufferReaper; // Make sure it is constructed, so destructor is called
+#endif
+
+    PThreadIdentifier threadId = PThread::GetCurrentThreadId();
+    PUniqueThreadIdentifier uniqueId = PThread::GetCurrentUniqueIdentifier();
+
+    // Reuse the buffer of an ended thread, if it has nothing left in it to analyse
+    ThreadBuffer * buffer;
+    for (buffer = s_database.m_buffers; buffer != NULL; buffer = buffer->m_link) {
+      if (buffer->m_written.load(memory_order_acquire) != buffer->m_resetPoint.load(memory_order_acquire))
+        continue;
+      bool ended = true;
+      if (buffer->m_ended.compare_exchange_strong(ended, false))
+        break;
+    }
+
+    if (buffer == NULL) {
+      size_t bytes = sizeof(ThreadBuffer) + (s_database.m_bufferSize-1)*sizeof(FunctionRawData);
+      buffer = (ThreadBuffer *)runtime_malloc(bytes);
+      if (buffer == NULL)
+        return NULL;
+
+      // Touch every page now, rather than distort timing of the first events recorded
+      memset(buffer->m_records, 0, s_database.m_bufferSize*sizeof(FunctionRawData));
+      buffer->m_written = 0;
+      buffer->m_resetPoint = 0;
+      buffer->m_ended = false;
+      buffer->m_mask = s_database.m_bufferSize-1;
+      buffer->m_link = s_database.m_buffers.load();
+      while (!s_database.m_buffers.compare_exchange_weak(buffer->m_link, buffer))
+        ;
+    }
+
+    buffer->m_threadIdentifier = threadId;
+    buffer->m_threadUniqueId = uniqueId;
+    return t_threadBuffer = buffer;
+  }
+
+
+  PPROFILE_EXCLUDE(static FunctionRawData * AddRecord(FunctionType type));
+
+  static FunctionRawData * AddRecord(FunctionType type)
+  {
+    ThreadBuffer * buffer = t_threadBuffer;
+    if (buffer == NULL && (buffer = GetThreadBuffer()) == NULL)
+      return NULL;
+
+    uint64_t index = buffer->m_written.load(memory_order_relaxed);
+    FunctionRawData * record = &buffer->m_records[index & buffer->m_mask];
+    record->m_type = type;
+    record->m_when = GetCycles();
+    return record;
+  }
+
+
+  PPROFILE_EXCLUDE(static void CommitRecord());
+
+  static void CommitRecord()
+  {
+    t_threadBuffer->m_written.fetch_add(1, memory_order_release);
+  }
+
+
+  PPROFILE_EXCLUDE(static void RecordEvent(FunctionType type, const PDebugLocation * location));
+
+  static void RecordEvent(FunctionType type, const PDebugLocation * location)
+  {
+    // Things called from here may be instrumented too, avoid recursion
+    if (t_recording)
+      return;
+    t_recording = true;
+
+    FunctionRawData * record = AddRecord(type);
+    if (record != NULL) {
+      if (location) {
+        record->m_function.m_name = location->m_extra;
+        record->m_function.m_file = location->m_file;
+        record->m_function.m_line = location->m_line;
+      }
+      else {
+        record->m_function.m_name = NULL;
+        record->m_function.m_file = NULL;
+        record->m_function.m_line = 0;
+      }
+      CommitRecord();
+    }
+
+    t_recording = false;
+  }
+
+
+  PPROFILE_EXCLUDE(void RecordAutoEvent(FunctionType type, void * function, void * caller));
+
+  void RecordAutoEvent(FunctionType type, void * function, void * caller)
+  {
+    if (t_recording)
+      return;
+    t_recording = true;
+
+    FunctionRawData * record = AddRecord(type);
+    if (record != NULL) {
+      record->m_function.m_pointer = function;
+      record->m_function.m_caller = caller;
+      CommitRecord();
+    }
+
+    t_recording = false;
   }
 
 
@@ -1712,14 +2140,14 @@ namespace PProfiling
     : m_location(location)
   {
     if (s_database.m_enabled)
-      new FunctionRawData(e_ManualEntry, &location);
+      RecordEvent(e_ManualEntry, &location);
   }
 
 
   Block::~Block()
   {
     if (s_database.m_enabled)
-      new FunctionRawData(e_ManualExit, &m_location);
+      RecordEvent(e_ManualExit, &m_location);
   }
 
 
@@ -1727,16 +2155,34 @@ namespace PProfiling
 
   Database::Database()
     : m_enabled(getenv("PTLIB_PROFILING_ENABLED") != NULL)
-    , m_functions(NULL)
+    , m_bufferSize(65536)
+    , m_buffers(NULL)
     , m_threads(NULL)
     , m_start(GetCycles())
   {
+    const char * env = getenv("PTLIB_PROFILING_BUFFER_SIZE");
+    if (env != NULL) {
+      size_t records = strtoul(env, NULL, 10);
+      if (records > 0) {
+        // Ring buffer index is a mask, so must be power of two
+        m_bufferSize = 1;
+        while (m_bufferSize < records)
+          m_bufferSize <<= 1;
+      }
+    }
   }
 
 
   Database::~Database()
   {
-    if (static_cast<FunctionRawData *>(m_functions) == NULL)
+    m_enabled = false;
+
+    bool anything = false;
+    for (ThreadBuffer * buffer = m_buffers; buffer != NULL; buffer = buffer->m_link) {
+      if (buffer->m_written != buffer->m_resetPoint)
+        anything = true;
+    }
+    if (!anything)
       return;
 
     const char * filename;
@@ -1749,11 +2195,18 @@ namespace PProfiling
 
     if ((filename = getenv("PTLIB_PROFILING_FILENAME")) != NULL) {
       ofstream out(filename, ios::out | ios::trunc);
-      if (out.is_open())
-        Analyse(out, strstr(filename, ".html") != NULL);
+      if (out.is_open()) {
+        if (strstr(filename, ".json") != NULL)
+          ToChromeTrace(out);
+        else if (strstr(filename, ".folded") != NULL)
+          ToFoldedStacks(out);
+        else
+          Analyse(out, strstr(filename, ".html") != NULL);
+      }
     }
 
-    Reset();
+    /* Do not free the ring buffers, other threads may still be running
+       during static destruction, and could be recording into them. */
   }
 
 
@@ -1773,13 +2226,9 @@ namespace PProfiling
   {
     s_database.m_start = GetCycles();
     ThreadRawData * thrd = s_database.m_threads.exchange(NULL);
-    FunctionRawData * func = s_database.m_functions.exchange(NULL);
 
-    while (func != NULL) {
-      FunctionRawData * del = func;
-      func = func->m_link;
-      delete del;
-    }
+    for (ThreadBuffer * buffer = s_database.m_buffers; buffer != NULL; buffer = buffer->m_link)
+      buffer->m_resetPoint.store(buffer->m_written.load(memory_order_acquire), memory_order_release);
 
     while (thrd != NULL) {
       ThreadRawData * del = thrd;
@@ -1792,14 +2241,14 @@ namespace PProfiling
   void PreSystem()
   {
     if (s_database.m_enabled)
-      new FunctionRawData(e_SystemEntry, NULL);
+      RecordEvent(e_SystemEntry, NULL);
   }
 
 
   void PostSystem()
   {
     if (s_database.m_enabled)
-      new FunctionRawData(e_SystemExit, NULL);
+      RecordEvent(e_SystemExit, NULL);
   }
 
 
@@ -1807,8 +2256,11 @@ namespace PProfiling
   {
     for (ThreadRawData * info = s_database.m_threads; info != NULL; info = info->m_link)
       info->Dump(strm);
-    for (FunctionRawData * info = s_database.m_functions; info != NULL; info = info->m_link)
-      info->Dump(strm);
+    for (ThreadBuffer * buffer = s_database.m_buffers; buffer != NULL; buffer = buffer->m_link) {
+      uint64_t written = buffer->m_written.load(memory_order_acquire);
+      for (uint64_t index = buffer->GetFirst(); index < written; ++index)
+        buffer->m_records[index & buffer->m_mask].Dump(strm, buffer->m_threadUniqueId);
+    }
   }
 
 
@@ -2044,82 +2496,127 @@ namespace PProfiling
     return threadByID.insert(make_pair(times.m_uniqueId, threadInfo)).first;
   }
 
-  void Analyse(Analysis & analysis)
-  {
-    analysis.m_durationCycles = GetCycles() - s_database.m_start;
 
+  static void GetThreads(ThreadByID & threadByID)
+  {
     std::list<PThread::Times> times;
     PThread::GetTimes(times);
     for (std::list<PThread::Times>::iterator it = times.begin(); it != times.end(); ++it)
-      AddThreadByID(analysis.m_threadByID, *it);
+      AddThreadByID(threadByID, *it);
 
     for (ThreadRawData * thrd = s_database.m_threads; thrd != NULL; thrd = thrd->m_link)
-      analysis.m_threadByID.insert(make_pair(thrd->m_uniqueId, *thrd));
-
-    for (FunctionRawData * exit = s_database.m_functions; exit != NULL; exit = exit->m_link) {
-      std::string functionName;
-      switch (exit->m_type) {
-        default :
-          continue;
-
-        case e_ManualExit:
-          functionName = exit->m_function.m_name;
-          break;
-
-        case e_AutoExit:
-          stringstream strm;
-          strm << exit->m_function.m_pointer;
-          functionName = strm.str();
-          break;
-      }
+      threadByID.insert(make_pair(thrd->m_uniqueId, *thrd));
+  }
 
-      uint64_t subFunctionAccumulator = 0;
 
-      // Find the next entry in that thread
-      FunctionRawData * entry;
-      for (entry = exit->m_link; entry != NULL; entry = entry->m_link) {
-        if (entry->m_threadUniqueId != exit->m_threadUniqueId)
-          continue;
+  static ThreadByID::iterator GetThread(ThreadByID & threadByID, const ThreadBuffer & buffer)
+  {
+    ThreadByID::iterator thrd = threadByID.find(buffer.m_threadUniqueId);
+    if (thrd == threadByID.end()) {
+      PThread::Times threadTimes;
+      PThread::GetTimes(buffer.m_threadIdentifier, threadTimes);
+      threadTimes.m_uniqueId = buffer.m_threadUniqueId;
+      thrd = AddThreadByID(threadByID, threadTimes);
+    }
+    return thrd;
+  }
 
-        switch (entry->m_type) {
-          case e_ManualEntry :
-          case e_AutoEntry:
-          case e_SystemEntry :
-            if (entry->m_function.m_pointer == exit->m_function.m_pointer)
-              break;
-            continue; // Should not happen!
 
-          default :
-            // Have an exit, so look for matching entry
-            FunctionRawData * subEntry;
-            for (subEntry = entry->m_link; subEntry != NULL; subEntry = subEntry->m_link) {
-              if (subEntry->m_threadUniqueId == entry->m_threadUniqueId && subEntry->m_function.m_pointer == entry->m_function.m_pointer)
-                break;
-            }
-            if (subEntry == NULL)
-              continue; // Should not happen!
+  /* Pairs up the entry and exit records in each threads ring buffer, oldest
+     first, calling OnFrame() for each completed call. The current call is at
+     the top of the stack, with the callers below it. Records that lost their
+     partner when the ring buffer wrapped are ignored. */
+  class FrameWalker
+  {
+    public:
+      struct Frame
+      {
+        const FunctionRawData * m_entry;
+        uint64_t                m_childCycles;
 
-            // Amount of time in sub-function, subtract it off later
-            subFunctionAccumulator += entry->m_when - subEntry->m_when;
-            entry = subEntry;
+        uint64_t GetSelfCycles(uint64_t exitTime) const { return exitTime - m_entry->m_when - m_childCycles; }
+      };
+      typedef std::vector<Frame> Stack;
+
+      virtual ~FrameWalker() { }
+
+      void Walk()
+      {
+        Stack stack;
+        for (ThreadBuffer * buffer = s_database.m_buffers; buffer != NULL; buffer = buffer->m_link) {
+          uint64_t written = buffer->m_written.load(memory_order_acquire);
+          uint64_t index = buffer->GetFirst();
+          if (index >= written)
             continue;
-        }
 
-        ThreadByID::iterator thrd = analysis.m_threadByID.find(entry->m_threadUniqueId);
-        if (thrd == analysis.m_threadByID.end()) {
-          PThread::Times threadTimes;
-          PThread::GetTimes(entry->m_threadIdentifier, threadTimes);
-          thrd = AddThreadByID(analysis.m_threadByID, threadTimes);
+          OnThread(*buffer);
+          stack.clear();
+
+          for (; index < written; ++index) {
+            const FunctionRawData & record = buffer->m_records[index & buffer->m_mask];
+            if (IsEntry(record.m_type)) {
+              Frame frame = { &record, 0 };
+              stack.push_back(frame);
+              continue;
+            }
+
+            size_t depth = stack.size();
+            while (depth > 0 && (stack[depth-1].m_entry->m_type != record.m_type-1 ||
+                                 stack[depth-1].m_entry->m_function.m_pointer != record.m_function.m_pointer))
+              --depth;
+            if (depth == 0)
+              continue;
+
+            // Discard any calls that never exited, e.g. by longjmp()
+            stack.resize(depth);
+
+            OnFrame(*buffer, stack, record.m_when);
+
+            uint64_t duration = record.m_when - stack.back().m_entry->m_when;
+            stack.pop_back();
+            if (!stack.empty())
+              stack.back().m_childCycles += duration;
+          }
         }
+      }
+
+    protected:
+      virtual void OnThread(const ThreadBuffer & /*buffer*/) { }
+      virtual void OnFrame(const ThreadBuffer & buffer, const Stack & stack, uint64_t exitTime) = 0;
+  };
 
-        FunctionMap & functions = thrd->second.m_functions;
+
+  class FunctionAnalyser : public FrameWalker
+  {
+    public:
+      FunctionAnalyser(Analysis & analysis)
+        : m_analysis(analysis)
+      {
+      }
+
+    protected:
+      virtual void OnThread(const ThreadBuffer & buffer)
+      {
+        m_thread = GetThread(m_analysis.m_threadByID, buffer);
+      }
+
+      virtual void OnFrame(const ThreadBuffer &, const Stack & stack, uint64_t exitTime)
+      {
+        const Frame & frame = stack.back();
+
+        // Time in system calls is excluded from the caller, but not a function itself
+        if (frame.m_entry->m_type == e_SystemEntry)
+          return;
+
+        FunctionMap & functions = m_thread->second.m_functions;
+        std::string functionName = frame.m_entry->GetName();
         FunctionMap::iterator func = functions.find(functionName);
         if (func == functions.end()) {
           func = functions.insert(make_pair(functionName, Function())).first;
-          ++analysis.m_functionCount;
+          ++m_analysis.m_functionCount;
         }
 
-        uint64_t diff = exit->m_when - entry->m_when - subFunctionAccumulator;
+        uint64_t diff = frame.GetSelfCycles(exitTime);
 
         if (func->second.m_minimum > diff)
           func->second.m_minimum = diff;
@@ -2128,9 +2625,21 @@ namespace PProfiling
 
         func->second.m_sum += diff;
         ++func->second.m_count;
-        break;
       }
-    }
+
+      Analysis           & m_analysis;
+      ThreadByID::iterator m_thread;
+  };
+
+
+  void Analyse(Analysis & analysis)
+  {
+    analysis.m_durationCycles = GetCycles() - s_database.m_start;
+
+    GetThreads(analysis.m_threadByID);
+
+    FunctionAnalyser analyser(analysis);
+    analyser.Walk();
 
     for (ThreadByID::iterator thrd = analysis.m_threadByID.begin(); thrd != analysis.m_threadByID.end(); ++thrd)
       analysis.m_threadByUsage.insert(make_pair(Percentage(thrd->second.m_userCPU, thrd->second.m_realTime), thrd->second));
@@ -2148,6 +2657,164 @@ namespace PProfiling
       analysis.ToText(strm);
   }
 
+
+  class EscapedJSON
+  {
+    private:
+      const std::string m_str;
+
+    public:
+      EscapedJSON(const std::string & str)
+        : m_str(str)
+      {
+      }
+
+    friend ostream & operator<<(ostream & strm, const EscapedJSON & e)
+    {
+      strm << '"';
+      for (size_t i = 0; i < e.m_str.length(); ++i) {
+        char c = e.m_str[i];
+        switch (c) {
+          case '"':
+            strm << "\\\"";
+            break;
+          case '\\':
+            strm << "\\\\";
+            break;
+          default:
+            if ((unsigned char)c >= ' ')
+              strm << c;
+            else
+              strm << "\\u00" << hex << setfill('0') << setw(2) << (unsigned)c << dec << setfill(' ');
+        }
+      }
+      return strm << '"';
+    }
+  };
+
+
+  class ChromeTraceWriter : public FrameWalker
+  {
+    public:
+      ChromeTraceWriter(ostream & strm)
+        : m_strm(strm)
+        , m_processId(PProcess::GetCurrentProcessID())
+      {
+        GetThreads(m_threads);
+        m_strm << fixed << setprecision(3) << "{\"traceEvents\":[\n"
+               << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << m_processId << ",\"tid\":0,\"args\":{\"name\":"
+               << EscapedJSON(PProcess::IsInitialised() ? (const char *)PProcess::Current().GetName() : "PTLib") << "}}";
+      }
+
+      ~ChromeTraceWriter()
+      {
+        m_strm << "\n],\"displayTimeUnit\":\"ns\"}\n";
+      }
+
+    protected:
+      virtual void OnThread(const ThreadBuffer & buffer)
+      {
+        m_strm << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << m_processId
+               << ",\"tid\":" << buffer.m_threadUniqueId
+               << ",\"args\":{\"name\":" << EscapedJSON(GetThread(m_threads, buffer)->second.m_name) << "}}";
+      }
+
+      virtual void OnFrame(const ThreadBuffer & buffer, const Stack & stack, uint64_t exitTime)
+      {
+        const FunctionRawData & entry = *stack.back().m_entry;
+        const char * category;
+        switch (entry.m_type) {
+          case e_ManualEntry :
+            category = "manual";
+            break;
+          case e_SystemEntry :
+            category = "system";
+            break;
+          default :
+            category = "auto";
+        }
+
+        // Chrome trace times are in microseconds, relative to profile start
+        int64_t start = (int64_t)(entry.m_when - s_database.m_start);
+        m_strm << ",\n{\"name\":" << EscapedJSON(entry.GetName())
+               << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":" << m_processId
+               << ",\"tid\":" << buffer.m_threadUniqueId
+               << ",\"ts\":" << (start < 0 ? -CyclesToNanoseconds(-start) : CyclesToNanoseconds(start))/1000.0
+               << ",\"dur\":" << CyclesToNanoseconds(exitTime - entry.m_when)/1000.0;
+        if (entry.m_type == e_ManualEntry && entry.m_function.m_file != NULL)
+          m_strm << ",\"args\":{\"file\":" << EscapedJSON(entry.m_function.m_file) << ",\"line\":" << entry.m_function.m_line << '}';
+        m_strm << '}';
+      }
+
+      ostream          & m_strm;
+      PProcessIdentifier m_processId;
+      ThreadByID         m_threads;
+  };
+
+
+  void ToChromeTrace(ostream & strm)
+  {
+    ChromeTraceWriter writer(strm);
+    writer.Walk();
+  }
+
+
+  class FoldedStackWriter : public FrameWalker
+  {
+    public:
+      typedef std::map<std::string, uint64_t> StackMap;
+
+      FoldedStackWriter()
+      {
+        GetThreads(m_threads);
+      }
+
+      void Output(ostream & strm) const
+      {
+        for (StackMap::const_iterator it = m_stacks.begin(); it != m_stacks.end(); ++it) {
+          int64_t nanoseconds = CyclesToNanoseconds(it->second);
+          if (nanoseconds > 0)
+            strm << it->first << ' ' << nanoseconds << '\n';
+        }
+      }
+
+    protected:
+      static void AddFrame(std::string & key, const std::string & name)
+      {
+        key += ';';
+        // Semicolon separates frames and the last space separates the count
+        for (size_t i = 0; i < name.length(); ++i)
+          key += name[i] == ';' ? ',' : name[i];
+      }
+
+      virtual void OnThread(const ThreadBuffer & buffer)
+      {
+        m_threadName = GetThread(m_threads, buffer)->second.m_name;
+        if (m_threadName.empty())
+          m_threadName = "<thread>";
+      }
+
+      virtual void OnFrame(const ThreadBuffer &, const Stack & stack, uint64_t exitTime)
+      {
+        std::string key = m_threadName;
+        for (Stack::const_iterator frame = stack.begin(); frame != stack.end(); ++frame)
+          AddFrame(key, frame->m_entry->GetName());
+        m_stacks[key] += stack.back().GetSelfCycles(exitTime);
+      }
+
+      ThreadByID  m_threads;
+      std::string m_threadName;
+      StackMap    m_stacks;
+  };
+
+
+  void ToFoldedStacks(ostream & strm)
+  {
+    FoldedStackWriter writer;
+    writer.Walk();
+    writer.Output(strm);
+  }
+
 #endif // P_PROFILING
 
 #if PTRACING
@@ -2166,6 +2833,7 @@ namespace PProfiling
     unsigned                  m_countTimesOverThreshold;
     PTime                     m_lastOutputTime;
     PTimeInterval             m_lastDuration;
+    PLatencyHistogram       * m_histogram;
 
     struct History
     {
@@ -2198,11 +2866,15 @@ namespace PProfiling
       , m_mma("s")
       , m_countTimesOverThreshold(0)
       , m_lastOutputTime(0)
+      , m_histogram(location.m_extra != NULL ? &PLatencyHistogram::Get(location.m_extra) : NULL)
     {
     }
 
     void EndMeasurement(const void * ptr, const PObject * object, const PDebugLocation * location, const PNanoSeconds & duration)
     {
+      if (m_histogram != NULL)
+        m_histogram->Record(duration);
+
       PWaitAndSignal lock(m_mutex);
 
       m_lastDuration = duration;
@@ -2338,21 +3010,19 @@ namespace PProfiling
 #ifdef __GNUC__
 extern "C"
 {
-  #undef new
-
   PPROFILE_EXCLUDE(void __cyg_profile_func_enter(void * function, void * caller));
   PPROFILE_EXCLUDE(void __cyg_profile_func_exit(void * function, void * caller));
 
   void __cyg_profile_func_enter(void * function, void * caller)
   {
     if (PProfiling::s_database.m_enabled)
-      new PProfiling::FunctionRawData(PProfiling::e_AutoEntry, function, caller);
+      PProfiling::RecordAutoEvent(PProfiling::e_AutoEntry, function, caller);
   }
 
   void __cyg_profile_func_exit(void * function, void * caller)
   {
     if (PProfiling::s_database.m_enabled)
-      new PProfiling::FunctionRawData(PProfiling::e_AutoExit, function, caller);
+      PProfiling::RecordAutoEvent(PProfiling::e_AutoExit, function, caller);
   }
 };
 #endif // __GNUC__
@@ -40,6 +40,7 @@
 #include <ptlib/svcproc.h>
 #include <ptlib/pluginmgr.h>
 #include <ptlib/syslog.h>
+#include <ptlib/histogram.h>
 #include <ptclib/random.h>
 #include "../../../version.h"
 #include "../../../revision.h"
@@ -1670,7 +1671,11 @@ bool PTimer::List::OnTimeout(PIdGenerator::Handle handle)
   }
 
   // Must be outside of m_timersMutex and timer->m_timerMutex mutexes
+  static PLatencyHistogram & s_callbackHistogram = PLatencyHistogram::Get("ptlib.timer.callback");
+  uint64_t startCycle = s_callbackHistogram.IsEnabled() ? PProfiling::GetCycles() : 0;
   timer->OnTimeout();
+  if (startCycle != 0)
+    s_callbackHistogram.RecordSince(startCycle);
   timer->m_callbackMutex.Signal();
   return true; // Done
 }
@@ -1678,6 +1683,8 @@ bool PTimer::List::OnTimeout(PIdGenerator::Handle handle)
 
 PTimeInterval PTimer::List::Process()
 {
+  static PLatencyHistogram & s_latenessHistogram = PLatencyHistogram::Get("ptlib.timer.lateness");
+
   PTimeInterval now = PTimer::Tick();
 
   // Calculate interval before next Process() call
@@ -1707,6 +1714,7 @@ PTimeInterval PTimer::List::Process()
         timer.m_callbackMutex.Signal();
 
         m_threadPool.AddWork(new Timeout(it->first));
+        s_latenessHistogram.Record(-delta);
         PTRACE(6, &timer, "Timer: " << timer << " work added, lateness=" << -delta);
       }
     }
@@ -2641,6 +2649,14 @@ PProcess::~PProcess()
 {
   PTRACE(4, "Starting process destruction.");
 
+#if PTRACING
+  if (PMutexContention::IsEnabled() && PTrace::CanTrace(3)) {
+    ostream & trace = PTRACE_BEGIN(3, "PTLib");
+    PMutexContention::PrintOn(trace);
+    trace << PTrace::End;
+  }
+#endif
+
   m_shuttingDown = true;
 
   RemoveRunTimeSignalHandlers();
@@ -3714,6 +3730,7 @@ PMutexExcessiveLockInfo::PMutexExcessiveLockInfo(const PDebugLocation & location
 void PMutexExcessiveLockInfo::Construct(unsigned timeout)
 {
   m_excessiveLockActive = false;
+  m_contentionProfiled = true;
   m_startHeldSamplePoint = 0;
 
   if (timeout > 0)
@@ -3723,6 +3740,13 @@ void PMutexExcessiveLockInfo::Construct(unsigned timeout)
       const char * env = getenv("PTLIB_DEADLOCK_TIME");
       int seconds = env != NULL ? atoi(env) : 0;
       PTimedMutex::ExcessiveLockWaitTime = seconds > 0 ? seconds*1000 : 15000;
+
+      env = getenv("PTLIB_LOCK_CONTENTION");
+      int threshold = env != NULL ? atoi(env) : 0;
+      if (threshold > 0) {
+        PMutexContention::SetThreshold(threshold);
+        PMutexContention::SetEnabled(true);
+      }
     }
     m_excessiveLockTimeout = PTimedMutex::ExcessiveLockWaitTime;
   }
@@ -3733,6 +3757,7 @@ PMutexExcessiveLockInfo::PMutexExcessiveLockInfo(const PMutexExcessiveLockInfo &
   : m_location(other.m_location)
   , m_excessiveLockTimeout(other.m_excessiveLockTimeout)
   , m_excessiveLockActive(false)
+  , m_contentionProfiled(other.m_contentionProfiled)
   , m_startHeldSamplePoint(0)
 {
 }
@@ -3782,16 +3807,363 @@ void PMutexExcessiveLockInfo::ExcessiveLockPhantom(const PObject & mutex) const
 }
 
 
-void PMutexExcessiveLockInfo::AcquiredLock(uint64_t, bool, const PDebugLocation &)
+///////////////////////////////////////////////////////////////////////////////
+// PMutexContention
+
+namespace {
+  const unsigned ContentionTables = 8;
+  const unsigned ContentionSites = 256; // Per table
+  const unsigned ContentionProbes = 16;
+  const unsigned ContentionBucketShift = 3; // Four buckets per power of two
+  const unsigned ContentionBuckets = PLatencyHistogram::NumBuckets >> ContentionBucketShift;
+
+  struct ContentionSite
+  {
+    atomic<uint64_t> m_key;
+    atomic<bool>     m_ready;
+    PDebugLocation   m_location;
+    atomic<uint64_t> m_acquisitions;
+    atomic<uint64_t> m_contended;
+    atomic<uint64_t> m_waitTotal;
+    atomic<uint64_t> m_waitMaximum;
+    atomic<uint64_t> m_holdTotal;
+    atomic<uint64_t> m_holdMaximum;
+    atomic<uint32_t> m_waitBuckets[ContentionBuckets];
+    atomic<uint32_t> m_holdBuckets[ContentionBuckets];
+  };
+
+  struct ContentionTable
+  {
+    ContentionSite m_sites[ContentionSites];
+  };
+
+  atomic<bool>              s_contentionEnabled;
+  atomic<unsigned>          s_contentionThreshold(1000);
+  atomic<ContentionTable *> s_contentionTables;
+  atomic<uint64_t>          s_contentionDropped;
+  atomic<unsigned>          s_contentionNextTable;
+  P_THREAD_LOCAL unsigned   t_contentionTable; // Plus one, zero is unassigned
+
+
+  ContentionSite * FindContentionSite(const PDebugLocation & location)
+  {
+    ContentionTable * tables = s_contentionTables.load(memory_order_acquire);
+    if (tables == NULL)
+      return NULL;
+
+    unsigned index = t_contentionTable;
+    if (index == 0)
+      t_contentionTable = index = s_contentionNextTable++ % ContentionTables + 1;
+    ContentionTable & table = tables[index-1];
+
+    uint64_t key = (uint64_t)(uintptr_t)location.m_file*0x9E3779B97F4A7C15ULL ^
+                   (uint64_t)(uintptr_t)location.m_extra*0xC2B2AE3D27D4EB4FULL ^
+                   location.m_line;
+    if (key == 0)
+      key = 1;
+
+    unsigned hash = (unsigned)(key ^ (key >> 32));
+    for (unsigned probe = 0; probe < ContentionProbes; ++probe) {
+      ContentionSite & site = table.m_sites[(hash + probe) % ContentionSites];
+      uint64_t existing = site.m_key.load(memory_order_relaxed);
+      if (existing == 0 && site.m_key.compare_exchange_strong(existing, key, memory_order_relaxed)) {
+        site.m_location = location;
+        site.m_ready.store(true, memory_order_release);
+        return &site;
+      }
+      if (existing == key)
+        return &site;
+    }
+
+    ++s_contentionDropped;
+    return NULL;
+  }
+
+
+  uint64_t AccumulateContention(atomic<uint64_t> & total,
+                                atomic<uint64_t> & maximum,
+                                atomic<uint32_t> * buckets,
+                                uint64_t startCycle)
+  {
+    int64_t ns = PProfiling::CyclesToNanoseconds(PProfiling::GetCycles() - startCycle);
+    if (ns < 0)
+      ns = 0;
+
+    total.fetch_add(ns, memory_order_relaxed);
+    buckets[PLatencyHistogram::GetBucketIndex(ns) >> ContentionBucketShift].fetch_add(1, memory_order_relaxed);
+
+    uint64_t value = maximum.load(memory_order_relaxed);
+    while ((uint64_t)ns > value && !maximum.compare_exchange_weak(value, ns, memory_order_relaxed))
+      ;
+
+    return ns;
+  }
+
+
+  struct MergedContentionSite : PMutexContention::Site
+  {
+    MergedContentionSite(const PDebugLocation & location)
+      : PMutexContention::Site(location)
+      , m_waitBuckets(ContentionBuckets)
+      , m_holdBuckets(ContentionBuckets)
+    { }
+
+    std::vector<uint64_t> m_waitBuckets;
+    std::vector<uint64_t> m_holdBuckets;
+  };
+
+
+  uint64_t ContentionPercentile(const std::vector<uint64_t> & buckets, uint64_t count, uint64_t maximum, unsigned percent)
+  {
+    uint64_t rank = std::max((uint64_t)1, (count*percent + 99)/100);
+    uint64_t accumulated = 0;
+    for (unsigned b = 0; b < buckets.size(); ++b) {
+      accumulated += buckets[b];
+      if (accumulated >= rank)
+        return std::min(maximum, PLatencyHistogram::GetBucketHighest(((b+1) << ContentionBucketShift) - 1));
+    }
+    return maximum;
+  }
+
+
+  PString ContentionDuration(uint64_t ns)
+  {
+    return PTimeInterval::NanoSeconds(ns).AsString(3, PTimeInterval::SecondsSI) + 's';
+  }
+};
+
+
+PMutexContention::Site::Site(const PDebugLocation & location)
+  : m_location(location)
+  , m_acquisitions(0)
+  , m_contended(0)
+  , m_waitTotal(0)
+  , m_waitMaximum(0)
+  , m_waitPercentile99(0)
+  , m_holdTotal(0)
+  , m_holdMaximum(0)
+  , m_holdPercentile99(0)
 {
 }
 
 
-void PMutexExcessiveLockInfo::ReleasedLock(const PObject & mutex,
-                                           uint64_t PTRACE_PARAM(startHeldSamplePoint),
-                                           bool,
-                                           const PDebugLocation & PTRACE_PARAM(location))
+void PMutexContention::SetEnabled(bool enabled)
+{
+  if (enabled && s_contentionTables.load(memory_order_acquire) == NULL) {
+    ContentionTable * tables;
+    {
+      // Never deleted, as other threads may be using them at any time
+      PMEMORY_IGNORE_ALLOCATIONS_FOR_SCOPE;
+      tables = new ContentionTable[ContentionTables]();
+    }
+    ContentionTable * expected = NULL;
+    if (!s_contentionTables.compare_exchange_strong(expected, tables, memory_order_acq_rel))
+      delete [] tables;
+  }
+
+  s_contentionEnabled.store(enabled, memory_order_relaxed);
+}
+
+
+bool PMutexContention::IsEnabled()
+{
+  return s_contentionEnabled.load(memory_order_relaxed);
+}
+
+
+void PMutexContention::SetThreshold(unsigned nanoseconds)
+{
+  s_contentionThreshold.store(nanoseconds, memory_order_relaxed);
+}
+
+
+unsigned PMutexContention::GetThreshold()
+{
+  return s_contentionThreshold.load(memory_order_relaxed);
+}
+
+
+void PMutexContention::Reset()
+{
+  ContentionTable * tables = s_contentionTables.load(memory_order_acquire);
+  if (tables == NULL)
+    return;
+
+  for (unsigned t = 0; t < ContentionTables; ++t) {
+    for (unsigned s = 0; s < ContentionSites; ++s) {
+      ContentionSite & site = tables[t].m_sites[s];
+      site.m_acquisitions.store(0, memory_order_relaxed);
+      site.m_contended.store(0, memory_order_relaxed);
+      site.m_waitTotal.store(0, memory_order_relaxed);
+      site.m_waitMaximum.store(0, memory_order_relaxed);
+      site.m_holdTotal.store(0, memory_order_relaxed);
+      site.m_holdMaximum.store(0, memory_order_relaxed);
+      for (unsigned b = 0; b < ContentionBuckets; ++b) {
+        site.m_waitBuckets[b].store(0, memory_order_relaxed);
+        site.m_holdBuckets[b].store(0, memory_order_relaxed);
+      }
+    }
+  }
+  s_contentionDropped.store(0, memory_order_relaxed);
+}
+
+
+void PMutexContention::Acquired(const PDebugLocation & location, uint64_t startWaitCycle)
 {
+  ContentionSite * site = FindContentionSite(location);
+  if (site == NULL)
+    return;
+
+  site->m_acquisitions.fetch_add(1, memory_order_relaxed);
+  if (AccumulateContention(site->m_waitTotal, site->m_waitMaximum, site->m_waitBuckets, startWaitCycle) >=
+                                                            s_contentionThreshold.load(memory_order_relaxed))
+    site->m_contended.fetch_add(1, memory_order_relaxed);
+}
+
+
+void PMutexContention::Released(const PDebugLocation & location, uint64_t startHeldCycle)
+{
+  ContentionSite * site = FindContentionSite(location);
+  if (site != NULL)
+    AccumulateContention(site->m_holdTotal, site->m_holdMaximum, site->m_holdBuckets, startHeldCycle);
+}
+
+
+PMutexContention::Sites PMutexContention::GetSites(SortOrder order)
+{
+  ContentionTable * tables = s_contentionTables.load(memory_order_acquire);
+  if (tables == NULL)
+    return Sites();
+
+  // The same site can be in several tables, and the same source location
+  // can have several string pointers, so merge by the text of the location.
+  typedef std::map<PString, MergedContentionSite> MergedMap;
+  MergedMap merged;
+
+  for (unsigned t = 0; t < ContentionTables; ++t) {
+    for (unsigned s = 0; s < ContentionSites; ++s) {
+      ContentionSite & site = tables[t].m_sites[s];
+      if (!site.m_ready.load(memory_order_acquire))
+        continue;
+
+      uint64_t acquisitions = site.m_acquisitions.load(memory_order_relaxed);
+      if (acquisitions == 0)
+        continue;
+
+      PStringStream name;
+      if (site.m_location.m_file == NULL && site.m_location.m_extra == NULL)
+        name << "unnamed";
+      else
+        name << site.m_location;
+
+      MergedMap::iterator it = merged.find(name);
+      if (it == merged.end())
+        it = merged.insert(MergedMap::value_type(name, MergedContentionSite(site.m_location))).first;
+
+      MergedContentionSite & info = it->second;
+      info.m_acquisitions += acquisitions;
+      info.m_contended += site.m_contended.load(memory_order_relaxed);
+      info.m_waitTotal += site.m_waitTotal.load(memory_order_relaxed);
+      info.m_waitMaximum = std::max(info.m_waitMaximum, (uint64_t)site.m_waitMaximum.load(memory_order_relaxed));
+      info.m_holdTotal += site.m_holdTotal.load(memory_order_relaxed);
+      info.m_holdMaximum = std::max(info.m_holdMaximum, (uint64_t)site.m_holdMaximum.load(memory_order_relaxed));
+      for (unsigned b = 0; b < ContentionBuckets; ++b) {
+        info.m_waitBuckets[b] += site.m_waitBuckets[b].load(memory_order_relaxed);
+        info.m_holdBuckets[b] += site.m_holdBuckets[b].load(memory_order_relaxed);
+      }
+    }
+  }
+
+  Sites sites;
+  sites.reserve(merged.size());
+  for (MergedMap::iterator it = merged.begin(); it != merged.end(); ++it) {
+    MergedContentionSite & info = it->second;
+    info.m_waitPercentile99 = ContentionPercentile(info.m_waitBuckets, info.m_acquisitions, info.m_waitMaximum, 99);
+    info.m_holdPercentile99 = ContentionPercentile(info.m_holdBuckets, info.m_acquisitions, info.m_holdMaximum, 99);
+    sites.push_back(info);
+  }
+
+  struct Compare {
+    SortOrder m_order;
+    Compare(SortOrder order) : m_order(order) { }
+    uint64_t Get(const Site & site) const
+    {
+      switch (m_order) {
+        case SortByHoldTime :
+          return site.m_holdTotal;
+        case SortByContended :
+          return site.m_contended;
+        case SortByAcquisitions :
+          return site.m_acquisitions;
+        default :
+          return site.m_waitTotal;
+      }
+    }
+    bool operator()(const Site & first, const Site & second) const { return Get(first) > Get(second); }
+  };
+  std::stable_sort(sites.begin(), sites.end(), Compare(order));
+
+  return sites;
+}
+
+
+void PMutexContention::PrintOn(ostream & strm, unsigned maxSites, SortOrder order)
+{
+  Sites sites = GetSites(order);
+
+  strm << "Lock contention: sites=" << sites.size() << ","
+          " threshold=" << ContentionDuration(GetThreshold()) << ","
+          " dropped=" << s_contentionDropped.load(memory_order_relaxed) << '\n'
+       << setw(12) << "Acquired"
+       << setw(12) << "Contended"
+       << setw(12) << "Wait total"
+       << setw(10) << "p99"
+       << setw(10) << "max"
+       << setw(12) << "Hold total"
+       << setw(10) << "p99"
+       << setw(10) << "max"
+       << "  Site\n";
+
+  for (Sites::iterator it = sites.begin(); it != sites.end() && maxSites-- > 0; ++it) {
+    strm << setw(12) << it->m_acquisitions
+         << setw(12) << it->m_contended
+         << setw(12) << ContentionDuration(it->m_waitTotal)
+         << setw(10) << ContentionDuration(it->m_waitPercentile99)
+         << setw(10) << ContentionDuration(it->m_waitMaximum)
+         << setw(12) << ContentionDuration(it->m_holdTotal)
+         << setw(10) << ContentionDuration(it->m_holdPercentile99)
+         << setw(10) << ContentionDuration(it->m_holdMaximum)
+         << "  ";
+    if (it->m_location.m_file == NULL && it->m_location.m_extra == NULL)
+      strm << "unnamed";
+    else
+      strm << it->m_location;
+    strm << '\n';
+  }
+  strm.flush();
+}
+
+
+void PMutexExcessiveLockInfo::AcquiredLock(uint64_t startWaitCycle, bool, const PDebugLocation & location)
+{
+  if (s_contentionEnabled.load(memory_order_relaxed) && m_contentionProfiled)
+    PMutexContention::Acquired(m_location.m_file != NULL || m_location.m_extra != NULL ? m_location : location, startWaitCycle);
+}
+
+
+void PMutexExcessiveLockInfo::ReleasedLock(const PObject & mutex,
+                                           uint64_t startHeldSamplePoint,
+                                           bool readOnly,
+                                           const PDebugLocation & location)
+{
+  static PLatencyHistogram & s_heldHistogram = PLatencyHistogram::Get("ptlib.mutex.held");
+  static PLatencyHistogram & s_readHeldHistogram = PLatencyHistogram::Get("ptlib.mutex.read_held");
+  if (startHeldSamplePoint != 0) {
+    (readOnly ? s_readHeldHistogram : s_heldHistogram).RecordSince(startHeldSamplePoint);
+    if (s_contentionEnabled.load(memory_order_relaxed) && m_contentionProfiled)
+      PMutexContention::Released(m_location.m_file != NULL || m_location.m_extra != NULL ? m_location : location, startHeldSamplePoint);
+  }
+
   if (m_excessiveLockActive) {
 #if PTRACING
     PTime releaseTime;
@@ -4003,9 +4375,10 @@ bool PInstrumentedMutex::InstrumentedWait(const PTimeInterval & timeout, const P
 }
 
 
-void PInstrumentedMutex::AcquiredLock(uint64_t startWaitCycle, bool, const PDebugLocation & location)
+void PInstrumentedMutex::AcquiredLock(uint64_t startWaitCycle, bool readOnly, const PDebugLocation & location)
 {
   m_timeWaitContext.EndMeasurement(this, this, &location, startWaitCycle);
+  PTimedMutex::AcquiredLock(startWaitCycle, readOnly, location);
 }
 
 
@@ -4181,7 +4554,7 @@ PReadWriteMutex::PReadWriteMutex()
   , m_writerCount(0)
 #endif
 {
-  PMUTEX_CONSTRUCTED();
+  Construct();
 }
 
 PReadWriteMutex::PReadWriteMutex(const PDebugLocation & location, unsigned timeout)
@@ -4203,6 +4576,18 @@ PReadWriteMutex::PReadWriteMutex(const PDebugLocation & location, unsigned timeo
   , m_writerCount(0)
 #endif
 {
+  Construct();
+}
+
+
+void PReadWriteMutex::Construct()
+{
+#if !P_READ_WRITE_ALGO2
+  // Only the read/write lock as a whole is of interest
+  m_readerMutex.SetContentionProfiled(false);
+  m_starvationPreventer.SetContentionProfiled(false);
+  m_writerMutex.SetContentionProfiled(false);
+#endif
   PMUTEX_CONSTRUCTED();
 }
 
@@ -4530,6 +4915,8 @@ void PInstrumentedReadWriteMutex::AcquiredLock(uint64_t startWaitCycle, bool rea
     m_timeWaitReadOnlyContext.EndMeasurement(this, this, &location, startWaitCycle);
   else
     m_timeWaitReadWriteContext.EndMeasurement(this, this, &location, startWaitCycle);
+
+  PReadWriteMutex::AcquiredLock(startWaitCycle, readOnly, location);
 }
 
 
@@ -0,0 +1,1892 @@
+/*
+ * pregex.cxx
+ *
+ * Regular expression classes.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#include <ptlib.h>
+#include <ctype.h>
+
+#if P_REGEX
+  #include <regex.h>
+#else
+  #include "regex/regex.h"
+#endif
+
+
+/* The linear time engine.
+
+   The pattern is parsed into a tree, which is then compiled into a program
+   for a Thompson NFA, as described by Russ Cox in "Regular Expression
+   Matching Can Be Simple And Fast". A program is compiled twice, forwards
+   and backwards. The backwards program is used by a lazily built DFA, run
+   from the end of the string, to find the leftmost start of a match, then
+   a DFA of the forward program finds the longest match from that start.
+   Only if sub-expressions are needed is the NFA simulated directly (a "Pike
+   VM"), over just the matched part of the string.
+
+   The DFA states are built only as the input requires them, and the number
+   kept is bounded, when full they are all discarded and building starts
+   again, so the time is always linear in the length of the string.
+ */
+
+// Categories of the character before or after a position, for anchors
+enum PRegExContexts {
+  e_Boundary,   // Beginning or end of the string
+  e_NewLine,    // A '\n' character
+  e_Other,
+  NumContexts
+};
+
+static __inline BYTE PRegExCategory(char c)
+{
+  return c == '\n' ? e_NewLine : e_Other;
+}
+
+
+struct PRegExCharSet
+{
+  PUInt64 m_bits[4];
+
+  PRegExCharSet() { memset(m_bits, 0, sizeof(m_bits)); }
+  bool Test(BYTE c) const { return (m_bits[c >> 6] & (PUInt64(1) << (c & 63))) != 0; }
+  void Set(BYTE c) { m_bits[c >> 6] |= PUInt64(1) << (c & 63); }
+  void Clear(BYTE c) { m_bits[c >> 6] &= ~(PUInt64(1) << (c & 63)); }
+  void Invert() { for (int i = 0; i < 4; ++i) m_bits[i] = ~m_bits[i]; }
+  bool operator<(const PRegExCharSet & other) const { return memcmp(m_bits, other.m_bits, sizeof(m_bits)) < 0; }
+
+  void FoldCase()
+  {
+    for (BYTE c = 'A'; c <= 'Z'; ++c) {
+      if (Test(c) || Test(c + 'a' - 'A')) {
+        Set(c);
+        Set(c + 'a' - 'A');
+      }
+    }
+  }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* Parser for the subset of POSIX basic and extended syntax the linear time
+   engine supports. Anything else, including errors, fails the parse so the
+   pattern goes to regcomp(), which will handle it or report the error. */
+
+class PRegExParser
+{
+  public:
+    enum { Unbounded = UINT_MAX, MaxRepeat = 255 };
+
+    struct Node
+    {
+      enum Types {
+        e_Set,
+        e_LineStart,
+        e_LineEnd,
+        e_Concat,
+        e_Alternate,
+        e_Group,
+        e_Repeat
+      } m_type;
+      PRegExCharSet         m_set;
+      unsigned              m_group;
+      unsigned              m_min;
+      unsigned              m_max;
+      std::vector<unsigned> m_children;
+
+      Node(Types type) : m_type(type), m_group(0), m_min(0), m_max(0) { }
+    };
+
+
+    PRegExParser(const char * pattern, PRegularExpression::CompileOptions options)
+      : m_extended((options & PRegularExpression::Extended) != 0)
+      , m_ignoreCase((options & PRegularExpression::IgnoreCase) != 0)
+      , m_newLine((options & PRegularExpression::AnchorNewLine) != 0)
+      , m_root(0)
+      , m_groups(0)
+      , m_ptr(pattern)
+    {
+    }
+
+
+    bool Parse()
+    {
+      if (!ParseAlternate(m_root, 0) || *m_ptr != '\0')
+        return false;
+
+      // Note if the pattern can only match at the start or end of the string
+      const Node & root = m_nodes[m_root];
+      unsigned first = root.m_type == Node::e_Concat ? root.m_children.front() : m_root;
+      unsigned last  = root.m_type == Node::e_Concat ? root.m_children.back()  : m_root;
+      m_anchoredStart = !m_newLine && m_nodes[first].m_type == Node::e_LineStart;
+      m_anchoredEnd   = !m_newLine && m_nodes[last ].m_type == Node::e_LineEnd;
+      return true;
+    }
+
+
+    bool                m_extended;
+    bool                m_ignoreCase;
+    bool                m_newLine;
+    bool                m_anchoredStart;
+    bool                m_anchoredEnd;
+    std::vector<Node>   m_nodes;
+    unsigned            m_root;
+    unsigned            m_groups;
+
+  protected:
+    unsigned NewNode(Node::Types type)
+    {
+      m_nodes.push_back(Node(type));
+      return (unsigned)m_nodes.size()-1;
+    }
+
+
+    unsigned NewSet(PRegExCharSet set)
+    {
+      if (m_ignoreCase)
+        set.FoldCase();
+      unsigned node = NewNode(Node::e_Set);
+      m_nodes[node].m_set = set;
+      return node;
+    }
+
+
+    unsigned NewLiteral(char c)
+    {
+      PRegExCharSet set;
+      set.Set(c);
+      return NewSet(set);
+    }
+
+
+    unsigned NewList(Node::Types type, const std::vector<unsigned> & children)
+    {
+      if (children.size() == 1)
+        return children[0];
+      unsigned node = NewNode(type);
+      m_nodes[node].m_children = children;
+      return node;
+    }
+
+
+    bool IsGroupEnd() const
+    {
+      return m_extended ? (*m_ptr == ')') : (m_ptr[0] == '\\' && m_ptr[1] == ')');
+    }
+
+
+    bool ParseAlternate(unsigned & node, unsigned depth)
+    {
+      std::vector<unsigned> alternatives;
+      for (;;) {
+        unsigned concat;
+        if (!ParseConcat(concat, depth))
+          return false;
+        alternatives.push_back(concat);
+
+        if (!m_extended || *m_ptr != '|')
+          break;
+        ++m_ptr;
+      }
+
+      node = NewList(Node::e_Alternate, alternatives);
+      return true;
+    }
+
+
+    bool ParseConcat(unsigned & node, unsigned depth)
+    {
+      std::vector<unsigned> items;
+
+      while (*m_ptr != '\0' && !(m_extended && *m_ptr == '|')) {
+        if (IsGroupEnd()) {
+          if (depth == 0)
+            return false;
+          break;
+        }
+
+        unsigned atom;
+        if (!(m_extended ? ParseExtendedAtom(atom, depth) : ParseBasicAtom(atom, depth, items)))
+          return false;
+
+        Node::Types atomType = m_nodes[atom].m_type;
+        if (atomType == Node::e_LineStart || atomType == Node::e_LineEnd) {
+          // Cannot repeat an anchor, and in basic syntax "^*" is a literal '*'
+          if (m_extended && (*m_ptr == '*' || *m_ptr == '+' || *m_ptr == '?' || *m_ptr == '{'))
+            return false;
+        }
+        else {
+          unsigned min, max;
+          if (!ParseRepeat(min, max))
+            return false;
+          if (min != 1 || max != 1) {
+            unsigned repeat = NewNode(Node::e_Repeat);
+            m_nodes[repeat].m_min = min;
+            m_nodes[repeat].m_max = max;
+            m_nodes[repeat].m_children.push_back(atom);
+            atom = repeat;
+
+            // Multiple repeat operators are not supported
+            unsigned dummyMin, dummyMax;
+            const char * save = m_ptr;
+            if (!ParseRepeat(dummyMin, dummyMax) || m_ptr != save)
+              return false;
+          }
+        }
+
+        items.push_back(atom);
+      }
+
+      if (items.empty())
+        return false; // Empty expressions, e.g. "a||b" or "()"
+
+      node = NewList(Node::e_Concat, items);
+      return true;
+    }
+
+
+    bool ParseGroup(unsigned & atom, unsigned depth)
+    {
+      unsigned group = ++m_groups;
+      unsigned inner;
+      if (!ParseAlternate(inner, depth+1) || !IsGroupEnd())
+        return false;
+      m_ptr += m_extended ? 1 : 2;
+
+      atom = NewNode(Node::e_Group);
+      m_nodes[atom].m_group = group;
+      m_nodes[atom].m_children.push_back(inner);
+      return true;
+    }
+
+
+    bool ParseExtendedAtom(unsigned & atom, unsigned depth)
+    {
+      char c = *m_ptr++;
+      switch (c) {
+        case '(' :
+          return ParseGroup(atom, depth);
+
+        case '*' :
+        case '+' :
+        case '?' :
+        case '{' :
+          return false; // Nothing to repeat
+
+        case '^' :
+          atom = NewNode(Node::e_LineStart);
+          return true;
+
+        case '$' :
+          atom = NewNode(Node::e_LineEnd);
+          return true;
+
+        case '\\' :
+          return ParseEscape(atom);
+
+        default :
+          return ParseCommonAtom(atom, c);
+      }
+    }
+
+
+    bool ParseBasicAtom(unsigned & atom, unsigned depth, const std::vector<unsigned> & previous)
+    {
+      bool atStart = previous.empty() || (previous.size() == 1 && m_nodes[previous[0]].m_type == Node::e_LineStart);
+
+      char c = *m_ptr++;
+      switch (c) {
+        case '\\' :
+          if (*m_ptr == '(') {
+            ++m_ptr;
+            return ParseGroup(atom, depth);
+          }
+          return ParseEscape(atom);
+
+        case '^' :
+          // Only an anchor at the start of the expression or sub-expression
+          atom = previous.empty() ? NewNode(Node::e_LineStart) : NewLiteral(c);
+          return true;
+
+        case '$' :
+          // Only an anchor at the end of the expression or sub-expression
+          atom = *m_ptr == '\0' || IsGroupEnd() ? NewNode(Node::e_LineEnd) : NewLiteral(c);
+          return true;
+
+        case '*' :
+          // Literal at the start, otherwise would have been parsed as a repeat
+          if (!atStart)
+            return false;
+          atom = NewLiteral(c);
+          return true;
+
+        default :
+          return ParseCommonAtom(atom, c);
+      }
+    }
+
+
+    bool ParseCommonAtom(unsigned & atom, char c)
+    {
+      PRegExCharSet set;
+
+      switch (c) {
+        case '.' :
+          set.Invert();
+          set.Clear('\0');
+          if (m_newLine)
+            set.Clear('\n');
+          break;
+
+        case '[' :
+          if (!ParseBracket(set))
+            return false;
+          break;
+
+        default :
+          set.Set(c);
+      }
+
+      atom = NewSet(set);
+      return true;
+    }
+
+
+    bool ParseEscape(unsigned & atom)
+    {
+      char c = *m_ptr;
+      if (c == '\0' || isdigit(c & 0xff))
+        return false; // Trailing backslash or back reference
+
+      // GNU extensions, or operators in the GNU basic syntax
+      if (strchr("wWsSbB<>`'", c) != NULL || (!m_extended && strchr("+?|{}()", c) != NULL))
+        return false;
+
+      ++m_ptr;
+      atom = NewLiteral(c);
+      return true;
+    }
+
+
+    bool ParseRepeat(unsigned & min, unsigned & max)
+    {
+      min = max = 1;
+
+      if (*m_ptr == '*') {
+        ++m_ptr;
+        min = 0;
+        max = Unbounded;
+        return true;
+      }
+
+      if (m_extended) {
+        switch (*m_ptr) {
+          case '+' :
+            ++m_ptr;
+            max = Unbounded;
+            return true;
+
+          case '?' :
+            ++m_ptr;
+            min = 0;
+            return true;
+
+          case '{' :
+            ++m_ptr;
+            return ParseBound(min, max);
+        }
+      }
+      else if (m_ptr[0] == '\\' && m_ptr[1] == '{') {
+        m_ptr += 2;
+        return ParseBound(min, max);
+      }
+
+      return true;
+    }
+
+
+    bool ParseBound(unsigned & min, unsigned & max)
+    {
+      if (!isdigit(*m_ptr & 0xff))
+        return false;
+
+      min = 0;
+      while (isdigit(*m_ptr & 0xff)) {
+        min = min*10 + *m_ptr++ - '0';
+        if (min > MaxRepeat)
+          return false;
+      }
+
+      if (*m_ptr != ',')
+        max = min;
+      else if (!isdigit(*++m_ptr & 0xff))
+        max = Unbounded;
+      else {
+        max = 0;
+        while (isdigit(*m_ptr & 0xff)) {
+          max = max*10 + *m_ptr++ - '0';
+          if (max > MaxRepeat)
+            return false;
+        }
+        if (max < min)
+          return false;
+      }
+
+      if (m_extended) {
+        if (*m_ptr != '}')
+          return false;
+        ++m_ptr;
+      }
+      else {
+        if (m_ptr[0] != '\\' || m_ptr[1] != '}')
+          return false;
+        m_ptr += 2;
+      }
+
+      return max > 0;
+    }
+
+
+    bool ParseBracket(PRegExCharSet & set)
+    {
+      bool negate = *m_ptr == '^';
+      if (negate)
+        ++m_ptr;
+
+      bool first = true;
+      for (;;) {
+        char c = *m_ptr;
+        if (c == '\0')
+          return false;
+
+        if (c == ']' && !first) {
+          ++m_ptr;
+          break;
+        }
+        first = false;
+
+        if (c == '[') {
+          if (m_ptr[1] == '.' || m_ptr[1] == '=')
+            return false; // Collating elements and equivalence classes
+
+          if (m_ptr[1] == ':') {
+            const char * end = strstr(m_ptr+2, ":]");
+            if (end == NULL || !AddClass(set, PString(m_ptr+2, end-m_ptr-2)))
+              return false;
+            m_ptr = end+2;
+            continue;
+          }
+        }
+
+        ++m_ptr;
+        BYTE lo = c;
+        BYTE hi = c;
+        if (m_ptr[0] == '-' && m_ptr[1] != ']' && m_ptr[1] != '\0') {
+          if (m_ptr[1] == '[')
+            return false;
+          hi = m_ptr[1];
+          if (hi < lo)
+            return false;
+          m_ptr += 2;
+        }
+
+        for (unsigned b = lo; b <= hi; ++b)
+          set.Set((BYTE)b);
+      }
+
+      if (m_ignoreCase)
+        set.FoldCase();
+
+      if (negate) {
+        set.Invert();
+        if (m_newLine)
+          set.Clear('\n');
+      }
+
+      set.Clear('\0');
+      return true;
+    }
+
+
+    static bool AddClass(PRegExCharSet & set, const PString & name)
+    {
+      static struct {
+        const char * m_name;
+        int (*m_function)(int);
+      } const Classes[] = {
+        { "alpha",  isalpha  },
+        { "digit",  isdigit  },
+        { "alnum",  isalnum  },
+        { "upper",  isupper  },
+        { "lower",  islower  },
+        { "space",  isspace  },
+        { "punct",  ispunct  },
+        { "print",  isprint  },
+        { "graph",  isgraph  },
+        { "cntrl",  iscntrl  },
+        { "xdigit", isxdigit }
+      };
+
+      if (name == "blank") {
+        set.Set(' ');
+        set.Set('\t');
+        return true;
+      }
+
+      for (PINDEX i = 0; i < PARRAYSIZE(Classes); ++i) {
+        if (name == Classes[i].m_name) {
+          for (unsigned c = 1; c < 256; ++c) {
+            if (Classes[i].m_function(c))
+              set.Set((BYTE)c);
+          }
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+
+    const char * m_ptr;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PRegExProgram
+{
+  public:
+    enum { MaxInstructions = 20000 };
+
+    struct Instruction
+    {
+      enum Ops {
+        e_Set,        // Consume character in set m_x
+        e_Split,      // Continue at m_x, with priority, and m_y
+        e_Jump,       // Continue at m_x
+        e_Save,       // Record position in capture slot m_x
+        e_LineStart,
+        e_LineEnd,
+        e_Match       // Pattern m_x has matched
+      };
+      BYTE     m_op;
+      bool     m_newLine; // Anchor also matches at '\n'
+      unsigned m_x;
+      unsigned m_y;
+    };
+
+    std::vector<Instruction>   m_instructions;
+    std::vector<PRegExCharSet> m_sets;
+    std::vector<unsigned>      m_starts;    // Entry points of each pattern
+    std::vector<unsigned>      m_floating;  // Entry points that may start anywhere in string
+    unsigned                   m_captures;  // Number of capture slots
+
+
+    PRegExProgram()
+      : m_captures(0)
+    {
+    }
+
+
+    void RemoveAll()
+    {
+      m_instructions.clear();
+      m_sets.clear();
+      m_setIndex.clear();
+      m_starts.clear();
+      m_floating.clear();
+      m_captures = 0;
+    }
+
+
+    bool Append(const PRegExParser & parser, unsigned matchId, bool reverse, bool captures)
+    {
+      unsigned start = (unsigned)m_instructions.size();
+
+      if (captures)
+        AddInstruction(Instruction::e_Save, 0);
+
+      if (!Emit(parser, parser.m_root, reverse, captures))
+        return false;
+
+      if (captures) {
+        AddInstruction(Instruction::e_Save, 1);
+        m_captures = std::max(m_captures, (parser.m_groups+1)*2);
+      }
+
+      AddInstruction(Instruction::e_Match, matchId);
+
+      m_starts.push_back(start);
+      if (!(reverse ? parser.m_anchoredEnd : parser.m_anchoredStart))
+        m_floating.push_back(start);
+      return true;
+    }
+
+
+  protected:
+    unsigned AddInstruction(BYTE op, unsigned x = 0, unsigned y = 0)
+    {
+      Instruction instruction;
+      instruction.m_op = op;
+      instruction.m_newLine = false;
+      instruction.m_x = x;
+      instruction.m_y = y;
+      m_instructions.push_back(instruction);
+      return (unsigned)m_instructions.size()-1;
+    }
+
+
+    unsigned GetSetIndex(const PRegExCharSet & set)
+    {
+      std::map<PRegExCharSet, unsigned>::iterator it = m_setIndex.find(set);
+      if (it != m_setIndex.end())
+        return it->second;
+
+      unsigned index = (unsigned)m_sets.size();
+      m_sets.push_back(set);
+      m_setIndex[set] = index;
+      return index;
+    }
+
+
+    bool Emit(const PRegExParser & parser, unsigned index, bool reverse, bool captures)
+    {
+      if (m_instructions.size() > MaxInstructions)
+        return false;
+
+      const PRegExParser::Node & node = parser.m_nodes[index];
+      switch (node.m_type) {
+        case PRegExParser::Node::e_Set :
+          AddInstruction(Instruction::e_Set, GetSetIndex(node.m_set));
+          break;
+
+        case PRegExParser::Node::e_LineStart :
+        case PRegExParser::Node::e_LineEnd :
+          // Running backwards, the start of a line is the end of a line
+          AddInstruction((node.m_type == PRegExParser::Node::e_LineStart) != reverse
+                                ? Instruction::e_LineStart : Instruction::e_LineEnd);
+          m_instructions.back().m_newLine = parser.m_newLine;
+          break;
+
+        case PRegExParser::Node::e_Concat :
+          if (reverse) {
+            for (std::vector<unsigned>::const_reverse_iterator it = node.m_children.rbegin(); it != node.m_children.rend(); ++it) {
+              if (!Emit(parser, *it, reverse, captures))
+                return false;
+            }
+          }
+          else {
+            for (std::vector<unsigned>::const_iterator it = node.m_children.begin(); it != node.m_children.end(); ++it) {
+              if (!Emit(parser, *it, reverse, captures))
+                return false;
+            }
+          }
+          break;
+
+        case PRegExParser::Node::e_Alternate :
+        {
+          std::vector<unsigned> jumps;
+          for (size_t i = 0; i < node.m_children.size(); ++i) {
+            unsigned split = 0;
+            bool notLast = i < node.m_children.size()-1;
+            if (notLast)
+              split = AddInstruction(Instruction::e_Split, (unsigned)m_instructions.size()+1);
+            if (!Emit(parser, node.m_children[i], reverse, captures))
+              return false;
+            if (notLast) {
+              jumps.push_back(AddInstruction(Instruction::e_Jump));
+              m_instructions[split].m_y = (unsigned)m_instructions.size();
+            }
+          }
+          for (std::vector<unsigned>::iterator it = jumps.begin(); it != jumps.end(); ++it)
+            m_instructions[*it].m_x = (unsigned)m_instructions.size();
+          break;
+        }
+
+        case PRegExParser::Node::e_Group :
+          if (captures)
+            AddInstruction(Instruction::e_Save, node.m_group*2);
+          if (!Emit(parser, node.m_children[0], reverse, captures))
+            return false;
+          if (captures)
+            AddInstruction(Instruction::e_Save, node.m_group*2+1);
+          break;
+
+        case PRegExParser::Node::e_Repeat :
+          if (node.m_max == PRegExParser::Unbounded) {
+            if (node.m_min == 0) {
+              // L: split L+1, out; child; jump L; out:
+              unsigned split = AddInstruction(Instruction::e_Split, (unsigned)m_instructions.size()+1);
+              if (!Emit(parser, node.m_children[0], reverse, captures))
+                return false;
+              AddInstruction(Instruction::e_Jump, split);
+              m_instructions[split].m_y = (unsigned)m_instructions.size();
+            }
+            else {
+              // child repeated min-1 times, then L: child; split L, out; out:
+              for (unsigned i = 1; i < node.m_min; ++i) {
+                if (!Emit(parser, node.m_children[0], reverse, captures))
+                  return false;
+              }
+              unsigned loop = (unsigned)m_instructions.size();
+              if (!Emit(parser, node.m_children[0], reverse, captures))
+                return false;
+              AddInstruction(Instruction::e_Split, loop, (unsigned)m_instructions.size()+1);
+            }
+          }
+          else {
+            // child repeated min times, then max-min optional copies
+            for (unsigned i = 0; i < node.m_min; ++i) {
+              if (!Emit(parser, node.m_children[0], reverse, captures))
+                return false;
+            }
+            std::vector<unsigned> splits;
+            for (unsigned i = node.m_min; i < node.m_max; ++i) {
+              splits.push_back(AddInstruction(Instruction::e_Split, (unsigned)m_instructions.size()+1));
+              if (!Emit(parser, node.m_children[0], reverse, captures))
+                return false;
+            }
+            for (std::vector<unsigned>::iterator it = splits.begin(); it != splits.end(); ++it)
+              m_instructions[*it].m_y = (unsigned)m_instructions.size();
+          }
+          break;
+      }
+
+      return m_instructions.size() <= MaxInstructions;
+    }
+
+
+    std::map<PRegExCharSet, unsigned> m_setIndex;
+};
+
+
+static bool PRegExAssertion(const PRegExProgram::Instruction & instruction, BYTE context)
+{
+  return context == e_Boundary || (instruction.m_newLine && context == e_NewLine);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PRegExDFA
+{
+  public:
+    enum { MaxStates = 2000 };
+
+    PRegExDFA(const PRegExProgram & program, bool unanchored)
+      : m_program(program)
+      , m_unanchored(unanchored)
+      , m_classCount(0)
+      , m_generation(0)
+    {
+      for (int i = 0; i < NumContexts; ++i)
+        m_start[i] = NULL;
+    }
+
+
+    ~PRegExDFA()
+    {
+      Reset();
+    }
+
+
+    /* Discard all states, and the byte classes if the program changed */
+    void Reset(bool programChanged = false)
+    {
+      for (StateMap::iterator it = m_states.begin(); it != m_states.end(); ++it)
+        delete it->second;
+      m_states.clear();
+
+      for (int i = 0; i < NumContexts; ++i)
+        m_start[i] = NULL;
+
+      if (programChanged)
+        m_classCount = 0;
+    }
+
+
+    /* Run from begin towards the end of the text, return the end of the
+       longest match, or P_MAX_INDEX if none. */
+    PINDEX Longest(const char * text, PINDEX begin, PINDEX length, BYTE beginContext, BYTE endContext)
+    {
+      PINDEX last = P_MAX_INDEX;
+      State * state = GetStart(beginContext);
+      for (PINDEX i = begin; ; ++i) {
+        if (GetClosure(state, i < length ? PRegExCategory(text[i]) : endContext).m_matched)
+          last = i;
+        if (i >= length)
+          break;
+        state = GetNext(state, text[i]);
+        if (state->m_instructions.empty())
+          break; // Dead state, cannot match any more
+      }
+      return last;
+    }
+
+
+    /* Run from the end of the text towards the start, return the lowest
+       position where a match of the reversed program ended, which is the
+       leftmost start of a match of the pattern, or P_MAX_INDEX if none. */
+    PINDEX Leftmost(const char * text, PINDEX length, BYTE beginContext, BYTE endContext)
+    {
+      PINDEX first = P_MAX_INDEX;
+      State * state = GetStart(endContext);
+      for (PINDEX i = length; ; --i) {
+        if (GetClosure(state, i > 0 ? PRegExCategory(text[i-1]) : beginContext).m_matched)
+          first = i;
+        if (i == 0)
+          break;
+        state = GetNext(state, text[i-1]);
+        if (state->m_instructions.empty())
+          break;
+      }
+      return first;
+    }
+
+
+    /* Run through the whole text, marking each pattern that matched. */
+    void Search(const char * text, PINDEX length, BYTE beginContext, BYTE endContext,
+                std::vector<bool> & found, PINDEX & remaining)
+    {
+      State * state = GetStart(beginContext);
+      for (PINDEX i = 0; ; ++i) {
+        const Closure & closure = GetClosure(state, i < length ? PRegExCategory(text[i]) : endContext);
+        for (std::vector<unsigned>::const_iterator it = closure.m_matches.begin(); it != closure.m_matches.end(); ++it) {
+          if (!found[*it]) {
+            found[*it] = true;
+            if (--remaining == 0)
+              return;
+          }
+        }
+        if (i >= length)
+          break;
+        state = GetNext(state, text[i]);
+        if (state->m_instructions.empty())
+          break;
+      }
+    }
+
+
+    PCriticalSection m_mutex;
+
+  protected:
+    struct Closure
+    {
+      bool                  m_computed;
+      bool                  m_matched;
+      std::vector<unsigned> m_consumers;  // e_Set instructions reached
+      std::vector<unsigned> m_matches;    // Pattern identifiers that matched
+
+      Closure() : m_computed(false), m_matched(false) { }
+    };
+
+    struct State
+    {
+      BYTE                  m_context;      // Category of previous character
+      std::vector<unsigned> m_instructions; // Before following empty transitions
+      std::vector<State *>  m_next;         // Indexed by byte class
+      Closure               m_closure[NumContexts]; // Indexed by category of next character
+    };
+
+    typedef std::map<std::vector<unsigned>, State *> StateMap;
+
+
+    void CalculateClasses()
+    {
+      /* Divide the bytes into classes which no instruction distinguishes
+         between, so transitions are per class rather than per byte. The
+         '\n' is always in a class of its own, as it matters to anchors. */
+      memset(m_classOf, 0, sizeof(m_classOf));
+      m_classCount = 1;
+
+      PRegExCharSet newLine;
+      newLine.Set('\n');
+      Refine(newLine);
+      for (std::vector<PRegExCharSet>::const_iterator it = m_program.m_sets.begin(); it != m_program.m_sets.end(); ++it)
+        Refine(*it);
+
+      for (unsigned c = 256; c-- > 0;)
+        m_classExample[m_classOf[c]] = (BYTE)c;
+    }
+
+
+    void Refine(const PRegExCharSet & set)
+    {
+      std::vector<int> remap(m_classCount*2, -1);
+      unsigned count = 0;
+      for (unsigned c = 0; c < 256; ++c) {
+        int & newClass = remap[m_classOf[c]*2 + set.Test((BYTE)c)];
+        if (newClass < 0)
+          newClass = count++;
+        m_classOf[c] = (BYTE)newClass;
+      }
+      m_classCount = count;
+    }
+
+
+    State * GetStart(BYTE context)
+    {
+      if (m_classCount == 0)
+        CalculateClasses();
+
+      if (m_start[context] == NULL) {
+        std::vector<unsigned> key(m_program.m_starts.size()+1);
+        key[0] = context;
+        std::copy(m_program.m_starts.begin(), m_program.m_starts.end(), key.begin()+1);
+        std::sort(key.begin()+1, key.end());
+        m_start[context] = Lookup(key);
+      }
+      return m_start[context];
+    }
+
+
+    State * Lookup(const std::vector<unsigned> & key)
+    {
+      StateMap::iterator it = m_states.find(key);
+      if (it != m_states.end())
+        return it->second;
+
+      State * state = new State;
+      state->m_context = (BYTE)key[0];
+      state->m_instructions.assign(key.begin()+1, key.end());
+      state->m_next.resize(m_classCount);
+      m_states[key] = state;
+      return state;
+    }
+
+
+    const Closure & GetClosure(State * state, BYTE nextContext)
+    {
+      Closure & closure = state->m_closure[nextContext];
+      if (closure.m_computed)
+        return closure;
+
+      if (m_visited.size() < m_program.m_instructions.size())
+        m_visited.resize(m_program.m_instructions.size());
+      ++m_generation;
+
+      m_stack = state->m_instructions;
+      while (!m_stack.empty()) {
+        unsigned pc = m_stack.back();
+        m_stack.pop_back();
+        if (m_visited[pc] == m_generation)
+          continue;
+        m_visited[pc] = m_generation;
+
+        const PRegExProgram::Instruction & instruction = m_program.m_instructions[pc];
+        switch (instruction.m_op) {
+          case PRegExProgram::Instruction::e_Set :
+            closure.m_consumers.push_back(pc);
+            break;
+          case PRegExProgram::Instruction::e_Match :
+            closure.m_matches.push_back(instruction.m_x);
+            break;
+          case PRegExProgram::Instruction::e_Split :
+            m_stack.push_back(instruction.m_y);
+            // Fall into jump case
+          case PRegExProgram::Instruction::e_Jump :
+            m_stack.push_back(instruction.m_x);
+            break;
+          case PRegExProgram::Instruction::e_Save :
+            m_stack.push_back(pc+1);
+            break;
+          case PRegExProgram::Instruction::e_LineStart :
+            if (PRegExAssertion(instruction, state->m_context))
+              m_stack.push_back(pc+1);
+            break;
+          case PRegExProgram::Instruction::e_LineEnd :
+            if (PRegExAssertion(instruction, nextContext))
+              m_stack.push_back(pc+1);
+            break;
+        }
+      }
+
+      std::sort(closure.m_matches.begin(), closure.m_matches.end());
+      closure.m_matched = !closure.m_matches.empty();
+      closure.m_computed = true;
+      return closure;
+    }
+
+
+    __inline State * GetNext(State * state, char c)
+    {
+      unsigned byteClass = m_classOf[(BYTE)c];
+      State * next = state->m_next[byteClass];
+      return next != NULL ? next : CalculateNext(state, byteClass);
+    }
+
+
+    State * CalculateNext(State * state, unsigned byteClass)
+    {
+      BYTE c = m_classExample[byteClass];
+      BYTE context = PRegExCategory(c);
+
+      std::vector<unsigned> key;
+      key.push_back(context);
+
+      const Closure & closure = GetClosure(state, context);
+      for (std::vector<unsigned>::const_iterator it = closure.m_consumers.begin(); it != closure.m_consumers.end(); ++it) {
+        if (m_program.m_sets[m_program.m_instructions[*it].m_x].Test(c))
+          key.push_back(*it+1);
+      }
+
+      if (m_unanchored)
+        key.insert(key.end(), m_program.m_floating.begin(), m_program.m_floating.end());
+
+      std::sort(key.begin()+1, key.end());
+      key.erase(std::unique(key.begin()+1, key.end()), key.end());
+
+      if (m_states.size() < MaxStates)
+        return state->m_next[byteClass] = Lookup(key);
+
+      // Cache full, start again, state is deleted so do not remember transition
+      Reset();
+      return Lookup(key);
+    }
+
+
+    const PRegExProgram & m_program;
+    bool                  m_unanchored;
+    BYTE                  m_classOf[256];
+    BYTE                  m_classExample[256];
+    unsigned              m_classCount;
+    StateMap              m_states;
+    State               * m_start[NumContexts];
+    std::vector<unsigned> m_visited;
+    unsigned              m_generation;
+    std::vector<unsigned> m_stack;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/* Simulate the NFA directly to get the sub-expression positions. This is
+   only done for the already known extent of the match, from begin to end,
+   and the highest priority thread to match at end is the result. */
+
+class PRegExPikeVM
+{
+  public:
+    PRegExPikeVM(const PRegExProgram & program)
+      : m_program(program)
+      , m_captures(program.m_captures)
+    {
+      size_t count = program.m_instructions.size();
+      for (int i = 0; i < 2; ++i) {
+        m_lists[i].m_dense.resize(count);
+        m_lists[i].m_sparse.resize(count);
+        m_lists[i].m_slots.resize(count*m_captures);
+        m_lists[i].m_size = 0;
+      }
+    }
+
+
+    bool Execute(const char * text, PINDEX length, PINDEX begin, PINDEX end,
+                 BYTE beginContext, BYTE endContext, std::vector<int> & result)
+    {
+      std::vector<int> captures(m_captures, -1);
+
+      ThreadList * current = &m_lists[0];
+      ThreadList * next = &m_lists[1];
+      current->m_size = 0;
+      AddThread(*current, m_program.m_starts[0], captures, begin, beginContext,
+                begin < length ? PRegExCategory(text[begin]) : endContext);
+
+      for (PINDEX pos = begin; pos < end; ++pos) {
+        char c = text[pos];
+        BYTE nextContext = pos+1 < length ? PRegExCategory(text[pos+1]) : endContext;
+        next->m_size = 0;
+        for (unsigned i = 0; i < current->m_size; ++i) {
+          unsigned pc = current->m_dense[i];
+          const PRegExProgram::Instruction & instruction = m_program.m_instructions[pc];
+          if (instruction.m_op == PRegExProgram::Instruction::e_Set && m_program.m_sets[instruction.m_x].Test(c)) {
+            captures.assign(current->m_slots.begin() + pc*m_captures, current->m_slots.begin() + (pc+1)*m_captures);
+            AddThread(*next, pc+1, captures, pos+1, PRegExCategory(c), nextContext);
+          }
+        }
+        std::swap(current, next);
+        if (current->m_size == 0)
+          return false;
+      }
+
+      for (unsigned i = 0; i < current->m_size; ++i) {
+        unsigned pc = current->m_dense[i];
+        if (m_program.m_instructions[pc].m_op == PRegExProgram::Instruction::e_Match) {
+          result.assign(current->m_slots.begin() + pc*m_captures, current->m_slots.begin() + (pc+1)*m_captures);
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+
+  protected:
+    struct ThreadList
+    {
+      std::vector<unsigned> m_dense;   // Instructions in priority order
+      std::vector<unsigned> m_sparse;  // Index into m_dense for membership test
+      std::vector<int>      m_slots;   // Captures for each instruction
+      unsigned              m_size;
+
+      bool Contains(unsigned pc) const { unsigned i = m_sparse[pc]; return i < m_size && m_dense[i] == pc; }
+      void Add(unsigned pc) { m_sparse[pc] = m_size; m_dense[m_size++] = pc; }
+    };
+
+    struct StackEntry
+    {
+      unsigned m_pc;
+      int      m_slot;     // If not negative, restore this capture slot
+      int      m_value;
+      StackEntry(unsigned pc, int slot = -1, int value = 0) : m_pc(pc), m_slot(slot), m_value(value) { }
+    };
+
+
+    void AddThread(ThreadList & list, unsigned startPC, std::vector<int> & captures,
+                   PINDEX pos, BYTE previousContext, BYTE nextContext)
+    {
+      m_stack.push_back(StackEntry(startPC));
+      while (!m_stack.empty()) {
+        StackEntry entry = m_stack.back();
+        m_stack.pop_back();
+
+        if (entry.m_slot >= 0) {
+          captures[entry.m_slot] = entry.m_value;
+          continue;
+        }
+
+        unsigned pc = entry.m_pc;
+        if (list.Contains(pc))
+          continue;
+        list.Add(pc);
+
+        const PRegExProgram::Instruction & instruction = m_program.m_instructions[pc];
+        switch (instruction.m_op) {
+          case PRegExProgram::Instruction::e_Set :
+          case PRegExProgram::Instruction::e_Match :
+            std::copy(captures.begin(), captures.end(), list.m_slots.begin() + pc*m_captures);
+            break;
+          case PRegExProgram::Instruction::e_Split :
+            m_stack.push_back(StackEntry(instruction.m_y));
+            m_stack.push_back(StackEntry(instruction.m_x));
+            break;
+          case PRegExProgram::Instruction::e_Jump :
+            m_stack.push_back(StackEntry(instruction.m_x));
+            break;
+          case PRegExProgram::Instruction::e_Save :
+            m_stack.push_back(StackEntry(0, instruction.m_x, captures[instruction.m_x]));
+            captures[instruction.m_x] = (int)pos;
+            m_stack.push_back(StackEntry(pc+1));
+            break;
+          case PRegExProgram::Instruction::e_LineStart :
+            if (PRegExAssertion(instruction, previousContext))
+              m_stack.push_back(StackEntry(pc+1));
+            break;
+          case PRegExProgram::Instruction::e_LineEnd :
+            if (PRegExAssertion(instruction, nextContext))
+              m_stack.push_back(StackEntry(pc+1));
+            break;
+        }
+      }
+    }
+
+
+    const PRegExProgram   & m_program;
+    unsigned                m_captures;
+    ThreadList              m_lists[2];
+    std::vector<StackEntry> m_stack;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PRegularExpression::Compiled
+{
+  public:
+    Compiled()
+      : m_referenceCount(1)
+      , m_backtrack(NULL)
+      , m_groups(0)
+      , m_anchoredStart(false)
+      , m_forwardDFA(m_forward, false)
+      , m_reverseDFA(m_reverse, true)
+    {
+    }
+
+
+    ~Compiled()
+    {
+      if (m_backtrack != NULL) {
+        regfree(m_backtrack);
+        free(m_backtrack);
+      }
+    }
+
+
+    void AddReference() { ++m_referenceCount; }
+    bool IsShared() const { return m_referenceCount > 1; }
+
+    static void Release(Compiled * compiled)
+    {
+      if (compiled != NULL && --compiled->m_referenceCount == 0)
+        delete compiled;
+    }
+
+
+    ErrorCodes Compile(const PString & pattern, CompileOptions options)
+    {
+      if ((options & Backtracking) == 0) {
+        PRegExParser parser(pattern, options);
+        if (parser.Parse() && m_forward.Append(parser, 0, false, true) && m_reverse.Append(parser, 0, true, false)) {
+          m_groups = parser.m_groups;
+          m_anchoredStart = parser.m_anchoredStart;
+          return NoError;
+        }
+        m_forward.RemoveAll();
+        m_reverse.RemoveAll();
+      }
+
+      m_backtrack = (regex_t *)malloc(sizeof(regex_t));
+      ErrorCodes error = (ErrorCodes)regcomp(m_backtrack, pattern, (options - Backtracking).AsBits());
+      if (error != NoError) {
+        free(m_backtrack);
+        m_backtrack = NULL;
+      }
+      return error;
+    }
+
+
+    bool IsLinearTime() const { return m_backtrack == NULL; }
+
+
+    // Same interface as regexec() so either engine may be used
+    int Execute(const char * cstr, size_t count, regmatch_t * matches, int options)
+    {
+      if (m_backtrack != NULL)
+        return regexec(m_backtrack, cstr, count, matches, options);
+
+      PINDEX length = strlen(cstr);
+      BYTE beginContext = (options & NotBeginningOfLine) ? e_Other : e_Boundary;
+      BYTE endContext = (options & NotEndofLine) ? e_Other : e_Boundary;
+
+      PINDEX start, end;
+      if (!Search(cstr, length, beginContext, endContext, start, end))
+        return REG_NOMATCH;
+
+      if (count == 0)
+        return 0;
+
+      matches[0].rm_so = (regoff_t)start;
+      matches[0].rm_eo = (regoff_t)end;
+
+      if (count > 1) {
+        std::vector<int> captures(m_forward.m_captures, -1);
+        if (m_groups > 0) {
+          PRegExPikeVM vm(m_forward);
+          vm.Execute(cstr, length, start, end,
+                     start > 0 ? PRegExCategory(cstr[start-1]) : beginContext, endContext, captures);
+        }
+
+        for (size_t i = 1; i < count; ++i) {
+          if (i <= m_groups) {
+            matches[i].rm_so = captures[i*2];
+            matches[i].rm_eo = captures[i*2+1];
+          }
+          else
+            matches[i].rm_so = matches[i].rm_eo = -1;
+        }
+      }
+
+      return 0;
+    }
+
+
+    bool Matches(const char * cstr, int options)
+    {
+      PINDEX length = strlen(cstr);
+
+      if (m_backtrack != NULL) {
+        regmatch_t match;
+        return regexec(m_backtrack, cstr, 1, &match, options) == 0 && match.rm_so == 0 && (PINDEX)match.rm_eo == length;
+      }
+
+      return Longest(cstr, 0, length,
+                     (options & NotBeginningOfLine) ? e_Other : e_Boundary,
+                     (options & NotEndofLine) ? e_Other : e_Boundary) == length;
+    }
+
+
+  protected:
+    bool Search(const char * cstr, PINDEX length, BYTE beginContext, BYTE endContext, PINDEX & start, PINDEX & end)
+    {
+      if (m_anchoredStart)
+        start = 0;
+      else {
+        // Use shared cache of DFA states, unless another thread is, then use our own
+        if (m_reverseDFA.m_mutex.Try()) {
+          start = m_reverseDFA.Leftmost(cstr, length, beginContext, endContext);
+          m_reverseDFA.m_mutex.Signal();
+        }
+        else
+          start = PRegExDFA(m_reverse, true).Leftmost(cstr, length, beginContext, endContext);
+
+        if (start == P_MAX_INDEX)
+          return false;
+      }
+
+      end = Longest(cstr, start, length, start > 0 ? PRegExCategory(cstr[start-1]) : beginContext, endContext);
+      return end != P_MAX_INDEX;
+    }
+
+
+    PINDEX Longest(const char * cstr, PINDEX begin, PINDEX length, BYTE beginContext, BYTE endContext)
+    {
+      if (!m_forwardDFA.m_mutex.Try())
+        return PRegExDFA(m_forward, false).Longest(cstr, begin, length, beginContext, endContext);
+
+      PINDEX end = m_forwardDFA.Longest(cstr, begin, length, beginContext, endContext);
+      m_forwardDFA.m_mutex.Signal();
+      return end;
+    }
+
+
+  public:
+    class Cache;
+    static Cache & GetCache();
+
+  protected:
+    atomic<unsigned> m_referenceCount;
+    regex_t        * m_backtrack;
+    PRegExProgram    m_forward;
+    PRegExProgram    m_reverse;
+    unsigned         m_groups;
+    bool             m_anchoredStart;
+    PRegExDFA        m_forwardDFA;
+    PRegExDFA        m_reverseDFA;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PRegularExpression::Compiled::Cache
+{
+  public:
+    enum { DefaultMaxSize = 1000 };
+
+    Cache()
+      : m_maxSize(DefaultMaxSize)
+    {
+    }
+
+
+    ~Cache()
+    {
+      for (CacheMap::iterator it = m_cache.begin(); it != m_cache.end(); ++it)
+        Compiled::Release(it->second);
+    }
+
+
+    Compiled * Get(const PString & pattern, PRegularExpression::CompileOptions options)
+    {
+      PWaitAndSignal lock(m_mutex);
+      CacheMap::iterator it = m_cache.find(Key(pattern, options));
+      if (it == m_cache.end())
+        return NULL;
+
+      it->second->AddReference();
+      return it->second;
+    }
+
+
+    void Add(const PString & pattern, PRegularExpression::CompileOptions options, Compiled * compiled)
+    {
+      PWaitAndSignal lock(m_mutex);
+
+      if (m_cache.size() >= m_maxSize) {
+        // Remove patterns not in use anywhere but the cache
+        CacheMap::iterator it = m_cache.begin();
+        while (it != m_cache.end()) {
+          if (it->second->IsShared())
+            ++it;
+          else {
+            Compiled::Release(it->second);
+            m_cache.erase(it++);
+          }
+        }
+        if (m_cache.size() >= m_maxSize)
+          return;
+      }
+
+      Key key(pattern, options);
+      if (m_cache.find(key) != m_cache.end())
+        return; // Another thread compiled it at the same time
+
+      compiled->AddReference();
+      m_cache[key] = compiled;
+    }
+
+
+    void SetMaxSize(PINDEX size)
+    {
+      PWaitAndSignal lock(m_mutex);
+      m_maxSize = size;
+    }
+
+
+  protected:
+    typedef std::pair<PString, unsigned> Key;
+    typedef std::map<Key, Compiled *> CacheMap;
+
+    CacheMap         m_cache;
+    PINDEX           m_maxSize;
+    PCriticalSection m_mutex;
+};
+
+
+PRegularExpression::Compiled::Cache & PRegularExpression::Compiled::GetCache()
+{
+  return *PSafeSingleton<Cache>();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PRegularExpression::PRegularExpression()
+  : m_compileOptions(IgnoreCase)
+  , m_compiled(NULL)
+  , m_lastError(NotCompiled)
+{
+}
+
+
+PRegularExpression::PRegularExpression(const PString & pattern, CompileOptions options)
+  : m_pattern(pattern)
+  , m_compileOptions(options)
+  , m_compiled(NULL)
+{
+  InternalCompile(true);
+}
+
+
+PRegularExpression::PRegularExpression(const char * pattern, CompileOptions options)
+  : m_pattern(pattern)
+  , m_compileOptions(options)
+  , m_compiled(NULL)
+{
+  InternalCompile(true);
+}
+
+
+PRegularExpression::PRegularExpression(const PRegularExpression & from)
+  : m_pattern(from.m_pattern)
+  , m_compileOptions(from.m_compileOptions)
+  , m_compiled(from.m_compiled)
+  , m_lastError(from.m_compiled != NULL ? NoError : from.m_lastError)
+{
+  if (m_compiled != NULL)
+    m_compiled->AddReference();
+}
+
+
+PRegularExpression & PRegularExpression::operator=(const PRegularExpression & from)
+{
+  if (&from != this) {
+    InternalClean();
+    m_pattern = from.m_pattern;
+    m_compileOptions = from.m_compileOptions;
+    m_compiled = from.m_compiled;
+    m_lastError = from.m_compiled != NULL ? NoError : from.m_lastError;
+    if (m_compiled != NULL)
+      m_compiled->AddReference();
+  }
+
+  return *this;
+}
+
+
+PRegularExpression::~PRegularExpression()
+{
+  InternalClean();
+}
+
+
+void PRegularExpression::InternalClean()
+{
+  Compiled::Release(m_compiled);
+  m_compiled = NULL;
+}
+
+
+void PRegularExpression::PrintOn(ostream &strm) const
+{
+  strm << m_pattern;
+}
+
+
+PString PRegularExpression::GetErrorText() const
+{
+  char str[256];
+  regerror(m_lastError, NULL, str, sizeof(str));
+  return str;
+}
+
+
+bool PRegularExpression::IsLinearTime() const
+{
+  return m_compiled != NULL && m_compiled->IsLinearTime();
+}
+
+
+bool PRegularExpression::Compile(const PString & pattern, CompileOptions options)
+{
+  m_pattern = pattern;
+  m_compileOptions = options;
+  return InternalCompile(false);
+}
+
+
+bool PRegularExpression::Compile(const char * pattern, CompileOptions options)
+{
+  m_pattern = pattern;
+  m_compileOptions = options;
+  return InternalCompile(false);
+}
+
+
+bool PRegularExpression::InternalCompile(bool assertOnFail)
+{
+  InternalClean();
+
+  if (m_pattern.IsEmpty()) {
+    m_lastError = assertOnFail ? NotCompiled : BadPattern;
+    return false;
+  }
+
+  Compiled::Cache & cache = Compiled::GetCache();
+  if ((m_compiled = cache.Get(m_pattern, m_compileOptions)) != NULL) {
+    m_lastError = NoError;
+    return true;
+  }
+
+  m_compiled = new Compiled;
+  m_lastError = m_compiled->Compile(m_pattern, m_compileOptions);
+  if (m_lastError == NoError) {
+    cache.Add(m_pattern, m_compileOptions, m_compiled);
+    return true;
+  }
+
+  InternalClean();
+
+  if (assertOnFail)
+    PAssertAlways(PSTRSTRM("Regular expression " << m_pattern.ToLiteral() << " failed to compile: " << GetErrorText()));
+
+  return false;
+}
+
+
+void PRegularExpression::SetMaxCacheSize(PINDEX size)
+{
+  Compiled::GetCache().SetMaxSize(size);
+}
+
+
+bool PRegularExpression::Execute(const PString & str, PINDEX & start, ExecOptions options) const
+{
+  PINDEX dummy;
+  return Execute((const char *)str, start, dummy, options);
+}
+
+
+bool PRegularExpression::Execute(const PString & str, PINDEX & start, PINDEX & len, ExecOptions options) const
+{
+  return Execute((const char *)str, start, len, options);
+}
+
+
+bool PRegularExpression::Execute(const char * cstr, PINDEX & start, ExecOptions options) const
+{
+  PINDEX dummy;
+  return Execute(cstr, start, dummy, options);
+}
+
+
+bool PRegularExpression::Execute(const char * cstr, PINDEX & start, PINDEX & len, ExecOptions options) const
+{
+  if (m_compiled == NULL)
+    m_lastError = NotCompiled;
+
+  if (m_lastError != NoError && m_lastError != NoMatch)
+    return false;
+
+  regmatch_t match;
+
+  m_lastError = (ErrorCodes)m_compiled->Execute(cstr, 1, &match, options);
+  if (m_lastError != NoError)
+    return false;
+
+  start = match.rm_so;
+  len = match.rm_eo - start;
+  return true;
+}
+
+
+bool PRegularExpression::Execute(const PString & str, PIntArray & starts, ExecOptions options) const
+{
+  PIntArray dummy;
+  return Execute((const char *)str, starts, dummy, options);
+}
+
+
+bool PRegularExpression::Execute(const PString & str,
+                                 PIntArray & starts,
+                                 PIntArray & ends,
+                                 ExecOptions options) const
+{
+  return Execute((const char *)str, starts, ends, options);
+}
+
+
+bool PRegularExpression::Execute(const char * cstr, PIntArray & starts, ExecOptions options) const
+{
+  PIntArray dummy;
+  return Execute(cstr, starts, dummy, options);
+}
+
+
+bool PRegularExpression::Execute(const char * cstr,
+                                 PIntArray & starts,
+                                 PIntArray & ends,
+                                 ExecOptions options) const
+{
+  if (m_compiled == NULL) {
+    m_lastError = NotCompiled;
+    return false;
+  }
+
+  PINDEX count = starts.GetSize();
+  if (count == 0) {
+    starts.SetSize(1);
+    count = 1;
+  }
+  ends.SetSize(count);
+
+  regmatch_t * matches = new regmatch_t[count];
+
+  m_lastError = (ErrorCodes)m_compiled->Execute(cstr, count, matches, options);
+  if (m_lastError == NoError) {
+    for (PINDEX i = 0; i < count; i++) {
+      starts[i] = matches[i].rm_so;
+      ends[i] = matches[i].rm_eo;
+    }
+  }
+
+  delete [] matches;
+
+  return m_lastError == NoError;
+}
+
+
+bool PRegularExpression::Execute(const char * cstr, PStringArray & substring, ExecOptions options) const
+{
+  if (m_compiled == NULL) {
+    m_lastError = NotCompiled;
+    return false;
+  }
+
+  PINDEX count = substring.GetSize();
+  if (count == 0) {
+    substring.SetSize(1);
+    count = 1;
+  }
+
+  regmatch_t * matches = new regmatch_t[count];
+
+  m_lastError = (ErrorCodes)m_compiled->Execute(cstr, count, matches, options);
+  if (m_lastError == NoError) {
+    for (PINDEX i = 0; i < count; i++)
+      substring[i] = PString(cstr+matches[i].rm_so, matches[i].rm_eo-matches[i].rm_so);
+  }
+
+  delete [] matches;
+
+  return m_lastError == NoError;
+}
+
+
+bool PRegularExpression::Matches(const char * cstr, ExecOptions options) const
+{
+  if (m_compiled == NULL) {
+    m_lastError = NotCompiled;
+    return false;
+  }
+
+  m_lastError = m_compiled->Matches(cstr, options) ? NoError : NoMatch;
+  return m_lastError == NoError;
+}
+
+
+PString PRegularExpression::EscapeString(const PString & str)
+{
+  PString translated = str;
+
+  PINDEX lastPos = 0;
+  PINDEX nextPos;
+  while ((nextPos = translated.FindOneOf("\\^$+?*.[]()|{}", lastPos)) != P_MAX_INDEX) {
+    translated.Splice("\\", nextPos);
+    lastPos = nextPos+2;
+  }
+
+  return translated;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class PRegularExpressionSet::Combined
+{
+  public:
+    Combined()
+      : m_dfa(m_program, true)
+      , m_linearCount(0)
+    {
+    }
+
+    PRegExProgram         m_program;
+    PRegExDFA             m_dfa;
+    PINDEX                m_linearCount;
+    std::vector<PINDEX>   m_backtracking; // Patterns executed individually
+};
+
+
+PRegularExpressionSet::PRegularExpressionSet()
+  : m_combined(new Combined)
+{
+}
+
+
+PRegularExpressionSet::~PRegularExpressionSet()
+{
+  RemoveAll();
+  delete m_combined;
+}
+
+
+PINDEX PRegularExpressionSet::Add(const PString & pattern, PRegularExpression::CompileOptions options)
+{
+  PRegularExpression * regex = new PRegularExpression;
+  if (!regex->Compile(pattern, options)) {
+    delete regex;
+    return P_MAX_INDEX;
+  }
+
+  PINDEX index = GetSize();
+
+  bool linear = regex->IsLinearTime();
+  if (linear) {
+    PRegExParser parser(pattern, options);
+    linear = parser.Parse() && m_combined->m_program.Append(parser, (unsigned)index, false, false);
+    if (linear) {
+      ++m_combined->m_linearCount;
+      m_combined->m_dfa.Reset(true);
+    }
+    else {
+      // Too big when combined, rebuild without it
+      m_combined->m_program.RemoveAll();
+      m_combined->m_linearCount = 0;
+      m_combined->m_dfa.Reset(true);
+      for (PINDEX i = 0; i < index; ++i) {
+        if (std::find(m_combined->m_backtracking.begin(), m_combined->m_backtracking.end(), i) == m_combined->m_backtracking.end()) {
+          PRegExParser reparse(m_patterns[i]->GetPattern(), m_patterns[i]->m_compileOptions);
+          reparse.Parse();
+          m_combined->m_program.Append(reparse, (unsigned)i, false, false);
+          ++m_combined->m_linearCount;
+        }
+      }
+    }
+  }
+
+  if (!linear)
+    m_combined->m_backtracking.push_back(index);
+
+  m_patterns.push_back(regex);
+  return index;
+}
+
+
+void PRegularExpressionSet::RemoveAll()
+{
+  for (std::vector<PRegularExpression *>::iterator it = m_patterns.begin(); it != m_patterns.end(); ++it)
+    delete *it;
+  m_patterns.clear();
+
+  m_combined->m_program.RemoveAll();
+  m_combined->m_dfa.Reset(true);
+  m_combined->m_linearCount = 0;
+  m_combined->m_backtracking.clear();
+}
+
+
+bool PRegularExpressionSet::Execute(const char * cstr, std::vector<PINDEX> & matches, PRegularExpression::ExecOptions options) const
+{
+  matches.clear();
+
+  std::vector<bool> found(m_patterns.size());
+
+  PINDEX remaining = m_combined->m_linearCount;
+  if (remaining > 0) {
+    PINDEX length = strlen(cstr);
+    BYTE beginContext = (options & PRegularExpression::NotBeginningOfLine) ? e_Other : e_Boundary;
+    BYTE endContext = (options & PRegularExpression::NotEndofLine) ? e_Other : e_Boundary;
+
+    if (m_combined->m_dfa.m_mutex.Try()) {
+      m_combined->m_dfa.Search(cstr, length, beginContext, endContext, found, remaining);
+      m_combined->m_dfa.m_mutex.Signal();
+    }
+    else
+      PRegExDFA(m_combined->m_program, true).Search(cstr, length, beginContext, endContext, found, remaining);
+  }
+
+  for (std::vector<PINDEX>::const_iterator it = m_combined->m_backtracking.begin(); it != m_combined->m_backtracking.end(); ++it) {
+    PINDEX start, len;
+    if (m_patterns[*it]->Execute(cstr, start, len, options))
+      found[*it] = true;
+  }
+
+  for (size_t i = 0; i < found.size(); ++i) {
+    if (found[i])
+      matches.push_back((PINDEX)i);
+  }
+
+  return !matches.empty();
+}
+
+
+PINDEX PRegularExpressionSet::FindFirst(const PString & str, PRegularExpression::ExecOptions options) const
+{
+  std::vector<PINDEX> matches;
+  return Execute(str, matches, options) ? matches.front() : P_MAX_INDEX;
+}
+
+
+// End Of File ///////////////////////////////////////////////////////////////
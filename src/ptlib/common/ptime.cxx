@@ -249,8 +249,10 @@ PTime::PTime(time_t tsecs, int64_t usecs)
 PTime::PTime(const PString & str)
   : m_microSecondsSinceEpoch(0)
 {
-  PStringStream s(str);
-  ReadFrom(s);
+  if (!ParseStandard(str)) {
+    PStringStream s(str);
+    ReadFrom(s);
+  }
 }
 
 
@@ -396,16 +398,28 @@ PString PTime::AsString(TimeFormat format, int zone) const
 
   switch (format) {
     case RFC1123 :
-      return AsString("wwwe, dd MMME yyyy hh:mm:ss z", zone);
+    {
+      static const PTimeFormatter formatter("wwwe, dd MMME yyyy hh:mm:ss z");
+      return formatter.Format(*this, zone);
+    }
 
     case RFC3339 :
-      return AsString("yyyy-MM-ddThh:mm:ssZZ", zone);
+    {
+      static const PTimeFormatter formatter("yyyy-MM-ddThh:mm:ssZZ");
+      return formatter.Format(*this, zone);
+    }
 
     case ShortISO8601 :
-      return AsString("yyyyMMddThhmmssZ", zone);
+    {
+      static const PTimeFormatter formatter("yyyyMMddThhmmssZ");
+      return formatter.Format(*this, zone);
+    }
 
     case LongISO8601 :
-      return AsString("yyyy-MM-ddThh:mm:ss.uuuZ", zone);
+    {
+      static const PTimeFormatter formatter("yyyy-MM-ddThh:mm:ss.uuuZ");
+      return formatter.Format(*this, zone);
+    }
 
     case EpochTime:
     {
@@ -417,13 +431,18 @@ PString PTime::AsString(TimeFormat format, int zone) const
     {
       PTime now;
       static const PTimeInterval halfDay(0, 0, 0, 12);
-      if (*this > (now - halfDay) && *this < (now + halfDay))
-        return AsString("hh:mm:ss.uuu", zone);
+      if (*this > (now - halfDay) && *this < (now + halfDay)) {
+        static const PTimeFormatter formatter("hh:mm:ss.uuu");
+        return formatter.Format(*this, zone);
+      }
       // Do next case
     }
 
     case LoggingFormat :
-      return AsString("yyyy/MM/dd hh:mm:ss.uuu", zone);
+    {
+      static const PTimeFormatter formatter("yyyy/MM/dd hh:mm:ss.uuu");
+      return formatter.Format(*this, zone);
+    }
 
     default:
       break;
@@ -532,139 +551,350 @@ PString PTime::AsString(TimeFormat format, int zone) const
 
 PString PTime::AsString(const char * format, int zone) const
 {
-  PAssert(format != NULL, PInvalidParameter);
-  PAssert(zone == Local || std::abs(zone) <= 13, PInvalidParameter);
+  return PTimeFormatter(format).Format(*this, zone);
+}
 
-  if (!IsValid())
-    return "<invalid>";
 
-  // the localtime call automatically adjusts for daylight savings time
-  // so take this into account when converting non-local times
-  if (zone == Local)
-    zone = GetTimeZone();  // includes daylight savings time
-  time_t realTime = m_microSecondsSinceEpoch.load()/Micro + zone*60;     // to correct timezone
-  struct tm ts;
-  struct tm * t = os_gmtime(&realTime, &ts);
-  if (t == NULL)
-    return "<error>";
+///////////////////////////////////////////////////////////////////////////////
+// PTimeFormatter
+
+PTimeFormatter::PTimeFormatter(const char * format)
+  : m_is12hour(false)
+{
+  Compile(format);
+}
 
-  PStringStream str;
-  str.fill('0');
 
-  bool is12hour = strchr(format, 'a') != NULL;
+void PTimeFormatter::Compile(const char * format)
+{
+  PAssert(format != NULL, PInvalidParameter);
+
+  m_ops.clear();
+  m_literals.clear();
+  m_is12hour = strchr(format, 'a') != NULL;
 
   while (*format != '\0') {
     char formatLetter = *format;
-    PINDEX repeatCount = 1;
+    unsigned repeatCount = 1;
     while (*++format == formatLetter)
       repeatCount++;
 
     switch (formatLetter) {
       case 'a' :
-        if (t->tm_hour < 12)
-          str << GetTimeAM();
-        else
-          str << GetTimePM();
+        m_ops.push_back(Op(e_AmPm, 0));
         break;
 
       case 'h' :
-        str << setw(repeatCount) << (is12hour ? (t->tm_hour+11)%12+1 : t->tm_hour);
+        m_ops.push_back(Op(e_Hour, repeatCount));
         break;
 
       case 'm' :
-        str << setw(repeatCount) << t->tm_min;
+        m_ops.push_back(Op(e_Minute, repeatCount));
         break;
 
       case 's' :
-        str << setw(repeatCount) << t->tm_sec;
+        m_ops.push_back(Op(e_Second, repeatCount));
         break;
 
       case 'w' :
-        if (repeatCount != 3 || *format != 'e')
-          str << GetDayName((Weekdays)t->tm_wday, repeatCount <= 3 ? Abbreviated : FullName);
-        else {
-          static const char * const EnglishDayName[] = {
-            "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
-          };
-          str << EnglishDayName[t->tm_wday];
+        if (repeatCount == 3 && *format == 'e') {
+          m_ops.push_back(Op(e_EnglishDayName, 0));
           format++;
         }
+        else
+          m_ops.push_back(Op(repeatCount <= 3 ? e_DayName : e_FullDayName, 0));
         break;
 
       case 'M' :
         if (repeatCount < 3)
-          str << setw(repeatCount) << (t->tm_mon+1);
-        else if (repeatCount > 3 || *format != 'E')
-          str << GetMonthName((Months)(t->tm_mon+1),
-                                    repeatCount == 3 ? Abbreviated : FullName);
-        else {
-          static const char * const EnglishMonthName[] = {
-            "Jan", "Feb", "Mar", "Apr", "May", "Jun",
-            "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
-          };
-          str << EnglishMonthName[t->tm_mon];
+          m_ops.push_back(Op(e_Month, repeatCount));
+        else if (repeatCount == 3 && *format == 'E') {
+          m_ops.push_back(Op(e_EnglishMonthName, 0));
           format++;
         }
+        else
+          m_ops.push_back(Op(repeatCount == 3 ? e_MonthName : e_FullMonthName, 0));
         break;
 
       case 'd' :
-        str << setw(repeatCount) << t->tm_mday;
+        m_ops.push_back(Op(e_Day, repeatCount));
         break;
 
       case 'y' :
         if (repeatCount < 3)
-          str << setw(2) << (t->tm_year%100);
+          m_ops.push_back(Op(e_ShortYear, 2));
         else
-          str << setw(4) << (t->tm_year+1900);
+          m_ops.push_back(Op(e_Year, 4));
         break;
 
       case 'z' :
+        m_ops.push_back(Op(repeatCount == 1 ? e_ZoneGMT : e_ZoneOffset, 0));
+        break;
+
       case 'Z' :
-        if (zone == 0 && formatLetter == 'Z')
-          str << 'Z';
-        else if (zone == 0 && repeatCount == 1)
-          str << "GMT";
-        else {
-          str << (zone < 0 ? '-' : '+');
-          zone = PABS(zone);
-          str << setw(2) << (zone/60);
-          if (repeatCount > 0)
-            str << ':';
-          str << setw(2) << (zone%60);
-        }
+        m_ops.push_back(Op(e_ZoneZ, 0));
         break;
 
       case 'u':
-      {
-        unsigned usecs = m_microSecondsSinceEpoch.load()%Micro;
         switch (repeatCount) {
           case 1:
-            str << (usecs / 100000);
+            m_ops.push_back(Op(e_Tenths, 1));
             break;
           case 2:
-            str << setw(2) << (usecs / 10000);
+            m_ops.push_back(Op(e_Hundredths, 2));
             break;
           case 3:
-            str << setw(3) << (usecs / 1000);
+            m_ops.push_back(Op(e_Milliseconds, 3));
             break;
           default:
-            str << setw(6) << usecs;
+            m_ops.push_back(Op(e_Microseconds, 6));
             break;
         }
         break;
-      }
 
       case '\\' :
         // Escaped character, put straight through to output string
 
       default :
-        str << formatLetter;
+        // Note a run of the same character is output once
+        if (m_ops.empty() || m_ops.back().m_code != e_Literal) {
+          m_ops.push_back(Op(e_Literal, 0));
+          m_ops.back().m_offset = (unsigned)m_literals.length();
+        }
+        m_literals += formatLetter;
+        m_ops.back().m_length++;
     }
   }
+}
+
 
+PString PTimeFormatter::Format(const PTime & time, int zone) const
+{
+  char buffer[100];
+  PINDEX len = Format(time, buffer, sizeof(buffer), zone);
+  if (len < (PINDEX)sizeof(buffer))
+    return PString(buffer, len);
+
+  // Long, probably localised, names, try again with enough room
+  PString str;
+  Format(time, str.GetPointerAndSetLength(len), len+1, zone);
   return str;
 }
 
+
+namespace {
+  struct BrokenDownTime
+  {
+    bool      m_valid;
+    time_t    m_utcSeconds;
+    int       m_requestedZone;
+    int       m_zone;
+    struct tm m_tm;
+  };
+
+  // Formatting is usually for "now", so most calls are in the same second
+  static P_THREAD_LOCAL BrokenDownTime s_lastBrokenDownTime;
+
+
+  class TimeOutput
+  {
+      char * m_ptr;
+      char * m_end;
+      PINDEX m_length;
+
+    public:
+      TimeOutput(char * buffer, PINDEX size)
+        : m_ptr(buffer)
+        , m_end(buffer + size - 1)
+        , m_length(0)
+      {
+      }
+
+      PINDEX Finish()
+      {
+        *m_ptr = '\0';
+        return m_length;
+      }
+
+      void Append(const char * str, PINDEX len)
+      {
+        m_length += len;
+        PINDEX room = m_end - m_ptr;
+        if (len > room)
+          len = room;
+        memcpy(m_ptr, str, len);
+        m_ptr += len;
+      }
+
+      void Append(const char * str)
+      {
+        Append(str, strlen(str));
+      }
+
+      void Append(const PString & str)
+      {
+        Append(str, str.GetLength());
+      }
+
+      void Append(unsigned value, unsigned width)
+      {
+        char digits[12];
+        char * ptr = &digits[sizeof(digits)];
+        do {
+          *--ptr = (char)('0' + value%10);
+          value /= 10;
+        } while (value != 0);
+        while (&digits[sizeof(digits)] - ptr < (ptrdiff_t)width && ptr > digits)
+          *--ptr = '0';
+        Append(ptr, &digits[sizeof(digits)] - ptr);
+      }
+  };
+}
+
+
+PINDEX PTimeFormatter::Format(const PTime & time, char * buffer, PINDEX size, int zone) const
+{
+  PAssert(buffer != NULL && size > 0, PInvalidParameter);
+  PAssert(zone == PTime::Local || std::abs(zone) <= 13, PInvalidParameter);
+
+  TimeOutput output(buffer, size);
+
+  if (!time.IsValid()) {
+    output.Append("<invalid>");
+    return output.Finish();
+  }
+
+  int64_t timestamp = time.GetTimestamp();
+  time_t utcSeconds = (time_t)(timestamp/1000000);
+
+  BrokenDownTime & cache = s_lastBrokenDownTime;
+  if (!cache.m_valid || cache.m_utcSeconds != utcSeconds || cache.m_requestedZone != zone) {
+    cache.m_valid = false;
+    cache.m_utcSeconds = utcSeconds;
+    cache.m_requestedZone = zone;
+
+    // the localtime call automatically adjusts for daylight savings time
+    // so take this into account when converting non-local times
+    cache.m_zone = zone == PTime::Local ? PTime::GetTimeZone() : zone;  // includes daylight savings time
+    time_t realTime = utcSeconds + cache.m_zone*60;     // to correct timezone
+    if (PTime::os_gmtime(&realTime, &cache.m_tm) == NULL) {
+      output.Append("<error>");
+      return output.Finish();
+    }
+    cache.m_valid = true;
+  }
+
+  const struct tm & t = cache.m_tm;
+  zone = cache.m_zone;
+  unsigned usecs = (unsigned)(timestamp%1000000);
+
+  static const char * const EnglishDayName[] = {
+    "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+  };
+  static const char * const EnglishMonthName[] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+  };
+
+  for (std::vector<Op>::const_iterator op = m_ops.begin(); op != m_ops.end(); ++op) {
+    switch (op->m_code) {
+      case e_Literal :
+        output.Append(m_literals.data() + op->m_offset, op->m_length);
+        break;
+
+      case e_AmPm :
+        output.Append(t.tm_hour < 12 ? PTime::GetTimeAM() : PTime::GetTimePM());
+        break;
+
+      case e_Hour :
+        output.Append(m_is12hour ? (t.tm_hour+11)%12+1 : t.tm_hour, op->m_width);
+        break;
+
+      case e_Minute :
+        output.Append(t.tm_min, op->m_width);
+        break;
+
+      case e_Second :
+        output.Append(t.tm_sec, op->m_width);
+        break;
+
+      case e_DayName :
+        output.Append(PTime::GetDayName((PTime::Weekdays)t.tm_wday, PTime::Abbreviated));
+        break;
+
+      case e_FullDayName :
+        output.Append(PTime::GetDayName((PTime::Weekdays)t.tm_wday, PTime::FullName));
+        break;
+
+      case e_EnglishDayName :
+        output.Append(EnglishDayName[t.tm_wday], 3);
+        break;
+
+      case e_Month :
+        output.Append(t.tm_mon+1, op->m_width);
+        break;
+
+      case e_MonthName :
+        output.Append(PTime::GetMonthName((PTime::Months)(t.tm_mon+1), PTime::Abbreviated));
+        break;
+
+      case e_FullMonthName :
+        output.Append(PTime::GetMonthName((PTime::Months)(t.tm_mon+1), PTime::FullName));
+        break;
+
+      case e_EnglishMonthName :
+        output.Append(EnglishMonthName[t.tm_mon], 3);
+        break;
+
+      case e_Day :
+        output.Append(t.tm_mday, op->m_width);
+        break;
+
+      case e_ShortYear :
+        output.Append(t.tm_year%100, 2);
+        break;
+
+      case e_Year :
+        output.Append(t.tm_year+1900, 4);
+        break;
+
+      case e_ZoneZ :
+      case e_ZoneGMT :
+        if (zone == 0) {
+          output.Append(op->m_code == e_ZoneZ ? "Z" : "GMT");
+          break;
+        }
+        // Do next case
+
+      case e_ZoneOffset :
+        output.Append(zone < 0 ? "-" : "+", 1);
+        output.Append(PABS(zone)/60, 2);
+        output.Append(":", 1);
+        output.Append(PABS(zone)%60, 2);
+        break;
+
+      case e_Tenths :
+        output.Append(usecs/100000, 1);
+        break;
+
+      case e_Hundredths :
+        output.Append(usecs/10000, 2);
+        break;
+
+      case e_Milliseconds :
+        output.Append(usecs/1000, 3);
+        break;
+
+      case e_Microseconds :
+        output.Append(usecs, 6);
+        break;
+    }
+  }
+
+  return output.Finish();
+}
+
+
 ///////////////////////////////////////////////////////////
 //
 //  Time parser
@@ -720,6 +950,182 @@ int STDAPICALLTYPE PTimeIsDayName(const char * str, int day, int abbrev)
 };
 
 
+static bool ParseDigits(const char * & str, unsigned count, int & value)
+{
+  value = 0;
+  while (count-- > 0) {
+    if (*str < '0' || *str > '9')
+      return false;
+    value = value*10 + *str++ - '0';
+  }
+  return true;
+}
+
+
+static bool ParseZone(const char * & str, int & zone)
+{
+  switch (*str) {
+    case 'Z' :
+    case 'z' :
+      zone = 0;
+      ++str;
+      return true;
+
+    case '+' :
+    case '-' :
+    {
+      bool negative = *str++ == '-';
+      int hours, minutes = 0;
+      if (!ParseDigits(str, 2, hours))
+        return false;
+      if (*str == ':')
+        ++str;
+      if (isdigit(*str) && !ParseDigits(str, 2, minutes))
+        return false;
+      if (hours > 23 || minutes > 59)
+        return false;
+      zone = hours*60 + minutes;
+      if (negative)
+        zone = -zone;
+      return true;
+    }
+  }
+
+  if (strncasecmp(str, "GMT", 3) == 0 || strncasecmp(str, "UTC", 3) == 0) {
+    zone = 0;
+    str += 3;
+    return true;
+  }
+
+  if (strncasecmp(str, "UT", 2) == 0) {
+    zone = 0;
+    str += 2;
+    return true;
+  }
+
+  return false;
+}
+
+
+static bool ParseTimeOfDay(const char * & str, bool separators, int & hour, int & minute, int & second)
+{
+  if (!ParseDigits(str, 2, hour))
+    return false;
+  if (separators && *str++ != ':')
+    return false;
+  if (!ParseDigits(str, 2, minute))
+    return false;
+  if (separators && *str++ != ':')
+    return false;
+  return ParseDigits(str, 2, second);
+}
+
+
+// Days since 1970-01-01 for a Gregorian calendar date
+static int64_t DaysFromCivil(int year, int month, int day)
+{
+  year -= month <= 2;
+  int64_t era = (year >= 0 ? year : year-399) / 400;
+  unsigned yoe = (unsigned)(year - era * 400);
+  unsigned doy = (153*(month + (month > 2 ? -3 : 9)) + 2)/5 + day-1;
+  unsigned doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+  return era * 146097 + (int64_t)doe - 719468;
+}
+
+
+bool PTime::ParseStandard(const char * str)
+{
+  if (str == NULL)
+    return false;
+
+  while (isspace(*str))
+    ++str;
+
+  int year, month, day, hour, minute, second, zone;
+  int64_t usecs = 0;
+
+  if (isdigit(str[0]) && isdigit(str[1]) && isdigit(str[2]) && isdigit(str[3])) {
+    // ISO8601, long form yyyy-MM-ddThh:mm:ss[.uuu]zone or short yyyyMMddThhmmss[.uuu]zone
+    ParseDigits(str, 4, year);
+    bool separators = *str == '-';
+    if (separators)
+      ++str;
+    if (!ParseDigits(str, 2, month))
+      return false;
+    if (separators && *str++ != '-')
+      return false;
+    if (!ParseDigits(str, 2, day))
+      return false;
+    if (*str != 'T' && *str != 't')
+      return false;
+    ++str;
+    if (!ParseTimeOfDay(str, separators, hour, minute, second))
+      return false;
+
+    if (*str == '.' || *str == ',') {
+      ++str;
+      if (!isdigit(*str))
+        return false;
+      int64_t scale = Micro;
+      while (isdigit(*str)) {
+        scale /= 10;
+        usecs += (*str++ - '0')*scale;
+      }
+    }
+  }
+  else {
+    // RFC1123, [www, ]dd MMM yyyy hh:mm:ss zone
+    if (isalpha(str[0]) && isalpha(str[1]) && isalpha(str[2]) && str[3] == ',') {
+      str += 4;
+      while (*str == ' ')
+        ++str;
+    }
+
+    if (!ParseDigits(str, 1, day))
+      return false;
+    if (isdigit(*str))
+      day = day*10 + *str++ - '0';
+    if (*str++ != ' ')
+      return false;
+
+    static const char MonthNames[] = "janfebmaraprmayjunjulaugsepoctnovdec";
+    char name[3];
+    for (int i = 0; i < 3; ++i) {
+      if (*str == '\0')
+        return false;
+      name[i] = (char)tolower(*str++);
+    }
+    month = 1;
+    while (month <= 12 && memcmp(&MonthNames[(month-1)*3], name, 3) != 0)
+      ++month;
+    if (month > 12 || *str++ != ' ')
+      return false;
+
+    if (!ParseDigits(str, 4, year) || *str++ != ' ')
+      return false;
+    if (!ParseTimeOfDay(str, true, hour, minute, second) || *str++ != ' ')
+      return false;
+  }
+
+  if (!ParseZone(str, zone))
+    return false;
+
+  while (isspace(*str))
+    ++str;
+  if (*str != '\0')
+    return false;
+
+  if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+    return false;
+  if (second == 60)
+    second = 59; // Leap second
+
+  int64_t seconds = ((DaysFromCivil(year, month, day)*24 + hour)*60 + minute)*60 + second - zone*60;
+  m_microSecondsSinceEpoch.store(seconds*Micro + usecs);
+  return true;
+}
+
+
 void PTime::ReadFrom(istream & strm)
 {
   time_t now;
@@ -732,6 +1138,9 @@ void PTime::ReadFrom(istream & strm)
 
 bool PTime::Parse(const PString & str)
 {
+  if (ParseStandard(str))
+    return IsValid();
+
   PStringStream strm(str);
   ReadFrom(strm);
   return IsValid();
@@ -0,0 +1,591 @@
+/*
+ * slaballoc.cxx
+ *
+ * Thread caching slab allocator for small objects.
+ *
+ * Portable Tools Library
+ *
+ * Copyright (C) 2024 Vox Lucida Pty. Ltd.
+ *
+ * The contents of this file are subject to the Mozilla Public License
+ * Version 1.0 (the "License"); you may not use this file except in
+ * compliance with the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS"
+ * basis, WITHOUT WARRANTY OF ANY KIND, either express or implied. See
+ * the License for the specific language governing rights and limitations
+ * under the License.
+ *
+ * The Original Code is Portable Tools Library.
+ *
+ * The Initial Developer of the Original Code is Vox Lucida Pty. Ltd.
+ *
+ * Contributor(s): ______________________________________.
+ */
+
+#include <ptlib.h>
+
+#if !P_GNU_ALLOCATOR && P_SLAB_ALLOCATOR && !PMEMORY_HEAP
+
+#include <thread>
+#include <new>
+
+
+/* Note this module must not use anything that allocates via a pool
+   allocator, e.g. PString, as that would recurse back into here.
+   All state is in zero initialised statics, so it is usable from static
+   constructors in other modules, and has nothing to destroy at exit, so
+   objects freed by static destructors after this module are still safe.
+ */
+
+namespace {
+
+  const size_t   SizeClassGranularity = 16;
+  const size_t   NumSizeClasses = 32;
+  const size_t   MaxBlockSize = SizeClassGranularity*NumSizeClasses;
+  const unsigned BatchSize = 32;
+  const size_t   SlabSize = 64*1024;
+  const unsigned MaxAllocators = 64; // Any more share the statistics of the last
+
+
+  class SpinLock
+  {
+    public:
+      void Lock()
+      {
+        while (m_locked.exchange(true, std::memory_order_acquire)) {
+          while (m_locked.load(std::memory_order_relaxed))
+            std::this_thread::yield();
+        }
+      }
+
+      void Unlock()
+      {
+        m_locked.store(false, std::memory_order_release);
+      }
+
+    private:
+      std::atomic<bool> m_locked;
+  };
+
+
+  struct FreeBlock
+  {
+    FreeBlock * m_next;       // Next block in this list
+    FreeBlock * m_nextBatch;  // Next batch, only used by first block of a batch in the depot
+  };
+
+  static_assert(sizeof(FreeBlock) <= SizeClassGranularity, "Size class too small for free list");
+
+
+  // Blocks shared between threads, for one size class
+  struct Depot
+  {
+    SpinLock    m_lock;
+    FreeBlock * m_batches;   // Batches of exactly BatchSize blocks
+    FreeBlock * m_singles;   // Loose blocks, from exiting threads
+    size_t      m_slabBytes;
+  };
+
+
+  /* Only the owning thread writes its counters, so they do not need an
+     atomic read-modify-write, the atomic is so other threads can read them.
+   */
+  struct Counters
+  {
+    std::atomic<uint64_t> m_allocations;
+    std::atomic<uint64_t> m_deallocations;
+    std::atomic<uint64_t> m_cacheHits;
+    std::atomic<uint64_t> m_allocatedBytes;
+    std::atomic<uint64_t> m_deallocatedBytes;
+  };
+
+  inline void Increment(std::atomic<uint64_t> & counter, uint64_t amount)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+
+
+  struct ThreadCache
+  {
+    struct Bin
+    {
+      FreeBlock * m_head;
+      unsigned    m_count;
+    } m_bins[NumSizeClasses];
+
+    Counters m_counters[MaxAllocators];
+
+    ThreadCache * m_next;
+    ThreadCache * m_prev;
+  };
+
+
+  Depot         s_depots[NumSizeClasses];
+  SpinLock      s_registryLock;
+  ThreadCache * s_threadCaches;
+  Counters      s_exitedCounters[MaxAllocators];
+
+  std::atomic<PSlabAllocator *> s_allocators[MaxAllocators];
+  std::atomic<unsigned>         s_allocatorCount;
+
+  P_THREAD_LOCAL ThreadCache * t_threadCache;
+  P_THREAD_LOCAL bool          t_threadExited;
+
+
+  inline unsigned GetSizeClass(size_t size)
+  {
+    return (unsigned)((size - 1) / SizeClassGranularity);
+  }
+
+
+  FreeBlock * LinkBlocks(BYTE * base, size_t blockSize, size_t count)
+  {
+    for (size_t i = 1; i < count; ++i)
+      reinterpret_cast<FreeBlock *>(base + (i-1)*blockSize)->m_next = reinterpret_cast<FreeBlock *>(base + i*blockSize);
+    reinterpret_cast<FreeBlock *>(base + (count-1)*blockSize)->m_next = NULL;
+    return reinterpret_cast<FreeBlock *>(base);
+  }
+
+
+  // Take up to a batch of blocks from the depot, returns the count
+  unsigned TakeFromDepot(unsigned sizeClass, FreeBlock * & head)
+  {
+    Depot & depot = s_depots[sizeClass];
+    depot.m_lock.Lock();
+
+    head = depot.m_batches;
+    if (head != NULL) {
+      depot.m_batches = head->m_nextBatch;
+      depot.m_lock.Unlock();
+      return BatchSize;
+    }
+
+    unsigned count = 0;
+    head = depot.m_singles;
+    if (head != NULL) {
+      FreeBlock * last = head;
+      count = 1;
+      while (count < BatchSize && last->m_next != NULL) {
+        last = last->m_next;
+        ++count;
+      }
+      depot.m_singles = last->m_next;
+      last->m_next = NULL;
+    }
+
+    depot.m_lock.Unlock();
+    return count;
+  }
+
+
+  void GiveToDepot(unsigned sizeClass, FreeBlock * head, unsigned count)
+  {
+    if (count == 0)
+      return;
+
+    Depot & depot = s_depots[sizeClass];
+
+    if (count == BatchSize) {
+      depot.m_lock.Lock();
+      head->m_nextBatch = depot.m_batches;
+      depot.m_batches = head;
+      depot.m_lock.Unlock();
+      return;
+    }
+
+    FreeBlock * last = head;
+    while (last->m_next != NULL)
+      last = last->m_next;
+
+    depot.m_lock.Lock();
+    last->m_next = depot.m_singles;
+    depot.m_singles = head;
+    depot.m_lock.Unlock();
+  }
+
+
+  /* Get a new slab and divide it into blocks. This is done by the thread
+     that needs the memory, so the pages are first touched, and placed by the
+     operating system, near that thread. One batch is returned to the caller
+     and the rest go to the depot.
+   */
+  unsigned CarveSlab(unsigned sizeClass, FreeBlock * & head)
+  {
+    BYTE * slab = (BYTE *)malloc(SlabSize);
+    if (slab == NULL)
+      return 0;
+
+    size_t blockSize = (sizeClass+1)*SizeClassGranularity;
+    size_t blockCount = SlabSize/blockSize;
+    size_t batchBytes = blockSize*BatchSize;
+
+    head = LinkBlocks(slab, blockSize, BatchSize);
+
+    FreeBlock * batches = NULL;
+    FreeBlock * lastBatch = NULL;
+    size_t offset = batchBytes;
+    for (size_t i = 2*BatchSize; i <= blockCount; i += BatchSize, offset += batchBytes) {
+      FreeBlock * batch = LinkBlocks(slab + offset, blockSize, BatchSize);
+      batch->m_nextBatch = batches;
+      batches = batch;
+      if (lastBatch == NULL)
+        lastBatch = batch;
+    }
+
+    FreeBlock * singles = NULL;
+    FreeBlock * lastSingle = NULL;
+    size_t remaining = blockCount % BatchSize;
+    if (remaining > 0) {
+      singles = LinkBlocks(slab + offset, blockSize, remaining);
+      lastSingle = reinterpret_cast<FreeBlock *>(slab + offset + (remaining-1)*blockSize);
+    }
+
+    Depot & depot = s_depots[sizeClass];
+    depot.m_lock.Lock();
+    if (batches != NULL) {
+      lastBatch->m_nextBatch = depot.m_batches;
+      depot.m_batches = batches;
+    }
+    if (singles != NULL) {
+      lastSingle->m_next = depot.m_singles;
+      depot.m_singles = singles;
+    }
+    depot.m_slabBytes += SlabSize;
+    depot.m_lock.Unlock();
+
+    return BatchSize;
+  }
+
+
+  void ReleaseThreadCache()
+  {
+    ThreadCache * cache = t_threadCache;
+    t_threadCache = NULL;
+    t_threadExited = true;
+    if (cache == NULL)
+      return;
+
+    s_registryLock.Lock();
+
+    if (cache->m_prev != NULL)
+      cache->m_prev->m_next = cache->m_next;
+    else
+      s_threadCaches = cache->m_next;
+    if (cache->m_next != NULL)
+      cache->m_next->m_prev = cache->m_prev;
+
+    for (unsigned i = 0; i < MaxAllocators; ++i) {
+      const Counters & from = cache->m_counters[i];
+      Counters & to = s_exitedCounters[i];
+      to.m_allocations      += from.m_allocations;
+      to.m_deallocations    += from.m_deallocations;
+      to.m_cacheHits        += from.m_cacheHits;
+      to.m_allocatedBytes   += from.m_allocatedBytes;
+      to.m_deallocatedBytes += from.m_deallocatedBytes;
+    }
+
+    s_registryLock.Unlock();
+
+    for (unsigned sizeClass = 0; sizeClass < NumSizeClasses; ++sizeClass) {
+      ThreadCache::Bin & bin = cache->m_bins[sizeClass];
+      while (bin.m_count >= BatchSize) {
+        FreeBlock * batch = bin.m_head;
+        FreeBlock * last = batch;
+        for (unsigned i = 1; i < BatchSize; ++i)
+          last = last->m_next;
+        bin.m_head = last->m_next;
+        last->m_next = NULL;
+        bin.m_count -= BatchSize;
+        GiveToDepot(sizeClass, batch, BatchSize);
+      }
+      GiveToDepot(sizeClass, bin.m_head, bin.m_count);
+    }
+
+    cache->~ThreadCache();
+    free(cache);
+  }
+
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+  // Returns the thread cache to the depot when the thread exits
+  struct ThreadCacheReaper
+  {
+    ThreadCacheReaper() : m_active(true) { }
+    ~ThreadCacheReaper() { ReleaseThreadCache(); }
+    bool m_active;
+  };
+
+  thread_local ThreadCacheReaper t_threadCacheReaper;
+#endif
+
+
+  ThreadCache * CreateThreadCache()
+  {
+    // Once a thread has exited, blocks go directly to and from the depot
+    if (t_threadExited)
+      return NULL;
+
+    void * memory = malloc(sizeof(ThreadCache));
+    if (memory == NULL)
+      return NULL;
+
+    ThreadCache * cache = new (memory) ThreadCache();
+
+    s_registryLock.Lock();
+    cache->m_next = s_threadCaches;
+    if (s_threadCaches != NULL)
+      s_threadCaches->m_prev = cache;
+    s_threadCaches = cache;
+    s_registryLock.Unlock();
+
+    t_threadCache = cache;
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+    // Touching the reaper constructs it, so its destructor runs at thread exit
+    t_threadCacheReaper.m_active = true;
+#endif
+
+    return cache;
+  }
+
+
+  inline ThreadCache * GetThreadCache()
+  {
+    ThreadCache * cache = t_threadCache;
+    return cache != NULL ? cache : CreateThreadCache();
+  }
+
+
+  // Allocate() is called from a throwing operator new, so must never return NULL
+  void * OutOfMemory()
+  {
+#if P_EXCEPTIONS
+    throw std::bad_alloc();
+#else
+    PAssertAlways(POutOfMemory);
+    abort();
+#endif
+  }
+
+
+  inline void * CheckedMalloc(size_t size)
+  {
+    void * ptr = malloc(size);
+    return ptr != NULL ? ptr : OutOfMemory();
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PSlabAllocator::PSlabAllocator(const char * name, size_t size)
+  : m_name(name)
+  , m_size(size)
+  , m_index(s_allocatorCount++)
+{
+  if (m_index < MaxAllocators)
+    s_allocators[m_index] = this;
+  else
+    m_index = MaxAllocators-1;
+}
+
+
+void * PSlabAllocator::Allocate(size_t size)
+{
+  ThreadCache * cache = GetThreadCache();
+
+  if (cache == NULL) {
+    Counters & counters = s_exitedCounters[m_index];
+    ++counters.m_allocations;
+    counters.m_allocatedBytes += size;
+
+    if (size > MaxBlockSize)
+      return CheckedMalloc(size);
+
+    unsigned sizeClass = GetSizeClass(size);
+    FreeBlock * head;
+    unsigned count = TakeFromDepot(sizeClass, head);
+    if (count == 0 && (count = CarveSlab(sizeClass, head)) == 0)
+      return OutOfMemory();
+    GiveToDepot(sizeClass, head->m_next, count-1);
+    return head;
+  }
+
+  Counters & counters = cache->m_counters[m_index];
+  Increment(counters.m_allocations, 1);
+  Increment(counters.m_allocatedBytes, size);
+
+  if (size > MaxBlockSize)
+    return CheckedMalloc(size);
+
+  unsigned sizeClass = GetSizeClass(size);
+  ThreadCache::Bin & bin = cache->m_bins[sizeClass];
+  if (bin.m_head != NULL)
+    Increment(counters.m_cacheHits, 1);
+  else if ((bin.m_count = TakeFromDepot(sizeClass, bin.m_head)) == 0 &&
+           (bin.m_count = CarveSlab(sizeClass, bin.m_head)) == 0)
+    return OutOfMemory();
+
+  FreeBlock * block = bin.m_head;
+  bin.m_head = block->m_next;
+  --bin.m_count;
+  return block;
+}
+
+
+void PSlabAllocator::Deallocate(void * ptr, size_t size)
+{
+  if (ptr == NULL)
+    return;
+
+  ThreadCache * cache = GetThreadCache();
+
+  if (cache == NULL) {
+    Counters & counters = s_exitedCounters[m_index];
+    ++counters.m_deallocations;
+    counters.m_deallocatedBytes += size;
+
+    if (size > MaxBlockSize)
+      free(ptr);
+    else {
+      FreeBlock * block = static_cast<FreeBlock *>(ptr);
+      block->m_next = NULL;
+      GiveToDepot(GetSizeClass(size), block, 1);
+    }
+    return;
+  }
+
+  Counters & counters = cache->m_counters[m_index];
+  Increment(counters.m_deallocations, 1);
+  Increment(counters.m_deallocatedBytes, size);
+
+  if (size > MaxBlockSize) {
+    free(ptr);
+    return;
+  }
+
+  unsigned sizeClass = GetSizeClass(size);
+  ThreadCache::Bin & bin = cache->m_bins[sizeClass];
+  FreeBlock * block = static_cast<FreeBlock *>(ptr);
+  block->m_next = bin.m_head;
+  bin.m_head = block;
+
+  // Keep one batch in hand after returning one, so alternating new/delete does not thrash the depot
+  if (++bin.m_count >= 2*BatchSize) {
+    FreeBlock * last = block;
+    for (unsigned i = 1; i < BatchSize; ++i)
+      last = last->m_next;
+    bin.m_head = last->m_next;
+    last->m_next = NULL;
+    bin.m_count -= BatchSize;
+    GiveToDepot(sizeClass, block, BatchSize);
+  }
+}
+
+
+PSlabAllocator::Statistics::Statistics()
+  : m_name(NULL)
+  , m_objectSize(0)
+  , m_allocations(0)
+  , m_deallocations(0)
+  , m_cacheHits(0)
+  , m_liveObjects(0)
+  , m_liveBytes(0)
+{
+}
+
+
+double PSlabAllocator::Statistics::GetCacheHitRate() const
+{
+  return m_allocations > 0 ? 100.0*m_cacheHits/m_allocations : 0.0;
+}
+
+
+void PSlabAllocator::GetStatistics(StatisticsList & stats)
+{
+  struct Totals
+  {
+    uint64_t m_allocations;
+    uint64_t m_deallocations;
+    uint64_t m_cacheHits;
+    uint64_t m_allocatedBytes;
+    uint64_t m_deallocatedBytes;
+
+    void Add(const Counters & counters)
+    {
+      m_allocations      += counters.m_allocations.load(std::memory_order_relaxed);
+      m_deallocations    += counters.m_deallocations.load(std::memory_order_relaxed);
+      m_cacheHits        += counters.m_cacheHits.load(std::memory_order_relaxed);
+      m_allocatedBytes   += counters.m_allocatedBytes.load(std::memory_order_relaxed);
+      m_deallocatedBytes += counters.m_deallocatedBytes.load(std::memory_order_relaxed);
+    }
+  } totals[MaxAllocators];
+
+  unsigned count = std::min(s_allocatorCount.load(), MaxAllocators);
+  memset(totals, 0, sizeof(totals));
+
+  s_registryLock.Lock();
+  for (unsigned i = 0; i < count; ++i) {
+    totals[i].Add(s_exitedCounters[i]);
+    for (ThreadCache * cache = s_threadCaches; cache != NULL; cache = cache->m_next)
+      totals[i].Add(cache->m_counters[i]);
+  }
+  s_registryLock.Unlock();
+
+  stats.clear();
+  for (unsigned i = 0; i < count; ++i) {
+    PSlabAllocator * allocator = s_allocators[i];
+    if (allocator == NULL)
+      continue;
+
+    Statistics stat;
+    stat.m_name = allocator->m_name;
+    stat.m_objectSize = allocator->m_size;
+    stat.m_allocations = totals[i].m_allocations;
+    stat.m_deallocations = totals[i].m_deallocations;
+    stat.m_cacheHits = totals[i].m_cacheHits;
+    stat.m_liveObjects = (size_t)(totals[i].m_allocations - totals[i].m_deallocations);
+    stat.m_liveBytes = (size_t)(totals[i].m_allocatedBytes - totals[i].m_deallocatedBytes);
+    stats.push_back(stat);
+  }
+}
+
+
+void PSlabAllocator::PrintStatistics(ostream & strm)
+{
+  StatisticsList stats;
+  GetStatistics(stats);
+
+  std::ios::fmtflags flags = strm.flags();
+  strm << left << setw(20) << "Class" << right
+       << setw(6)  << "Size"
+       << setw(10) << "Live"
+       << setw(12) << "Bytes"
+       << setw(14) << "Allocations"
+       << setw(10) << "Hit rate"
+       << '\n';
+  for (StatisticsList::iterator it = stats.begin(); it != stats.end(); ++it)
+    strm << left << setw(20) << it->m_name << right
+         << setw(6)  << it->m_objectSize
+         << setw(10) << it->m_liveObjects
+         << setw(12) << it->m_liveBytes
+         << setw(14) << it->m_allocations
+         << setw(9)  << fixed << setprecision(1) << it->GetCacheHitRate() << "%\n";
+
+  size_t slabBytes = 0;
+  for (unsigned i = 0; i < NumSizeClasses; ++i) {
+    s_depots[i].m_lock.Lock();
+    slabBytes += s_depots[i].m_slabBytes;
+    s_depots[i].m_lock.Unlock();
+  }
+  strm << "Slab memory " << slabBytes << " bytes\n";
+  strm.flags(flags);
+}
+
+
+#endif // !P_GNU_ALLOCATOR && P_SLAB_ALLOCATOR && !PMEMORY_HEAP
+
+
+// End Of File ///////////////////////////////////////////////////////////////
@@ -2195,7 +2195,6 @@ void PIPSocket::RouteEntry::PrintOn(ostream & strm) const
 #ifdef __NUCLEUS_NET__
 PBoolean PIPSocket::GetInterfaceTable(InterfaceTable & table)
 {
-    InterfaceEntry *IE;
     list<IPInterface>::iterator i;
     for(i=Route4Configuration->Getm_IPInterfaceList().begin();
             i!=Route4Configuration->Getm_IPInterfaceList().end();
@@ -2203,9 +2202,7 @@ PBoolean PIPSocket::GetInterfaceTable(InterfaceTable & table)
     {
         char ma[6];
         for(int j=0; j<6; j++) ma[j]=(*i).Getm_macaddr(j);
-        IE = new InterfaceEntry((*i).Getm_name().c_str(), (*i).Getm_ipaddr(), ma );
-        if(!IE) return false;
-        table.Append(IE);
+        table.Append(InterfaceEntry((*i).Getm_name().c_str(), (*i).Getm_ipaddr(), ma ));
     }
     return true;
 }
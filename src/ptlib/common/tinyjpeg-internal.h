@@ -37,6 +37,7 @@
 
 #include <setjmp.h>
 #include <ptlib_config.h>
+#include "tinyjpeg.h"
 
 #define SANITY_CHECK 1
 
@@ -50,6 +51,7 @@ struct jdec_private;
 #define COMPONENTS	   3
 #define JPEG_MAX_WIDTH	   2048
 #define JPEG_MAX_HEIGHT	   2048
+#define JPEG_MAX_SEGMENTS  1024
 
 struct huffman_table
 {
@@ -70,6 +72,7 @@ struct component
   unsigned int Vfactor;
 #ifndef P_MEDIALIB
   float *Q_table;		/* Pointer to the quantisation table to use */
+  int32_t *IQ_table;		/* Pointer to the integer IDCT multipliers to use */
 #else
   uint16_t *Q_table;   /* Pointer to the quantisation table to use */
 #endif
@@ -103,6 +106,7 @@ struct jdec_private
   struct component component_infos[COMPONENTS];
 #ifndef P_MEDIALIB
   float Q_tables[COMPONENTS][64];		/* quantization tables */
+  int32_t IQ_tables[COMPONENTS][64];		/* quantization tables scaled for integer IDCT */
 #else
   uint16_t Q_tables[COMPONENTS][64];   /* quantization tables */
 #endif
@@ -113,17 +117,31 @@ struct jdec_private
   int restarts_to_go;				/* MCUs left in this restart interval */
   int last_rst_marker_seen;			/* Rst marker is incremented each time */
 
+  /* Start of the entropy coded data for each restart interval */
+  const unsigned char *segment_start[JPEG_MAX_SEGMENTS];
+  int segment_count;
+
   /* Temp space used after the IDCT to store each components */
   uint8_t Y[64*4], Cr[64], Cb[64];
 
   jmp_buf jump_state;
+  char error_string[TINYJPEG_ERROR_SIZE];	/* Last error found while decoding */
+
   /* Internal Pointer use for colorspace conversion, do not modify it !!! */
   uint8_t *plane[COMPONENTS];
 
 };
 
+/* Extra precision carried by the integer IDCT quantization multipliers */
+#define TINYJPEG_IDCT_INT_PASS1_BITS 3
+
+#ifndef P_MEDIALIB
+#define IDCT tinyjpeg_idct_int
+#else
 #define IDCT tinyjpeg_idct_float
+#endif
 void tinyjpeg_idct_float (struct component *compptr, uint8_t *output_buf, int stride);
+void tinyjpeg_idct_int (struct component *compptr, uint8_t *output_buf, int stride);
 
 #endif
 
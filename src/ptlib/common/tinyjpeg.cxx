@@ -91,8 +91,8 @@ enum std_markers {
 #endif
 
 #define error(fmt, ...) do { \
-   snprintf(error_string, sizeof(error_string), fmt, ## __VA_ARGS__); \
-   trace("%s", error_string); \
+   snprintf(priv->error_string, sizeof(priv->error_string), fmt, ## __VA_ARGS__); \
+   trace("%s", priv->error_string); \
    return -1; \
 } while(0)
 
@@ -129,9 +129,6 @@ static void print_next_16bytes(int offset, const unsigned char *stream)
 
 #endif
 
-/* Global variable to return the last error found while deconding */
-static char error_string[256];
-
 static const unsigned char zigzag[64] = 
 {
    0,  1,  5,  6, 14, 15, 27, 28,
@@ -1622,6 +1619,14 @@ static int parse_DQT(struct jdec_private *priv, const unsigned char *stream)
 #endif
      table = priv->Q_tables[qi];
      build_quantization_table(table, stream);
+#ifndef P_MEDIALIB
+     {
+       /* Same AA&N scaled values, in fixed point for tinyjpeg_idct_int() */
+       int i;
+       for (i=0; i<64; i++)
+	 priv->IQ_tables[qi][i] = (int32_t)(table[i] * (1 << TINYJPEG_IDCT_INT_PASS1_BITS) + 0.5f);
+     }
+#endif
      stream += 64;
    }
   trace("< DQT marker\n");
@@ -1664,6 +1669,9 @@ static int parse_SOF(struct jdec_private *priv, const unsigned char *stream)
      c->Vfactor = sampling_factor&0xf;
      c->Hfactor = sampling_factor>>4;
      c->Q_table = priv->Q_tables[Q_table];
+#ifndef P_MEDIALIB
+     c->IQ_table = priv->IQ_tables[Q_table];
+#endif
      trace("Component:%d  factor:%dx%d  Quantization table:%d\n",
 	 cid, c->Hfactor, c->Hfactor, Q_table );
 
@@ -2019,70 +2027,66 @@ static const convert_colorspace_fct convert_colorspace_grey[4] = {
    YCrCB_to_Grey_2x2,
 };
 
-/**
- * Decode and convert the jpeg image into @pixfmt@ image
- *
- * Note: components will be automaticaly allocated if no memory is attached.
- */
-int tinyjpeg_decode(struct jdec_private *priv, int pixfmt)
+/* Where each MCU goes in the output planes, and how to decode it */
+struct decode_layout
 {
-  unsigned int x, y, xstride_by_mcu, ystride_by_mcu;
-  unsigned int bytes_per_blocklines[3], bytes_per_mcu[3];
   decode_MCU_fct decode_MCU;
-  const decode_MCU_fct *decode_mcu_table;
-  const convert_colorspace_fct *colorspace_array_conv;
   convert_colorspace_fct convert_to_pixfmt;
+  unsigned int xstride_by_mcu, ystride_by_mcu;
+  unsigned int mcus_per_row, mcu_rows;
+  unsigned int bytes_per_blocklines[3], bytes_per_mcu[3];
+};
 
-  if (setjmp(priv->jump_state))
-    return -1;
+static int setup_decode(struct jdec_private *priv, int pixfmt, struct decode_layout *layout, int allocate)
+{
+  const decode_MCU_fct *decode_mcu_table;
+  const convert_colorspace_fct *colorspace_array_conv;
+  unsigned int component_size[3];
+  int i;
 
   /* To keep gcc happy initialize some array */
-  bytes_per_mcu[1] = 0;
-  bytes_per_mcu[2] = 0;
-  bytes_per_blocklines[1] = 0;
-  bytes_per_blocklines[2] = 0;
+  layout->bytes_per_mcu[1] = 0;
+  layout->bytes_per_mcu[2] = 0;
+  layout->bytes_per_blocklines[1] = 0;
+  layout->bytes_per_blocklines[2] = 0;
+  component_size[1] = 0;
+  component_size[2] = 0;
 
   decode_mcu_table = decode_mcu_3comp_table;
   switch (pixfmt) {
      case TINYJPEG_FMT_YUV420P:
        colorspace_array_conv = convert_colorspace_yuv420p;
-       if (priv->components[0] == NULL)
-	 priv->components[0] = (uint8_t *)malloc(priv->width * priv->height);
-       if (priv->components[1] == NULL)
-	 priv->components[1] = (uint8_t *)malloc(priv->width * priv->height/4);
-       if (priv->components[2] == NULL)
-	 priv->components[2] = (uint8_t *)malloc(priv->width * priv->height/4);
-       bytes_per_blocklines[0] = priv->width;
-       bytes_per_blocklines[1] = priv->width/4;
-       bytes_per_blocklines[2] = priv->width/4;
-       bytes_per_mcu[0] = 8;
-       bytes_per_mcu[1] = 4;
-       bytes_per_mcu[2] = 4;
+       component_size[0] = priv->width * priv->height;
+       component_size[1] = priv->width * priv->height/4;
+       component_size[2] = priv->width * priv->height/4;
+       layout->bytes_per_blocklines[0] = priv->width;
+       layout->bytes_per_blocklines[1] = priv->width/4;
+       layout->bytes_per_blocklines[2] = priv->width/4;
+       layout->bytes_per_mcu[0] = 8;
+       layout->bytes_per_mcu[1] = 4;
+       layout->bytes_per_mcu[2] = 4;
        break;
 
      case TINYJPEG_FMT_RGB24:
        colorspace_array_conv = convert_colorspace_rgb24;
-       if (priv->components[0] == NULL)
-	 priv->components[0] = (uint8_t *)malloc(priv->width * priv->height * 3);
-       bytes_per_blocklines[0] = priv->width * 3;
-       bytes_per_mcu[0] = 3*8;
+       component_size[0] = priv->width * priv->height * 3;
+       layout->bytes_per_blocklines[0] = priv->width * 3;
+       layout->bytes_per_mcu[0] = 3*8;
        break;
 
      case TINYJPEG_FMT_BGR24:
        colorspace_array_conv = convert_colorspace_bgr24;
-       if (priv->components[0] == NULL)
-	 priv->components[0] = (uint8_t *)malloc(priv->width * priv->height * 3);
-       bytes_per_blocklines[0] = priv->width * 3;
-       bytes_per_mcu[0] = 3*8;
+       component_size[0] = priv->width * priv->height * 3;
+       layout->bytes_per_blocklines[0] = priv->width * 3;
+       layout->bytes_per_mcu[0] = 3*8;
        break;
 
      case TINYJPEG_FMT_GREY:
        decode_mcu_table = decode_mcu_1comp_table;
        colorspace_array_conv = convert_colorspace_grey;
-       if (priv->components[0] == NULL)
-	 priv->components[0] = (uint8_t *)malloc(priv->width * priv->height);
-       bytes_per_blocklines[0] = priv->width;
-       bytes_per_mcu[0] = 8;
+       component_size[0] = priv->width * priv->height;
+       layout->bytes_per_blocklines[0] = priv->width;
+       layout->bytes_per_mcu[0] = 8;
        break;
 
      default:
@@ -2090,64 +2094,82 @@ int tinyjpeg_decode(struct jdec_private *priv, int pixfmt)
        return -1;
   }
 
-  xstride_by_mcu = ystride_by_mcu = 8;
+  for (i=0; i<3; i++) {
+     if (component_size[i] > 0 && priv->components[i] == NULL) {
+       if (!allocate)
+	 error("Output component %d not set\n", i);
+       priv->components[i] = (uint8_t *)malloc(component_size[i]);
+     }
+  }
+
+  layout->xstride_by_mcu = layout->ystride_by_mcu = 8;
   if ((priv->component_infos[cY].Hfactor | priv->component_infos[cY].Vfactor) == 1) {
-     decode_MCU = decode_mcu_table[0];
-     convert_to_pixfmt = colorspace_array_conv[0];
+     layout->decode_MCU = decode_mcu_table[0];
+     layout->convert_to_pixfmt = colorspace_array_conv[0];
      trace("Use decode 1x1 sampling\n");
   } else if (priv->component_infos[cY].Hfactor == 1) {
-     decode_MCU = decode_mcu_table[1];
-     convert_to_pixfmt = colorspace_array_conv[1];
-     ystride_by_mcu = 16;
+     layout->decode_MCU = decode_mcu_table[1];
+     layout->convert_to_pixfmt = colorspace_array_conv[1];
+     layout->ystride_by_mcu = 16;
      trace("Use decode 1x2 sampling (not supported)\n");
   } else if (priv->component_infos[cY].Vfactor == 2) {
-     decode_MCU = decode_mcu_table[3];
-     convert_to_pixfmt = colorspace_array_conv[3];
-     xstride_by_mcu = 16;
-     ystride_by_mcu = 16;
+     layout->decode_MCU = decode_mcu_table[3];
+     layout->convert_to_pixfmt = colorspace_array_conv[3];
+     layout->xstride_by_mcu = 16;
+     layout->ystride_by_mcu = 16;
      trace("Use decode 2x2 sampling\n");
   } else {
-     decode_MCU = decode_mcu_table[2];
-     convert_to_pixfmt = colorspace_array_conv[2];
-     xstride_by_mcu = 16;
+     layout->decode_MCU = decode_mcu_table[2];
+     layout->convert_to_pixfmt = colorspace_array_conv[2];
+     layout->xstride_by_mcu = 16;
      trace("Use decode 2x1 sampling\n");
   }
 
-  resync(priv);
-
   /* Don't forget to that block can be either 8 or 16 lines */
-  bytes_per_blocklines[0] *= ystride_by_mcu;
-  bytes_per_blocklines[1] *= ystride_by_mcu;
-  bytes_per_blocklines[2] *= ystride_by_mcu;
+  for (i=0; i<3; i++) {
+     layout->bytes_per_blocklines[i] *= layout->ystride_by_mcu;
+     layout->bytes_per_mcu[i] *= layout->xstride_by_mcu/8;
+  }
+
+  layout->mcus_per_row = (priv->width + layout->xstride_by_mcu - 1) / layout->xstride_by_mcu;
+  layout->mcu_rows = priv->height / layout->ystride_by_mcu;
+  return 0;
+}
 
-  bytes_per_mcu[0] *= xstride_by_mcu/8;
-  bytes_per_mcu[1] *= xstride_by_mcu/8;
-  bytes_per_mcu[2] *= xstride_by_mcu/8;
+/*
+ * Decode the macroblocks (size is 8x8, 8x16, or 16x16) from first to last,
+ * optionally following the restart markers in the stream.
+ */
+static int decode_MCUs(struct jdec_private *priv, const struct decode_layout *layout,
+		       unsigned int first, unsigned int last, int follow_restarts)
+{
+  unsigned int mcu, x;
 
-  /* Just the decode the image by macroblock (size is 8x8, 8x16, or 16x16) */
-  for (y=0; y < priv->height/ystride_by_mcu; y++)
+  for (mcu = first; mcu < last; mcu++)
    {
-     //trace("Decoding row %d\n", y);
-     priv->plane[0] = priv->components[0] + (y * bytes_per_blocklines[0]);
-     priv->plane[1] = priv->components[1] + (y * bytes_per_blocklines[1]);
-     priv->plane[2] = priv->components[2] + (y * bytes_per_blocklines[2]);
-     for (x=0; x < priv->width; x+=xstride_by_mcu)
+     x = mcu % layout->mcus_per_row;
+     if (mcu == first || x == 0)
       {
-	decode_MCU(priv);
-	convert_to_pixfmt(priv);
-	priv->plane[0] += bytes_per_mcu[0];
-	priv->plane[1] += bytes_per_mcu[1];
-	priv->plane[2] += bytes_per_mcu[2];
-	if (priv->restarts_to_go>0)
+	unsigned int y = mcu / layout->mcus_per_row;
+	int i;
+	for (i=0; i<3; i++)
+	  priv->plane[i] = priv->components[i] + y*layout->bytes_per_blocklines[i] + x*layout->bytes_per_mcu[i];
+      }
+
+     layout->decode_MCU(priv);
+     layout->convert_to_pixfmt(priv);
+     priv->plane[0] += layout->bytes_per_mcu[0];
+     priv->plane[1] += layout->bytes_per_mcu[1];
+     priv->plane[2] += layout->bytes_per_mcu[2];
+     if (follow_restarts && priv->restarts_to_go>0)
+      {
+	priv->restarts_to_go--;
+	if (priv->restarts_to_go == 0)
 	 {
-	   priv->restarts_to_go--;
-	   if (priv->restarts_to_go == 0)
-	    {
-	      priv->stream -= (priv->nbits_in_reservoir/8);
-	      resync(priv);
-	      if (find_next_rst_marker(priv) < 0)
-		return -1;
-	    }
+	   priv->stream -= (priv->nbits_in_reservoir/8);
+	   resync(priv);
+	   if (find_next_rst_marker(priv) < 0)
+	     return -1;
 	 }
       }
    }
@@ -2155,11 +2177,176 @@ int tinyjpeg_decode(struct jdec_private *priv, int pixfmt)
   return 0;
 }
 
-const char *tinyjpeg_get_errorstring(struct jdec_private * /*priv*/)
+/**
+ * Decode and convert the jpeg image into @pixfmt@ image
+ *
+ * Note: components will be automaticaly allocated if no memory is attached.
+ */
+int tinyjpeg_decode(struct jdec_private *priv, int pixfmt)
+{
+  struct decode_layout layout;
+
+  if (setjmp(priv->jump_state))
+    return -1;
+
+  if (setup_decode(priv, pixfmt, &layout, 1) < 0)
+    return -1;
+
+  resync(priv);
+
+  return decode_MCUs(priv, &layout, 0, layout.mcus_per_row*layout.mcu_rows, 1);
+}
+
+/**
+ * Locate the restart markers in the entropy coded data, each restart
+ * interval can then be decoded independently, e.g. on separate threads,
+ * with tinyjpeg_decode_segments().
+ *
+ * Must be called after tinyjpeg_parse_header(). Returns the number of
+ * segments, which is 1 if the stream has no usable restart intervals.
+ */
+int tinyjpeg_get_segment_count(struct jdec_private *priv, int pixfmt)
+{
+  struct decode_layout layout;
+  const unsigned char *stream;
+  unsigned int total_mcus, expected;
+  int count;
+
+  priv->segment_start[0] = priv->stream;
+  priv->segment_count = 1;
+
+  if (priv->restart_interval <= 0)
+    return 1;
+
+  if (setup_decode(priv, pixfmt, &layout, 1) < 0)
+    return -1;
+
+  /* The stream codes any partial MCU row at the bottom, even though we skip it */
+  total_mcus = layout.mcus_per_row*((priv->height + layout.ystride_by_mcu - 1) / layout.ystride_by_mcu);
+  expected = (total_mcus + priv->restart_interval - 1) / priv->restart_interval;
+  if (expected > JPEG_MAX_SEGMENTS)
+    return 1;
+
+  count = 1;
+  stream = priv->stream;
+  while (stream+1 < priv->stream_end)
+   {
+     if (*stream++ != 0xff)
+       continue;
+     /* Skip any padding ff byte (this is normal) */
+     while (stream < priv->stream_end && *stream == 0xff)
+       stream++;
+     if (stream >= priv->stream_end || *stream == 0x00)
+       continue;
+     if (*stream < RST || *stream > RST7)
+       break; /* EOI or some other marker ends the scan */
+     if (count >= (int)expected)
+       return 1;
+     priv->segment_start[count++] = ++stream;
+   }
+
+  /* Anything unexpected and we fall back to the sequential decoder, which
+     has the error recovery for corrupt or truncated streams */
+  if (count != (int)expected)
+    return 1;
+
+  priv->segment_count = count;
+  return count;
+}
+
+static int decode_segments(struct jdec_private *priv, int pixfmt, int first, int count)
+{
+  struct decode_layout layout;
+  const unsigned char *stream_end = priv->stream_end;
+  unsigned int total_mcus, first_mcu, last_mcu;
+  int segment;
+
+  if (first < 0 || count <= 0 || first+count > priv->segment_count)
+    error("Invalid segment range %d to %d\n", first, first+count-1);
+
+  if (setup_decode(priv, pixfmt, &layout, 0) < 0)
+    return -1;
+
+  if (setjmp(priv->jump_state))
+    error("Unexpected end of segment data\n");
+
+  total_mcus = layout.mcus_per_row*layout.mcu_rows;
+  for (segment = first; segment < first+count; segment++)
+   {
+     if (priv->segment_count > 1) {
+       first_mcu = segment * priv->restart_interval;
+       if (first_mcu >= total_mcus)
+	 break;
+       last_mcu = first_mcu + priv->restart_interval;
+       if (last_mcu > total_mcus)
+	 last_mcu = total_mcus;
+     }
+     else {
+       first_mcu = 0;
+       last_mcu = total_mcus;
+     }
+
+     priv->stream = priv->segment_start[segment];
+     if (segment+1 < priv->segment_count)
+       priv->stream_end = priv->segment_start[segment+1];
+     else
+       priv->stream_end = stream_end;
+     resync(priv);
+
+     if (decode_MCUs(priv, &layout, first_mcu, last_mcu, priv->segment_count == 1) < 0)
+       return -1;
+   }
+
+  return 0;
+}
+
+/**
+ * Decode the restart interval segments from first to first+count-1.
+ *
+ * The output components must have been set with tinyjpeg_set_components().
+ * Disjoint ranges of segments may be decoded concurrently from different
+ * threads, as all the decoder state is copied, and only the output area for
+ * the segments are written. For the same reason priv is not written at all,
+ * so on failure the reason is returned in error_string, if not NULL.
+ */
+int tinyjpeg_decode_segments(struct jdec_private *priv, int pixfmt, int first, int count,
+                             char *error_string, unsigned int error_size)
+{
+  struct jdec_private *local;
+
+  /* Decode state is in the private structure, so work on a copy. The
+     huffman and quantization tables are only read so may be shared. */
+  local = (struct jdec_private *)malloc(sizeof(struct jdec_private));
+  if (local == NULL) {
+    if (error_string != NULL)
+      snprintf(error_string, error_size, "Can't allocate decoder copy\n");
+    return -1;
+  }
+  memcpy(local, priv, sizeof(struct jdec_private));
+  local->error_string[0] = '\0';
+
+  if (decode_segments(local, pixfmt, first, count) < 0) {
+    if (error_string != NULL)
+      snprintf(error_string, error_size, "%s", local->error_string);
+    free(local);
+    return -1;
+  }
+
+  free(local);
+  return 0;
+}
+
+const char *tinyjpeg_get_errorstring(struct jdec_private *priv)
+{
+  return priv->error_string;
+}
+
+/**
+ * Set the error string, e.g. to one returned by tinyjpeg_decode_segments().
+ */
+void tinyjpeg_set_errorstring(struct jdec_private *priv, const char *error_string)
 {
-  /* FIXME: the error string must be store in the context */
-  //priv = priv;
-  return error_string;
+  snprintf(priv->error_string, sizeof(priv->error_string), "%s", error_string);
 }
 
 void tinyjpeg_get_size(struct jdec_private *priv, unsigned int *width, unsigned int *height)
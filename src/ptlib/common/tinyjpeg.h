@@ -41,6 +41,9 @@ extern "C" {
 
 struct jdec_private;
 
+/* Size of the last error string kept by the decoder */
+#define TINYJPEG_ERROR_SIZE 256
+
 /* Flags that can be set by any applications */
 #define TINYJPEG_FLAGS_MJPEG_TABLE	(1<<1)
 
@@ -57,7 +60,11 @@ void tinyjpeg_free(struct jdec_private *priv);
 
 int tinyjpeg_parse_header(struct jdec_private *priv, const unsigned char *buf, unsigned int size);
 int tinyjpeg_decode(struct jdec_private *priv, int pixel_format);
+int tinyjpeg_get_segment_count(struct jdec_private *priv, int pixel_format);
+int tinyjpeg_decode_segments(struct jdec_private *priv, int pixel_format, int first, int count,
+                             char *error_string, unsigned int error_size);
 const char *tinyjpeg_get_errorstring(struct jdec_private *priv);
+void tinyjpeg_set_errorstring(struct jdec_private *priv, const char *error_string);
 void tinyjpeg_get_size(struct jdec_private *priv, unsigned int *width, unsigned int *height);
 int tinyjpeg_get_components(struct jdec_private *priv, unsigned char **components);
 int tinyjpeg_set_components(struct jdec_private *priv, unsigned char **components, unsigned int ncomponents);
@@ -37,6 +37,7 @@
 #endif
 
 #include <ptlib/vconvert.h>
+#include <ptclib/threadpool.h>
 
 #if P_TINY_JPEG
   #include "tinyjpeg.h"
@@ -759,6 +760,76 @@ static void CropYUV420P(const BYTE * srcPtr, unsigned srcWidth, unsigned srcHeig
 PRAGMA_OPTIMISE_DEFAULT()
 
 
+typedef void (*YUV420PRowFunction)(const BYTE * srcPtr, unsigned srcWidth, unsigned srcHeight, unsigned srcLineSpan,
+                                   BYTE * dstPtr, unsigned dstWidth, unsigned dstHeight, int dstLineSpan);
+
+static YUV420PRowFunction GetScalingRowFunction(unsigned srcWidth, unsigned srcHeight, unsigned dstWidth, unsigned dstHeight)
+{
+  if (srcWidth > dstWidth)
+    return ShrinkBothYUV420P;
+  if (srcWidth < dstWidth)
+    return GrowBothYUV420P;
+  if (srcHeight > dstHeight)
+    return ShrinkRowsYUV420P; // More efficient version for same width case
+  if (srcHeight < dstHeight)
+    return GrowRowsYUV420P;
+  return CropYUV420P;
+}
+
+
+// Frame sizes must already be rounded up to even
+static void CopyPlanesYUV420P(YUV420PRowFunction rowFunction,
+                              unsigned srcX, unsigned srcY, unsigned srcWidth, unsigned srcHeight,
+                              unsigned srcFrameWidth, unsigned srcFrameHeight, const BYTE * srcYUV,
+                              unsigned dstX, unsigned dstY, unsigned dstWidth, unsigned dstHeight,
+                              unsigned dstFrameWidth, unsigned dstFrameHeight, BYTE * dstYUV,
+                              bool verticalFlip)
+{
+  const BYTE * srcPtr = srcYUV + srcY * srcFrameWidth + srcX;
+  BYTE * dstPtr = dstYUV + dstY * dstFrameWidth + dstX;
+  int dstLineSpan = dstFrameWidth;
+  if (verticalFlip) {
+    dstPtr += (dstHeight - 1) * dstFrameWidth;
+    dstLineSpan = -dstLineSpan;
+  }
+
+  // Copy plane Y
+  rowFunction(srcPtr, srcWidth, srcHeight, srcFrameWidth, dstPtr, dstWidth, dstHeight, dstLineSpan);
+
+  srcYUV += srcFrameWidth*srcFrameHeight;
+  dstYUV += dstFrameWidth*dstFrameHeight;
+
+  // U & V planes half size
+  srcX /= 2;
+  srcY /= 2;
+  dstX /= 2;
+  dstY /= 2;
+  srcWidth /= 2;
+  srcHeight /= 2;
+  dstWidth /= 2;
+  dstHeight /= 2;
+  srcFrameWidth /= 2;
+  srcFrameHeight /= 2;
+  dstFrameWidth /= 2;
+  dstFrameHeight /= 2;
+  dstLineSpan /= 2;
+
+  srcPtr = srcYUV + srcY * srcFrameWidth + srcX;
+  dstPtr = dstYUV + dstY * dstFrameWidth + dstX;
+  if (verticalFlip)
+    dstPtr += (dstHeight - 1) * dstFrameWidth;
+
+  // Copy plane U
+  rowFunction(srcPtr, srcWidth, srcHeight, srcFrameWidth, dstPtr, dstWidth, dstHeight, dstLineSpan);
+
+  srcPtr += srcFrameWidth*srcFrameHeight;
+  dstPtr += dstFrameWidth*dstFrameHeight;
+
+  // Copy plane V
+  rowFunction(srcPtr, srcWidth, srcHeight, srcFrameWidth, dstPtr, dstWidth, dstHeight, dstLineSpan);
+}
+
+
 static bool ValidateDimensions(unsigned srcFrameWidth, unsigned srcFrameHeight,
                                unsigned dstFrameWidth, unsigned dstFrameHeight,
                                PVideoFrameInfo::ResizeMode resizeMode,
@@ -902,20 +973,11 @@ bool PColourConverter::CopyYUV420P(unsigned srcX, unsigned srcY, unsigned srcWid
 
 #endif // P_FFMPEG_SWSCALE
 
-  void(*rowFunction)(const BYTE * srcPtr, unsigned srcWidth, unsigned srcHeight, unsigned srcLineSpan,
-                     BYTE * dstPtr, unsigned dstWidth, unsigned dstHeight, int dstFrameWidth) = CropYUV420P;
+  YUV420PRowFunction rowFunction = CropYUV420P;
 
   switch (resizeMode) {
     default : // Scaling options
-      if (srcWidth > dstWidth)
-        rowFunction = ShrinkBothYUV420P;
-      else if (srcWidth < dstWidth)
-        rowFunction = GrowBothYUV420P;
-      else if (srcHeight > dstHeight)
-        rowFunction = ShrinkRowsYUV420P; // More efficient version for same width case
-      else if (srcHeight < dstHeight)
-        rowFunction = GrowRowsYUV420P;
-      // else use crop
+      rowFunction = GetScalingRowFunction(srcWidth, srcHeight, dstWidth, dstHeight);
       break;
 
     case PVideoFrameInfo::eCropTopLeft :
@@ -961,48 +1023,10 @@ bool PColourConverter::CopyYUV420P(unsigned srcX, unsigned srcY, unsigned srcWid
       break;
   }
 
-  const BYTE * srcPtr = srcYUV + srcY * srcFrameWidth + srcX;
-  BYTE * dstPtr = dstYUV + dstY * dstFrameWidth + dstX;
-  int dstLineSpan = dstFrameWidth;
-  if (verticalFlip) {
-    dstPtr += (dstHeight - 1) * dstFrameWidth;
-    dstLineSpan = -dstLineSpan;
-  }
-
-  // Copy plane Y
-  rowFunction(srcPtr, srcWidth, srcHeight, srcFrameWidth, dstPtr, dstWidth, dstHeight, dstLineSpan);
-
-  srcYUV += srcFrameWidth*srcFrameHeight;
-  dstYUV += dstFrameWidth*dstFrameHeight;
-
-  // U & V planes half size
-  srcX /= 2;
-  srcY /= 2;
-  dstX /= 2;
-  dstY /= 2;
-  srcWidth /= 2;
-  srcHeight /= 2;
-  dstWidth /= 2;
-  dstHeight /= 2;
-  srcFrameWidth /= 2;
-  srcFrameHeight /= 2;
-  dstFrameWidth /= 2;
-  dstFrameHeight /= 2;
-  dstLineSpan /= 2;
-
-  srcPtr = srcYUV + srcY * srcFrameWidth + srcX;
-  dstPtr = dstYUV + dstY * dstFrameWidth + dstX;
-  if (verticalFlip)
-    dstPtr += (dstHeight - 1) * dstFrameWidth;
-
-  // Copy plane U
-  rowFunction(srcPtr, srcWidth, srcHeight, srcFrameWidth, dstPtr, dstWidth, dstHeight, dstLineSpan);
-
-  srcPtr += srcFrameWidth*srcFrameHeight;
-  dstPtr += dstFrameWidth*dstFrameHeight;
-
-  // Copy plane V
-  rowFunction(srcPtr, srcWidth, srcHeight, srcFrameWidth, dstPtr, dstWidth, dstHeight, dstLineSpan);
+  CopyPlanesYUV420P(rowFunction,
+                    srcX, srcY, srcWidth, srcHeight, srcFrameWidth, srcFrameHeight, srcYUV,
+                    dstX, dstY, dstWidth, dstHeight, dstFrameWidth, dstFrameHeight, dstYUV,
+                    verticalFlip);
 
   return true;
 }
@@ -3097,6 +3121,561 @@ PSTANDARD_COLOUR_CONVERTER(UYV444,YUV420P)
 PRAGMA_OPTIMISE_DEFAULT()
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+PVideoCompositor::Tile::Tile(unsigned x, unsigned y, unsigned width, unsigned height, PVideoFrameInfo::ResizeMode resizeMode)
+  : m_x(x)
+  , m_y(y)
+  , m_width(width)
+  , m_height(height)
+  , m_cropX(0)
+  , m_cropY(0)
+  , m_cropWidth(0)
+  , m_cropHeight(0)
+  , m_resizeMode(resizeMode)
+  , m_border(0)
+  , m_borderRed(255)
+  , m_borderGreen(255)
+  , m_borderBlue(255)
+{
+}
+
+
+struct PVideoCompositor::TileState
+{
+  struct Rect
+  {
+    Rect(unsigned x = 0, unsigned y = 0, unsigned width = 0, unsigned height = 0)
+      : m_x(x), m_y(y), m_width(width), m_height(height) { }
+    unsigned m_x, m_y, m_width, m_height;
+  };
+
+  Tile       m_tile;
+  Rect       m_inner;         // Tile area less border
+  PBYTEArray m_source;
+  unsigned   m_sourceWidth;
+  unsigned   m_sourceHeight;
+  bool       m_dirty;
+
+  // Scaling parameters, kept until source size changes
+  bool               m_prepared;
+  std::vector<Rect>  m_fills;
+  Rect               m_srcRect;
+  Rect               m_dstRect;
+  YUV420PRowFunction m_rowFunction;
+#if P_FFMPEG_SWSCALE
+  struct SwsContext * m_context;
+#endif
+
+
+  TileState(const Tile & tile)
+    : m_tile(tile)
+    , m_sourceWidth(0)
+    , m_sourceHeight(0)
+    , m_dirty(true)
+    , m_prepared(false)
+    , m_rowFunction(NULL)
+#if P_FFMPEG_SWSCALE
+    , m_context(NULL)
+#endif
+  {
+    m_tile.m_x &= ~1;
+    m_tile.m_y &= ~1;
+    m_tile.m_width &= ~1;
+    m_tile.m_height &= ~1;
+    m_tile.m_border = (m_tile.m_border+1)&~1;
+
+    unsigned border = std::min(m_tile.m_border, std::min(m_tile.m_width, m_tile.m_height)/2);
+    m_inner = Rect(m_tile.m_x + border, m_tile.m_y + border, m_tile.m_width - border*2, m_tile.m_height - border*2);
+  }
+
+
+  ~TileState()
+  {
+    Unprepare();
+  }
+
+
+  void Unprepare()
+  {
+    m_prepared = false;
+#if P_FFMPEG_SWSCALE
+    if (m_context != NULL) {
+      sws_freeContext(m_context);
+      m_context = NULL;
+    }
+#endif
+  }
+
+
+  bool HasSource() const { return m_sourceWidth > 0 && m_sourceHeight > 0; }
+
+
+  void Prepare()
+  {
+    if (m_prepared)
+      return;
+
+    m_fills.clear();
+
+    // Area of source to use, must be even for YUV420P
+    m_srcRect = Rect(m_tile.m_cropX, m_tile.m_cropY, m_tile.m_cropWidth, m_tile.m_cropHeight);
+    if (m_srcRect.m_x >= m_sourceWidth)
+      m_srcRect.m_x = 0;
+    if (m_srcRect.m_y >= m_sourceHeight)
+      m_srcRect.m_y = 0;
+    if (m_srcRect.m_width == 0 || m_srcRect.m_x + m_srcRect.m_width > m_sourceWidth)
+      m_srcRect.m_width = m_sourceWidth - m_srcRect.m_x;
+    if (m_srcRect.m_height == 0 || m_srcRect.m_y + m_srcRect.m_height > m_sourceHeight)
+      m_srcRect.m_height = m_sourceHeight - m_srcRect.m_y;
+    m_srcRect.m_x &= ~1;
+    m_srcRect.m_y &= ~1;
+    m_srcRect.m_width &= ~1;
+    m_srcRect.m_height &= ~1;
+
+    m_dstRect = m_inner;
+
+    switch (m_tile.m_resizeMode) {
+      case PVideoFrameInfo::eCropTopLeft :
+      case PVideoFrameInfo::eCropCentre :
+      {
+        bool centre = m_tile.m_resizeMode == PVideoFrameInfo::eCropCentre;
+        if (m_srcRect.m_width > m_inner.m_width) {
+          if (centre)
+            m_srcRect.m_x += ((m_srcRect.m_width - m_inner.m_width)/2)&~1;
+          m_srcRect.m_width = m_inner.m_width;
+        }
+        else {
+          m_dstRect.m_width = m_srcRect.m_width;
+          if (centre)
+            m_dstRect.m_x += ((m_inner.m_width - m_srcRect.m_width)/2)&~1;
+        }
+
+        if (m_srcRect.m_height > m_inner.m_height) {
+          if (centre)
+            m_srcRect.m_y += ((m_srcRect.m_height - m_inner.m_height)/2)&~1;
+          m_srcRect.m_height = m_inner.m_height;
+        }
+        else {
+          m_dstRect.m_height = m_srcRect.m_height;
+          if (centre)
+            m_dstRect.m_y += ((m_inner.m_height - m_srcRect.m_height)/2)&~1;
+        }
+        break;
+      }
+
+      case PVideoFrameInfo::eScale :
+        // Cannot grow in one direction and shrink in the other, so keep aspect instead
+        if ((m_srcRect.m_width < m_inner.m_width) == (m_srcRect.m_height < m_inner.m_height) ||
+             m_srcRect.m_width == m_inner.m_width || m_srcRect.m_height == m_inner.m_height)
+          break;
+        // Do next case
+
+      default :
+      {
+        unsigned srcWidthByDstHeight = m_srcRect.m_width * m_inner.m_height;
+        unsigned dstWidthBySrcHeight = m_inner.m_width * m_srcRect.m_height;
+        if (srcWidthByDstHeight < dstWidthBySrcHeight) {
+          m_dstRect.m_width = (srcWidthByDstHeight/m_srcRect.m_height)&~1;
+          m_dstRect.m_x += ((m_inner.m_width - m_dstRect.m_width)/2)&~1;
+        }
+        else if (srcWidthByDstHeight > dstWidthBySrcHeight) {
+          m_dstRect.m_height = (dstWidthBySrcHeight/m_srcRect.m_width)&~1;
+          m_dstRect.m_y += ((m_inner.m_height - m_dstRect.m_height)/2)&~1;
+        }
+      }
+    }
+
+    // Background for the parts of the inner area not covered by the image
+    if (m_dstRect.m_y > m_inner.m_y)
+      m_fills.push_back(Rect(m_inner.m_x, m_inner.m_y, m_inner.m_width, m_dstRect.m_y - m_inner.m_y));
+    if (m_dstRect.m_y + m_dstRect.m_height < m_inner.m_y + m_inner.m_height)
+      m_fills.push_back(Rect(m_inner.m_x, m_dstRect.m_y + m_dstRect.m_height,
+                             m_inner.m_width, m_inner.m_y + m_inner.m_height - m_dstRect.m_y - m_dstRect.m_height));
+    if (m_dstRect.m_x > m_inner.m_x)
+      m_fills.push_back(Rect(m_inner.m_x, m_dstRect.m_y, m_dstRect.m_x - m_inner.m_x, m_dstRect.m_height));
+    if (m_dstRect.m_x + m_dstRect.m_width < m_inner.m_x + m_inner.m_width)
+      m_fills.push_back(Rect(m_dstRect.m_x + m_dstRect.m_width, m_dstRect.m_y,
+                             m_inner.m_x + m_inner.m_width - m_dstRect.m_x - m_dstRect.m_width, m_dstRect.m_height));
+
+    m_rowFunction = GetScalingRowFunction(m_srcRect.m_width, m_srcRect.m_height, m_dstRect.m_width, m_dstRect.m_height);
+
+#if P_FFMPEG_SWSCALE
+    if (m_rowFunction != CropYUV420P && m_dstRect.m_width > 0 && m_dstRect.m_height > 0)
+      m_context = sws_getContext(m_srcRect.m_width, m_srcRect.m_height, AV_PIX_FMT_YUV420P,
+                                 m_dstRect.m_width, m_dstRect.m_height, AV_PIX_FMT_YUV420P,
+                                 SWS_BILINEAR, NULL, NULL, NULL);
+#endif
+
+    m_prepared = true;
+    PTRACE(5, NULL, "Compositor", "Tile prepared: "
+           << m_sourceWidth << 'x' << m_sourceHeight << " -> " << m_inner.m_width << 'x' << m_inner.m_height
+           << ", src=" << m_srcRect.m_x << ',' << m_srcRect.m_y << ',' << m_srcRect.m_width << 'x' << m_srcRect.m_height
+           << ", dst=" << m_dstRect.m_x << ',' << m_dstRect.m_y << ',' << m_dstRect.m_width << 'x' << m_dstRect.m_height);
+  }
+
+
+  void Draw(unsigned frameWidth, unsigned frameHeight, BYTE * canvas, const BYTE * background)
+  {
+    if (m_inner.m_width < m_tile.m_width) {
+      // Draw the border as four strips
+      unsigned border = (m_tile.m_width - m_inner.m_width)/2;
+      FillRect(Rect(m_tile.m_x, m_tile.m_y, m_tile.m_width, border), frameWidth, frameHeight, canvas, m_tile.m_borderRed, m_tile.m_borderGreen, m_tile.m_borderBlue, true);
+      FillRect(Rect(m_tile.m_x, m_inner.m_y + m_inner.m_height, m_tile.m_width, border), frameWidth, frameHeight, canvas, m_tile.m_borderRed, m_tile.m_borderGreen, m_tile.m_borderBlue, true);
+      FillRect(Rect(m_tile.m_x, m_inner.m_y, border, m_inner.m_height), frameWidth, frameHeight, canvas, m_tile.m_borderRed, m_tile.m_borderGreen, m_tile.m_borderBlue, true);
+      FillRect(Rect(m_inner.m_x + m_inner.m_width, m_inner.m_y, border, m_inner.m_height), frameWidth, frameHeight, canvas, m_tile.m_borderRed, m_tile.m_borderGreen, m_tile.m_borderBlue, true);
+    }
+
+    if (!HasSource() || m_inner.m_width == 0 || m_inner.m_height == 0) {
+      FillRect(m_inner, frameWidth, frameHeight, canvas, background[0], background[1], background[2], false);
+      return;
+    }
+
+    Prepare();
+
+    for (std::vector<Rect>::iterator it = m_fills.begin(); it != m_fills.end(); ++it)
+      FillRect(*it, frameWidth, frameHeight, canvas, background[0], background[1], background[2], false);
+
+    if (m_srcRect.m_width == 0 || m_srcRect.m_height == 0 || m_dstRect.m_width == 0 || m_dstRect.m_height == 0)
+      return;
+
+    unsigned srcFrameWidth = (m_sourceWidth+1)&~1;
+    unsigned srcFrameHeight = (m_sourceHeight+1)&~1;
+
+#if P_FFMPEG_SWSCALE
+    if (m_context != NULL) {
+      const uint8_t* srcSlice[] = {
+          ffmpeg_yuvptr(m_source, srcFrameWidth, srcFrameHeight, m_srcRect.m_x, m_srcRect.m_y, 0),
+          ffmpeg_yuvptr(m_source, srcFrameWidth, srcFrameHeight, m_srcRect.m_x, m_srcRect.m_y, 1),
+          ffmpeg_yuvptr(m_source, srcFrameWidth, srcFrameHeight, m_srcRect.m_x, m_srcRect.m_y, 2)
+      };
+      const int srcStride[] = { (int)srcFrameWidth, (int)srcFrameWidth/2, (int)srcFrameWidth/2 };
+
+      uint8_t* dstSlice[] = {
+          ffmpeg_yuvptr(canvas, frameWidth, frameHeight, m_dstRect.m_x, m_dstRect.m_y, 0),
+          ffmpeg_yuvptr(canvas, frameWidth, frameHeight, m_dstRect.m_x, m_dstRect.m_y, 1),
+          ffmpeg_yuvptr(canvas, frameWidth, frameHeight, m_dstRect.m_x, m_dstRect.m_y, 2)
+      };
+      const int dstStride[] = { (int)frameWidth, (int)frameWidth/2, (int)frameWidth/2 };
+
+      sws_scale(m_context, srcSlice, srcStride, 0, m_srcRect.m_height, dstSlice, dstStride);
+      return;
+    }
+#endif // P_FFMPEG_SWSCALE
+
+    CopyPlanesYUV420P(m_rowFunction,
+                      m_srcRect.m_x, m_srcRect.m_y, m_srcRect.m_width, m_srcRect.m_height,
+                      srcFrameWidth, srcFrameHeight, m_source,
+                      m_dstRect.m_x, m_dstRect.m_y, m_dstRect.m_width, m_dstRect.m_height,
+                      frameWidth, frameHeight, canvas, false);
+  }
+
+
+  static void FillRect(const Rect & rect, unsigned frameWidth, unsigned frameHeight, BYTE * canvas,
+                       unsigned r_or_y, unsigned g_or_u, unsigned b_or_v, bool rgb)
+  {
+    if (rect.m_width > 0 && rect.m_height > 0)
+      PColourConverter::FillYUV420P(rect.m_x, rect.m_y, rect.m_width, rect.m_height,
+                                    frameWidth, frameHeight, canvas, r_or_y, g_or_u, b_or_v, rgb);
+  }
+};
+
+
+/* Work item for a PQueuedThreadPool that the submitting thread waits for.
+   Signal on destruction, not at end of Work(), as the pool still references
+   the item until it deletes it, and the address may be reused immediately. */
+class PWaitableWork
+{
+  public:
+    PWaitableWork(PSemaphore & done)
+      : m_done(done)
+    {
+    }
+
+    ~PWaitableWork()
+    {
+      m_done.Signal();
+    }
+
+  protected:
+    PSemaphore & m_done;
+};
+
+
+struct PVideoCompositor::TileWork : PWaitableWork
+{
+  PVideoCompositor  & m_compositor;
+  TileState * const * m_tiles;
+  size_t              m_count;
+
+  TileWork(PVideoCompositor & compositor, TileState * const * tiles, size_t count, PSemaphore & done)
+    : PWaitableWork(done)
+    , m_compositor(compositor)
+    , m_tiles(tiles)
+    , m_count(count)
+  {
+  }
+
+  void Work()
+  {
+    for (size_t i = 0; i < m_count; ++i)
+      m_compositor.InternalDrawTile(*m_tiles[i]);
+  }
+};
+
+
+PVideoCompositor::PVideoCompositor(unsigned width, unsigned height, unsigned threads)
+  : m_width(width&~1)
+  , m_height(height&~1)
+  , m_threads(threads)
+  , m_redrawAll(true)
+  , m_pool(NULL)
+{
+  m_background[0] = m_background[1] = m_background[2] = 0;
+  PColourConverter::RGBtoYUV(0, 0, 0, m_background[0], m_background[1], m_background[2]);
+  m_canvas.SetSize(PVideoFrameInfo::CalculateFrameBytes(m_width, m_height));
+}
+
+
+PVideoCompositor::~PVideoCompositor()
+{
+  delete m_pool;
+  for (std::vector<TileState *>::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
+    delete *it;
+}
+
+
+bool PVideoCompositor::SetCanvasSize(unsigned width, unsigned height)
+{
+  PWaitAndSignal lock(m_mutex);
+
+  width &= ~1;
+  height &= ~1;
+  if (width == 0 || height == 0)
+    return false;
+
+  for (std::vector<TileState *>::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+    if ((*it)->m_tile.m_x + (*it)->m_tile.m_width > width || (*it)->m_tile.m_y + (*it)->m_tile.m_height > height) {
+      PTRACE(2, NULL, "Compositor", "Canvas " << width << 'x' << height << " too small for current layout");
+      return false;
+    }
+  }
+
+  m_width = width;
+  m_height = height;
+  m_canvas.SetSize(PVideoFrameInfo::CalculateFrameBytes(m_width, m_height));
+  m_redrawAll = true;
+  return true;
+}
+
+
+void PVideoCompositor::SetBackground(BYTE red, BYTE green, BYTE blue)
+{
+  PWaitAndSignal lock(m_mutex);
+  PColourConverter::RGBtoYUV(red, green, blue, m_background[0], m_background[1], m_background[2]);
+  m_redrawAll = true;
+}
+
+
+bool PVideoCompositor::SetLayout(const Layout & layout)
+{
+  PWaitAndSignal lock(m_mutex);
+
+  std::vector<TileState *> tiles;
+  for (Layout::const_iterator it = layout.begin(); it != layout.end(); ++it) {
+    TileState * tile = new TileState(*it);
+    tiles.push_back(tile);
+    const Tile & area = tile->m_tile;
+
+    bool bad = false;
+    if (area.m_x + area.m_width > m_width || area.m_y + area.m_height > m_height) {
+      PTRACE(2, NULL, "Compositor", "Tile " << (tiles.size()-1) << " outside of canvas " << m_width << 'x' << m_height);
+      bad = true;
+    }
+    else {
+      /* Tiles are drawn in parallel, and individually when dirty, so they
+         must not share any pixels with each other. */
+      for (size_t i = 0; i < tiles.size()-1; ++i) {
+        const Tile & other = tiles[i]->m_tile;
+        if (area.m_x < other.m_x + other.m_width  && other.m_x < area.m_x + area.m_width &&
+            area.m_y < other.m_y + other.m_height && other.m_y < area.m_y + area.m_height) {
+          PTRACE(2, NULL, "Compositor", "Tile " << (tiles.size()-1) << " overlaps tile " << i);
+          bad = true;
+          break;
+        }
+      }
+    }
+
+    if (bad) {
+      for (std::vector<TileState *>::iterator del = tiles.begin(); del != tiles.end(); ++del)
+        delete *del;
+      return false;
+    }
+  }
+
+  // Keep any existing sources
+  for (size_t i = 0; i < m_tiles.size(); ++i) {
+    if (i < tiles.size()) {
+      tiles[i]->m_source = m_tiles[i]->m_source;
+      tiles[i]->m_sourceWidth = m_tiles[i]->m_sourceWidth;
+      tiles[i]->m_sourceHeight = m_tiles[i]->m_sourceHeight;
+    }
+    delete m_tiles[i];
+  }
+
+  m_tiles = tiles;
+  m_layout = layout;
+  m_redrawAll = true;
+  return true;
+}
+
+
+PVideoCompositor::Layout PVideoCompositor::MakeGrid(unsigned columns,
+                                                    unsigned rows,
+                                                    unsigned width,
+                                                    unsigned height,
+                                                    unsigned border,
+                                                    PVideoFrameInfo::ResizeMode resizeMode)
+{
+  Layout layout;
+  if (columns == 0 || rows == 0)
+    return layout;
+
+  unsigned tileWidth = (width/columns)&~1;
+  unsigned tileHeight = (height/rows)&~1;
+  for (unsigned row = 0; row < rows; ++row) {
+    for (unsigned column = 0; column < columns; ++column) {
+      Tile tile(column*tileWidth, row*tileHeight, tileWidth, tileHeight, resizeMode);
+      tile.m_border = border;
+      layout.push_back(tile);
+    }
+  }
+  return layout;
+}
+
+
+void PVideoCompositor::SetThreads(unsigned threads)
+{
+  PWaitAndSignal lock(m_mutex);
+
+  if (m_threads == threads)
+    return;
+
+  m_threads = threads;
+
+  // Resized on next Compose()
+  delete m_pool;
+  m_pool = NULL;
+}
+
+
+bool PVideoCompositor::SetSource(PINDEX index, const BYTE * yuv, unsigned width, unsigned height)
+{
+  if (!PAssert(yuv != NULL && width > 0 && height > 0, PInvalidParameter))
+    return false;
+
+  PWaitAndSignal lock(m_mutex);
+
+  if (index < 0 || (size_t)index >= m_tiles.size())
+    return false;
+
+  TileState & tile = *m_tiles[index];
+  if (tile.m_sourceWidth != width || tile.m_sourceHeight != height) {
+    tile.Unprepare();
+    tile.m_sourceWidth = width;
+    tile.m_sourceHeight = height;
+  }
+
+  PINDEX size = PVideoFrameInfo::CalculateFrameBytes(width, height);
+  memcpy(tile.m_source.GetPointer(size), yuv, size);
+  tile.m_dirty = true;
+  return true;
+}
+
+
+bool PVideoCompositor::ClearSource(PINDEX index)
+{
+  PWaitAndSignal lock(m_mutex);
+
+  if (index < 0 || (size_t)index >= m_tiles.size())
+    return false;
+
+  TileState & tile = *m_tiles[index];
+  if (tile.HasSource()) {
+    tile.Unprepare();
+    tile.m_sourceWidth = tile.m_sourceHeight = 0;
+    tile.m_source.SetSize(0);
+    tile.m_dirty = true;
+  }
+  return true;
+}
+
+
+void PVideoCompositor::InternalDrawTile(TileState & tile)
+{
+  tile.Draw(m_width, m_height, m_canvas.GetPointer(), m_background);
+}
+
+
+PINDEX PVideoCompositor::Compose()
+{
+  PWaitAndSignal lock(m_mutex);
+
+  if (m_redrawAll) {
+    PColourConverter::FillYUV420P(0, 0, m_width, m_height, m_width, m_height, m_canvas.GetPointer(),
+                                  m_background[0], m_background[1], m_background[2], false);
+    for (std::vector<TileState *>::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
+      (*it)->m_dirty = true;
+    m_redrawAll = false;
+  }
+
+  std::vector<TileState *> dirty;
+  for (std::vector<TileState *>::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+    if ((*it)->m_dirty) {
+      dirty.push_back(*it);
+      (*it)->m_dirty = false;
+    }
+  }
+
+  if (dirty.empty())
+    return 0;
+
+  unsigned maxThreads = m_threads > 0 ? m_threads : PThread::GetNumProcessors();
+  unsigned threads = maxThreads;
+  if (threads > dirty.size())
+    threads = dirty.size();
+
+  if (threads <= 1) {
+    for (std::vector<TileState *>::iterator it = dirty.begin(); it != dirty.end(); ++it)
+      InternalDrawTile(**it);
+    return dirty.size();
+  }
+
+  // This thread is one of the threads, so the pool needs one less
+  if (m_pool == NULL)
+    m_pool = new PQueuedThreadPool<TileWork>(maxThreads-1, 0, "Compositor");
+
+  // Each thread draws a contiguous range of tiles, this thread does the first
+  size_t perThread = dirty.size()/threads;
+  size_t extra = dirty.size()%threads;
+  size_t first = perThread + (extra > 0 ? 1 : 0);
+  PSemaphore done(0, threads-1);
+  for (unsigned i = 1; i < threads; ++i) {
+    size_t count = perThread + (i < extra ? 1 : 0);
+    m_pool->AddWork(new TileWork(*this, &dirty[first], count, done));
+    first += count;
+  }
+
+  for (size_t i = 0; i < perThread + (extra > 0 ? 1 : 0); ++i)
+    InternalDrawTile(*dirty[i]);
+
+  for (unsigned i = 1; i < threads; ++i)
+    done.Wait();
+
+  return dirty.size();
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #if P_JPEG_DECODER
@@ -3113,7 +3692,90 @@ struct PJPEGConverter::Context
 
   jdec_private * m_decoder;
 
+  /* Restart intervals in the JPEG may be decoded in parallel, each work
+     item decodes a contiguous range of them from a copy of the decoder. */
+  struct SegmentWork : PWaitableWork
+  {
+    jdec_private   * m_decoder;
+    ColourSpace      m_colourSpace;
+    int              m_first;
+    int              m_count;
+    std::string    & m_error;
+
+    SegmentWork(jdec_private * decoder, ColourSpace colourSpace, int first, int count, std::string & error, PSemaphore & done)
+      : PWaitableWork(done)
+      , m_decoder(decoder)
+      , m_colourSpace(colourSpace)
+      , m_first(first)
+      , m_count(count)
+      , m_error(error)
+    {
+    }
+
+    void Work()
+    {
+      char error[TINYJPEG_ERROR_SIZE];
+      if (tinyjpeg_decode_segments(m_decoder, m_colourSpace, m_first, m_count, error, sizeof(error)) < 0)
+        m_error = error[0] != '\0' ? error : "Unknown segment decode error";
+    }
+  };
+
+  PQueuedThreadPool<SegmentWork> * m_segmentPool;
+
+
+  bool DecodeSegments(unsigned threads)
+  {
+    int segments = tinyjpeg_get_segment_count(m_decoder, m_colourSpace);
+    if (segments < 0)
+      return false;
+
+    if (threads == 0)
+      threads = PThread::GetNumProcessors();
+    if (threads > (unsigned)segments)
+      threads = segments;
+
+    PSemaphore done(0, threads);
+    std::vector<std::string> errors(threads);
+
+    if (threads <= 1)
+      SegmentWork(m_decoder, m_colourSpace, 0, segments, errors[0], done).Work();
+    else {
+      PTRACE(5, NULL, "JPEG", "TinyJpeg decoding " << segments << " segments using " << threads << " threads");
+
+      if (m_segmentPool == NULL)
+        m_segmentPool = new PQueuedThreadPool<SegmentWork>(PThread::GetNumProcessors(), 0, "JPEG Decode");
+
+      // This thread does the first range, the rest go to the pool
+      int perThread = segments/threads;
+      int extra = segments%threads;
+      int first = perThread + (extra > 0 ? 1 : 0);
+      for (unsigned i = 1; i < threads; ++i) {
+        int count = perThread + ((int)i < extra ? 1 : 0);
+        m_segmentPool->AddWork(new SegmentWork(m_decoder, m_colourSpace, first, count, errors[i], done));
+        first += count;
+      }
+
+      SegmentWork(m_decoder, m_colourSpace, 0, perThread + (extra > 0 ? 1 : 0), errors[0], done).Work();
+
+      for (unsigned i = 0; i < threads; ++i)
+        done.Wait();
+    }
+
+    // The workers only have copies of the decoder, so report the first error via the original
+    for (unsigned i = 0; i < threads; ++i) {
+      if (!errors[i].empty()) {
+        tinyjpeg_set_errorstring(m_decoder, errors[i].c_str());
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+
   Context()
+    : m_segmentPool(NULL)
+    , m_threads(1)
   {
     m_decoder = tinyjpeg_init();
     if (m_decoder == NULL) {
@@ -3128,6 +3790,7 @@ struct PJPEGConverter::Context
 
   ~Context()
   {
+    delete m_segmentPool;
     if (m_decoder != NULL)
       free(m_decoder);
     PTRACE(4, NULL, "JPEG", "TinyJpeg decoder destroyed");
@@ -3165,7 +3828,7 @@ struct PJPEGConverter::Context
  
     tinyjpeg_set_components(m_decoder, components, componentCount);
 
-    if (tinyjpeg_decode(m_decoder, m_colourSpace) >= 0)
+    if (m_threads == 1 ? (tinyjpeg_decode(m_decoder, m_colourSpace) >= 0) : DecodeSegments(m_threads))
       return true;
 
     PTRACE(2, NULL, "JPEG", "Decode error: " << tinyjpeg_get_errorstring(m_decoder));
@@ -3191,6 +3854,7 @@ struct PJPEGConverter::Context
 
 
   Context()
+    : m_threads(1)
   {
     m_decoder.err = jpeg_std_error(&m_error_mgr);
     jpeg_create_decompress(&m_decoder);
@@ -3311,6 +3975,7 @@ struct PJPEGConverter::Context
 
 
   ColourSpace m_colourSpace;
+  unsigned    m_threads;
 
   bool SetColourSpace(const PCaselessString & colourFormat)
   {
@@ -3510,6 +4175,18 @@ PBoolean PJPEGConverter::Convert(const BYTE * srcFrameBuffer, BYTE * dstFrameBuf
 }
 
 
+void PJPEGConverter::SetDecodeThreads(unsigned threads)
+{
+  m_context->m_threads = threads;
+}
+
+
+unsigned PJPEGConverter::GetDecodeThreads() const
+{
+  return m_context->m_threads;
+}
+
+
 bool PJPEGConverter::Load(const PFilePath & filename, PBYTEArray & dstFrameBuffer)
 {
   PFile file;
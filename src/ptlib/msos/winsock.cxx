@@ -1342,10 +1342,7 @@ PBoolean PIPSocket::GetInterfaceTable(InterfaceTable & table, PBoolean includeDo
 {
   PIPInterfaceAddressTable byAddress;
 
-  if (!table.SetSize(0))
-    return false;
-
-  PINDEX count = 0; // address count
+  table.RemoveAll();
 
 #if P_HAS_IPV6 || _WIN32_WINNT_WINXP
   PIPAdaptersAddressTable interfaces;
@@ -1383,7 +1380,7 @@ PBoolean PIPSocket::GetInterfaceTable(InterfaceTable & table, PBoolean includeDo
           }
         } // find mask for the address
 
-        table.SetAt(count++, new InterfaceEntry(adapter->Description, addr, mask, macAddr));
+        table.Append(InterfaceEntry(adapter->Description, addr, mask, macAddr));
       } // ipv4
 #if P_HAS_IPV6
       else if (unicast->Address.lpSockaddr->sa_family == AF_INET6) {
@@ -1391,7 +1388,7 @@ PBoolean PIPSocket::GetInterfaceTable(InterfaceTable & table, PBoolean includeDo
         PIPSocket::Address addr(sock6->sin6_addr, sock6->sin6_scope_id);
         if (addr.IsAny() || addr.IsBroadcast())
           addr = GetInvalidAddress();
-        table.SetAt(count++, new InterfaceEntry(adapter->Description, addr, 0L, macAddr));
+        table.Append(InterfaceEntry(adapter->Description, addr, 0L, macAddr));
       }
 #endif
     }
@@ -1411,10 +1408,10 @@ PBoolean PIPSocket::GetInterfaceTable(InterfaceTable & table, PBoolean includeDo
       if (addr.IsAny() || addr.IsBroadcast())
         addr = GetInvalidAddress();
 
-      table.SetAt(count++, new InterfaceEntry(PString((const char *)info.bDescr, info.dwDescrLen),
-                                              addr,
-                                              byAddress->table[i].dwMask,
-                                              macAddr));
+      table.Append(InterfaceEntry(PString((const char *)info.bDescr, info.dwDescrLen),
+                                  addr,
+                                  byAddress->table[i].dwMask,
+                                  macAddr));
     }
   }
 
@@ -1652,7 +1652,7 @@ PBoolean PIPSocket::GetInterfaceTable(InterfaceTable & list, PBoolean includeDow
 
       if (addr.IsAny() || addr.IsBroadcast())
         addr = GetInvalidAddress();
-      list.Append(PNEW InterfaceEntry(ifa->ifa_name, addr, mask, macAddr));
+      list.Append(InterfaceEntry(ifa->ifa_name, addr, mask, macAddr));
     }
     freeifaddrs(interfaces);
   }
@@ -1745,7 +1745,7 @@ PBoolean PIPSocket::GetInterfaceTable(InterfaceTable & list, PBoolean includeDow
                   break;
               }
               if (i >= list.GetSize())
-                list.Append(PNEW InterfaceEntry(name, addr, mask, macAddr));
+                list.Append(InterfaceEntry(name, addr, mask, macAddr));
             }
           }
         }
@@ -1797,7 +1797,7 @@ PBoolean PIPSocket::GetInterfaceTable(InterfaceTable & list, PBoolean includeDow
       // so, we need to use the hack of assuming that if_nametoindex returns the correct scope
       // for link-local interfaces. if anyone knows how to do this better, contact craigs@postincrement.com
       scope = if_nametoindex(ifaceName);
-      list.Append(PNEW InterfaceEntry(ifaceName, Address(16, bytes, scope), Address::GetAny(6), macAddr));
+      list.Append(InterfaceEntry(ifaceName, Address(16, bytes, scope), Address::GetAny(6), macAddr));
     }
     fclose(file);
   }
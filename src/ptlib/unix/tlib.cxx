@@ -62,6 +62,17 @@
 #include <errno.h>
 
 #if defined(P_LINUX) || defined(P_GNU_HURD)
+#if PMEMORY_CHECK
+// These redeclare the C heap functions, so hide the memory check macros
+#pragma push_macro("malloc")
+#pragma push_macro("calloc")
+#pragma push_macro("realloc")
+#pragma push_macro("free")
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+#endif
 #include <sys/cdefs.h>
 #include <sys/types.h>
 #include <sys/mman.h>
@@ -70,6 +81,12 @@
 #ifndef P_RTEMS
 #include <sys/resource.h>
 #endif
+#if PMEMORY_CHECK
+#pragma pop_macro("malloc")
+#pragma pop_macro("calloc")
+#pragma pop_macro("realloc")
+#pragma pop_macro("free")
+#endif
 #endif
 
 #if defined(P_LINUX) || defined(P_SUN4) || defined(P_SOLARIS) || defined(P_FREEBSD) || defined(P_OPENBSD) || defined(P_NETBSD) || defined(P_MACOSX) || defined(P_IOS) || defined (P_AIX) || defined(P_BEOS) || defined(P_IRIX) || defined(P_QNX) || defined(P_GNU_HURD) || defined(P_ANDROID)
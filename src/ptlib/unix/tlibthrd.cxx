@@ -45,6 +45,9 @@
 #include <sys/sysctl.h>
 #elif defined(P_LINUX)
 #include <sys/syscall.h>
+#if P_FUTEX_MUTEX
+#include <linux/futex.h>
+#endif
 #elif defined(P_ANDROID)
 #include <asm/page.h>
 #include <jni.h>
@@ -1238,6 +1241,154 @@ void PSemaphore::Signal()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+#if P_FUTEX_MUTEX
+
+static __inline void FutexSpinPause()
+{
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+
+PFutexMutex::PFutexMutex(bool handoff)
+  : m_state(0)
+  , m_owner(pthread_t())
+  , m_recursion(0)
+  , m_spinEstimate(0)
+  , m_handoff(handoff)
+{
+}
+
+
+bool PFutexMutex::Wait(const PTimeInterval & timeout)
+{
+  pthread_t self = pthread_self();
+  if (m_owner.load(memory_order_relaxed) == self) {
+    ++m_recursion;
+    return true;
+  }
+
+  uint32_t state = m_state.load(memory_order_relaxed);
+  if ((!CanAcquire(state) || !m_state.compare_exchange_strong(state, state|LockedBit, memory_order_acquire, memory_order_relaxed)) &&
+      !InternalWait(state, timeout == PMaxTimeInterval ? NULL : &timeout))
+    return false;
+
+  m_owner.store(self, memory_order_relaxed);
+  return true;
+}
+
+
+bool PFutexMutex::InternalWait(uint32_t state, const PTimeInterval * timeout)
+{
+  // The fast path may have failed due to a race, try again
+  while (CanAcquire(state)) {
+    if (m_state.compare_exchange_weak(state, state|LockedBit, memory_order_acquire, memory_order_relaxed))
+      return true;
+  }
+
+  /* Spin for a while first, unless in handoff mode with threads already
+     waiting, as then the lock will not become available to us. The limit is
+     adapted in the same manner as glibc's PTHREAD_MUTEX_ADAPTIVE_NP. There
+     is no point spinning at all on a single processor, the holder cannot
+     release the lock while we are running. */
+  static unsigned const MaxSpinLimit = PThread::GetNumProcessors() > 1 ? MaxSpins : 0;
+  unsigned estimate = m_spinEstimate.load(memory_order_relaxed);
+  unsigned spinLimit = std::min(estimate*2 + 10, MaxSpinLimit);
+  unsigned spins = 0;
+  while (spins < spinLimit && (!m_handoff || state < WaiterIncrement)) {
+    ++spins;
+    if (!CanAcquire(state)) {
+      FutexSpinPause();
+      state = m_state.load(memory_order_relaxed);
+    }
+    else if (m_state.compare_exchange_weak(state, state|LockedBit, memory_order_acquire, memory_order_relaxed)) {
+      m_spinEstimate.store(estimate + ((int)spins - (int)estimate)/8, memory_order_relaxed);
+      return true;
+    }
+  }
+  if (spins > 0)
+    m_spinEstimate.store(estimate + ((int)spins - (int)estimate)/8, memory_order_relaxed);
+
+  struct timespec deadline;
+  if (timeout != NULL) {
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    int64_t ns = deadline.tv_nsec + timeout->GetMilliSeconds()*1000000;
+    deadline.tv_sec += ns/1000000000;
+    deadline.tv_nsec = ns%1000000000;
+  }
+
+  // Register as a waiter, unless it can be acquired now
+  for (;;) {
+    if (CanAcquire(state)) {
+      if (m_state.compare_exchange_weak(state, state|LockedBit, memory_order_acquire, memory_order_relaxed))
+        return true;
+    }
+    else if (timeout != NULL && *timeout <= 0)
+      return false;
+    else if (m_state.compare_exchange_weak(state, state+WaiterIncrement, memory_order_relaxed, memory_order_relaxed)) {
+      state += WaiterIncrement;
+      break;
+    }
+  }
+
+  /* A waiter may take the lock whenever it is not locked, which in handoff
+     mode is only when it has been passed to the waiters. Otherwise, before
+     sleeping, it clears the wake pending flag so the next release wakes a
+     thread again. While the flag is set, releases do not make the system
+     call, as the waiter that is awake will see the change. */
+  bool timedOut = false;
+  for (;;) {
+    if ((state & LockedBit) == 0) {
+      if (m_state.compare_exchange_weak(state, ((state - WaiterIncrement) & ~(HandoffBit|WakePendingBit)) | LockedBit,
+                                        memory_order_acquire, memory_order_relaxed))
+        return true;
+    }
+    else if (timedOut) {
+      if (m_state.compare_exchange_weak(state, (state - WaiterIncrement) & ~WakePendingBit,
+                                        memory_order_relaxed, memory_order_relaxed))
+        return false;
+    }
+    else if ((state & WakePendingBit) == 0 ||
+              m_state.compare_exchange_weak(state, state & ~WakePendingBit, memory_order_relaxed, memory_order_relaxed)) {
+      /* Sleep until the state changes. FUTEX_WAIT_BITSET takes an absolute
+         CLOCK_MONOTONIC time, so the deadline need not be recalculated. */
+      state &= ~WakePendingBit;
+      PPROFILE_SYSTEM(
+        if (syscall(SYS_futex, &m_state, FUTEX_WAIT_BITSET|FUTEX_PRIVATE_FLAG, state,
+                    timeout != NULL ? &deadline : NULL, NULL, FUTEX_BITSET_MATCH_ANY) < 0)
+          timedOut = errno == ETIMEDOUT;
+      );
+      state = m_state.load(memory_order_relaxed);
+    }
+  }
+}
+
+
+void PFutexMutex::InternalSignal(uint32_t state)
+{
+  // There are waiters, release or pass it to them, and wake one up if not already
+  uint32_t newState;
+  do {
+    if (state < WaiterIncrement)
+      newState = 0;
+    else if (m_handoff)
+      newState = (state & ~LockedBit) | HandoffBit | WakePendingBit;
+    else
+      newState = (state & ~LockedBit) | WakePendingBit;
+  } while (!m_state.compare_exchange_weak(state, newState, memory_order_release, memory_order_relaxed));
+
+  if (newState != 0 && (state & WakePendingBit) == 0)
+    syscall(SYS_futex, &m_state, FUTEX_WAKE|FUTEX_PRIVATE_FLAG, 1, NULL, NULL, 0);
+}
+
+#endif // P_FUTEX_MUTEX
+
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void PTimedMutex::InitialiseRecursiveMutex(pthread_mutex_t *mutex)
@@ -1267,12 +1418,28 @@ void PTimedMutex::InitialiseRecursiveMutex(pthread_mutex_t *mutex)
 
 void PTimedMutex::PlatformConstruct()
 {
+#if !P_FUTEX_MUTEX
   InitialiseRecursiveMutex(&m_mutex);
+#endif
 }
 
 
 PTimedMutex::~PTimedMutex()
 {
+#if P_FUTEX_MUTEX
+  if (m_lockerId != pthread_self()) {
+    // Wait a bit for someone else to unlock it
+    for (PINDEX i = 0; i < 100; ++i) {
+      if (m_mutex.Try()) {
+        m_mutex.Signal();
+        break;
+      }
+      PPROFILE_SYSTEM(
+        usleep(100);
+      );
+    }
+  }
+#else
   int result;
   if (m_lockerId == pthread_self()) {
     // Unlock first
@@ -1294,6 +1461,7 @@ PTimedMutex::~PTimedMutex()
 #ifdef _DEBUG
   PAssert(result == 0, "Error destroying mutex");
 #endif
+#endif // P_FUTEX_MUTEX
 
   PMUTEX_DESTROYED();
 }
@@ -1308,6 +1476,9 @@ void PTimedMutex::PrintOn(ostream &strm) const
 
 PBoolean PTimedMutex::PlatformWait(const PTimeInterval & waitTime) 
 {
+#if P_FUTEX_MUTEX
+  return m_mutex.Wait(waitTime);
+#else
 #if !P_HAS_RECURSIVE_MUTEX
   // if we already have the mutex, return immediately
   if (pthread_equal(m_lockerId, pthread_self())) {
@@ -1370,11 +1541,19 @@ PBoolean PTimedMutex::PlatformWait(const PTimeInterval & waitTime)
 
   PAssertAlways(psprintf("Mutex lock failed, result=%i", result));
   return false;
+#endif // P_FUTEX_MUTEX
 }
 
 
 void PTimedMutex::PlatformSignal(const PDebugLocation * location)
 {
+#if P_FUTEX_MUTEX
+
+  InternalSignal(location);
+  m_mutex.Signal();
+
+#else
+
 #if P_HAS_RECURSIVE_MUTEX
 
   InternalSignal(location);
@@ -1395,6 +1574,8 @@ void PTimedMutex::PlatformSignal(const PDebugLocation * location)
 #endif
 
   PAssertWithRetry(pthread_mutex_unlock, &m_mutex);
+
+#endif // P_FUTEX_MUTEX
 }
 
 
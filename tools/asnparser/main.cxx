@@ -246,6 +246,8 @@ void App::Main()
              "v-verbose."
              "x-xml."
              "-no-operators."
+             "-tables."
+             "-feature:"
              "-classheader:"
              "-classheaderfile:");
 
@@ -283,6 +285,8 @@ void App::Main()
               "  --no-operators      Generate functions instead of operators for choice\n"
               "                        sub-object extraction.\n"
               "  -x --xml            X.693 support (XER)\n"
+              "  --tables            Also generate table driven codec, see ptclib/asntable.h\n"
+              "  --feature macro     Make table output conditional on macro, PTLib style\n"
               "  -o --output file    Output filename/directory\n"
            << endl;
     return;
@@ -956,7 +960,7 @@ void TypeBase::PrintOn(ostream & strm) const
 void TypeBase::PrintStart(ostream & strm) const
 {
   strm << indent();
-  if (!name) {
+  if (!name.IsEmpty()) {
     strm << name;
     if (!parameters.IsEmpty()) {
       strm << " { ";
@@ -1262,7 +1266,7 @@ DefinedType::DefinedType(TypeBase * refType, const PString & refName)
 DefinedType::DefinedType(TypeBase * refType, const TypeBase & parent)
   : TypeBase(refType)
 {
-  if (!name)
+  if (!name.IsEmpty())
     ConstructFromType(refType, parent.GetName() + '_' + name);
   else
     ConstructFromType(refType, parent.GetName() + "_subtype");
@@ -2761,7 +2765,7 @@ AnyType::AnyType(PString * ident)
 void AnyType::PrintOn(ostream & strm) const
 {
   PrintStart(strm);
-  if (!identifier)
+  if (!identifier.IsEmpty())
     strm << "Defined by " << identifier;
   PrintFinish(strm);
 }
@@ -2773,6 +2777,19 @@ const char * AnyType::GetAncestorClass() const
 }
 
 
+PString AnyType::GetTableValueType() const
+{
+  return "PASN_TableOctets";
+}
+
+
+PBoolean AnyType::GetTableInfo(TableInfo & info, ostream &)
+{
+  info.kind = "e_Any";
+  return TRUE;
+}
+
+
 /////////////////////////////////////////////////////////
 
 StringTypeBase::StringTypeBase(int tag)
@@ -3212,7 +3229,7 @@ void ValueBase::SetValueName(PString * name)
 
 void ValueBase::PrintBase(ostream & strm) const
 {
-  if (!valueName)
+  if (!valueName.IsEmpty())
     strm << '\n' << indent() << valueName << '=';
 }
 
@@ -3591,9 +3608,13 @@ ImportModule::ImportModule(PString * name, TypesList * syms)
   {
     case 3 :
       filename = renameArgs[2];
+      directoryPrefix = renameArgs[1];
+      shortModuleName = renameArgs[0];
+      break;
     case 2 :
       directoryPrefix = renameArgs[1];
       shortModuleName = renameArgs[0];
+      filename = shortModuleName.ToLower();
   }
 
   for (PINDEX i = 0; i < symbols.GetSize(); i++) {
@@ -3727,7 +3748,7 @@ void ModuleDefinition::GenerateCplusplus(const PFilePath & path,
   usingOperators = useOperators;
 
   // Adjust the module name to what is specified to a default
-  if (!modName)
+  if (!modName.IsEmpty())
     moduleName = modName;
   else
     moduleName = MakeIdentifierC(moduleName);
@@ -3936,6 +3957,605 @@ void ModuleDefinition::GenerateCplusplus(const PFilePath & path,
 
   if (verbose)
     cout << "Completed " << cxxFile.GetFilePath() << endl;
+
+  if (args.HasOption("tables"))
+    GenerateTables(path, headerPrefix, useNamespaces, verbose);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  Table driven codec generation
+//
+
+TypeBase::TableInfo::TableInfo()
+  : constraint("PASN_Object::Unconstrained"),
+    lowerLimit("0"),
+    upperLimit("UINT_MAX"),
+    rootCount(0),
+    fieldCount(0),
+    optionalCount(0),
+    extendable(FALSE)
+{
+}
+
+
+PString TypeBase::GetTableValueType() const
+{
+  return PString();
+}
+
+
+PString TypeBase::GetTableReference() const
+{
+  return PString();
+}
+
+
+PBoolean TypeBase::GetTableInfo(TableInfo &, ostream &)
+{
+  return FALSE;
+}
+
+
+PBoolean TypeBase::TableUsesType(const TypeBase &) const
+{
+  return FALSE;
+}
+
+
+void TypeBase::GenerateTableValue(ostream & hdr, ostream &)
+{
+  hdr << "typedef " << GetTableValueType() << ' ' << GetIdentifier() << "_Value;\n";
+}
+
+
+PBoolean TypeBase::IsTableSupported() const
+{
+  if (HasNonStandardTag() && tag.mode == Tag::Explicit)
+    return FALSE;
+
+  return !GetTableValueType().IsEmpty();
+}
+
+
+void TypeBase::GenerateTable(ostream & hdr, ostream & cxx)
+{
+  if (!IsTableSupported()) {
+    PError << StdError(Warning) << name << " not supported by table generation, ignored." << endl;
+    return;
+  }
+
+  hdr << "//\n"
+         "// " << name << "\n"
+         "//\n"
+         "\n";
+  cxx << "//\n"
+         "// " << name << "\n"
+         "//\n"
+         "\n";
+
+  GenerateTableValue(hdr, cxx);
+
+  hdr << "extern const PASN_TypeDescriptor " << GetIdentifier() << "_Descriptor;\n"
+         "\n"
+         "\n";
+
+  GenerateTableDescriptor(GetIdentifier() + "_Descriptor", FALSE, cxx);
+  cxx << "\n";
+}
+
+
+PString TypeBase::GenerateTableDescriptor(const PString & descName, PBoolean isStatic, ostream & cxx)
+{
+  // Fields and elements just refer to the descriptor of a named type
+  if (isStatic) {
+    PString reference = GetTableReference();
+    if (!reference.IsEmpty())
+      return reference;
+  }
+
+  TableInfo info;
+  if (!GetTableInfo(info, cxx)) {
+    PError << StdError(Warning) << name << " not supported by table generation, ignored." << endl;
+    return "NULL";
+  }
+
+  GetTableConstraints(info);
+  if (info.constraint == "PASN_Object::ExtendableConstraint")
+    info.extendable = TRUE;
+
+  PString tagName;
+  if (tag.type == Tag::Universal &&
+      tag.number < PARRAYSIZE(UniversalTagNames) &&
+      UniversalTagNames[tag.number] != NULL)
+    tagName = PString("PASN_Object::") + UniversalTagNames[tag.number];
+  else
+    tagName = PString(PString::Unsigned, tag.number);
+
+  if (isStatic)
+    cxx << "static ";
+  cxx << "const PASN_TypeDescriptor " << descName << " = {\n"
+         "  \"" << name << "\",\n"
+         "  PASN_TypeDescriptor::" << info.kind << ",\n"
+         "  " << tagName << ", PASN_Object::" << UniversalTagClassNames[tag.type] << ",\n"
+         "  " << info.constraint << ", " << info.lowerLimit << ", " << info.upperLimit << ", "
+      << (info.extendable ? "true" : "false") << ",\n"
+         "  sizeof(" << GetTableValueType() << "),\n"
+         "  " << (info.fields.IsEmpty() ? "NULL" : (const char *)info.fields) << ", "
+      << info.rootCount << ", " << info.fieldCount << ", " << info.optionalCount << ",\n"
+         "  " << (info.element.IsEmpty() ? "NULL" : (const char *)info.element) << "\n"
+         "};\n"
+         "\n";
+
+  return '&' + descName;
+}
+
+
+void TypeBase::GetTableConstraints(TableInfo & info)
+{
+  // Reuse the C++ generation and extract the SetConstraints() arguments
+  PStringStream dummy, text;
+  GenerateCplusplusConstraints(PString(), dummy, text);
+
+  PINDEX start = text.Find("SetConstraints(");
+  if (start == P_MAX_INDEX)
+    return;
+  start += 15;
+
+  PINDEX end = text.Find(')', start);
+  PStringArray args = text(start, end-1).Tokenise(", ", FALSE);
+  PString type, lower, upper;
+  switch (args.GetSize()) {
+    case 2 :
+      type = args[0];
+      lower = upper = args[1];
+      break;
+
+    case 3 :
+      type = args[0];
+      lower = args[1];
+      upper = args[2];
+      break;
+
+    default :
+      PError << StdError(Warning) << "unsupported constraint on " << name << ", ignored." << endl;
+      return;
+  }
+
+  // Same semantics as the PASN_Object::SetConstraints() overloads
+  if (upper == "MaximumValue") {
+    type = "PASN_Object::PartiallyConstrained";
+    upper = lower == "MinimumValue" || lower[0] == '-' ? "INT_MAX" : "UINT_MAX";
+  }
+  if (lower == "MinimumValue") {
+    type = "PASN_Object::PartiallyConstrained";
+    lower = "INT_MIN";
+  }
+
+  info.constraint = type;
+  info.lowerLimit = lower;
+  info.upperLimit = upper;
+}
+
+
+PString DefinedType::GetTableValueType() const
+{
+  if (baseType == NULL || !baseType->IsTableSupported())
+    return PString();
+  return baseType->GetIdentifier() + "_Value";
+}
+
+
+PString DefinedType::GetTableReference() const
+{
+  if (baseType == NULL || HasNonStandardTag() || HasConstraints())
+    return PString();
+  return '&' + baseType->GetIdentifier() + "_Descriptor";
+}
+
+
+PBoolean DefinedType::GetTableInfo(TableInfo & info, ostream & cxx)
+{
+  if (baseType == NULL || !baseType->GetTableInfo(info, cxx))
+    return FALSE;
+
+  // Our own constraints, if any, are applied after this
+  baseType->GetTableConstraints(info);
+  return TRUE;
+}
+
+
+PBoolean DefinedType::TableUsesType(const TypeBase & type) const
+{
+  return type.GetName() == referenceName;
+}
+
+
+PString BooleanType::GetTableValueType() const
+{
+  return "bool";
+}
+
+
+PBoolean BooleanType::GetTableInfo(TableInfo & info, ostream &)
+{
+  info.kind = "e_Boolean";
+  return TRUE;
+}
+
+
+PString IntegerType::GetTableValueType() const
+{
+  return "PInt64";
+}
+
+
+PBoolean IntegerType::GetTableInfo(TableInfo & info, ostream &)
+{
+  info.kind = "e_Integer";
+  return TRUE;
+}
+
+
+PString EnumeratedType::GetTableValueType() const
+{
+  return "unsigned";
+}
+
+
+PBoolean EnumeratedType::GetTableInfo(TableInfo & info, ostream &)
+{
+  int maxEnumValue = 0;
+  for (PINDEX i = 0; i < numEnums; i++) {
+    if (maxEnumValue < enumerations[i].GetNumber())
+      maxEnumValue = enumerations[i].GetNumber();
+  }
+
+  info.kind = "e_Enumeration";
+  info.upperLimit = PString(PString::Unsigned, maxEnumValue);
+  info.extendable = extendable;
+  return TRUE;
+}
+
+
+PString OctetStringType::GetTableValueType() const
+{
+  return "PASN_TableOctets";
+}
+
+
+PBoolean OctetStringType::GetTableInfo(TableInfo & info, ostream &)
+{
+  info.kind = "e_OctetString";
+  return TRUE;
+}
+
+
+PString NullType::GetTableValueType() const
+{
+  return "PASN_TableNull";
+}
+
+
+PBoolean NullType::GetTableInfo(TableInfo & info, ostream &)
+{
+  info.kind = "e_Null";
+  return TRUE;
+}
+
+
+PString ObjectIdentifierType::GetTableValueType() const
+{
+  return "PASN_TableObjectId";
+}
+
+
+PBoolean ObjectIdentifierType::GetTableInfo(TableInfo & info, ostream &)
+{
+  info.kind = "e_ObjectId";
+  return TRUE;
+}
+
+
+PString SequenceType::GetTableValueType() const
+{
+  for (PINDEX i = 0; i < fields.GetSize(); i++) {
+    if (!fields[i].IsTableSupported())
+      return PString();
+  }
+  return GetIdentifier() + "_Value";
+}
+
+
+PBoolean SequenceType::TableUsesType(const TypeBase & type) const
+{
+  for (PINDEX i = 0; i < fields.GetSize(); i++) {
+    if (fields[i].TableUsesType(type))
+      return TRUE;
+  }
+  return FALSE;
+}
+
+
+PString SetType::GetTableValueType() const
+{
+  return PString(); // Fields may be in any order, which is not supported
+}
+
+
+PBoolean SequenceType::GetTableInfo(TableInfo & info, ostream &)
+{
+  info.kind = IsChoice() ? "e_Choice" : "e_Sequence";
+  info.fields = GetIdentifier() + "_Fields";
+  info.rootCount = numFields;
+  info.fieldCount = fields.GetSize();
+  info.extendable = extendable;
+
+  for (PINDEX i = 0; i < numFields; i++) {
+    if (fields[i].IsOptional())
+      info.optionalCount++;
+  }
+
+  return TRUE;
+}
+
+
+void SequenceType::GenerateTableValue(ostream & hdr, ostream & cxx)
+{
+  PINDEX i;
+
+  hdr << "struct " << GetIdentifier() << "_Value\n"
+         "{\n";
+
+  PBoolean outputEnum = FALSE;
+  for (i = 0; i < fields.GetSize(); i++) {
+    if (i >= numFields || fields[i].IsOptional()) {
+      if (outputEnum)
+        hdr << ",\n";
+      else {
+        hdr << "  enum OptionalFields {\n";
+        outputEnum = TRUE;
+      }
+      hdr << "    e_" << fields[i].GetIdentifier();
+    }
+  }
+
+  if (outputEnum)
+    hdr << "\n"
+           "  };\n"
+           "\n"
+           "  PUInt64 m_options;\n";
+
+  for (i = 0; i < fields.GetSize(); i++)
+    hdr << "  " << fields[i].GetTableValueType() << " m_" << fields[i].GetIdentifier() << ";\n";
+
+  hdr << "};\n";
+
+  GenerateTableFields(cxx);
+}
+
+
+PString SequenceType::GenerateTableFields(ostream & cxx)
+{
+  PINDEX i;
+
+  PStringArray descriptors(fields.GetSize());
+  for (i = 0; i < fields.GetSize(); i++)
+    descriptors[i] = fields[i].GenerateTableDescriptor(GetIdentifier() + '_' + fields[i].GetIdentifier() + "_Descriptor", TRUE, cxx);
+
+  cxx << "static const PASN_FieldDescriptor " << GetIdentifier() << "_Fields[] = {\n";
+
+  int optionBit = 0;
+  for (i = 0; i < fields.GetSize(); i++) {
+    int optional = -1;
+    if (!IsChoice() && (i >= numFields || fields[i].IsOptional()))
+      optional = optionBit++;
+
+    cxx << "  { \"" << fields[i].GetName() << "\", "
+        << descriptors[i] << ", "
+           "offsetof(" << GetIdentifier() << "_Value, m_" << fields[i].GetIdentifier() << "), "
+        << optional << " }" << (i < fields.GetSize()-1 ? ",\n" : "\n");
+  }
+
+  cxx << "};\n"
+         "\n";
+
+  return GetIdentifier() + "_Fields";
+}
+
+
+void ChoiceType::GenerateTableValue(ostream & hdr, ostream & cxx)
+{
+  PINDEX i;
+
+  hdr << "struct " << GetIdentifier() << "_Value\n"
+         "{\n"
+         "  enum Choices {\n";
+
+  for (i = 0; i < fields.GetSize(); i++)
+    hdr << "    e_" << fields[i].GetIdentifier() << (i < fields.GetSize()-1 ? ",\n" : "\n");
+
+  hdr << "  };\n"
+         "\n"
+         "  unsigned m_choice;\n";
+
+  for (i = 0; i < fields.GetSize(); i++)
+    hdr << "  " << fields[i].GetTableValueType() << " m_" << fields[i].GetIdentifier() << ";\n";
+
+  hdr << "};\n";
+
+  GenerateTableFields(cxx);
+}
+
+
+PString SequenceOfType::GetTableValueType() const
+{
+  if (!baseType->IsTableSupported())
+    return PString();
+  return "PASN_TableArrayOf<" + baseType->GetTableValueType() + '>';
+}
+
+
+PBoolean SequenceOfType::GetTableInfo(TableInfo & info, ostream & cxx)
+{
+  if (tableElement.IsEmpty())
+    tableElement = baseType->GenerateTableDescriptor(GetIdentifier() + "_Element", TRUE, cxx);
+
+  info.kind = "e_SequenceOf";
+  info.element = tableElement;
+  return TRUE;
+}
+
+
+PBoolean SequenceOfType::TableUsesType(const TypeBase & type) const
+{
+  return baseType->TableUsesType(type);
+}
+
+
+PString ImportedType::GetTableValueType() const
+{
+  return GetIdentifier() + "_Value";
+}
+
+
+PString ImportedType::GetTableReference() const
+{
+  return '&' + GetIdentifier() + "_Descriptor";
+}
+
+
+void ImportedType::GenerateTable(ostream &, ostream &)
+{
+}
+
+
+void ImportModule::GenerateTable(ostream & hdr, PBoolean ptlibStyle)
+{
+  if (ptlibStyle)
+    hdr << "#include <" << directoryPrefix << filename << "_tab.h>\n";
+  else
+    hdr << "#include \"" << directoryPrefix << filename << "_tab.h\"\n";
+}
+
+
+void ModuleDefinition::GenerateTables(const PFilePath & path,
+                                      const PString & headerPrefix,
+                                      PBoolean useNamespaces,
+                                      PBoolean verbose)
+{
+  PINDEX i;
+
+  OutputFile hdrFile;
+  if (!hdrFile.Open(path, "_tab", ".h"))
+    return;
+
+  /* Within PTLib the output is conditional on a feature macro, e.g. P_SNMP,
+     rather than on an H323_DISABLE_xxx, and uses the PTLib header style. */
+  PString feature = PProcess::Current().GetArguments().GetOptionString("feature");
+  PBoolean ptlibStyle = !feature.IsEmpty();
+
+  PString featureIf, featureEndif, guard, headerName = headerPrefix + hdrFile.GetFilePath().GetFileName();
+  if (ptlibStyle) {
+    featureIf = "#ifdef " + feature;
+    featureEndif = "#endif // " + feature;
+    guard = "PTLIB_" + hdrFile.GetFilePath().GetTitle().ToUpper() + "_H";
+    headerName = '<' + headerName + '>';
+  }
+  else {
+    featureIf = "#if ! H323_DISABLE_" + moduleName.ToUpper();
+    featureEndif = "#endif // if ! H323_DISABLE_" + moduleName.ToUpper();
+    guard = "__" + moduleName.ToUpper() + "_TAB_H";
+    headerName = '"' + headerName + '"';
+  }
+
+  hdrFile << featureIf << "\n"
+             "\n"
+             "#ifndef " << guard << "\n"
+             "#define " << guard << "\n"
+             "\n"
+             "#include <ptclib/asntable.h>\n";
+
+  for (i = 0; i < imports.GetSize(); i++)
+    imports[i].GenerateTable(hdrFile, ptlibStyle);
+
+  hdrFile << "\n"
+             "\n";
+
+  OutputFile cxxFile;
+  if (!cxxFile.Open(path, "_tab", ".cxx"))
+    return;
+
+  cxxFile << "#include <ptlib.h>\n"
+             "#include " << headerName << "\n"
+             "\n"
+             "\n"
+          << featureIf << "\n"
+             "\n";
+
+  if (useNamespaces) {
+    hdrFile << "namespace " << moduleName << " {\n"
+               "\n";
+    cxxFile << "using namespace " << moduleName << ";\n"
+               "\n";
+  }
+
+  /* Structures contain other structures by value, unlike the classes which
+     only need forward declarations for CHOICE alternatives, so reorder again.
+     A recursive type, via a SEQUENCE OF, relies on the forward declaration. */
+  TypesList ordered;
+  ordered.DisallowDeleteObjects();
+  for (i = 0; i < types.GetSize(); i++)
+    ordered.Append(&types[i]);
+
+  PINDEX loopDetect = 0;
+  PINDEX bubble = 0;
+  while (bubble < ordered.GetSize()) {
+    PBoolean makesReference = FALSE;
+    if (loopDetect <= ordered.GetSize()) {
+      for (i = bubble+1; i < ordered.GetSize(); i++) {
+        if (ordered[bubble].TableUsesType(ordered[i])) {
+          makesReference = TRUE;
+          break;
+        }
+      }
+    }
+
+    if (makesReference) {
+      ordered.Append(ordered.RemoveAt(bubble));
+      loopDetect++;
+    }
+    else {
+      loopDetect = bubble;
+      bubble++;
+    }
+  }
+
+  for (i = 0; i < ordered.GetSize(); i++) {
+    if (PIsDescendant(&ordered[i], SequenceType) && ordered[i].IsTableSupported())
+      hdrFile << "struct " << ordered[i].GetIdentifier() << "_Value;\n";
+  }
+  hdrFile << "\n"
+             "\n";
+
+  for (i = 0; i < ordered.GetSize(); i++)
+    ordered[i].GenerateTable(hdrFile, cxxFile);
+
+  if (useNamespaces)
+    hdrFile << "};\n"
+               "\n";
+
+  hdrFile << "#endif // " << guard << "\n"
+             "\n"
+          << featureEndif << "\n"
+             "\n";
+
+  cxxFile << featureEndif << "\n"
+             "\n";
+
+  if (verbose)
+    cout << "Completed " << cxxFile.GetFilePath() << endl;
 }
 
 
@@ -398,6 +398,30 @@ class TypeBase : public PObject
     void GenerateCplusplusConstructor(ostream & hdr, ostream & cxx);
     void GenerateCplusplusConstraints(const PString & prefix, ostream & hdr, ostream & cxx);
 
+    // Table driven codec generation, see ptclib/asntable.h
+    struct TableInfo {
+      TableInfo();
+      PString  kind;          // PASN_TypeDescriptor::Kinds enumeration name
+      PString  constraint;
+      PString  lowerLimit;
+      PString  upperLimit;
+      PString  fields;        // Field descriptor array for SEQUENCE/CHOICE
+      PString  element;       // Element descriptor for SEQUENCE OF
+      PINDEX   rootCount;
+      PINDEX   fieldCount;
+      PINDEX   optionalCount;
+      PBoolean extendable;
+    };
+    virtual PString GetTableValueType() const;
+    virtual PString GetTableReference() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
+    virtual PBoolean TableUsesType(const TypeBase & type) const;
+    virtual void GenerateTableValue(ostream & hdr, ostream & cxx);
+    virtual void GenerateTable(ostream & hdr, ostream & cxx);
+    PBoolean IsTableSupported() const;
+    PString GenerateTableDescriptor(const PString & descName, PBoolean isStatic, ostream & cxx);
+    void GetTableConstraints(TableInfo & info);
+
   protected:
     TypeBase(unsigned tagNum);
     TypeBase(TypeBase * copy);
@@ -437,6 +461,10 @@ class DefinedType : public TypeBase
     virtual PString GetTypeName() const;
     virtual PBoolean CanReferenceType() const;
     virtual PBoolean ReferencesType(const TypeBase & type);
+    virtual PString GetTableValueType() const;
+    virtual PString GetTableReference() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
+    virtual PBoolean TableUsesType(const TypeBase & type) const;
 
   protected:
     void ConstructFromType(TypeBase * refType, const PString & name);
@@ -493,6 +521,8 @@ class BooleanType : public TypeBase
     BooleanType();
     virtual void GenerateOperators(ostream & hdr, ostream & cxx, const TypeBase & actualType);
     virtual const char * GetAncestorClass() const;
+    virtual PString GetTableValueType() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
 };
 
 
@@ -504,6 +534,8 @@ class IntegerType : public TypeBase
     IntegerType(NamedNumberList *);
     virtual void GenerateOperators(ostream & hdr, ostream & cxx, const TypeBase & actualType);
     virtual const char * GetAncestorClass() const;
+    virtual PString GetTableValueType() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
   protected:
     NamedNumberList allowedValues;
 };
@@ -519,6 +551,8 @@ class EnumeratedType : public TypeBase
     virtual void GenerateCplusplus(ostream & hdr, ostream & cxx);
     virtual void GenerateOperators(ostream & hdr, ostream & cxx, const TypeBase & actualType);
     virtual const char * GetAncestorClass() const;
+    virtual PString GetTableValueType() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
   protected:
     NamedNumberList enumerations;
     PINDEX numEnums;
@@ -556,6 +590,8 @@ class OctetStringType : public TypeBase
     OctetStringType();
     virtual void GenerateOperators(ostream & hdr, ostream & cxx, const TypeBase & actualType);
     virtual const char * GetAncestorClass() const;
+    virtual PString GetTableValueType() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
 };
 
 
@@ -565,6 +601,8 @@ class NullType : public TypeBase
   public:
     NullType();
     virtual const char * GetAncestorClass() const;
+    virtual PString GetTableValueType() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
 };
 
 
@@ -584,7 +622,13 @@ class SequenceType : public TypeBase
     virtual const char * GetAncestorClass() const;
     virtual PBoolean CanReferenceType() const;
     virtual PBoolean ReferencesType(const TypeBase & type);
+    virtual PString GetTableValueType() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
+    virtual PBoolean TableUsesType(const TypeBase & type) const;
+    virtual void GenerateTableValue(ostream & hdr, ostream & cxx);
   protected:
+    PString GenerateTableFields(ostream & cxx);
+
     TypesList fields;
     PINDEX numFields;
     PBoolean extendable;
@@ -606,8 +650,12 @@ class SequenceOfType : public TypeBase
     virtual const char * GetAncestorClass() const;
     virtual PBoolean CanReferenceType() const;
     virtual PBoolean ReferencesType(const TypeBase & type);
+    virtual PString GetTableValueType() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
+    virtual PBoolean TableUsesType(const TypeBase & type) const;
   protected:
     TypeBase * baseType;
+    PString    tableElement;
 };
 
 
@@ -618,6 +666,7 @@ class SetType : public SequenceType
     SetType();
     SetType(SequenceType * seq);
     virtual const char * GetAncestorClass() const;
+    virtual PString GetTableValueType() const;
 };
 
 
@@ -642,6 +691,7 @@ class ChoiceType : public SequenceType
     virtual PBoolean IsChoice() const;
     virtual const char * GetAncestorClass() const;
     virtual PBoolean ReferencesType(const TypeBase & type);
+    virtual void GenerateTableValue(ostream & hdr, ostream & cxx);
 };
 
 
@@ -670,6 +720,8 @@ class AnyType : public TypeBase
     AnyType(PString * ident);
     void PrintOn(ostream & strm) const;
     virtual const char * GetAncestorClass() const;
+    virtual PString GetTableValueType() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
   protected:
     PString identifier;
 };
@@ -838,6 +890,8 @@ class ObjectIdentifierType : public TypeBase
     virtual int GetIdentifierTokenContext() const;
     virtual int GetBraceTokenContext() const;
     virtual const char * GetAncestorClass() const;
+    virtual PString GetTableValueType() const;
+    virtual PBoolean GetTableInfo(TableInfo & info, ostream & cxx);
 };
 
 
@@ -869,6 +923,9 @@ class ImportedType : public TypeBase
     virtual void GenerateCplusplus(ostream & hdr, ostream & cxx);
     virtual void SetImportPrefix(const PString &);
     virtual PBoolean IsParameterisedImport() const;
+    virtual PString GetTableValueType() const;
+    virtual PString GetTableReference() const;
+    virtual void GenerateTable(ostream & hdr, ostream & cxx);
   protected:
     PString modulePrefix;
     PBoolean    parameterised;
@@ -939,7 +996,6 @@ class IntegerValue : public ValueBase
     virtual void GenerateCplusplus(ostream & hdr, ostream & cxx);
 
     operator PInt64() const { return value; }
-    operator long() const { return (long)value; }
 
   protected:
     PInt64 value;
@@ -1124,6 +1180,7 @@ class ImportModule : public PObject
     void PrintOn(ostream &) const;
 
     void GenerateCplusplus(ostream & hdr, ostream & cxx);
+    void GenerateTable(ostream & hdr, PBoolean ptlibStyle);
 
     PString   fullModuleName;
   protected:
@@ -1188,6 +1245,11 @@ class ModuleDefinition : public PObject
                            PBoolean useOperators,
                            PBoolean verbose);
 
+    void GenerateTables(const PFilePath & path,
+                        const PString & headerDir,
+                        PBoolean useNamespaces,
+                        PBoolean verbose);
+
 
   protected:
     PString         moduleName;